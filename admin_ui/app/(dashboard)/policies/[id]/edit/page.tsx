@@ -48,6 +48,7 @@ const matchExamples: Record<string, string> = {
   PREFIX: "e.g. /api/v2/",
   CONTAINS: "e.g. phishing",
   REGEX: "e.g. .*\\.evil\\.(net|com)",
+  DOMAIN: "e.g. evil.net",
 }
 
 function normalizeRule(r: PolicyRule): RuleForm {
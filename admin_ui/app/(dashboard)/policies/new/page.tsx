@@ -32,6 +32,7 @@ const matchExamples: Record<string, string> = {
   PREFIX: "e.g. /api/v2/",
   CONTAINS: "e.g. phishing",
   REGEX: "e.g. .*\\.evil\\.(net|com)",
+  DOMAIN: "e.g. evil.net",
 }
 
 export default function PolicyEditorPage() {
@@ -362,6 +363,7 @@ export default function PolicyEditorPage() {
                           <SelectItem value="PREFIX">Prefix</SelectItem>
                           <SelectItem value="CONTAINS">Contains</SelectItem>
                           <SelectItem value="REGEX">Regex</SelectItem>
+                          <SelectItem value="DOMAIN">Domain</SelectItem>
                         </SelectContent>
                       </Select>
                     </div>
@@ -461,6 +463,11 @@ export default function PolicyEditorPage() {
                   <br />
                   <code className="font-mono text-[11px]">{".*\\.evil\\.(net|com)"}</code>
                 </div>
+                <div>
+                  <span className="font-semibold text-foreground">DOMAIN:</span> Domain and all subdomains (HOST)
+                  <br />
+                  <code className="font-mono text-[11px]">evil.net</code>
+                </div>
               </div>
             </CardContent>
           </Card>
@@ -6,7 +6,7 @@ export type ReviewStatus = "OPEN" | "IN_PROGRESS" | "CLOSED"
 export type PolicyType = "ALLOWLIST" | "BLOCKLIST" | "MONITOR"
 export type PolicyAction = "ALLOW" | "BLOCK" | "REDIRECT" | "REVIEW"
 export type RuleType = "HOST" | "PATH" | "URL"
-export type MatchType = "EXACT" | "PREFIX" | "CONTAINS" | "REGEX"
+export type MatchType = "EXACT" | "PREFIX" | "CONTAINS" | "REGEX" | "DOMAIN"
 export type AuditAction = "CREATE" | "UPDATE" | "DELETE"
 export type UserRole = "Operator" | "Admin" | "Engineer"
 export type AILabel = "MALICIOUS" | "SUSPICIOUS" | "BENIGN" | "UNKNOWN"
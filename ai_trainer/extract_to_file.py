@@ -2,9 +2,12 @@ from __future__ import annotations
 
 import json
 import os
-from typing import Any, Dict, List
+import struct
+import zlib
+from typing import Any, Dict, List, Optional
 
 import joblib
+import numpy as np
 from sklearn.feature_extraction.text import TfidfVectorizer
 from sklearn.preprocessing import LabelEncoder
 
@@ -50,6 +53,157 @@ def save_metrics(metrics: Dict[str, Any], output_dir: str) -> str:
     return metrics_path
 
 
+NATIVE_MODEL_MAGIC = b"GGNMODL\x00"
+NATIVE_MODEL_FORMAT_VERSION = 1
+NATIVE_ENDIAN_TAG = 0x01020304
+
+NATIVE_PROB_BINARY = 0
+NATIVE_PROB_SOFTMAX = 1
+NATIVE_PROB_OVR = 2
+
+NATIVE_LABEL_SIZE = 32
+NATIVE_FEATURE_NAME_SIZE = 48
+NATIVE_MODEL_VERSION_SIZE = 64
+
+
+def _fixed_bytes(value: str, size: int) -> bytes:
+    raw = value.encode("utf-8")
+    if len(raw) >= size:
+        raise ValueError(f"value too long for native model field ({size}): {value}")
+    return raw + b"\x00" * (size - len(raw))
+
+
+def _pad8(blob: bytes) -> bytes:
+    return blob + b"\x00" * (-len(blob) % 8)
+
+
+def native_export_skip_reason(model: Any, vectorizer: TfidfVectorizer) -> Optional[str]:
+    """
+    엔진 내장 분류기(url_native_model.c)가 같은 점수를 재현할 수 있는 조합인지 확인
+    - 선형 모델(coef_/intercept_) + char n-gram TF-IDF(l2, sublinear_tf 없음)만 지원
+    """
+    if not hasattr(model, "coef_") or not hasattr(model, "intercept_"):
+        return f"unsupported model for native export: {type(model).__name__}"
+
+    if vectorizer.analyzer != "char":
+        return f"unsupported tfidf analyzer: {vectorizer.analyzer}"
+
+    if not vectorizer.lowercase or vectorizer.strip_accents is not None:
+        return "tfidf lowercase=True / strip_accents=None required"
+
+    if vectorizer.norm != "l2" or vectorizer.sublinear_tf or not vectorizer.use_idf:
+        return "tfidf norm='l2', sublinear_tf=False, use_idf=True required"
+
+    return None
+
+
+def native_prob_mode(model: Any, class_count: int) -> int:
+    # LogisticRegression.predict_proba와 같은 기준 (ovr이면 sigmoid, 아니면 softmax)
+    multi_class = getattr(model, "multi_class", "auto")
+    ovr = multi_class in ("ovr", "warn") or (
+        multi_class in ("auto", "deprecated")
+        and (class_count <= 2 or getattr(model, "solver", "") == "liblinear")
+    )
+
+    if not ovr:
+        return NATIVE_PROB_SOFTMAX
+    if class_count == 2:
+        return NATIVE_PROB_BINARY
+    return NATIVE_PROB_OVR
+
+
+def build_native_model_bytes(
+    model: Any,
+    vectorizer: TfidfVectorizer,
+    label_encoder: LabelEncoder,
+    meta: Dict[str, Any],
+) -> bytes:
+    """
+    엔진 내장 분류기용 바이너리 (little-endian)
+    [header 120B][labels][numeric feature names][vocab offsets + blob][idf][coef][intercept]
+    - 특성 순서는 학습 시 hstack([tfidf, numeric])과 동일: vocabulary_ 인덱스 -> numeric_feature_columns
+    - header의 crc32는 header 뒤 전체 본문 기준
+    """
+    labels = [str(label) for label in label_encoder.classes_]
+    if "benign" not in labels:
+        raise ValueError("label_encoder.classes_ does not contain 'benign'")
+
+    numeric_columns = list(meta.get("numeric_feature_columns", []))
+
+    vocabulary = vectorizer.vocabulary_
+    terms = [""] * len(vocabulary)
+    for term, index in vocabulary.items():
+        terms[index] = term
+
+    term_blobs = [term.encode("utf-8") for term in terms]
+    offsets = [0]
+    for blob in term_blobs:
+        offsets.append(offsets[-1] + len(blob))
+
+    coef = np.asarray(model.coef_, dtype="<f8")
+    intercept = np.asarray(model.intercept_, dtype="<f8")
+    feature_count = len(terms) + len(numeric_columns)
+
+    if coef.shape[1] != feature_count:
+        raise ValueError(f"coef width {coef.shape[1]} != tfidf {len(terms)} + numeric {len(numeric_columns)}")
+
+    min_n, max_n = vectorizer.ngram_range
+
+    body = b"".join(
+        [
+            b"".join(_fixed_bytes(label, NATIVE_LABEL_SIZE) for label in labels),
+            b"".join(_fixed_bytes(name, NATIVE_FEATURE_NAME_SIZE) for name in numeric_columns),
+            _pad8(struct.pack(f"<{len(offsets)}I", *offsets) + b"".join(term_blobs)),
+            np.asarray(vectorizer.idf_, dtype="<f8").tobytes(),
+            coef.tobytes(order="C"),
+            intercept.tobytes(),
+        ]
+    )
+
+    header = struct.pack(
+        "<8s12I64s",
+        NATIVE_MODEL_MAGIC,
+        NATIVE_MODEL_FORMAT_VERSION,
+        NATIVE_ENDIAN_TAG,
+        len(labels),
+        labels.index("benign"),
+        int(min_n),
+        int(max_n),
+        len(terms),
+        len(numeric_columns),
+        coef.shape[0],
+        native_prob_mode(model, len(labels)),
+        zlib.crc32(body) & 0xFFFFFFFF,
+        0,
+        _fixed_bytes(str(meta.get("model_version", "unknown")), NATIVE_MODEL_VERSION_SIZE),
+    )
+
+    return header + body
+
+
+def save_native_model(
+    model: Any,
+    vectorizer: TfidfVectorizer,
+    label_encoder: LabelEncoder,
+    meta: Dict[str, Any],
+    output_dir: str,
+) -> Optional[str]:
+    skip_reason = native_export_skip_reason(model, vectorizer)
+    if skip_reason:
+        print(f"[AI_Trainer] native model export skipped: {skip_reason}")
+        return None
+
+    ensure_output_dir(output_dir)
+    native_path = os.path.join(output_dir, "model_native.bin")
+    tmp_path = native_path + ".tmp"
+
+    with open(tmp_path, "wb") as fp:
+        fp.write(build_native_model_bytes(model, vectorizer, label_encoder, meta))
+    os.replace(tmp_path, native_path)
+
+    return native_path
+
+
 def build_meta(
     config: Dict[str, Any],
     feature_columns: List[str],
@@ -97,11 +251,17 @@ def save_all_artifacts(
     label_encoder_path = save_label_encoder(label_encoder, output_dir)
     meta_path = save_meta(meta, output_dir)
     metrics_path = save_metrics(metrics, output_dir)
+    native_model_path = save_native_model(model, vectorizer, label_encoder, meta, output_dir)
 
-    return {
+    paths = {
         "model_path": model_path,
         "vectorizer_path": vectorizer_path,
         "label_encoder_path": label_encoder_path,
         "meta_path": meta_path,
         "metrics_path": metrics_path,
     }
+
+    if native_model_path:
+        paths["native_model_path"] = native_model_path
+
+    return paths
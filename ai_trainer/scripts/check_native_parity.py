@@ -0,0 +1,140 @@
+from __future__ import annotations
+
+import argparse
+import os
+import subprocess
+import sys
+from typing import List, Tuple
+from urllib.parse import urlparse
+
+import pandas as pd
+
+REPO_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+sys.path.insert(0, REPO_ROOT)
+
+from gateguard_api.ai_function import normalize_url, predict_scores  # noqa: E402
+from gateguard_api.ai_loader import load_model  # noqa: E402
+
+DEFAULT_TOOL = os.path.join(REPO_ROOT, "engine_C", "url_native_score")
+
+
+def build_arg_parser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(
+        description="Compare engine native scores with the Python /v1/score path"
+    )
+    parser.add_argument(
+        "--artifacts-dir",
+        default=os.getenv("MODEL_DIR", "/home/ktech/GateGuard/ai_trainer/artifacts/latest"),
+        help="Directory containing model.pkl, vectorizer.pkl, meta.json and model_native.bin",
+    )
+    parser.add_argument("--csv", required=True, help="Held-out CSV with a 'url' column")
+    parser.add_argument("--tool", default=DEFAULT_TOOL, help="engine_C url_native_score binary (make native_score)")
+    parser.add_argument("--tolerance", type=float, default=1e-6, help="Max allowed |native - python| score")
+    parser.add_argument("--limit", type=int, default=0, help="Only check the first N rows (0 = all)")
+    return parser
+
+
+def url_to_host_path(url: str) -> Tuple[str, str]:
+    # 엔진 HttpEvent와 같은 분리: host = netloc, path = path(+?query)
+    parsed = urlparse(normalize_url(url))
+    path = parsed.path or "/"
+    if parsed.query:
+        path = f"{path}?{parsed.query}"
+    return parsed.netloc, path
+
+
+def load_items(csv_path: str, limit: int) -> Tuple[List[Tuple[str, str]], int]:
+    df = pd.read_csv(csv_path)
+    if "url" not in df.columns:
+        raise ValueError(f"{csv_path} must contain a 'url' column")
+
+    items: List[Tuple[str, str]] = []
+    skipped = 0
+
+    for url in df["url"].astype(str):
+        # 내장 분류기는 바이트 단위 처리 -> ASCII URL만 비교
+        if not url.isascii() or "\t" in url or "\n" in url:
+            skipped += 1
+            continue
+
+        host, path = url_to_host_path(url)
+        if not host:
+            skipped += 1
+            continue
+
+        items.append((host, path))
+        if limit and len(items) >= limit:
+            break
+
+    return items, skipped
+
+
+def run_native(tool: str, native_model_path: str, items: List[Tuple[str, str]]) -> List[Tuple[bool, float, str]]:
+    tsv = "".join(f"{host}\t{path}\n" for host, path in items)
+    proc = subprocess.run(
+        [tool, native_model_path],
+        input=tsv,
+        capture_output=True,
+        text=True,
+        check=True,
+    )
+
+    results = []
+    for line in proc.stdout.splitlines():
+        ok, score, label = line.split("\t", 2)
+        results.append((ok == "1", float(score), label))
+
+    if len(results) != len(items):
+        raise RuntimeError(f"native tool returned {len(results)} rows for {len(items)} inputs")
+    return results
+
+
+def main() -> int:
+    args = build_arg_parser().parse_args()
+
+    native_model_path = os.path.join(args.artifacts_dir, "model_native.bin")
+    if not os.path.exists(native_model_path):
+        print(f"[Parity] native model not found: {native_model_path}", file=sys.stderr)
+        return 1
+
+    items, skipped = load_items(args.csv, args.limit)
+    if not items:
+        print("[Parity] no comparable rows", file=sys.stderr)
+        return 1
+
+    load_model(args.artifacts_dir)
+    python_results = predict_scores(items)
+    native_results = run_native(args.tool, native_model_path, items)
+
+    max_diff = 0.0
+    score_failures = 0
+    label_mismatches = 0
+    native_errors = 0
+
+    for (host, path), py, (ok, score, label) in zip(items, python_results, native_results):
+        if not ok:
+            native_errors += 1
+            print(f"[Parity] native error {host}{path}: {label}")
+            continue
+
+        diff = abs(score - py["score"])
+        max_diff = max(max_diff, diff)
+
+        if diff > args.tolerance:
+            score_failures += 1
+            if score_failures <= 10:
+                print(f"[Parity] score diff {diff:.3e} {host}{path}: native={score:.9f} python={py['score']:.9f}")
+
+        if label != py["label"]:
+            label_mismatches += 1
+
+    print(
+        f"[Parity] rows={len(items)} skipped={skipped} max_diff={max_diff:.3e} "
+        f"over_tolerance={score_failures} label_mismatch={label_mismatches} native_errors={native_errors}"
+    )
+
+    return 0 if score_failures == 0 and native_errors == 0 else 1
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
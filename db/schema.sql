@@ -40,7 +40,7 @@ CREATE TABLE IF NOT EXISTS policy_rule (
   rule_id BIGINT NOT NULL AUTO_INCREMENT,
   policy_id BIGINT NOT NULL,
   rule_type ENUM('HOST','PATH','URL') NOT NULL,
-  match_type ENUM('EXACT','PREFIX','CONTAINS','REGEX') NOT NULL,
+  match_type ENUM('EXACT','PREFIX','CONTAINS','REGEX','DOMAIN') NOT NULL,
   pattern VARCHAR(512) NOT NULL,
   is_case_sensitive TINYINT(1) NOT NULL DEFAULT 0,
   is_negated TINYINT(1) NOT NULL DEFAULT 0,
@@ -57,6 +57,11 @@ CREATE TABLE IF NOT EXISTS policy_rule (
     ON UPDATE CASCADE
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
+-- 기존 DB 마이그레이션: match_type에 DOMAIN 추가
+-- (CREATE TABLE IF NOT EXISTS는 기존 테이블 ENUM을 바꾸지 않음, 재실행해도 무해)
+ALTER TABLE policy_rule
+  MODIFY match_type ENUM('EXACT','PREFIX','CONTAINS','REGEX','DOMAIN') NOT NULL;
+
 -- =========================================
 -- 3) access_log
 -- 기술서(2026-02-13) 기준
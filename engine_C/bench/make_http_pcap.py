@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# engine_C/bench/make_http_pcap.py
+# 부하 테스트용 pcap 생성 (CAP_BACKEND=replay 입력, 표준 라이브러리만 사용)
+# - Ethernet/IPv4/TCP, 목적지 port 80, 패킷 1개 = HTTP GET 1건 (엔진 HttpEvent 1건)
+# - --unique-urls: 서로 다른 URL 수 (작을수록 판정 캐시/coalescing 적중 증가)
+# - --static-rate: 정적 리소스 비율 (1차 휴리스틱에서 바로 정상 판정)
+# - --suspicious-rate: 의심 키워드/IP host URL 비율 (AI 단계까지 가는 비율에 영향)
+from __future__ import annotations
+
+import argparse
+import random
+import struct
+
+ETH_HEADER = b"\x02\x00\x00\x00\x00\x02" + b"\x02\x00\x00\x00\x00\x01" + b"\x08\x00"
+
+BENIGN_HOSTS = ["www.example.com", "news.example.org", "shop.example.net", "docs.example.io", "api.example.com"]
+STATIC_PATHS = ["/static/app.css", "/img/logo.png", "/fonts/main.woff2", "/favicon.ico", "/js/bundle.js.map"]
+SUSPICIOUS_HOSTS = ["login-verify-account.example.xyz", "secure-update.example.top", "203.0.113.7",
+                    "paypa1-confirm.example.click"]
+SUSPICIOUS_PATHS = ["/wp-admin/setup.php?cmd=", "/login/verify?token=", "/update/invoice.exe?id=",
+                    "/account/confirm.zip?session="]
+
+
+def build_arg_parser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(description="Generate a synthetic HTTP GET pcap for engine replay benchmarks")
+    parser.add_argument("--out", required=True)
+    parser.add_argument("--count", type=int, default=100000, help="Number of HTTP requests (packets)")
+    parser.add_argument("--unique-urls", type=int, default=5000)
+    parser.add_argument("--static-rate", type=float, default=0.3)
+    parser.add_argument("--suspicious-rate", type=float, default=0.1)
+    parser.add_argument("--clients", type=int, default=200, help="Number of distinct client IPs (10.1.x.y)")
+    parser.add_argument("--pps", type=float, default=10000.0, help="Timestamp spacing (CAP_REPLAY_PACE=original)")
+    parser.add_argument("--seed", type=int, default=1)
+    return parser
+
+
+def checksum(data: bytes) -> int:
+    if len(data) % 2:
+        data += b"\x00"
+    s = sum(struct.unpack(f"!{len(data) // 2}H", data))
+    while s >> 16:
+        s = (s & 0xFFFF) + (s >> 16)
+    return ~s & 0xFFFF
+
+
+def make_url(i: int, rng: random.Random, static_rate: float, suspicious_rate: float):
+    r = rng.random()
+    if r < static_rate:
+        return rng.choice(BENIGN_HOSTS), f"{rng.choice(STATIC_PATHS)}?v={i}"
+    if r < static_rate + suspicious_rate:
+        return rng.choice(SUSPICIOUS_HOSTS), f"{rng.choice(SUSPICIOUS_PATHS)}{i:x}"
+    return rng.choice(BENIGN_HOSTS), f"/article/{i}/view?id={i * 7}"
+
+
+def make_packet(src_ip: bytes, dst_ip: bytes, sport: int, seq: int, host: str, path: str) -> bytes:
+    payload = (f"GET {path} HTTP/1.1\r\nHost: {host}\r\nUser-Agent: gateguard-bench\r\n"
+               f"Accept: */*\r\n\r\n").encode("ascii")
+
+    tcp = struct.pack("!HHIIBBHHH", sport, 80, seq, 1, 5 << 4, 0x18, 65535, 0, 0)
+    pseudo = src_ip + dst_ip + struct.pack("!BBH", 0, 6, len(tcp) + len(payload))
+    tcp = tcp[:16] + struct.pack("!H", checksum(pseudo + tcp + payload)) + tcp[18:]
+
+    total_len = 20 + len(tcp) + len(payload)
+    ip = struct.pack("!BBHHHBBH4s4s", 0x45, 0, total_len, seq & 0xFFFF, 0x4000, 64, 6, 0, src_ip, dst_ip)
+    ip = ip[:10] + struct.pack("!H", checksum(ip)) + ip[12:]
+
+    return ETH_HEADER + ip + tcp + payload
+
+
+def main() -> int:
+    args = build_arg_parser().parse_args()
+    rng = random.Random(args.seed)
+
+    urls = [make_url(i, rng, args.static_rate, args.suspicious_rate) for i in range(max(1, args.unique_urls))]
+    dst_ip = bytes([192, 0, 2, 10])
+    step_us = int(1_000_000 / args.pps) if args.pps > 0 else 0
+
+    with open(args.out, "wb") as fp:
+        # pcap global header (microsecond, LINKTYPE_ETHERNET)
+        fp.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535, 1))
+
+        ts_us = 1_700_000_000 * 1_000_000
+        for n in range(args.count):
+            host, path = urls[rng.randrange(len(urls))]
+            client = n % max(1, args.clients)
+            src_ip = bytes([10, 1, (client >> 8) & 0xFF, client & 0xFF])
+            pkt = make_packet(src_ip, dst_ip, 20000 + (n % 40000), 1000 + n, host, path)
+
+            fp.write(struct.pack("<IIII", ts_us // 1_000_000, ts_us % 1_000_000, len(pkt), len(pkt)))
+            fp.write(pkt)
+            ts_us += step_us
+
+    print(f"[PCAP] wrote {args.count} packets ({len(urls)} unique urls) to {args.out}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+# engine_C/bench/run_bench.sh
+# 엔진 부하 테스트 (네트워크/DB 없이 로컬에서 반복 가능)
+# - make_http_pcap.py로 만든 pcap을 CAP_BACKEND=replay로 재생 -> engine_handle_http_event 전체 경로
+# - ENGINE_DRY_RUN=1: DB 기록/차단 주입 생략, METRICS_HISTOGRAM=1: 단계별 히스토그램
+# - AI는 stub_score_server.py (지연/에러/잘못된 응답 비율을 시나리오별로 지정)
+# - 시나리오별 [METRICS] 출력은 $OUT_DIR/<scenario>.log, 요약은 $OUT_DIR/summary.txt
+#
+# 사용: bench/run_bench.sh [scenario ...]   (기본: 전체)
+#   healthy   : 지연 2ms 고정, 장애 없음
+#   slow      : lognormal 중앙값 40ms (adaptive timeout 동작 확인)
+#   errors    : 50% HTTP 503 (circuit breaker OPEN/HALF_OPEN 확인)
+#   malformed : 30% 잘못된 JSON
+#   timeouts  : 20% timeout (AI_TIMEOUT_MS 초과)
+#   down      : stub 없음 (연결 거부)
+#
+# 환경변수: ENGINE_BIN, PACKETS, UNIQUE_URLS, STUB_PORT, OUT_DIR, CAP_REPLAY_PACE, CAP_REPLAY_PPS
+# (그 밖의 엔진 설정, 예: AI_ASYNC_MAX_INFLIGHT / AI_BATCH_MAX / AI_PRESCORE_LOW 는 그대로 엔진에 전달)
+set -euo pipefail
+
+BENCH_DIR="$(cd "$(dirname "$0")" && pwd)"
+ENGINE_BIN="${ENGINE_BIN:-$BENCH_DIR/../gateguard_engine}"
+PACKETS="${PACKETS:-50000}"
+UNIQUE_URLS="${UNIQUE_URLS:-5000}"
+STUB_PORT="${STUB_PORT:-18090}"
+OUT_DIR="${OUT_DIR:-/tmp/gateguard_bench}"
+PYTHON="${PYTHON:-python3}"
+
+SCENARIOS=("$@")
+if [ ${#SCENARIOS[@]} -eq 0 ]; then
+    SCENARIOS=(healthy slow errors malformed timeouts down)
+fi
+
+if [ ! -x "$ENGINE_BIN" ]; then
+    echo "[BENCH] engine binary not found: $ENGINE_BIN (run make first)" >&2
+    exit 1
+fi
+
+mkdir -p "$OUT_DIR"
+PCAP="$OUT_DIR/http_${PACKETS}_${UNIQUE_URLS}.pcap"
+if [ ! -f "$PCAP" ]; then
+    "$PYTHON" "$BENCH_DIR/make_http_pcap.py" --out "$PCAP" --count "$PACKETS" --unique-urls "$UNIQUE_URLS"
+fi
+
+STUB_PID=""
+stop_stub() {
+    if [ -n "$STUB_PID" ]; then
+        kill "$STUB_PID" 2>/dev/null || true
+        wait "$STUB_PID" 2>/dev/null || true
+        STUB_PID=""
+    fi
+}
+trap stop_stub EXIT
+
+start_stub() {
+    "$PYTHON" "$BENCH_DIR/stub_score_server.py" --port "$STUB_PORT" "$@" 2>>"$OUT_DIR/stub.log" &
+    STUB_PID=$!
+    for _ in $(seq 1 50); do
+        if "$PYTHON" -c "import socket,sys; socket.create_connection(('127.0.0.1', $STUB_PORT), 0.2)" 2>/dev/null; then
+            return 0
+        fi
+        sleep 0.1
+    done
+    echo "[BENCH] stub server did not start" >&2
+    exit 1
+}
+
+: > "$OUT_DIR/summary.txt"
+
+for scenario in "${SCENARIOS[@]}"; do
+    case "$scenario" in
+        healthy)   start_stub --latency fixed --latency-ms 2 ;;
+        slow)      start_stub --latency lognormal --latency-ms 40 --latency-sigma 0.6 ;;
+        errors)    start_stub --latency fixed --latency-ms 2 --error-rate 0.5 ;;
+        malformed) start_stub --latency fixed --latency-ms 2 --malformed-rate 0.3 ;;
+        timeouts)  start_stub --latency fixed --latency-ms 2 --timeout-rate 0.2 --timeout-ms 5000 ;;
+        down)      ;;
+        *) echo "[BENCH] unknown scenario: $scenario" >&2; exit 2 ;;
+    esac
+
+    log="$OUT_DIR/$scenario.log"
+    echo "[BENCH] scenario=$scenario packets=$PACKETS unique_urls=$UNIQUE_URLS"
+
+    ENGINE_DRY_RUN=1 \
+    METRICS_HISTOGRAM=1 \
+    CAP_BACKEND=replay \
+    CAP_REPLAY_FILE="$PCAP" \
+    CAP_REPLAY_PACE="${CAP_REPLAY_PACE:-pps}" \
+    CAP_REPLAY_PPS="${CAP_REPLAY_PPS:-5000}" \
+    CAP_REPLAY_LOOPS=1 \
+    AI_BASE_URL="http://127.0.0.1:$STUB_PORT" \
+    API_TOKEN=changeme-token \
+    AI_TIMEOUT_MS="${AI_TIMEOUT_MS:-1000}" \
+    POLICY_SNAPSHOT_FILE="${POLICY_SNAPSHOT_FILE:-$OUT_DIR/policy.snap}" \
+        "$ENGINE_BIN" >"$log" 2>&1 || echo "[BENCH] engine exited with $? (see $log)" >&2
+
+    stop_stub
+
+    {
+        echo "=== $scenario"
+        grep '^\[METRICS\]' "$log" | grep -v ' hist ' || true
+        grep '^\[AI_BREAKER\]' "$log" | tail -n 5 || true
+    } | tee -a "$OUT_DIR/summary.txt"
+done
+
+echo "[BENCH] logs in $OUT_DIR (summary.txt, <scenario>.log with per-stage histograms)"
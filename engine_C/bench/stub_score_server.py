@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+# engine_C/bench/stub_score_server.py
+# 부하 테스트용 채점 API stub (/v1/score, /v1/score_batch, 표준 라이브러리만 사용)
+# - 모델 없이 URL 해시로 점수 생성 (같은 URL은 항상 같은 점수)
+# - 지연 분포, 에러율(5xx), 잘못된 응답 비율, timeout 비율을 옵션으로 지정
+# - 실행 중 설정 변경: POST /stub/config {"latency_ms": 50, "error_rate": 0.3, ...}
+#   (AI 장애/회복 구간을 한 실행 안에서 재현)
+from __future__ import annotations
+
+import argparse
+import hashlib
+import json
+import random
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+_lock = threading.Lock()
+_cfg = {}
+_stats = {"requests": 0, "items": 0, "errors": 0, "malformed": 0, "timeouts": 0}
+
+
+def build_arg_parser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(description="Stub /v1/score server for engine load tests")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=18090)
+    parser.add_argument("--token", default="changeme-token", help="Bearer token (empty = no check)")
+    parser.add_argument("--latency", choices=["fixed", "uniform", "lognormal"], default="fixed",
+                        help="Latency distribution per request")
+    parser.add_argument("--latency-ms", type=float, default=2.0, help="fixed value / uniform max / lognormal median")
+    parser.add_argument("--latency-sigma", type=float, default=0.5, help="lognormal sigma")
+    parser.add_argument("--error-rate", type=float, default=0.0, help="Fraction of requests answered with HTTP 503")
+    parser.add_argument("--malformed-rate", type=float, default=0.0, help="Fraction answered with truncated JSON")
+    parser.add_argument("--timeout-rate", type=float, default=0.0, help="Fraction that sleep --timeout-ms first")
+    parser.add_argument("--timeout-ms", type=float, default=10000.0)
+    parser.add_argument("--malicious-rate", type=float, default=0.1, help="Fraction of URLs scored as malicious")
+    parser.add_argument("--seed", type=int, default=1)
+    return parser
+
+
+def url_score(host: str, path: str) -> float:
+    # 실행마다 같은 URL -> 같은 점수 (판정 캐시/coalescing 효과가 재현되도록)
+    digest = hashlib.blake2b(f"{host}{path}".encode("utf-8", "replace"), digest_size=8).digest()
+    u = int.from_bytes(digest, "little") / float(1 << 64)
+    with _lock:
+        malicious_rate = _cfg["malicious_rate"]
+    if u < malicious_rate:
+        return round(0.5 + 0.5 * (u / malicious_rate), 4)
+    return round(0.5 * (u - malicious_rate) / (1.0 - malicious_rate), 4) if malicious_rate < 1.0 else 0.0
+
+
+def pick_latency_sec() -> float:
+    with _lock:
+        kind = _cfg["latency"]
+        ms = _cfg["latency_ms"]
+        sigma = _cfg["latency_sigma"]
+    if kind == "uniform":
+        return random.uniform(0.0, ms) / 1000.0
+    if kind == "lognormal":
+        return random.lognormvariate(0.0, sigma) * ms / 1000.0
+    return ms / 1000.0
+
+
+def pick_fault() -> str:
+    # 요청 1건에 장애 1종류만 적용: timeout -> error -> malformed 순서
+    with _lock:
+        rates = (("timeout", _cfg["timeout_rate"]), ("error", _cfg["error_rate"]),
+                 ("malformed", _cfg["malformed_rate"]))
+    r = random.random()
+    for name, rate in rates:
+        if r < rate:
+            return name
+        r -= rate
+    return ""
+
+
+def count(key: str, n: int = 1) -> None:
+    with _lock:
+        _stats[key] += n
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"   # 엔진 연결 풀 keep-alive 유지
+    disable_nagle_algorithm = True  # header/body 두 번 write: keep-alive 연결에서 delayed ACK(~40ms) 대기 방지
+
+    def log_message(self, fmt, *args):  # noqa: D401 - 요청마다 로그 출력 안 함
+        return
+
+    def send_body(self, status: int, body: bytes) -> None:
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def send_json(self, status: int, obj) -> None:
+        self.send_body(status, json.dumps(obj).encode("utf-8"))
+
+    def do_GET(self):
+        if self.path == "/stub/stats":
+            with _lock:
+                self.send_json(200, {"stats": dict(_stats), "config": dict(_cfg)})
+            return
+        self.send_json(404, {"detail": "not found"})
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length") or 0)
+        raw = self.rfile.read(length) if length > 0 else b""
+
+        if self.path == "/stub/config":
+            try:
+                update = json.loads(raw or b"{}")
+            except ValueError:
+                self.send_json(400, {"detail": "bad json"})
+                return
+            with _lock:
+                for key, value in update.items():
+                    if key in _cfg and key not in ("host", "port"):
+                        _cfg[key] = type(_cfg[key])(value)
+                current = dict(_cfg)
+            print(f"[STUB] config {current}", file=sys.stderr, flush=True)
+            self.send_json(200, current)
+            return
+
+        if self.path not in ("/v1/score", "/v1/score_batch"):
+            self.send_json(404, {"detail": "not found"})
+            return
+
+        with _lock:
+            token = _cfg["token"]
+        if token and self.headers.get("Authorization") != f"Bearer {token}":
+            self.send_json(401, {"detail": "invalid token"})
+            return
+
+        try:
+            req = json.loads(raw)
+        except ValueError:
+            self.send_json(422, {"detail": "bad json"})
+            return
+
+        count("requests")
+        fault = pick_fault()
+        delay = pick_latency_sec()
+        if fault == "timeout":
+            count("timeouts")
+            with _lock:
+                delay += _cfg["timeout_ms"] / 1000.0
+        if delay > 0:
+            time.sleep(delay)
+
+        if fault == "error":
+            count("errors")
+            self.send_json(503, {"detail": "stub injected error"})
+            return
+
+        if self.path == "/v1/score":
+            count("items")
+            if fault == "malformed":
+                count("malformed")
+                self.send_body(200, b'{"request_id": "' + str(req.get("request_id", "")).encode() + b'", "score": ')
+                return
+            score = url_score(req.get("host") or "", req.get("path") or "/")
+            self.send_json(200, {
+                "request_id": req.get("request_id"),
+                "model_version": "stub",
+                "score": score,
+                "label": "malicious" if score >= 0.5 else "benign",
+                "threshold": 0.5,
+                "latency_ms": int(delay * 1000),
+            })
+            return
+
+        items = req.get("items") or []
+        count("items", len(items))
+        if fault == "malformed":
+            count("malformed")
+            self.send_body(200, b'{"model_version": "stub", "results": [{"ok": true, "score": ')
+            return
+        results = []
+        for item in items:
+            score = url_score(item.get("host") or "", item.get("path") or "/")
+            results.append({
+                "request_id": item.get("request_id"),
+                "ok": True,
+                "score": score,
+                "label": "malicious" if score >= 0.5 else "benign",
+            })
+        self.send_json(200, {"model_version": "stub", "threshold": 0.5,
+                             "latency_ms": int(delay * 1000), "results": results})
+
+
+def main() -> int:
+    args = build_arg_parser().parse_args()
+    random.seed(args.seed)
+    _cfg.update({
+        "token": args.token,
+        "latency": args.latency,
+        "latency_ms": args.latency_ms,
+        "latency_sigma": args.latency_sigma,
+        "error_rate": args.error_rate,
+        "malformed_rate": args.malformed_rate,
+        "timeout_rate": args.timeout_rate,
+        "timeout_ms": args.timeout_ms,
+        "malicious_rate": args.malicious_rate,
+    })
+
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    server.daemon_threads = True
+    print(f"[STUB] listening on http://{args.host}:{args.port} {dict(_cfg)}", file=sys.stderr, flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+        with _lock:
+            print(f"[STUB] stats {_stats}", file=sys.stderr, flush=True)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
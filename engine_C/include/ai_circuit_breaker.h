@@ -0,0 +1,61 @@
+// include/ai_circuit_breaker.h
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 원격 AI 호출 circuit breaker + 적응형 timeout
+ * - CLOSED: 최근 window개 결과의 실패율이 error_rate 이상이면 (min_requests 이상일 때) OPEN
+ * - OPEN: open_ms 동안 네트워크 호출 없이 즉시 실패 (호출자는 설정된 기본 action 적용)
+ * - HALF_OPEN: half_open_probes개까지만 보내 보고 성공하면 CLOSED, 실패하면 다시 OPEN
+ * - 요청은 allow 때의 epoch(OPEN 전환 횟수)로 태그: 마지막 OPEN 전에 보낸 요청의 결과는 무시
+ * - timeout: 최근 응답 지연 p99 * p99_factor (min_timeout_ms ~ 설정 timeout_ms)
+ *   timeout된 요청은 당시 timeout 값을 표본으로 넣어 서비스가 느려지면 timeout도 늘어남
+ *   HALF_OPEN probe는 항상 최대 timeout 사용 (느려진 서비스에서 회복 판단이 가능하도록)
+ * - 실패: timeout / 연결 오류 / HTTP 5xx, 429 (잘못된 요청 등 4xx는 서비스 상태와 무관)
+ */
+typedef enum {
+    AI_BREAKER_CLOSED = 0,
+    AI_BREAKER_OPEN,
+    AI_BREAKER_HALF_OPEN
+} ai_breaker_state_t;
+
+typedef struct {
+    int    window;            // 실패율 계산에 쓰는 최근 결과 수 (0이면 breaker 끔)
+    int    min_requests;      // window 안에 이 수 이상 쌓여야 OPEN 판단
+    double error_rate;        // OPEN 전환 실패율 (0~1)
+    int    open_ms;           // OPEN 유지 시간
+    int    half_open_probes;  // HALF_OPEN에서 보낼 probe 수
+    int    adaptive_timeout;  // 1이면 p99 기반 timeout
+    int    min_timeout_ms;
+    double p99_factor;
+} ai_breaker_config_t;
+
+// max_timeout_ms: 적응형 timeout 상한 (= 설정 timeout_ms)
+void ai_breaker_init(const ai_breaker_config_t* cfg, int max_timeout_ms);
+
+#define AI_BREAKER_PROBE 2
+
+// 요청 전 호출: 0이면 즉시 실패 처리, 1이면 진행, AI_BREAKER_PROBE면 진행 (HALF_OPEN probe 슬롯 사용)
+// epoch: 결과 기록 때 넘길 태그 (NULL 가능)
+int  ai_breaker_allow(uint32_t* epoch);
+
+// AI_BREAKER_PROBE를 받고도 요청을 보내지 못한 경우 probe 슬롯 반환 (결과 없이 슬롯만 잡혀 있지 않도록)
+void ai_breaker_release_probe(void);
+
+// 실제로 보낸 요청의 결과 기록 (latency_ms는 성공 / timeout 응답만 timeout 계산에 사용)
+void ai_breaker_record(uint32_t epoch, int failure, int timed_out, int64_t latency_ms);
+
+// 이번 요청에 쓸 timeout
+int  ai_breaker_timeout_ms(void);
+
+ai_breaker_state_t ai_breaker_state(void);
+const char*        ai_breaker_state_name(ai_breaker_state_t s);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+// include/ai_score_proto.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "url_classification_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 채점 API Unix domain socket 바이너리 프로토콜 (gateguard_api/score_socket.py와 동일)
+ * - 모든 정수는 little-endian
+ * - 연결 직후 hello: "GGS1" + u16 token_len + token  ->  응답 u16 status(200/401/403) + u16 0
+ * - 요청: u32 len + u32 seq + u16 host_len + u16 path_len + u16 rid_len + u16 0 + host + path + rid
+ * - 응답: u32 len + u32 seq + u16 status + u8 label_len + u8 mv_len + f64 score + label + mv (+ 에러 메시지)
+ *   (len은 len 필드 다음부터의 바이트 수, status는 HTTP 코드와 같은 의미)
+ * - pipelining: 응답을 기다리지 않고 여러 요청을 보낼 수 있음, 응답은 요청 순서대로 옴
+ */
+#define AI_PROTO_MAGIC      "GGS1"
+#define AI_PROTO_REQ_MAX    2048
+#define AI_PROTO_RESP_MAX   1024
+#define AI_PROTO_HELLO_MAX  (4 + 2 + 128)
+#define AI_PROTO_HELLO_REPLY 4
+
+// 연결 + hello (blocking, 호출 스레드에서 대기), 성공 시 non-blocking fd / 실패 시 -1 (err에 사유)
+int    ai_proto_connect(const char* path, const char* token, int timeout_ms, char* err, size_t errsz);
+
+/*
+ * 이벤트 루프용: 소켓 생성 + connect만 (hello는 호출자가 보내고 응답을 확인)
+ * - nonblock=1이면 블로킹 없이 즉시 성공/실패 (backlog가 차 있으면 실패)
+ * - hello 응답(AI_PROTO_HELLO_REPLY 바이트)은 첫 응답 frame보다 먼저 오므로 요청을 바로 이어 보내도 됨
+ */
+int      ai_proto_open(const char* path, int nonblock, char* err, size_t errsz);
+size_t   ai_proto_encode_hello(uint8_t* out, size_t cap, const char* token);   // 0이면 cap 부족
+uint16_t ai_proto_hello_status(const uint8_t* reply);                          // 200이면 인증 성공
+
+// 요청 frame 작성: 쓴 바이트 수 (0이면 cap 부족 또는 필드 길이 초과)
+size_t ai_proto_encode_request(uint8_t* out, size_t cap, uint32_t seq,
+                               const char* host, const char* path, const char* request_id);
+
+/*
+ * 응답 frame 1개 해석
+ * - 1: 완료 (*used 바이트 소비, out에 score/label/model_version/http_status/error_code)
+ * - 0: 데이터 부족, -1: 잘못된 frame (연결을 버려야 함)
+ */
+int    ai_proto_decode_response(const uint8_t* buf, size_t len, uint32_t* seq, ai_result_t* out, size_t* used);
+
+#ifdef __cplusplus
+}
+#endif
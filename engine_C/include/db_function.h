@@ -2,37 +2,127 @@
 #define DB_FUNCTION_H
 
 #include <mysql/mysql.h>
+#include <stdint.h>
+
+#include "url_classification_client.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// AI 분석 결과 구조체 전방 선언
-typedef struct ai_result_t ai_result_t;
+/*
+ * 아래 함수들은 연결별 prepared statement 캐시 사용 (db_pool 연결)
+ * (문장별 1회 prepare, 재연결되면 자동으로 다시 prepare)
+ * - conn은 호출 스레드가 빌린 연결이어야 함 (다른 스레드와 동시에 쓰지 않음)
+ * - db_release_statements: 연결을 닫기 전(mysql_close 전)에 그 연결을 가진 스레드에서 호출
+ * - db_thread_cleanup: DB 함수를 쓴 스레드가 종료 전에 호출 (스레드별 SQL 버퍼 해제)
+ */
+void db_release_statements(MYSQL* conn);
+void db_thread_cleanup(void);
 
 /*
- * access_log 테이블에 새로운 요청 로그를 저장
- * 요청이 감지될 때 최초로 호출됨
- * 반환값: 생성된 log_id (auto increment)
+ * 이벤트 1건의 access_log 기록
+ * - 처리 중에는 메모리에서 요청/판정/AI/주입 결과를 모으고, 완료 시 INSERT 1회로 저장
+ * - request_id가 상관 키 (access_log.request_id UNIQUE)
+ * - 문자열은 포인터: insert_access_log_record 호출 때까지 유효해야 함 (HttpEvent 필드 / 문자열 상수)
+ *   log_writer_submit은 제출 시 복사(access_log_record_copy)하므로 반환 후 해제해도 됨
+ * - decision == NULL 이면 'ERROR','SYSTEM','FAIL_STAGE' (완료 전 타임아웃 flush)
+ */
+typedef struct {
+    char        request_id[37];
+    int64_t     detect_ts_ms;        // 처리 시작 시각 (epoch ms, detect_timestamp)
+
+    const char* client_ip;
+    int         client_port;
+    const char* server_ip;
+    int         server_port;
+    const char* host;
+    const char* path;
+    const char* method;
+    const char* url_norm;
+
+    const char* decision;            // "ALLOW" / "BLOCK" / "REVIEW"
+    const char* reason;              // "POLICY" / "AI" / "SYSTEM"
+    const char* decision_stage;      // "POLICY_STAGE" / "AI_STAGE" / "FAIL_STAGE"
+    long long   policy_id;           // 0이면 NULL
+    int         engine_latency_ms;   // 음수면 NULL
+
+    int         inject_attempted;    // 0이면 inject_* 는 기본값
+    int         inject_send;
+    int         inject_errno;
+    int         inject_latency_ms;
+    int         inject_status_code;
+
+    int         has_ai;              // 1이면 ai_analysis (analysis_seq 0) 함께 기록
+    int         ai_response;
+    ai_result_t ai;
+    char        ai_error_code[32];   // ai_response == 0 일 때
+
+    int         review_needed;       // BLOCK: review_event 생성
+} access_log_record_t;
+
+/*
+ * 문자열을 소유하는 레코드 복사본 (log writer 큐 / spool 재생)
+ * - rec의 문자열 포인터는 아래 버퍼를 가리킴 (크기는 HttpEvent 필드 기준)
+ */
+typedef struct {
+    access_log_record_t rec;
+    char client_ip[sizeof(((HttpEvent*)0)->meta.client_ip)];
+    char server_ip[sizeof(((HttpEvent*)0)->meta.server_ip)];
+    char host[sizeof(((HttpEvent*)0)->host)];
+    char path[sizeof(((HttpEvent*)0)->path)];
+    char method[sizeof(((HttpEvent*)0)->method)];
+    char url_norm[sizeof(((HttpEvent*)0)->url_norm)];
+    char decision[16];
+    char reason[16];
+    char decision_stage[16];
+} access_log_record_copy_t;
+
+void access_log_record_copy(access_log_record_copy_t* dst, const access_log_record_t* src);
+
+/*
+ * 완료된 이벤트 저장: access_log INSERT 1회
+ * + ai_analysis / review_event (새 log_id 기준, 필요한 경우만), 한 트랜잭션
+ * 반환값: 생성된 log_id (실패 시 -1, rollback: 한 행도 저장되지 않음)
+ */
+long long insert_access_log_record(MYSQL* conn, const access_log_record_t* rec);
+
+/*
+ * 완료된 이벤트 n건 저장 (log writer 배치)
+ * - access_log / ai_analysis / review_event 각각 multi-row INSERT 1회, 한 트랜잭션
+ * - ai_analysis / review_event의 log_id는 request_id로 조회 (같은 배치의 새 행)
+ * 반환값: 0 성공, -1 실패 (rollback: 한 행도 저장되지 않음 -> 1건씩 다시 기록 / spool)
+ */
+int insert_access_log_batch(MYSQL* conn, const access_log_record_t* const* recs, int n);
+
+/*
+ * 타임아웃 flush 이후 늦게 끝난 이벤트: request_id로 찾은 행에 판정/AI/주입 결과 추가 기록
+ * (행이 없으면 insert_access_log_record로 새로 저장), 한 트랜잭션
+ * 반환값: 0 성공, -1 실패 (첫 실패에서 rollback, db_last_errno는 그 문장의 오류)
+ */
+int update_access_log_record(MYSQL* conn, const access_log_record_t* rec);
+
+/*
+ * 이 스레드에서 위 기록 함수가 마지막으로 실패한 DB 오류 번호
+ * (필수값 없는 레코드는 ER_BAD_NULL_ERROR, 0이면 원인 모름 -> 재시도)
+ * permanent: 다시 기록해도 같은 결과인 오류 (중복 request_id / 잘못된 데이터)
+ *            그 밖(연결 끊김, lock 대기 / deadlock, 서버 일시 오류)은 재시도 대상
+ */
+unsigned int db_last_errno(void);
+int          db_error_is_permanent(unsigned int err);
+// 키 중복 (request_id UNIQUE 등): permanent의 일부
+int          db_error_is_duplicate(unsigned int err);
+
+/*
+ * 아래 update / insert 함수는 이미 저장된 log_id에 추가 기록할 때 사용
+ * (update_access_log_record 내부), update 반환값: 0 성공, -1 실패
  */
-long long insert_access_log(
-    MYSQL* conn,
-    const char* request_id,
-    const char* client_ip,
-    int client_port,
-    const char* server_ip,
-    int server_port,
-    const char* host,
-    const char* path,
-    const char* method,
-    const char* url_norm
-);
 
 /*
  * access_log 의 탐지 결과(decision) 업데이트
  * 차단 여부, 사유, 탐지 단계 및 정책 정보 기록
  */
-void update_access_log_decision(
+int update_access_log_decision(
     MYSQL* conn,
     long long log_id,
     const char* decision,
@@ -46,7 +136,7 @@ void update_access_log_decision(
  * HTTP Injection 처리 결과 업데이트
  * 차단 응답 전송 시도 여부 및 성공 여부 기록
  */
-void update_access_log_inject(
+int update_access_log_inject(
     MYSQL* conn,
     long long log_id,
     int attempted,
@@ -59,6 +149,7 @@ void update_access_log_inject(
 /*
  * AI 분석 결과를 ai_analysis 테이블에 저장
  * 동일 로그에 대해 여러 분석이 있을 경우 자동 순번 부여
+ * 같은 model_version 분석이 이미 있으면 추가하지 않고 0 (다시 적용해도 같은 결과)
  */
 int insert_ai_analysis_auto_seq(
     MYSQL* conn,
@@ -0,0 +1,50 @@
+// include/db_pool.h
+#pragma once
+
+#include <mysql/mysql.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * MySQL 연결 풀 (워커 / AI 콜백 / flush / log writer 공용)
+ * - 연결 수 상한 max_conns: 모두 사용 중이면 acquire가 timeout까지 대기 (대기 시간은 stage=db_pool_wait)
+ * - 스레드 affinity: 스레드가 마지막에 쓴 연결을 우선 반환 (연결별 prepared statement 캐시 재사용)
+ * - health check: health_idle_ms 이상 쉬었던 연결은 mysql_ping 후 반환, 끊겼으면 닫고 새로 연결
+ * - 연결 실패 시 backoff (backoff_min_ms부터 2배씩 backoff_max_ms까지): 그동안 빈 slot은 연결 시도 없이 실패
+ * - 같은 스레드의 중첩 acquire는 같은 연결 반환 (release 횟수만큼 맞춰 호출)
+ * - 연결을 쓰는 스레드는 mysql_thread_init 이후 사용 (engine_worker_init)
+ */
+typedef struct {
+    const char* host;
+    int         port;
+    const char* user;
+    const char* pass;
+    const char* name;
+
+    int max_conns;           // 연결 수 상한
+    int acquire_timeout_ms;  // acquire(-1) 대기 시간
+    int health_idle_ms;      // 이 시간 이상 쉬었던 연결은 ping 확인 (0이면 항상)
+    int backoff_min_ms;
+    int backoff_max_ms;
+
+    // 소켓 timeout (초, 0이면 라이브러리 기본값): DB가 응답 없이 멈춰도 연결을 쥔 스레드가 무한정 막히지 않도록
+    int connect_timeout_sec;
+    int read_timeout_sec;    // 클라이언트 재시도로 실제 대기는 최대 3배
+    int write_timeout_sec;   // 실제 대기는 최대 2배
+} db_pool_config_t;
+
+int  db_pool_init(const db_pool_config_t* cfg);
+void db_pool_shutdown(void);
+int  db_pool_enabled(void);
+
+// timeout_ms: -1이면 설정값, 0이면 대기 없음. 실패(DB 장애 / 대기 초과) 시 NULL
+MYSQL* db_pool_acquire(int timeout_ms);
+
+// failed: 호출자가 DB 오류를 만남 -> ping으로 확인해 끊긴 연결이면 닫음 (다음 acquire가 재연결)
+void   db_pool_release(MYSQL* conn, int failed);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+// include/decision_cache.h
+#pragma once
+
+#include <stdint.h>
+
+#include "policy.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 최종 판정 캐시 (match_policy + AI 분류 결과)
+ * - 키: url_norm(host+path) 64bit 해시, 상위 비트로 shard 선택
+ * - shard마다 고정 크기 엔트리 배열 + 해시 체인 + LRU 목록 (init 이후 메모리 할당 없음)
+ * - 정책 스냅샷 generation이 바뀌면 이전 엔트리는 조회 시 stale로 버림
+ * - TTL: positive(정책 적중 / AI 차단) / negative(AI가 차단하지 않음) 별도
+ * - AI 호출 실패 결과는 저장하지 않음 (다음 요청에서 재시도)
+ */
+typedef enum {
+    DC_STAGE_POLICY = 1,
+    DC_STAGE_AI
+} decision_stage_t;
+
+typedef struct {
+    decision_stage_t stage;
+    action_t  action;              // POLICY: policy action, AI: decision_manager 결과
+    long long policy_id;           // POLICY 전용
+    int       block_status_code;   // POLICY 전용
+    double    ai_score;            // AI 전용 (ai_analysis 기록용)
+    char      ai_label[32];
+    char      ai_model_version[64];
+} decision_cache_value_t;
+
+typedef struct {
+    int entries;          // 전체 엔트리 수 (0이면 캐시 끔)
+    int shards;           // 2의 거듭제곱으로 올림
+    int positive_ttl_ms;
+    int negative_ttl_ms;
+} decision_cache_config_t;
+
+int  decision_cache_init(const decision_cache_config_t* cfg);
+void decision_cache_shutdown(void);
+int  decision_cache_enabled(void);
+
+uint64_t decision_cache_key(const char* url_norm);
+
+// 적중 시 1 (out 채움), generation이 다르거나 만료되면 제거 후 0
+int  decision_cache_lookup(uint64_t key, uint64_t generation, decision_cache_value_t* out);
+
+// 저장 (같은 키는 갱신, shard가 가득 차면 LRU 엔트리 교체)
+void decision_cache_store(uint64_t key, uint64_t generation, const decision_cache_value_t* v);
+
+#ifdef __cplusplus
+}
+#endif
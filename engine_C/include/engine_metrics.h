@@ -0,0 +1,109 @@
+// include/engine_metrics.h
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 엔진 단계별 처리량/지연 계측
+ * - 스레드별 shard에 기록하고 리포트 시 합산 (워커 간 cache line 경합 방지)
+ * - 지연은 log2 버킷 히스토그램 (버킷당 8개 하위 구간, 상대 오차 ~12%)
+ */
+typedef enum {
+    EM_STAGE_PARSE = 0,  // 프레임 -> HttpEvent 파싱
+    EM_STAGE_LOG_INSERT, // access_log 기록 (log writer 사용 시 큐 제출)
+    EM_STAGE_POLICY,     // match_policy
+    EM_STAGE_AI,         // AI 분류 호출
+    EM_STAGE_DB_UPDATE,  // decision / ai_analysis / review_event 기록
+    EM_STAGE_INJECT,     // 차단 응답 주입
+    EM_STAGE_TOTAL,      // engine_handle_http_event 전체
+    EM_STAGE_LOG_WRITE,  // log writer 배치 1회 기록 (multi-row INSERT)
+    EM_STAGE_DB_POOL_WAIT, // DB 풀 acquire 대기 (연결을 얻거나 포기할 때까지)
+    EM_STAGE_COUNT
+} engine_stage_t;
+
+typedef enum {
+    EM_COUNT_PACKETS = 0,    // 캡처 백엔드가 넘긴 프레임
+    EM_COUNT_HTTP_EVENTS,    // HTTP 요청으로 파싱되어 엔진에 들어간 이벤트
+    EM_COUNT_DCACHE_HIT,     // 판정 캐시 적중
+    EM_COUNT_DCACHE_MISS,    // 판정 캐시 미스 (stale/expired 포함)
+    EM_COUNT_DCACHE_STALE,   // 정책 generation 변경으로 버린 엔트리
+    EM_COUNT_DCACHE_EXPIRED, // TTL 만료로 버린 엔트리
+    EM_COUNT_DCACHE_EVICT,   // 용량 초과로 교체된 LRU 엔트리
+    EM_COUNT_AI_BACKPRESSURE,// 비동기 AI in-flight 한도 초과로 호출 없이 REVIEW 처리한 이벤트
+    EM_COUNT_PRESCORE_BENIGN,    // 1차 휴리스틱에서 정상으로 판정 (AI 호출 없음)
+    EM_COUNT_PRESCORE_MALICIOUS, // 1차 휴리스틱에서 악성으로 판정 (AI 호출 없음)
+    EM_COUNT_AI_NATIVE,      // 내장 분류기로 판정한 이벤트
+    EM_COUNT_AI_NATIVE_FALLBACK, // 내장 분류기 실패로 HTTP AI로 넘긴 이벤트
+    EM_COUNT_AI_REMOTE,      // 원격 AI 요청 (비동기 제출 + 동기 호출)
+    EM_COUNT_AI_COALESCED,   // 진행 중인 같은 URL 요청에 합쳐져 요청하지 않은 건 (EM_COUNT_AI_REMOTE에 포함)
+    EM_COUNT_AI_FAST_FAIL,   // circuit breaker OPEN으로 호출 없이 실패 처리 (EM_COUNT_AI_REMOTE에 포함)
+    EM_COUNT_AI_BREAKER_OPEN,      // breaker CLOSED/HALF_OPEN -> OPEN 전환
+    EM_COUNT_AI_BREAKER_HALF_OPEN, // breaker OPEN -> HALF_OPEN 전환
+    EM_COUNT_AI_BREAKER_CLOSE,     // breaker HALF_OPEN -> CLOSED 전환 (회복)
+    EM_COUNT_DB_PREPARE,     // mysql_stmt_prepare 호출 (DB 왕복 1회)
+    EM_COUNT_DB_EXECUTE,     // mysql_stmt_execute / mysql_real_query 호출 (DB 왕복 1회)
+    EM_COUNT_EVENT_TIMEOUT_FLUSH,  // 완료 전에 타임아웃으로 먼저 저장한 이벤트
+    EM_COUNT_AI_FAIL,        // AI 판정 실패로 FAIL_STAGE 처리한 이벤트 (timeout/에러/BUSY/breaker)
+    EM_COUNT_LOG_QUEUED,     // log writer 큐에 넣은 레코드
+    EM_COUNT_LOG_WRITTEN,    // log writer가 기록한 레코드
+    EM_COUNT_LOG_BATCHES,    // log writer 배치 수
+    EM_COUNT_LOG_DROPPED,    // 기록하지 못하고 버린 레코드 (overflow=drop, DB 장애 + spool 없음 / 가득 참)
+    EM_COUNT_LOG_SYNC,       // 큐가 가득 차 호출 스레드에서 직접 기록한 레코드 (LOG_WRITER_OVERFLOW=sync)
+    EM_COUNT_LOG_FALLBACK,   // multi-row INSERT 실패로 1건씩 다시 기록한 배치
+    EM_COUNT_LOG_REJECTED,   // 다시 기록해도 같은 결과라 버린 레코드 (중복 request_id / 잘못된 데이터)
+    EM_COUNT_LOG_SPOOLED,    // 디스크 spool에 넣은 레코드 (DB 장애 / overflow=spool)
+    EM_COUNT_LOG_REPLAYED,   // spool에서 DB로 다시 기록한 레코드
+    EM_COUNT_SPOOL_CORRUPT,  // spool 재생 중 건너뛴 손상 레코드 / segment 끝
+    EM_COUNT_DB_POOL_CONNECT,      // DB 풀이 새로 연 연결 (시작 + 재연결)
+    EM_COUNT_DB_POOL_CLOSE,        // 끊겨서(health check / 오류 후 ping 실패) 닫은 연결
+    EM_COUNT_DB_POOL_CONNECT_FAIL, // 연결 실패 (이후 backoff)
+    EM_COUNT_DB_POOL_TIMEOUT,      // 연결을 얻지 못한 acquire (대기 초과 / backoff 중)
+    EM_COUNT_DB_POOL_SWITCH,       // 자기 연결이 사용 중이라 다른 연결을 받은 acquire (affinity miss)
+    EM_COUNT_COUNT
+} engine_counter_t;
+
+// 최댓값 gauge (shard 없이 전역, 리포트에 최대치만 출력)
+typedef enum {
+    EM_GAUGE_LOG_QUEUE_MAX = 0,  // log writer 큐 최대 깊이
+    EM_GAUGE_LOG_BATCH_MAX,      // log writer 최대 배치 크기
+    EM_GAUGE_SPOOL_BYTES_MAX,    // 재생 대기 spool 최대 바이트
+    EM_GAUGE_DB_POOL_OPEN_MAX,   // DB 풀 최대 동시 연결 수
+    EM_GAUGE_COUNT
+} engine_gauge_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} engine_stage_summary_t;
+
+uint64_t engine_metrics_now_ns(void);
+
+void engine_metrics_reset(void);
+void engine_metrics_record(engine_stage_t stage, uint64_t elapsed_ns);
+void engine_metrics_count(engine_counter_t counter, uint64_t n);
+void engine_metrics_gauge_max(engine_gauge_t gauge, uint64_t v);
+
+uint64_t engine_metrics_counter(engine_counter_t counter);
+uint64_t engine_metrics_gauge(engine_gauge_t gauge);
+void     engine_metrics_stage_summary(engine_stage_t stage, engine_stage_summary_t* out);
+
+const char* engine_stage_name(engine_stage_t stage);
+
+// packets/s, events/s, 판정 캐시 적중률, 단계별 p50/p90/p99/max 출력
+void engine_metrics_report(FILE* fp, double elapsed_sec);
+
+// 1이면 report에 단계별 히스토그램 (2배 간격 구간별 건수)도 출력
+void engine_metrics_set_histogram(int on);
+void engine_metrics_histogram(FILE* fp, engine_stage_t stage);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,6 +10,17 @@ extern "C" {
 // packet_extractor -> engine pipeline entry
 void process_http_event(const HttpEvent* ev);
 
+/*
+ * 캡처 워커 스레드 시작/종료 시 호출
+ * - 워커별 DB 연결 등 엔진의 스레드 로컬 상태를 준비/정리
+ * - 반환값: 0 성공, -1 실패
+ */
+int  process_worker_begin(int worker_id);
+void process_worker_end(void);
+
+// 비동기로 진행 중인 이벤트가 모두 끝날 때까지 대기 (replay 리포트 전)
+void process_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
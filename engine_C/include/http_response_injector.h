@@ -2,14 +2,23 @@
 #pragma once
 
 #include "engine_struct.h"
-#include <mysql/mysql.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// BLOCK 시 1회 주입 시도 + DB inject_* 업데이트
-void http_response_inject(const HttpEvent* ev, MYSQL* conn, long long log_id, int status_code);
+// 주입 결과 (access_log inject_* 컬럼)
+typedef struct {
+    int attempted;
+    int send_ok;
+    int inject_errno;
+    int latency_ms;
+    int status_code;
+} http_inject_result_t;
+
+// BLOCK 시 1회 주입 시도, 결과는 out (DB 기록은 호출자가 이벤트 완료 시)
+void http_response_inject(const HttpEvent* ev, const char* request_id, int status_code,
+                          http_inject_result_t* out);
 
 #ifdef __cplusplus
 }
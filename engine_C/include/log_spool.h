@@ -0,0 +1,62 @@
+// include/log_spool.h
+#pragma once
+
+#include <stdint.h>
+
+#include "db_function.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * access_log 레코드 디스크 spool (DB가 느리거나 내려갔을 때)
+ * - 디렉터리 안 append-only segment 파일 (<seq>.seg), segment_bytes를 넘으면 다음 segment로 교체
+ * - 레코드: [magic][payload 길이][CRC32] + payload (필드별 직렬화, 문자열은 길이 + 바이트)
+ * - 재생은 단일 스레드: read -> DB 기록 -> commit (cursor 파일 갱신, 다 읽은 segment 삭제)
+ *   DB 기록이 중간에 실패하면 기록된 앞부분까지만 commit_to, rewind로 그 위치부터 다시 읽음
+ * - commit 전에 종료되면 재시작 후 같은 레코드를 다시 기록
+ *   (저장된 INSERT는 request_id 중복 = 이미 기록됨, 늦은 완료 기록은 다시 적용해도 같은 결과)
+ * - CRC 불일치 / 잘린 레코드(기록 중 종료)는 해당 segment 나머지를 건너뛰고 카운트
+ * - 시작할 때는 항상 새 segment에 append (이전 segment 끝이 잘려 있어도 영향 없음)
+ * - 디렉터리는 이 사용자 소유 + group/other 쓰기 없음이어야 열림 (symlink 불가),
+ *   segment / cursor는 O_NOFOLLOW로 열고 새 파일은 O_EXCL로 만듦 (남이 만든 파일은 건너뜀)
+ */
+typedef struct {
+    const char* dir;            // 빈 값이면 사용 안 함 (이 사용자 소유, group/other 쓰기 없음)
+    uint64_t    segment_bytes;  // segment 교체 크기
+    uint64_t    max_bytes;      // 재생 대기 전체 상한 (넘으면 append 실패)
+    int         fsync;          // 1이면 fdatasync (segment / cursor)
+    int         fsync_ms;       // fsync 주기: sync 스레드가 모아서 flush (0이면 append마다, append가 flush를 기다림)
+} log_spool_config_t;
+
+int  log_spool_open(const log_spool_config_t* cfg);
+void log_spool_close(void);
+int  log_spool_enabled(void);
+
+// append한 스레드가 종료 전에 호출 (스레드별 직렬화 버퍼 해제)
+void log_spool_thread_cleanup(void);
+
+// n건 append (kinds: log_write_kind_t), 성공 시 0 (전부 기록되거나 하나도 기록되지 않음)
+int  log_spool_append(const access_log_record_t* const* recs, const int* kinds, int n);
+
+// 재생 위치 (레코드 끝)
+typedef struct {
+    uint64_t seq;
+    uint64_t off;
+} log_spool_pos_t;
+
+// 재생 (한 스레드에서만 호출): 다음 레코드 최대 max건, 반환값은 읽은 건수 (0이면 없음)
+// ends[i]: i번째 레코드 끝 위치 (NULL이면 생략)
+int  log_spool_read(access_log_record_copy_t* out, int* kinds, log_spool_pos_t* ends, int max);
+void log_spool_commit(void);
+// 마지막 read 중 pos(= ends[i])까지만 commit (이후 rewind하면 그 다음 레코드부터)
+void log_spool_commit_to(const log_spool_pos_t* pos);
+void log_spool_rewind(void);
+
+// 아직 재생하지 않은 바이트 (대략값)
+uint64_t log_spool_pending_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,67 @@
+// include/log_writer.h
+#pragma once
+
+#include "db_function.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * access_log 비동기 배치 기록
+ * - 패킷/AI 스레드는 완료된 레코드를 복사해 큐에 넣기만 함 (DB 왕복 없음)
+ * - writer 스레드가 모아서 access_log / ai_analysis / review_event multi-row INSERT
+ *   (batch_max건이 모이거나 첫 레코드 후 flush_ms가 지나면 기록)
+ * - 큐: writer 스레드별 bounded lock-free 큐, request_id 해시로 선택
+ *   -> 타임아웃 flush 레코드와 늦은 완료 레코드는 같은 writer에서 순서대로 처리
+ * - 큐가 가득 차면 overflow 정책
+ *   DROP: 버리고 EM_COUNT_LOG_DROPPED 카운트 (패킷 경로 지연 없음, 기록 유실)
+ *   SYNC: LOG_WRITER_DIRECT 반환 -> 호출 스레드가 직접 기록 (유실 없음, DB 지연이 패킷 경로로 전파)
+ *   SPOOL: 호출 스레드가 디스크 spool에 append (log_spool.h, DB 왕복 없음)
+ * - writer는 배치마다 DB 풀(db_pool.h)에서 연결을 빌림: 연결을 얻지 못하거나 끊기면 배치를 spool로
+ * - spool이 열려 있으면 재생 스레드(index = threads)가 spool 레코드를 같은 방식으로 DB에 기록
+ * - log_writer_stop은 남은 레코드를 모두 기록(또는 spool)한 뒤 반환
+ */
+typedef enum {
+    LOG_WRITER_OVERFLOW_DROP = 0,
+    LOG_WRITER_OVERFLOW_SYNC,
+    LOG_WRITER_OVERFLOW_SPOOL
+} log_writer_overflow_t;
+
+typedef enum {
+    LOG_WRITE_INSERT = 0,  // 완료 (또는 타임아웃 flush) 이벤트: 새 행
+    LOG_WRITE_LATE         // flush 이후 완료: 같은 request_id 행에 추가 기록
+} log_write_kind_t;
+
+typedef struct {
+    int threads;           // writer 스레드 수 (0이면 사용 안 함)
+    int queue_size;        // 스레드별 큐 크기 (2의 거듭제곱으로 올림, 레코드 칸을 시작 시 미리 할당)
+    int batch_max;         // 배치 최대 레코드 수
+    int flush_ms;          // 첫 레코드 이후 배치를 모으는 최대 시간
+    log_writer_overflow_t overflow;
+    int  (*thread_begin)(int index);  // writer / 재생 스레드 시작 (mysql_thread_init)
+    void (*thread_end)(void);
+} log_writer_config_t;
+
+#define LOG_WRITER_QUEUED   0   // writer가 기록
+#define LOG_WRITER_DROPPED  1   // 큐가 가득 차 버림 (DROP)
+#define LOG_WRITER_DIRECT   2   // writer 미사용 또는 큐가 가득 참 (SYNC): 호출자가 직접 기록
+#define LOG_WRITER_SPOOLED  3   // 큐가 가득 차 spool에 기록 (SPOOL)
+
+int  log_writer_start(const log_writer_config_t* cfg);
+void log_writer_stop(void);
+int  log_writer_enabled(void);
+
+// 제출된 레코드가 모두 기록될 때까지 대기 (replay 종료 시 리포트 전)
+void log_writer_drain(void);
+
+int  log_writer_submit(const access_log_record_t* rec, log_write_kind_t kind);
+
+// 직접 기록(LOG_WRITER_DIRECT)이 실패한 레코드를 spool에 넣음 (0: 성공, -1: spool 없음 / 가득 참 -> 버림)
+int  log_writer_spill(const access_log_record_t* rec, log_write_kind_t kind);
+
+int  log_writer_overflow_from_str(const char* s, log_writer_overflow_t* out);
+
+#ifdef __cplusplus
+}
+#endif
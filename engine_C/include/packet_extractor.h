@@ -1,12 +1,53 @@
 #ifndef PACKET_EXTRACTOR_H
 #define PACKET_EXTRACTOR_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* pcap 루프 시작 (HTTP 후보를 추출해 process_http_request() 호출) */
-int packet_extractor_run_pcap_loop(const char* ifname);
+/* 모든 캡처 백엔드가 공유하는 BPF 필터 */
+#define PACKET_EXTRACTOR_BPF "tcp and (port 80 or port 8080 or port 18080)"
+
+/*
+ * pcap 루프 시작 (HTTP 후보를 추출해 process_http_request() 호출)
+ * - stats_interval_sec > 0 이면 주기적으로 recv/drop 카운터 출력
+ */
+int packet_extractor_run_pcap_loop(const char* ifname, int stats_interval_sec);
+
+/*
+ * Ethernet 프레임 1개를 HTTP 탐지 경로로 전달
+ * - pcap / TPACKET_V3 등 캡처 백엔드 공통 진입점
+ * - ts_ms: 캡처 시각 (engine latency 기준)
+ */
+void packet_extractor_handle_frame(const unsigned char* pkt, size_t caplen, int64_t ts_ms);
+
+/*
+ * 오프라인 pcap/pcapng 재생 (부하 측정용)
+ * - 라이브 캡처와 동일한 on_packet -> process_http_event 경로 사용
+ * - 종료 시 packets/s, events/s, 단계별 지연 분위수 출력
+ */
+typedef enum {
+    REPLAY_PACE_FAST = 0, // 최대 속도
+    REPLAY_PACE_ORIGINAL, // 파일의 패킷 간격 그대로
+    REPLAY_PACE_PPS       // 고정 packets/s
+} replay_pace_t;
+
+typedef struct {
+    const char*   path;
+    replay_pace_t pace;
+    double        pps;   // REPLAY_PACE_PPS 전용
+    int           loops; // 파일 반복 횟수 (<=0 이면 1)
+} packet_replay_config_t;
+
+int replay_pace_from_str(const char* s, replay_pace_t* out);
+int packet_extractor_run_replay(const packet_replay_config_t* cfg);
+
+/* 캡처 루프 종료 요청 (signal handler에서 호출 가능) */
+void packet_extractor_request_stop(void);
+int  packet_extractor_stop_requested(void);
 
 #ifdef __cplusplus
 }
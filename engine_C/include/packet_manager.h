@@ -1,12 +1,49 @@
 #ifndef PACKET_MANAGER_H
 #define PACKET_MANAGER_H
 
+#include "packet_extractor.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef enum {
+    CAP_BACKEND_PCAP = 0,   // libpcap pcap_open_live (기본값)
+    CAP_BACKEND_TPACKET_V3, // AF_PACKET TPACKET_V3 mmap 링
+    CAP_BACKEND_REPLAY      // 오프라인 pcap 재생 (벤치마크)
+} capture_backend_t;
+
+typedef struct {
+    const char*       ifname;
+    capture_backend_t backend;
+
+    // TPACKET_V3 링 설정
+    unsigned int ring_block_size;
+    unsigned int ring_block_count;
+    unsigned int ring_frame_size;
+    unsigned int ring_block_timeout_ms;
+
+    int stats_interval_sec; // drop/freeze 카운터 출력 주기 (0이면 종료 시에만)
+
+    /*
+     * 멀티 워커 캡처 (tpacket_v3 전용)
+     * - workers > 1 이면 워커마다 링을 만들고 같은 PACKET_FANOUT 그룹에 조인
+     * - cpu_list: "0,2,4-7" 형식, 워커 i는 목록의 i번째 CPU에 고정 (빈 문자열이면 고정 안 함)
+     */
+    int         workers;
+    int         fanout_id;
+    const char* cpu_list;
+
+    // CAP_BACKEND_REPLAY 설정
+    packet_replay_config_t replay;
+} packet_manager_config_t;
+
+// "pcap" / "tpacket_v3" / "replay" 문자열 -> backend (알 수 없으면 -1)
+int capture_backend_from_str(const char* s, capture_backend_t* out);
+const char* capture_backend_to_str(capture_backend_t b);
+
 /*  캡처 파이프라인 관리 (내부에서 packet_extractor 사용) */
-int packet_manager_run(const char* ifname);
+int packet_manager_run(const packet_manager_config_t* cfg);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,40 @@
+// include/packet_ring_capture.h
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * AF_PACKET TPACKET_V3 mmap 링 캡처 백엔드
+ * - 커널이 채운 block 단위로 프레임을 순회 (패킷당 syscall 없음)
+ * - 각 프레임은 packet_extractor_handle_frame()으로 전달
+ */
+typedef struct {
+    const char* ifname;
+    unsigned int block_size;       // bytes, page size 배수
+    unsigned int block_count;
+    unsigned int frame_size;       // tp_frame_size (V3에서는 힌트)
+    unsigned int block_timeout_ms; // tp_retire_blk_tov
+    int stats_interval_sec;        // 0이면 종료 시에만 출력
+
+    int fanout_id;                 // PACKET_FANOUT 그룹 id (<0 이면 fanout 미사용)
+    int worker_id;                 // 로그 구분용
+} packet_ring_config_t;
+
+typedef struct {
+    uint64_t packets;      // 커널이 링에 넣은 패킷 (tp_packets 누적)
+    uint64_t drops;        // 링이 가득 차서 버려진 패킷 (tp_drops 누적)
+    uint64_t freeze_q_cnt; // 링 freeze 횟수 (tp_freeze_q_cnt 누적)
+    uint64_t blocks;       // 유저 공간에서 처리한 block 수
+    uint64_t frames;       // 유저 공간에서 순회한 프레임 수
+} packet_ring_stats_t;
+
+// 링 생성 + 캡처 루프 (packet_extractor_request_stop() 시 반환)
+int packet_ring_run_loop(const packet_ring_config_t* cfg, packet_ring_stats_t* out_stats);
+
+#ifdef __cplusplus
+}
+#endif
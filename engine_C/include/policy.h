@@ -2,6 +2,7 @@
 #define POLICY_H
 
 #include <stddef.h>
+#include <regex.h>
 #include <mysql/mysql.h>
 
 #ifdef __cplusplus
@@ -26,7 +27,8 @@ typedef enum {
     MT_EXACT = 0,
     MT_PREFIX,
     MT_CONTAINS,
-    MT_REGEX
+    MT_REGEX,
+    MT_DOMAIN       // 도메인 + 모든 하위 도메인 (RT_HOST)
 } match_type_t;
 
 typedef struct {
@@ -40,6 +42,12 @@ typedef struct {
     int          is_negated;
     int          rule_order;
     int          is_enabled;
+
+    /* load_policy_cache에서 1회 컴파일 (match_policy는 실행만) */
+    size_t       pattern_len;
+    char         pattern_lc[512];   // case-insensitive 룰용 소문자 패턴 (MT_DOMAIN은 정규화된 도메인)
+    regex_t*     re;                // MT_REGEX 전용 컴파일 결과
+    int          is_indexed;        // 1이면 policy_index가 처리 (선형 평가 제외)
 } policy_rule_t;
 
 typedef struct {
@@ -59,11 +67,23 @@ typedef struct {
 
     policy_rule_t* rules;
     size_t         rule_count;
+    int*           rules_refcnt;   // rules 배열을 공유하는 캐시 수 (델타 동기화 스냅샷 간)
+    size_t         rejected_rule_count;  // 이 policy에서 로드 시 제외된 룰 수 (병합 시 캐시 합계 재계산)
 } policy_t;
 
+struct policy_index;
+
 typedef struct {
     policy_t* policies;
     size_t    policy_count;
+
+    size_t    rejected_rule_count;  // 로드 시 컴파일 실패로 제외된 룰 수
+
+    struct policy_index* index;     // 룰 매칭 인덱스 (NULL이면 전체 선형 평가)
+
+    /* 바이너리 스냅샷 파일에서 읽은 캐시: 룰/인덱스 배열이 가리키는 읽기 전용 매핑 */
+    void*     map_base;
+    size_t    map_len;
 } policy_cache_t;
 
 typedef struct {
@@ -74,6 +94,13 @@ typedef struct {
     char      redirect_url[512];
 } policy_decision_t;
 
+/* 룰 1개 컴파일 (패턴 길이/소문자 패턴/정규식) 및 해제 - 로드/스냅샷 파일 공용 */
+int  policy_rule_compile(policy_rule_t* r, char* err, size_t errsz);
+void policy_rule_release(policy_rule_t* r);
+
+/* 정책 DB 연결 (policy 로드 / 버전 확인 공용) */
+MYSQL* policy_db_connect(const char* host, int port, const char* user, const char* pass, const char* db);
+
 /* 정책 캐시 로드/해제/매칭 */
 int  load_policy_cache(policy_cache_t* cache,
                        const char* host,
@@ -82,8 +109,38 @@ int  load_policy_cache(policy_cache_t* cache,
                        const char* pass,
                        const char* db);
 
+/* 이미 열린 연결로 로드 (엔진: DB 풀 연결) */
+int  load_policy_cache_conn(policy_cache_t* cache, MYSQL* conn);
+
 void free_policy_cache(policy_cache_t* cache);
 
+/*
+ * 델타 동기화
+ * - load_subset: 지정 policy_id들만 조회 (비활성/삭제된 id는 결과에 없음, 인덱스 미생성)
+ * - merge: base에서 changed_ids를 뺀 policy(룰 배열 공유) + delta를 우선순위 순으로 합침
+ *          delta는 소유권이 out으로 넘어가고 비워짐, 인덱스는 호출자가 생성
+ *          룰 재컴파일 없음, 인덱스는 policy_cache_build_index_delta로 바뀐 구획만 재생성
+ */
+int  policy_cache_load_subset(MYSQL* conn, policy_cache_t* out, const long long* policy_ids, size_t n);
+int  policy_cache_merge(policy_cache_t* out,
+                        const policy_cache_t* base,
+                        policy_cache_t* delta,
+                        const long long* changed_ids,
+                        size_t changed_count);
+
+/* 로드된 룰로 매칭 인덱스 (재)생성 - load_policy_cache 내부에서 호출됨 */
+int  policy_cache_build_index(policy_cache_t* cache);
+
+/*
+ * merge 결과의 인덱스를 base 인덱스에서 바뀐 구획만 다시 만들어 생성
+ * (changed_ids는 merge에 넘긴 것과 같은 오름차순 목록, base 인덱스가 없으면 전체 생성)
+ * 실패 시 -1, cache->index는 NULL (호출자는 게시하지 않음)
+ */
+int  policy_cache_build_index_delta(policy_cache_t* cache,
+                                    const policy_cache_t* base,
+                                    const long long* changed_ids,
+                                    size_t changed_count);
+
 policy_decision_t match_policy(const policy_cache_t* cache,
                                const char* host,
                                const char* path,
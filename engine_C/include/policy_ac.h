@@ -0,0 +1,74 @@
+// include/policy_ac.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POLICY_AC_NONE 0xFFFFFFFFu
+
+/*
+ * 룰 참조: 인덱스가 돌려주는 매칭 결과 단위
+ * - policy_idx: policy_cache_t.policies 내 위치 (priority 정렬 순서와 동일)
+ * - rule_idx:   해당 policy의 rules 내 위치
+ */
+typedef struct {
+    uint32_t policy_idx;
+    uint32_t rule_idx;
+} policy_rule_ref_t;
+
+typedef void (*policy_ref_hit_fn)(const policy_rule_ref_t* ref, void* ctx);
+
+/*
+ * Aho-Corasick 자동자 (MT_CONTAINS 룰 일괄 매칭)
+ * - 포인터 없는 평면 배열 구성 (스냅샷 파일로 그대로 저장/매핑 가능)
+ * - edges는 노드별로 byte 오름차순 연속 배치, 루트 전이는 256 테이블
+ */
+typedef struct {
+    uint32_t fail;       // 실패 링크
+    uint32_t dict;       // 실패 체인상 출력이 있는 가장 가까운 노드 (없으면 NONE)
+    uint32_t edge_start;
+    uint32_t edge_count;
+    uint32_t out_start;  // refs[] 시작
+    uint32_t out_count;
+} policy_ac_node_t;
+
+typedef struct {
+    uint32_t target;
+    uint8_t  byte;
+    uint8_t  pad[3];
+} policy_ac_edge_t;
+
+typedef struct {
+    policy_ac_node_t*  nodes;
+    uint32_t           node_count;
+    policy_ac_edge_t*  edges;
+    uint32_t           edge_count;
+    policy_rule_ref_t* refs;
+    uint32_t           ref_count;
+    uint32_t           root_next[256];
+    int                owns_memory;  // 0이면 외부(매핑된 스냅샷) 메모리
+} policy_ac_t;
+
+typedef struct policy_ac_builder policy_ac_builder_t;
+
+policy_ac_builder_t* policy_ac_builder_new(void);
+void policy_ac_builder_free(policy_ac_builder_t* b);
+
+// 패턴 추가 (len == 0 인 패턴은 추가하지 않음)
+int policy_ac_builder_add(policy_ac_builder_t* b, const char* pattern, size_t len, policy_rule_ref_t ref);
+
+// 실패 링크 계산 + 평면화 (out은 policy_ac_free로 해제, b는 성공/실패 모두 해제됨)
+int policy_ac_builder_finish(policy_ac_builder_t* b, policy_ac_t* out);
+
+void policy_ac_free(policy_ac_t* ac);
+
+// text 1회 순회로 포함된 모든 패턴의 룰 참조를 fn으로 전달
+void policy_ac_scan(const policy_ac_t* ac, const char* text, policy_ref_hit_fn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
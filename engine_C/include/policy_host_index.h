@@ -0,0 +1,79 @@
+// include/policy_host_index.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "policy_ac.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 문자열 해시 맵 / 역순 라벨 트라이 (MT_EXACT, MT_DOMAIN 룰 인덱스)
+ * - 키 = (parent 노드, 문자열). parent=0 단일 단계로 쓰면 exact 해시 테이블,
+ *   라벨 단위로 부모를 이어가면 "com" -> "example" -> "www" 역순 도메인 트라이
+ * - 노드 id = entry 위치 + 1 (0은 루트), 노드별 룰 참조는 refs[] 연속 구간
+ * - 포인터 없는 평면 배열 구성 (스냅샷 파일로 그대로 저장/매핑 가능)
+ */
+typedef struct {
+    uint64_t hash;
+    uint32_t parent;
+    uint32_t key_off;    // keys[] 내 위치
+    uint32_t key_len;
+    uint32_t next;       // 같은 버킷 체인 (없으면 NONE)
+} policy_host_entry_t;
+
+typedef struct {
+    uint32_t start;
+    uint32_t count;
+} policy_ref_range_t;
+
+typedef struct {
+    uint32_t*            buckets;      // bucket_count(2의 거듭제곱)개, entry 위치 또는 NONE
+    uint32_t             bucket_count;
+    policy_host_entry_t* entries;
+    uint32_t             entry_count;
+    char*                keys;
+    uint32_t             keys_len;
+    policy_ref_range_t*  nodes;        // entry_count + 1 개 (노드 id로 접근)
+    policy_rule_ref_t*   refs;
+    uint32_t             ref_count;
+    int                  owns_memory;  // 0이면 외부(매핑된 스냅샷) 메모리
+} policy_host_map_t;
+
+typedef struct policy_host_builder policy_host_builder_t;
+
+policy_host_builder_t* policy_host_builder_new(void);
+void policy_host_builder_free(policy_host_builder_t* b);
+
+// 문자열 전체를 키 1개로 추가 (exact)
+int policy_host_builder_add_exact(policy_host_builder_t* b, const char* key, size_t len, policy_rule_ref_t ref);
+
+// '.' 기준 라벨을 뒤에서부터 트라이 경로로 추가 (domain)
+int policy_host_builder_add_domain(policy_host_builder_t* b, const char* domain, size_t len, policy_rule_ref_t ref);
+
+// 평면화 (out은 policy_host_map_free로 해제, 성공/실패 모두 builder 해제)
+int policy_host_builder_finish(policy_host_builder_t* b, policy_host_map_t* out);
+
+void policy_host_map_free(policy_host_map_t* m);
+
+// key와 정확히 같은 exact 키의 룰 참조를 fn으로 전달
+void policy_host_lookup_exact(const policy_host_map_t* m, const char* key, size_t len,
+                              policy_ref_hit_fn fn, void* ctx);
+
+// host의 상위 도메인(자기 자신 포함)으로 등록된 모든 domain 룰 참조를 fn으로 전달
+void policy_host_lookup_domain(const policy_host_map_t* m, const char* host, size_t len,
+                               policy_ref_hit_fn fn, void* ctx);
+
+/*
+ * Host 헤더 정규화 길이
+ * - "example.com:8080" -> "example.com", "[::1]:443" -> "[::1]", 끝의 '.' 제거
+ * - 결과는 항상 원문의 앞부분이므로 길이만 돌려줌 (복사 없음)
+ */
+size_t policy_host_norm_len(const char* host, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,70 @@
+// include/policy_index.h
+#pragma once
+
+#include "policy.h"
+#include "policy_ac.h"
+#include "policy_host_index.h"
+#include "policy_radix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POLICY_INDEX_TARGETS 3   // RT_HOST, RT_PATH, RT_URL
+
+/*
+ * policy_cache 전체 룰에 대한 매칭 인덱스
+ * - 인덱스로 처리 가능한 룰은 is_indexed=1 로 표시되고 선형 평가에서 제외
+ * - 나머지(부정 룰, REGEX 등)는 residual 목록의 policy만 선형 평가
+ */
+typedef struct policy_index {
+    // MT_CONTAINS: [target][case_sensitive]
+    policy_ac_t contains[POLICY_INDEX_TARGETS][2];
+
+    // MT_PREFIX: [target][case_sensitive] 압축 radix tree
+    policy_radix_t prefix[POLICY_INDEX_TARGETS][2];
+
+    // MT_EXACT: [target][case_sensitive] 해시 테이블
+    policy_host_map_t exact[POLICY_INDEX_TARGETS][2];
+
+    // MT_DOMAIN (RT_HOST 전용, 항상 소문자): 역순 라벨 트라이
+    policy_host_map_t domain;
+
+    // 인덱스로 처리되지 않는 룰을 가진 policy 위치 (오름차순 = priority 순)
+    uint32_t*   residual_policies;
+    size_t      residual_count;
+
+    size_t      indexed_rule_count;
+} policy_index_t;
+
+// cache의 룰로 인덱스 생성 (성공 시 각 룰의 is_indexed 설정)
+int  policy_index_build(policy_index_t* idx, policy_cache_t* cache);
+
+/*
+ * 델타 동기화용 생성: base(이전 cache의 인덱스)에서 바뀐 구획만 다시 생성
+ * - remap[i]: 이전 cache의 i번째 policy의 새 위치 (빠졌거나 바뀐 policy는 UINT32_MAX)
+ * - fresh[i]: 새 cache의 i번째 policy가 델타로 들어온 policy면 1
+ * - 새 policy의 룰이 속한 구획과 빠진 policy를 참조하던 구획만 재생성,
+ *   나머지 구획(AC / radix / 해시)은 배열 복사 후 policy 위치만 remap
+ * - rebuilt_parts: 재생성한 구획 수 (NULL 가능)
+ */
+int  policy_index_build_delta(policy_index_t* idx, policy_cache_t* cache,
+                              const policy_index_t* base, size_t base_count,
+                              const uint32_t* remap, const unsigned char* fresh,
+                              size_t* rebuilt_parts);
+void policy_index_free(policy_index_t* idx);
+
+/*
+ * 인덱스 룰 중 매칭되는 가장 높은 우선순위 policy 위치
+ * - raw/lc: [target] 원문 / 소문자화 문자열
+ * - host_len: 포트/끝 점을 제외한 host 길이 (policy_host_norm_len)
+ * - 매칭 없으면 UINT32_MAX
+ */
+uint32_t policy_index_best(const policy_index_t* idx,
+                           const char* const raw[POLICY_INDEX_TARGETS],
+                           const char* const lc[POLICY_INDEX_TARGETS],
+                           size_t host_len);
+
+#ifdef __cplusplus
+}
+#endif
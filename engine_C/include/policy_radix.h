@@ -0,0 +1,57 @@
+// include/policy_radix.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "policy_ac.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 압축 radix tree (MT_PREFIX 룰 일괄 매칭)
+ * - 단일 분기 경로는 label 하나로 압축, 노드 수 <= 2 * 패턴 수
+ * - 한 노드의 자식은 nodes[]에 연속 배치, label 첫 byte 오름차순 (이진 탐색)
+ * - refs[]는 패턴 사전순으로 정렬되어 노드별 출력이 연속 구간
+ * - 포인터 없는 평면 배열 구성 (스냅샷 파일로 그대로 저장/매핑 가능)
+ */
+typedef struct {
+    uint32_t label_off;    // labels[] 내 위치
+    uint32_t label_len;    // 루트만 0
+    uint32_t child_start;
+    uint32_t child_count;
+    uint32_t out_start;    // refs[] 시작
+    uint32_t out_count;
+} policy_radix_node_t;
+
+typedef struct {
+    policy_radix_node_t* nodes;
+    uint32_t             node_count;
+    char*                labels;
+    uint32_t             labels_len;
+    policy_rule_ref_t*   refs;
+    uint32_t             ref_count;
+    int                  owns_memory;  // 0이면 외부(매핑된 스냅샷) 메모리
+} policy_radix_t;
+
+typedef struct policy_radix_builder policy_radix_builder_t;
+
+policy_radix_builder_t* policy_radix_builder_new(void);
+void policy_radix_builder_free(policy_radix_builder_t* b);
+
+// 패턴 추가 (빈 패턴은 모든 입력과 매칭되는 루트 출력)
+int policy_radix_builder_add(policy_radix_builder_t* b, const char* pattern, size_t len, policy_rule_ref_t ref);
+
+// 정렬 + 트리 구성 (out은 policy_radix_free로 해제, 성공/실패 모두 builder 해제)
+int policy_radix_builder_finish(policy_radix_builder_t* b, policy_radix_t* out);
+
+void policy_radix_free(policy_radix_t* rt);
+
+// text의 prefix인 모든 패턴의 룰 참조를 한 번의 하강으로 fn에 전달
+void policy_radix_scan(const policy_radix_t* rt, const char* text, policy_ref_hit_fn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+// include/policy_snapshot.h
+#pragma once
+
+#include <stdint.h>
+
+#include "policy.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 정책 스냅샷 + 무중단 재로드
+ * - 재로드 스레드가 새 policy_cache_t를 만들어 포인터 1개를 atomic 교체로 게시
+ * - 버전 변화 시 policy_audit의 새 기록에 나온 policy만 다시 읽어 병합 (델타 동기화)
+ * - 이전 스냅샷은 epoch 기반으로 진행 중인 reader가 모두 빠져나간 뒤 해제
+ * - 패킷 경로는 acquire/release (atomic load/store 몇 개)만 수행, 재로드를 기다리지 않음
+ */
+typedef struct {
+    policy_cache_t cache;
+    uint64_t       generation;   // 게시 순번 (1부터)
+    char           version[128]; // 로드 시점 DB 정책 버전 (policy_snapshot_db_version)
+    int64_t        loaded_at_ms;
+} policy_snapshot_t;
+
+typedef struct {
+    const char* db_host;
+    int         db_port;
+    const char* db_user;
+    const char* db_pass;
+    const char* db_name;
+
+    int interval_sec;      // 주기적 전체 재로드 = 정합성 점검 (0이면 끔)
+    int version_poll_sec;  // DB 정책 버전 확인 주기, 바뀌면 델타 동기화 (0이면 끔)
+    int delta_max_policies;// 델타 1회에 반영할 최대 policy 수, 넘으면 전체 재로드 (0이면 항상 전체)
+
+    const char* snapshot_path;     // 바이너리 스냅샷 파일 (NULL/빈 문자열이면 끔)
+    int         snapshot_write_sec;// 파일 재기록 최소 간격 (연속 델타 시 과도한 쓰기 방지)
+} policy_reload_config_t;
+
+/*
+ * 설정 저장 + 최초 게시
+ * - 스냅샷 파일이 유효하면 매핑해 즉시 게시하고 DB 대조는 재로드 스레드가 수행 (DB 장애 중에도 차단 가능)
+ * - 파일이 없거나 거부되면 DB에서 동기 로드 (실패 시 -1, 재로드 스레드가 이후 재시도)
+ * - DB 풀 초기화 전에 호출 가능 (풀이 없으면 직접 연결), 재로드 스레드는 이후 풀을 사용
+ */
+int  policy_snapshot_init(const policy_reload_config_t* cfg);
+
+// 재로드 스레드 시작 / 종료 + 현재 스냅샷 해제
+int  policy_snapshot_start_reloader(void);
+void policy_snapshot_shutdown(void);
+
+// 재로드 요청 (signal handler에서 호출 가능, 실제 로드는 재로드 스레드)
+void policy_snapshot_request_reload(void);
+
+// 즉시 재로드 (호출 스레드에서 로드, 성공 시 0)
+int  policy_snapshot_reload_now(void);
+
+/*
+ * reader 구간: acquire ~ release 사이에서만 스냅샷 사용
+ * - 스레드당 중첩 불가, 구간은 짧게 (match_policy 1회)
+ * - 게시된 스냅샷이 없으면 NULL
+ */
+const policy_snapshot_t* policy_snapshot_acquire(void);
+void policy_snapshot_release(void);
+
+// acquire를 쓴 스레드가 종료 전에 호출 (reader 슬롯 반환, 구간 밖에서만)
+void policy_snapshot_thread_cleanup(void);
+
+uint64_t policy_snapshot_generation(void);
+
+/*
+ * DB 정책 버전 문자열
+ * - policy_audit / policy / policy_rule 의 최대 PK 조합 (PK 끝 조회라 테이블 크기와 무관)
+ * - API 경유 변경은 모두 policy_audit에 남으므로 값 변화로 드러남
+ *   (감사 기록 없는 직접 UPDATE는 주기적 전체 재로드가 보정)
+ */
+int  policy_snapshot_db_version(MYSQL* conn, char* out, size_t outsz);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+// include/policy_snapshot_file.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "policy.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 컴파일된 정책 + 인덱스 바이너리 스냅샷 파일
+ * - [header][section table][sections...], 섹션은 8 byte 정렬
+ * - header에 포맷 버전 / 구조체 크기(ABI) / 전체 CRC32 기록, 하나라도 다르면 로드 거부
+ * - 로드는 읽기 전용 MAP_SHARED 매핑: 룰/인덱스 배열을 복사 없이 그대로 사용
+ *   (같은 호스트의 여러 엔진 프로세스가 page cache를 공유)
+ * - REGEX 룰이 있는 policy만 룰을 힙으로 복사해 정규식 재컴파일
+ * - 쓰기는 임시 파일(O_EXCL | O_NOFOLLOW, 0600) + rename (읽는 쪽은 항상 완전한 파일만 봄)
+ * - 디렉터리 소유자가 실행 uid/root가 아니거나 group/other 쓰기 가능하면, 파일이 실행 uid 소유가 아니면 거부
+ * - 로드 시 인덱스의 모든 노드/간선/룰 참조 범위와 문자열 종료를 검증 (CRC만으로 신뢰하지 않음)
+ */
+#define POLICY_SNAPSHOT_FILE_VERSION 1
+
+typedef struct {
+    uint64_t generation;
+    int64_t  created_at_ms;
+    char     db_version[128];
+    uint64_t file_size;
+} policy_snapshot_file_info_t;
+
+// cache(인덱스 포함)를 path에 기록, 성공 시 0
+int policy_snapshot_file_write(const char* path,
+                               const policy_cache_t* cache,
+                               uint64_t generation,
+                               const char* db_version);
+
+// path를 매핑해 out을 구성 (out은 free_policy_cache로 해제), 성공 시 0
+int policy_snapshot_file_load(const char* path,
+                              policy_cache_t* out,
+                              policy_snapshot_file_info_t* info);
+
+#ifdef __cplusplus
+}
+#endif
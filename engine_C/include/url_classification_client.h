@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "engine_struct.h"
+#include "ai_circuit_breaker.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,7 +15,9 @@ typedef enum {
     AI_ERR_HTTP = 2,
     AI_ERR_TIMEOUT = 3,
     AI_ERR_PARSE = 4,
-    AI_ERR_EMPTY = 5
+    AI_ERR_EMPTY = 5,
+    AI_ERR_BUSY = 6,        // 비동기 in-flight 한도 초과 (요청 안 함)
+    AI_ERR_CIRCUIT_OPEN = 7 // circuit breaker OPEN (요청 안 함)
 } ai_error_t;
 
 /*
@@ -38,12 +41,22 @@ typedef struct {
     int timeout_ms;         // total timeout
     int connect_timeout_ms; // connect timeout
     char token[128];        // optional
+    int pool_size;          // 워커당 유지할 idle 연결(CURL handle) 수 (음수면 재사용 안 함)
+    int keepalive_idle_sec; // TCP keep-alive probe 시작/간격 (0이면 끔)
+    char batch_endpoint[256]; // 예: http://127.0.0.1:8000/v1/score_batch (빈 값이면 배치 안 함)
+    int coalesce;           // 같은 URL 동시 요청을 1건으로 합침 (0이면 끔)
+    ai_breaker_config_t breaker; // circuit breaker + 적응형 timeout (timeout_ms가 상한)
+    char uds_path[108];     // 지정하면 HTTP/JSON 대신 Unix socket 바이너리 프로토콜 (ai_score_proto.h)
 } ai_client_config_t;
 
 // config는 main/config에서 1회 세팅하고 계속 재사용
+// - 연결(CURL handle)은 워커 스레드별로 유지되어 keep-alive로 재사용됨
 int ai_client_init(const ai_client_config_t* cfg);
 void ai_client_cleanup(void);
 
+// 워커 스레드 종료 시 해당 스레드의 idle 연결 정리
+void ai_client_thread_cleanup(void);
+
 /*
  * 신규 권장 API: request_id를 별도로 넘김 (HttpEvent에 request_id가 없기 때문)
  * - request_id == NULL 이면 payload에 request_id를 넣지 않고 호출
@@ -57,6 +70,44 @@ int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t*
  */
 int ai_classify_url(const HttpEvent* ev, ai_result_t* out);
 
+/*
+ * 비동기 분류 (curl multi 이벤트 루프 스레드 1개)
+ * - 캡처 스레드는 제출만 하고 바로 반환, 루프 스레드는 네트워크만 처리
+ * - done 콜백은 콜백 스레드(callback_threads개)에서 실행: DB 기록 / 주입이 루프를 막지 않음
+ * - max_inflight: 동시 진행 요청 상한, 넘으면 제출이 즉시 AI_ASYNC_BUSY (대기 없음)
+ * - batch_max > 1: 제출을 모아 /v1/score_batch 1건으로 보내고 항목별 결과를 각 콜백에 분배
+ *   (API가 404면 배치를 끄고 단건으로 전환)
+ * - thread_begin/end: 콜백 스레드 시작/종료 시 호출 (콜백이 쓰는 스레드 로컬 DB 자원 등)
+ *   하나라도 thread_begin이 실패하면 ai_async_start 실패 (호출자는 동기 호출로 진행)
+ * - uds_path 사용 시: 연결 1개에 요청을 pipelining (배치 설정은 무시)
+ * - coalesce: 같은 URL이 진행 중이면 요청 없이 그 결과를 받음 (in-flight로는 세지만 한도 검사 없음)
+ * - circuit breaker OPEN이면 요청 없이 AI_ERR_CIRCUIT_OPEN으로 콜백
+ * - ai_async_drain은 진행 중 요청의 콜백이 모두 끝날 때까지 대기 (새 제출은 막지 않음)
+ * - ai_async_stop은 새 제출을 막고 진행 중 요청의 콜백까지 끝낸 뒤 반환
+ */
+typedef void (*ai_classify_done_fn)(int ok, const ai_result_t* ar, void* ctx);
+
+typedef struct {
+    int   max_inflight;
+    int   batch_max;      // 배치 최대 항목 수 (1 이하면 단건 /v1/score)
+    int   batch_wait_ms;  // 첫 항목 이후 배치를 모으는 최대 시간
+    int   callback_threads;          // 완료 콜백 스레드 수 (0 이하면 1)
+    int  (*thread_begin)(int index); // 콜백 스레드 시작 (0 성공)
+    void (*thread_end)(void);
+} ai_async_config_t;
+
+#define AI_ASYNC_QUEUED    0   // done 콜백이 반드시 1회 호출됨
+#define AI_ASYNC_BUSY      1   // in-flight 한도 초과 (콜백 없음)
+#define AI_ASYNC_REJECTED -1   // 비동기 미사용/종료 중/메모리 부족 (콜백 없음)
+
+int  ai_async_start(const ai_async_config_t* cfg);
+void ai_async_stop(void);
+int  ai_async_enabled(void);
+int  ai_async_inflight(void);
+void ai_async_drain(void);
+
+int  ai_classify_url_async(const HttpEvent* ev, const char* request_id, ai_classify_done_fn done, void* ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,74 @@
+// include/url_features.h
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * URL 어휘 특성 (ai_trainer data_preprocessor.build_feature_row / gateguard_api ai_function과 같은 규칙)
+ * - 내장 분류기 입력과 1차 휴리스틱 점수에서 공유
+ * - 바이트 단위 처리 (ASCII 기준)
+ */
+#define URL_FEATURES_URL_MAX 1024
+
+typedef enum {
+    UF_URL_LENGTH = 0,
+    UF_HOST_LENGTH,
+    UF_PATH_LENGTH,
+    UF_QUERY_LENGTH,
+    UF_SLASH_COUNT,
+    UF_DOT_COUNT,
+    UF_HYPHEN_COUNT,
+    UF_UNDERSCORE_COUNT,
+    UF_QUESTION_MARK_COUNT,
+    UF_AMPERSAND_COUNT,
+    UF_EQUAL_COUNT,
+    UF_DIGIT_COUNT,
+    UF_SPECIAL_CHAR_COUNT,
+    UF_SUSPICIOUS_KEYWORD_HITS,
+    UF_HOST_SUSPICIOUS_KEYWORD_HITS,
+    UF_PATH_SUSPICIOUS_KEYWORD_HITS,
+    UF_QUERY_SUSPICIOUS_KEYWORD_HITS,
+    UF_BRAND_KEYWORD_HITS,
+    UF_HAS_BRAND_KEYWORD,
+    UF_BRAND_SUSPICIOUS_COMBO,
+    UF_HAS_SUSPICIOUS_EXTENSION,
+    UF_HAS_QUERY,
+    UF_IS_IPV4_HOST,
+    UF_SUBDOMAIN_COUNT,
+    UF_HOST_DOT_COUNT,
+    UF_HOST_HYPHEN_COUNT,
+    UF_PATH_HYPHEN_COUNT,
+    UF_QUERY_PARAM_COUNT,
+    UF_TLD_LENGTH,
+    UF_IS_SUSPICIOUS_TLD,
+    UF_HAS_LONG_HOST,
+    UF_HAS_MANY_SUBDOMAINS,
+    UF_HAS_AT_SYMBOL,
+    UF_DOUBLE_SLASH_IN_PATH,
+    UF_CONTAINS_HEX_LIKE_TOKEN,
+    UF_COUNT
+} url_feature_t;
+
+// feature 이름 (meta.json numeric_feature_columns와 같은 표기)
+const char* url_feature_name(url_feature_t f);
+int         url_feature_find(const char* name, size_t maxlen);
+
+// Python str.isspace 중 ASCII 범위 (strip / \s 와 같은 기준)
+int url_features_isspace(unsigned char c);
+
+/*
+ * build_url(host, path): strip/lower, path 기본값 "/", 선행 '/' 보장, scheme 없으면 "http://"
+ * 반환: url 길이 (0이면 버퍼 부족)
+ */
+size_t url_features_build_url(const char* host, const char* path, char* url, size_t cap);
+
+// url(build_url 결과)에서 특성 계산, f는 UF_COUNT개
+void url_features_compute(const char* url, size_t url_len, double* f);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+// include/url_native_model.h
+#pragma once
+
+#include "engine_struct.h"
+#include "url_classification_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 엔진 내장 URL 분류기 (네트워크 없이 /v1/score와 같은 점수 계산)
+ * - ai_trainer extract_to_file.py가 내보낸 model_native.bin 로드
+ *   (char n-gram TF-IDF vocabulary/idf + numeric feature 이름 + 선형 모델 계수)
+ * - numeric feature는 data_preprocessor.build_feature_row와 같은 규칙으로 C에서 계산
+ * - 로드 후 모델은 읽기 전용: 여러 워커 스레드에서 lock 없이 호출 가능
+ * - 바이트 단위 처리: ASCII가 아닌 URL은 Python 결과와 다를 수 있음
+ */
+#define URL_NATIVE_MODEL_VERSION 1
+
+// 시작 시 1회 로드 (워커 시작 전), 성공 시 0
+int  url_native_model_load(const char* path);
+void url_native_model_unload(void);
+int  url_native_model_loaded(void);
+
+// 성공 시 1 (out에 score/label/model_version), 모델이 없거나 입력이 잘못되면 0
+int  url_native_classify(const HttpEvent* ev, ai_result_t* out);
+
+// host/path 직접 지정 (parity 검증 도구용)
+int  url_native_classify_host_path(const char* host, const char* path, ai_result_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+// include/url_prescore.h
+#pragma once
+
+#include "engine_struct.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 1차 휴리스틱 점수 (AI 호출 전 단계)
+ * - url_features의 가벼운 어휘 특성(숫자/특수문자, 의심 확장자, IPv4 host, subdomain 수,
+ *   hex 토큰, 의심 키워드/TLD)에 고정 가중치를 더해 sigmoid로 0~1 점수 계산
+ * - score < low: 명백한 정상으로 바로 판정 (CDN / 정적 리소스 등)
+ * - score >= high: 명백한 악성으로 바로 판정 (high > 1이면 끔)
+ * - 그 사이(불확실 구간)만 AI 단계로 넘김
+ */
+#define URL_PRESCORE_MODEL_VERSION "prescore-v1"
+
+typedef enum {
+    PRESCORE_ESCALATE = 0,  // 불확실 -> AI
+    PRESCORE_BENIGN,
+    PRESCORE_MALICIOUS
+} url_prescore_tier_t;
+
+typedef struct {
+    double low;    // 0 이하면 정상 판정 안 함
+    double high;   // 1 초과면 악성 판정 안 함
+} url_prescore_config_t;
+
+void url_prescore_init(const url_prescore_config_t* cfg);
+int  url_prescore_enabled(void);
+
+// 0~1 점수 (입력이 잘못되면 0.5)
+double url_prescore(const char* host, const char* path);
+
+// 점수 + 구간 판정
+url_prescore_tier_t url_prescore_classify(const HttpEvent* ev, double* score);
+
+#ifdef __cplusplus
+}
+#endif
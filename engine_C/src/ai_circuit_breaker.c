@@ -0,0 +1,260 @@
+// src/ai_circuit_breaker.c
+#include "ai_circuit_breaker.h"
+#include "engine_metrics.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BREAKER_MAX_WINDOW   1024
+#define LATENCY_SAMPLES      256
+#define LATENCY_RECALC_EVERY 32
+
+static struct {
+    pthread_mutex_t     lock;
+    ai_breaker_config_t cfg;
+    int                 max_timeout_ms;
+
+    ai_breaker_state_t  state;
+    uint32_t            epoch;          // OPEN 전환마다 증가 (atomic read, 요청에 태그)
+    int64_t             opened_at_ms;
+    int64_t             half_open_at_ms;
+    int                 probes_sent;
+
+    // 최근 결과 (1 = 실패)
+    uint8_t             outcomes[BREAKER_MAX_WINDOW];
+    int                 outcome_pos;
+    int                 outcome_count;
+    int                 failures;
+
+    // 최근 응답 지연 (성공 + timeout은 당시 timeout 값으로)
+    int                 latencies[LATENCY_SAMPLES];
+    int                 latency_pos;
+    int                 latency_count;
+    int                 since_recalc;
+
+    int                 timeout_ms;  // atomic read
+} g_br = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static int64_t mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int cmp_int(const void* a, const void* b)
+{
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+const char* ai_breaker_state_name(ai_breaker_state_t s)
+{
+    switch (s) {
+        case AI_BREAKER_OPEN: return "OPEN";
+        case AI_BREAKER_HALF_OPEN: return "HALF_OPEN";
+        default: return "CLOSED";
+    }
+}
+
+static void reset_window_locked(void)
+{
+    g_br.outcome_pos = 0;
+    g_br.outcome_count = 0;
+    g_br.failures = 0;
+}
+
+// 상태 전환 (lock 보유 상태)
+static void transition_locked(ai_breaker_state_t to, const char* why)
+{
+    ai_breaker_state_t from = g_br.state;
+    if (from == to) return;
+
+    int64_t now = mono_ms();
+
+    switch (to) {
+        case AI_BREAKER_OPEN:
+            g_br.opened_at_ms = now;
+            __atomic_store_n(&g_br.epoch, g_br.epoch + 1, __ATOMIC_RELEASE);
+            engine_metrics_count(EM_COUNT_AI_BREAKER_OPEN, 1);
+            break;
+        case AI_BREAKER_HALF_OPEN:
+            g_br.half_open_at_ms = now;
+            g_br.probes_sent = 0;
+            engine_metrics_count(EM_COUNT_AI_BREAKER_HALF_OPEN, 1);
+            break;
+        case AI_BREAKER_CLOSED:
+            reset_window_locked();
+            engine_metrics_count(EM_COUNT_AI_BREAKER_CLOSE, 1);
+            break;
+    }
+    // epoch를 먼저 올린 뒤 상태 게시 (lock 없이 CLOSED를 본 요청은 이전 epoch 또는 새 epoch)
+    __atomic_store_n(&g_br.state, to, __ATOMIC_RELEASE);
+
+    fprintf(stderr, "[AI_BREAKER] %s -> %s (%s) timeout=%dms\n",
+            ai_breaker_state_name(from), ai_breaker_state_name(to), why,
+            __atomic_load_n(&g_br.timeout_ms, __ATOMIC_RELAXED));
+}
+
+static void recalc_timeout_locked(void)
+{
+    int n = g_br.latency_count;
+    if (n == 0) return;
+
+    int sorted[LATENCY_SAMPLES];
+    memcpy(sorted, g_br.latencies, (size_t)n * sizeof(int));
+    qsort(sorted, (size_t)n, sizeof(int), cmp_int);
+
+    int p99 = sorted[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1];
+    int t = (int)((double)(p99 > 0 ? p99 : 1) * g_br.cfg.p99_factor);
+    if (t < g_br.cfg.min_timeout_ms) t = g_br.cfg.min_timeout_ms;
+    if (t > g_br.max_timeout_ms) t = g_br.max_timeout_ms;
+
+    __atomic_store_n(&g_br.timeout_ms, t, __ATOMIC_RELAXED);
+}
+
+void ai_breaker_init(const ai_breaker_config_t* cfg, int max_timeout_ms)
+{
+    pthread_mutex_lock(&g_br.lock);
+    memset(&g_br.cfg, 0, sizeof(g_br.cfg));
+    if (cfg) g_br.cfg = *cfg;
+
+    if (g_br.cfg.window > BREAKER_MAX_WINDOW) g_br.cfg.window = BREAKER_MAX_WINDOW;
+    if (g_br.cfg.min_requests > g_br.cfg.window) g_br.cfg.min_requests = g_br.cfg.window;
+    if (g_br.cfg.min_requests < 1) g_br.cfg.min_requests = 1;
+    if (g_br.cfg.half_open_probes < 1) g_br.cfg.half_open_probes = 1;
+    if (g_br.cfg.p99_factor <= 0.0) g_br.cfg.p99_factor = 3.0;
+
+    g_br.max_timeout_ms = max_timeout_ms > 0 ? max_timeout_ms : 3000;
+    if (g_br.cfg.min_timeout_ms <= 0 || g_br.cfg.min_timeout_ms > g_br.max_timeout_ms) {
+        g_br.cfg.min_timeout_ms = g_br.max_timeout_ms;
+    }
+
+    g_br.state = AI_BREAKER_CLOSED;
+    reset_window_locked();
+    g_br.latency_pos = g_br.latency_count = g_br.since_recalc = 0;
+    __atomic_store_n(&g_br.timeout_ms, g_br.max_timeout_ms, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_br.lock);
+
+    if (g_br.cfg.window > 0) {
+        fprintf(stderr, "[AI_BREAKER] window=%d min_requests=%d error_rate=%.2f open=%dms probes=%d timeout=%s(%d~%dms)\n",
+                g_br.cfg.window, g_br.cfg.min_requests, g_br.cfg.error_rate, g_br.cfg.open_ms,
+                g_br.cfg.half_open_probes, g_br.cfg.adaptive_timeout ? "p99 " : "fixed ",
+                g_br.cfg.min_timeout_ms, g_br.max_timeout_ms);
+    }
+}
+
+int ai_breaker_allow(uint32_t* epoch)
+{
+    // epoch를 상태보다 먼저 읽음: OPEN 전환과 겹친 요청은 이전 epoch로 태그되어 이후 결과가 무시됨
+    if (epoch) *epoch = __atomic_load_n(&g_br.epoch, __ATOMIC_ACQUIRE);
+    if (g_br.cfg.window <= 0) return 1;
+
+    // CLOSED는 lock 없이 통과 (대부분의 요청)
+    if (__atomic_load_n(&g_br.state, __ATOMIC_ACQUIRE) == AI_BREAKER_CLOSED) return 1;
+
+    int allow = 0;
+    pthread_mutex_lock(&g_br.lock);
+    int64_t now = mono_ms();
+
+    if (g_br.state == AI_BREAKER_OPEN && now - g_br.opened_at_ms >= g_br.cfg.open_ms) {
+        transition_locked(AI_BREAKER_HALF_OPEN, "open period elapsed");
+    }
+
+    if (g_br.state == AI_BREAKER_HALF_OPEN) {
+        // probe 결과가 오지 않은 채 오래 지나면 다시 probe
+        if (g_br.probes_sent >= g_br.cfg.half_open_probes &&
+            now - g_br.half_open_at_ms > (int64_t)g_br.cfg.open_ms + g_br.max_timeout_ms) {
+            g_br.half_open_at_ms = now;
+            g_br.probes_sent = 0;
+        }
+        if (g_br.probes_sent < g_br.cfg.half_open_probes) {
+            g_br.probes_sent++;
+            allow = AI_BREAKER_PROBE;
+        }
+    } else if (g_br.state == AI_BREAKER_CLOSED) {
+        allow = 1;
+    }
+    if (allow && epoch) *epoch = g_br.epoch;
+    pthread_mutex_unlock(&g_br.lock);
+
+    if (!allow) engine_metrics_count(EM_COUNT_AI_FAST_FAIL, 1);
+    return allow;
+}
+
+void ai_breaker_release_probe(void)
+{
+    if (g_br.cfg.window <= 0) return;
+
+    pthread_mutex_lock(&g_br.lock);
+    if (g_br.state == AI_BREAKER_HALF_OPEN && g_br.probes_sent > 0) g_br.probes_sent--;
+    pthread_mutex_unlock(&g_br.lock);
+}
+
+void ai_breaker_record(uint32_t epoch, int failure, int timed_out, int64_t latency_ms)
+{
+    if (g_br.cfg.window <= 0 && !g_br.cfg.adaptive_timeout) return;
+
+    pthread_mutex_lock(&g_br.lock);
+
+    // 마지막 OPEN 전에 보낸 요청의 결과: 지금 서비스 상태가 아니므로 (HALF_OPEN probe 판정 포함) 무시
+    if (g_br.cfg.window > 0 && epoch != g_br.epoch) {
+        pthread_mutex_unlock(&g_br.lock);
+        return;
+    }
+
+    // timeout은 당시 timeout 값을 표본으로: 연속되면 p99가 timeout에 닿아 p99_factor만큼 늘어남 (상한 max)
+    if ((!failure || timed_out) && g_br.cfg.adaptive_timeout) {
+        int sample = latency_ms > 0 ? (int)latency_ms : 0;
+        if (timed_out) {
+            int cur = __atomic_load_n(&g_br.timeout_ms, __ATOMIC_RELAXED);
+            if (sample < cur) sample = cur;
+        }
+        g_br.latencies[g_br.latency_pos] = sample;
+        g_br.latency_pos = (g_br.latency_pos + 1) % LATENCY_SAMPLES;
+        if (g_br.latency_count < LATENCY_SAMPLES) g_br.latency_count++;
+        if (timed_out || ++g_br.since_recalc >= LATENCY_RECALC_EVERY || g_br.latency_count < LATENCY_RECALC_EVERY) {
+            g_br.since_recalc = 0;
+            recalc_timeout_locked();
+        }
+    }
+
+    if (g_br.cfg.window > 0) {
+        if (g_br.state == AI_BREAKER_HALF_OPEN) {
+            transition_locked(failure ? AI_BREAKER_OPEN : AI_BREAKER_CLOSED,
+                              failure ? "probe failed" : "probe succeeded");
+        } else if (g_br.state == AI_BREAKER_CLOSED) {
+            int w = g_br.cfg.window;
+            if (g_br.outcome_count == w) g_br.failures -= g_br.outcomes[g_br.outcome_pos];
+            else g_br.outcome_count++;
+            g_br.outcomes[g_br.outcome_pos] = (uint8_t)(failure ? 1 : 0);
+            g_br.failures += failure ? 1 : 0;
+            g_br.outcome_pos = (g_br.outcome_pos + 1) % w;
+
+            if (failure && g_br.outcome_count >= g_br.cfg.min_requests &&
+                (double)g_br.failures >= g_br.cfg.error_rate * (double)g_br.outcome_count) {
+                char why[64];
+                snprintf(why, sizeof(why), "%d/%d failed", g_br.failures, g_br.outcome_count);
+                transition_locked(AI_BREAKER_OPEN, why);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&g_br.lock);
+}
+
+int ai_breaker_timeout_ms(void)
+{
+    if (!g_br.cfg.adaptive_timeout) return g_br.max_timeout_ms;
+    if (__atomic_load_n(&g_br.state, __ATOMIC_ACQUIRE) == AI_BREAKER_HALF_OPEN) return g_br.max_timeout_ms;
+    return __atomic_load_n(&g_br.timeout_ms, __ATOMIC_RELAXED);
+}
+
+ai_breaker_state_t ai_breaker_state(void)
+{
+    return __atomic_load_n(&g_br.state, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,210 @@
+// src/ai_score_proto.c
+#include "ai_score_proto.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define REQ_FIXED   12  // seq + host_len + path_len + rid_len + reserved
+#define RESP_FIXED  16  // seq + status + label_len + mv_len + score
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static double get_f64(const uint8_t* p) {
+    uint64_t bits = (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// hello 주고받기 전용 (blocking + poll timeout)
+static int io_full(int fd, uint8_t* buf, size_t len, int writing, int timeout_ms) {
+    size_t off = 0;
+    while (off < len) {
+        struct pollfd pfd = { fd, (short)(writing ? POLLOUT : POLLIN), 0 };
+        int pr = poll(&pfd, 1, timeout_ms);
+        if (pr == 0) return -2;
+        if (pr < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+
+        ssize_t n = writing ? send(fd, buf + off, len - off, MSG_NOSIGNAL)
+                            : recv(fd, buf + off, len - off, 0);
+        if (n > 0) {
+            off += (size_t)n;
+            continue;
+        }
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        return -1;
+    }
+    return 0;
+}
+
+int ai_proto_open(const char* path, int nonblock, char* err, size_t errsz) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (!path || strlen(path) >= sizeof(addr.sun_path)) {
+        snprintf(err, errsz, "uds_path_invalid");
+        return -1;
+    }
+    memcpy(addr.sun_path, path, strlen(path) + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | (nonblock ? SOCK_NONBLOCK : 0), 0);
+    if (fd < 0) {
+        snprintf(err, errsz, "uds_socket:%s", strerror(errno));
+        return -1;
+    }
+
+    // Unix socket connect는 즉시 끝나거나 실패 (non-blocking에서 backlog가 차면 EAGAIN)
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        snprintf(err, errsz, "uds_connect:%s", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+size_t ai_proto_encode_hello(uint8_t* out, size_t cap, const char* token) {
+    size_t token_len = token ? strlen(token) : 0;
+    if (token_len > AI_PROTO_HELLO_MAX - 6) token_len = AI_PROTO_HELLO_MAX - 6;
+    if (cap < 6 + token_len) return 0;
+
+    memcpy(out, AI_PROTO_MAGIC, 4);
+    put_u16(out + 4, (uint16_t)token_len);
+    if (token_len) memcpy(out + 6, token, token_len);
+    return 6 + token_len;
+}
+
+uint16_t ai_proto_hello_status(const uint8_t* reply) {
+    return get_u16(reply);
+}
+
+int ai_proto_connect(const char* path, const char* token, int timeout_ms, char* err, size_t errsz) {
+    int fd = ai_proto_open(path, 0, err, errsz);
+    if (fd < 0) return -1;
+
+    uint8_t hello[AI_PROTO_HELLO_MAX];
+    size_t hello_len = ai_proto_encode_hello(hello, sizeof(hello), token);
+
+    uint8_t reply[AI_PROTO_HELLO_REPLY];
+    int rc = io_full(fd, hello, hello_len, 1, timeout_ms);
+    if (rc == 0) rc = io_full(fd, reply, sizeof(reply), 0, timeout_ms);
+    if (rc != 0) {
+        snprintf(err, errsz, "uds_hello:%s", rc == -2 ? "timeout" : "closed");
+        close(fd);
+        return -1;
+    }
+
+    uint16_t status = ai_proto_hello_status(reply);
+    if (status != 200) {
+        snprintf(err, errsz, "uds_hello_status:%u", (unsigned)status);
+        close(fd);
+        return -1;
+    }
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+size_t ai_proto_encode_request(uint8_t* out, size_t cap, uint32_t seq,
+                               const char* host, const char* path, const char* request_id) {
+    size_t hl = host ? strlen(host) : 0;
+    size_t pl = path ? strlen(path) : 0;
+    size_t rl = request_id ? strlen(request_id) : 0;
+    size_t total = 4 + REQ_FIXED + hl + pl + rl;
+    if (hl > 0xffff || pl > 0xffff || rl > 0xffff || total > cap) return 0;
+
+    put_u32(out, (uint32_t)(total - 4));
+    put_u32(out + 4, seq);
+    put_u16(out + 8, (uint16_t)hl);
+    put_u16(out + 10, (uint16_t)pl);
+    put_u16(out + 12, (uint16_t)rl);
+    put_u16(out + 14, 0);
+
+    uint8_t* p = out + 4 + REQ_FIXED;
+    if (hl) memcpy(p, host, hl);
+    p += hl;
+    if (pl) memcpy(p, path, pl);
+    p += pl;
+    if (rl) memcpy(p, request_id, rl);
+    return total;
+}
+
+int ai_proto_decode_response(const uint8_t* buf, size_t len, uint32_t* seq, ai_result_t* out, size_t* used) {
+    if (len < 4) return 0;
+
+    uint32_t body = get_u32(buf);
+    if (body < RESP_FIXED || body > AI_PROTO_RESP_MAX) return -1;
+    if (len < 4 + (size_t)body) return 0;
+
+    const uint8_t* p = buf + 4;
+    uint16_t status = get_u16(p + 4);
+    size_t label_len = p[6];
+    size_t mv_len = p[7];
+    if (RESP_FIXED + label_len + mv_len > body) return -1;
+
+    *seq = get_u32(p);
+    *used = 4 + (size_t)body;
+
+    const uint8_t* s = p + RESP_FIXED;
+    out->http_status = (int)status;
+
+    size_t n = label_len < sizeof(out->label) - 1 ? label_len : sizeof(out->label) - 1;
+    memcpy(out->label, s, n);
+    out->label[n] = '\0';
+    s += label_len;
+
+    n = mv_len < sizeof(out->model_version) - 1 ? mv_len : sizeof(out->model_version) - 1;
+    memcpy(out->model_version, s, n);
+    out->model_version[n] = '\0';
+    s += mv_len;
+
+    if (status != 200) {
+        size_t msg_len = body - RESP_FIXED - label_len - mv_len;
+        n = msg_len < sizeof(out->raw) - 1 ? msg_len : sizeof(out->raw) - 1;
+        memcpy(out->raw, s, n);
+        out->raw[n] = '\0';
+        out->ok = 0;
+        out->error_code = AI_ERR_HTTP;
+        return 1;
+    }
+
+    if (label_len == 0) {
+        out->ok = 0;
+        out->error_code = AI_ERR_PARSE;
+        snprintf(out->raw, sizeof(out->raw), "uds_response_without_label");
+        return 1;
+    }
+
+    out->ok = 1;
+    out->error_code = AI_OK;
+    out->score = get_f64(p + 8);
+    return 1;
+}
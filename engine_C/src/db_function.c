@@ -1,150 +1,277 @@
 #include "db_function.h"
+#include "engine_metrics.h"
 #include "url_classification_client.h"
 
+#include <pthread.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <mysql/mysql.h>
+#include <mysql/errmsg.h>
+#include <mysql/mysqld_error.h>
 
 #ifndef my_bool
 typedef _Bool my_bool;
 #endif
 
-// Prepared Statement SQL을 준비하는 공통 함수
-static int stmt_prepare(MYSQL_STMT* stmt, const char* sql)
-{
-    if (!stmt || !sql) return -1;
-    if (mysql_stmt_prepare(stmt, sql, (unsigned long)strlen(sql)) != 0) return -1;
-    return 0;
-}
-
-// access_log 테이블에 최초 HTTP 요청 로그를 저장
-long long insert_access_log(
-    MYSQL* conn,
-    const char* request_id,
-    const char* client_ip,
-    int client_port,
-    const char* server_ip,
-    int server_port,
-    const char* host,
-    const char* path,
-    const char* method,
-    const char* url_norm)
-{
-    // 필수값 확인
-    if (!conn || !request_id || !client_ip || !host) return -1;
-
-    const char* sql =
+/*
+ * Prepared statement 캐시 (DB 연결 단위)
+ * - 문장별로 1회만 prepare, 이후 호출은 bind + execute만 (이벤트당 prepare 왕복 제거)
+ * - 연결은 풀(db_pool.c)에서 빌려 쓰므로 캐시는 연결에 붙음: 연결을 빌린 스레드만 접근, 문장 사용에 lock 없음
+ *   연결 -> 캐시 조회는 스레드별 마지막 캐시로 먼저 확인 (풀 affinity로 대부분 같은 연결)
+ * - 재연결되면(mysql_thread_id 변경) 전체를 버리고 다시 prepare
+ * - execute가 서버 쪽 문장 무효 에러로 실패하면 해당 문장만 다시 prepare해서 1회 재시도
+ */
+typedef enum {
+    DB_STMT_INSERT_ACCESS_LOG = 0,
+    DB_STMT_UPDATE_DECISION,
+    DB_STMT_UPDATE_INJECT,
+    DB_STMT_NEXT_ANALYSIS_SEQ,
+    DB_STMT_INSERT_AI_ANALYSIS,
+    DB_STMT_INSERT_REVIEW_EVENT,
+    DB_STMT_FIND_LOG_ID,
+    DB_STMT_COUNT
+} db_stmt_id_t;
+
+static const char* const k_stmt_sql[DB_STMT_COUNT] = {
+    [DB_STMT_INSERT_ACCESS_LOG] =
         "INSERT INTO access_log "
         "(request_id, detect_timestamp, client_ip, client_port, server_ip, server_port, "
-        " host, path, method, url_norm, decision, reason, decision_stage) "
-        "VALUES (?, NOW(), ?, ?, ?, ?, ?, ?, ?, ?, 'ERROR', 'SYSTEM', 'FAIL_STAGE')";
+        " host, path, method, url_norm, decision, reason, decision_stage, policy_id, engine_latency_ms, "
+        " inject_attempted, inject_send, inject_errno, inject_latency_ms, inject_status_code) "
+        "VALUES (?, FROM_UNIXTIME(?), ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
 
-    MYSQL_STMT* stmt = mysql_stmt_init(conn);
-    if (!stmt) return -1;
-    if (stmt_prepare(stmt, sql) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
+    [DB_STMT_UPDATE_DECISION] =
+        "UPDATE access_log "
+        "SET decision=?, reason=?, decision_stage=?, policy_id=?, engine_latency_ms=? "
+        "WHERE log_id=?",
 
-    MYSQL_BIND b[9];
-    memset(b, 0, sizeof(b));
+    [DB_STMT_UPDATE_INJECT] =
+        "UPDATE access_log SET "
+        "inject_attempted=?, inject_send=?, inject_errno=?, "
+        "inject_latency_ms=?, inject_status_code=? "
+        "WHERE log_id=?",
 
-    // 기본값 보정
-    const char* p = (path && path[0]) ? path : "/";
-    const char* m = (method && method[0]) ? method : NULL;
-    const char* u = (url_norm && url_norm[0]) ? url_norm : NULL;
-    const char* sip = (server_ip && server_ip[0]) ? server_ip : NULL;
+    [DB_STMT_NEXT_ANALYSIS_SEQ] =
+        "SELECT COALESCE(MAX(analysis_seq), -1) + 1, COUNT(CASE WHEN model_version=? THEN 1 END) "
+        "FROM ai_analysis WHERE log_id=?",
 
-    // 문자열 길이 계산
-    unsigned long l0 = (unsigned long)strlen(request_id);
-    unsigned long l1 = (unsigned long)strlen(client_ip);
-    unsigned long l2 = sip ? (unsigned long)strlen(sip) : 0;
-    unsigned long l3 = (unsigned long)strlen(host);
-    unsigned long l4 = p ? (unsigned long)strlen(p) : 0;
-    unsigned long l5 = m ? (unsigned long)strlen(m) : 0;
-    unsigned long l6 = u ? (unsigned long)strlen(u) : 0;
+    [DB_STMT_INSERT_AI_ANALYSIS] =
+        "INSERT INTO ai_analysis "
+        "(log_id, analyzed_at, score, label, ai_response, latency_ms, model_version, error_code, analysis_seq) "
+        "VALUES (?, NOW(), ?, ?, ?, ?, ?, ?, ?)",
 
-    // NULL 여부 설정
-    my_bool is_null_client_port = (client_port <= 0) ? 1 : 0;
-    my_bool is_null_server_ip = (sip == NULL) ? 1 : 0;
-    my_bool is_null_server_port = (server_port <= 0) ? 1 : 0;
-    my_bool is_null_method = (m == NULL) ? 1 : 0;
-    my_bool is_null_url_norm = (u == NULL) ? 1 : 0;
+    [DB_STMT_INSERT_REVIEW_EVENT] =
+        "INSERT INTO review_event ("
+        "log_id, status, proposed_action, reviewer_id, reviewed_at, created_at, note, generated_policy_id"
+        ") "
+        "SELECT "
+        "?, 'OPEN', ?, NULL, NULL, NOW(), ?, NULL "
+        "FROM DUAL "
+        "WHERE NOT EXISTS ("
+        "  SELECT 1 "
+        "  FROM review_event "
+        "  WHERE log_id = ? "
+        "    AND status IN ('OPEN', 'IN_PROGRESS')"
+        ")",
+
+    [DB_STMT_FIND_LOG_ID] =
+        "SELECT log_id FROM access_log WHERE request_id=?",
+};
+
+typedef struct db_stmt_cache {
+    MYSQL*                conn;        // NULL이면 빈 항목 (재사용)
+    unsigned long         thread_id;   // 서버 연결 id (재연결 감지)
+    MYSQL_STMT*           stmt[DB_STMT_COUNT];
+    struct db_stmt_cache* next;
+} db_stmt_cache_t;
+
+// 항목은 해제하지 않고 재사용: 다른 스레드의 t_stmts가 가리켜도 유효한 메모리
+static pthread_mutex_t  g_stmt_caches_lock = PTHREAD_MUTEX_INITIALIZER;
+static db_stmt_cache_t* g_stmt_caches = NULL;
+
+static __thread db_stmt_cache_t* t_stmts = NULL;
+static __thread unsigned int     t_last_errno = 0;  // 마지막 DB 오류 (db_last_errno)
+static __thread int              t_in_tx = 0;       // 레코드 트랜잭션 안 (연결 끊김 후 재시도 금지)
+
+// multi-row INSERT 문장 버퍼 (스레드별, 배치마다 재사용)
+typedef struct {
+    char*  buf;
+    size_t len;
+    size_t cap;
+    int    oom;
+} sql_buf_t;
+
+static __thread sql_buf_t t_sql;
+
+static void stmt_cache_clear(db_stmt_cache_t* c)
+{
+    for (int i = 0; i < DB_STMT_COUNT; i++) {
+        if (c->stmt[i]) mysql_stmt_close(c->stmt[i]);
+        c->stmt[i] = NULL;
+    }
+}
 
-    // request_id
-    b[0].buffer_type = MYSQL_TYPE_STRING;
-    b[0].buffer = (char*)request_id;
-    b[0].buffer_length = l0;
-    b[0].length = &l0;
+// conn의 캐시 (create면 없을 때 빈 항목 할당)
+static db_stmt_cache_t* stmt_cache_of(MYSQL* conn, int create)
+{
+    db_stmt_cache_t* c = t_stmts;
+    if (c && __atomic_load_n(&c->conn, __ATOMIC_ACQUIRE) == conn) return c;
+
+    db_stmt_cache_t* empty = NULL;
+    pthread_mutex_lock(&g_stmt_caches_lock);
+    for (c = g_stmt_caches; c; c = c->next) {
+        if (c->conn == conn) break;
+        if (!c->conn && !empty) empty = c;
+    }
+    if (!c && create) {
+        c = empty;
+        if (!c && (c = (db_stmt_cache_t*)calloc(1, sizeof(db_stmt_cache_t))) != NULL) {
+            c->next = g_stmt_caches;
+            g_stmt_caches = c;
+        }
+        if (c) {
+            c->thread_id = mysql_thread_id(conn);
+            __atomic_store_n(&c->conn, conn, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&g_stmt_caches_lock);
 
-    // client_ip
-    b[1].buffer_type = MYSQL_TYPE_STRING;
-    b[1].buffer = (char*)client_ip;
-    b[1].buffer_length = l1;
-    b[1].length = &l1;
+    if (c) t_stmts = c;
+    return c;
+}
 
-    // client_port
-    b[2].buffer_type = MYSQL_TYPE_LONG;
-    b[2].buffer = &client_port;
-    b[2].is_null = &is_null_client_port;
+void db_release_statements(MYSQL* conn)
+{
+    if (!conn) return;
 
-    // server_ip
-    b[3].buffer_type = MYSQL_TYPE_STRING;
-    b[3].buffer = (char*)sip;
-    b[3].buffer_length = l2;
-    b[3].length = &l2;
-    b[3].is_null = &is_null_server_ip;
+    db_stmt_cache_t* c = stmt_cache_of(conn, 0);
+    if (!c) return;
 
-    // server_port
-    b[4].buffer_type = MYSQL_TYPE_LONG;
-    b[4].buffer = &server_port;
-    b[4].is_null = &is_null_server_port;
+    stmt_cache_clear(c);
+    pthread_mutex_lock(&g_stmt_caches_lock);
+    __atomic_store_n(&c->conn, NULL, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_stmt_caches_lock);
+}
 
-    // host
-    b[5].buffer_type = MYSQL_TYPE_STRING;
-    b[5].buffer = (char*)host;
-    b[5].buffer_length = l3;
-    b[5].length = &l3;
+void db_thread_cleanup(void)
+{
+    free(t_sql.buf);
+    memset(&t_sql, 0, sizeof(t_sql));
+    t_stmts = NULL;
+}
 
-    // path
-    b[6].buffer_type = MYSQL_TYPE_STRING;
-    b[6].buffer = (char*)p;
-    b[6].buffer_length = l4;
-    b[6].length = &l4;
+// 캐시된 문장 반환 (없으면 prepare)
+static MYSQL_STMT* stmt_get(MYSQL* conn, db_stmt_id_t id)
+{
+    db_stmt_cache_t* c = stmt_cache_of(conn, 1);
+    if (!c) return NULL;
 
-    // method
-    b[7].buffer_type = MYSQL_TYPE_STRING;
-    b[7].buffer = (char*)m;
-    b[7].buffer_length = l5;
-    b[7].length = &l5;
-    b[7].is_null = &is_null_method;
+    unsigned long tid = mysql_thread_id(conn);
+    if (c->thread_id != tid) {
+        stmt_cache_clear(c);
+        c->thread_id = tid;
+    }
 
-    // url_norm
-    b[8].buffer_type = MYSQL_TYPE_STRING;
-    b[8].buffer = (char*)u;
-    b[8].buffer_length = l6;
-    b[8].length = &l6;
-    b[8].is_null = &is_null_url_norm;
+    if (c->stmt[id]) return c->stmt[id];
 
-    if (mysql_stmt_bind_param(stmt, b) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
+    MYSQL_STMT* stmt = mysql_stmt_init(conn);
+    if (!stmt) {
+        t_last_errno = mysql_errno(conn);
+        fprintf(stderr, "[DB] mysql_stmt_init failed: %s\n", mysql_error(conn));
+        return NULL;
     }
 
-    // SQL 실행
-    if (mysql_stmt_execute(stmt) != 0) {
+    const char* sql = k_stmt_sql[id];
+    engine_metrics_count(EM_COUNT_DB_PREPARE, 1);
+    if (mysql_stmt_prepare(stmt, sql, (unsigned long)strlen(sql)) != 0) {
+        t_last_errno = mysql_stmt_errno(stmt);
+        fprintf(stderr, "[DB] mysql_stmt_prepare failed: %s\n", mysql_stmt_error(stmt));
         mysql_stmt_close(stmt);
-        return -1;
+        return NULL;
     }
 
-    // 생성된 log_id 반환
-    long long log_id = (long long)mysql_insert_id(conn);
-    mysql_stmt_close(stmt);
-    return log_id;
+    c->stmt[id] = stmt;
+    return stmt;
+}
+
+// 서버가 문장을 잃어버린 경우 (재연결, 테이블 변경 등): 다시 prepare하면 성공할 수 있음
+static int stmt_is_stale(unsigned int err)
+{
+    return err == ER_UNKNOWN_STMT_HANDLER || err == ER_NEED_REPREPARE ||
+           err == CR_SERVER_GONE_ERROR || err == CR_SERVER_LOST;
+}
+
+unsigned int db_last_errno(void)
+{
+    return t_last_errno;
+}
+
+int db_error_is_duplicate(unsigned int err)
+{
+#ifdef ER_DUP_ENTRY_WITH_KEY_NAME
+    if (err == ER_DUP_ENTRY_WITH_KEY_NAME) return 1;
+#endif
+    return err == ER_DUP_ENTRY;
+}
+
+int db_error_is_permanent(unsigned int err)
+{
+    switch (err) {
+    case ER_DUP_ENTRY:
+    case ER_BAD_NULL_ERROR:
+    case ER_NO_DEFAULT_FOR_FIELD:
+    case ER_DATA_TOO_LONG:
+    case ER_TRUNCATED_WRONG_VALUE:
+    case ER_TRUNCATED_WRONG_VALUE_FOR_FIELD:
+    case ER_WARN_DATA_OUT_OF_RANGE:
+    case ER_NO_REFERENCED_ROW_2:
+#ifdef ER_DUP_ENTRY_WITH_KEY_NAME
+    case ER_DUP_ENTRY_WITH_KEY_NAME:
+#endif
+#ifdef ER_CHECK_CONSTRAINT_VIOLATED
+    case ER_CHECK_CONSTRAINT_VIOLATED:
+#endif
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// bind + execute (성공 시 문장 반환, 결과 읽기/affected rows는 호출자)
+static MYSQL_STMT* stmt_execute(MYSQL* conn, db_stmt_id_t id, MYSQL_BIND* b)
+{
+    for (int attempt = 0; attempt < 2; attempt++) {
+        MYSQL_STMT* stmt = stmt_get(conn, id);
+        if (!stmt) return NULL;
+
+        if (mysql_stmt_bind_param(stmt, b) != 0) {
+            t_last_errno = mysql_stmt_errno(stmt);
+            fprintf(stderr, "[DB] mysql_stmt_bind_param failed: %s\n", mysql_stmt_error(stmt));
+            return NULL;
+        }
+
+        engine_metrics_count(EM_COUNT_DB_EXECUTE, 1);
+        if (mysql_stmt_execute(stmt) == 0) return stmt;
+
+        unsigned int err = mysql_stmt_errno(stmt);
+        t_last_errno = err;
+        // 트랜잭션 중 연결이 끊겼으면 앞선 쓰기가 사라졌으므로 이 문장만 다시 실행하지 않음
+        if (!stmt_is_stale(err) || (t_in_tx && (err == CR_SERVER_GONE_ERROR || err == CR_SERVER_LOST))) {
+            fprintf(stderr, "[DB] mysql_stmt_execute failed: %s\n", mysql_stmt_error(stmt));
+            return NULL;
+        }
+
+        // 재시도 전에 해당 문장만 버림 (재연결됐으면 stmt_get이 캐시 전체를 비움)
+        mysql_stmt_close(stmt);
+        t_stmts->stmt[id] = NULL;
+    }
+    return NULL;
 }
 
 // access_log의 탐지 결과(decision)를 업데이트
-void update_access_log_decision(
+int update_access_log_decision(
     MYSQL* conn,
     long long log_id,
     const char* decision,
@@ -153,19 +280,10 @@ void update_access_log_decision(
     long long policy_id,
     int engine_latency_ms)
 {
-    if (!conn || log_id <= 0 || !decision || !reason || !stage) return;
-
-    const char* sql =
-        "UPDATE access_log "
-        "SET decision=?, reason=?, decision_stage=?, policy_id=?, engine_latency_ms=? "
-        "WHERE log_id=?";
-
-    MYSQL_STMT* stmt = mysql_stmt_init(conn);
-    if (!stmt) return;
-
-    if (stmt_prepare(stmt, sql) != 0) {
-        mysql_stmt_close(stmt);
-        return;
+    if (!conn || log_id <= 0) return -1;
+    if (!decision || !reason || !stage) {
+        t_last_errno = ER_BAD_NULL_ERROR;
+        return -1;
     }
 
     MYSQL_BIND b[6];
@@ -205,17 +323,11 @@ void update_access_log_decision(
     b[5].buffer_type = MYSQL_TYPE_LONGLONG;
     b[5].buffer = &log_id;
 
-    if (mysql_stmt_bind_param(stmt, b) != 0) {
-        mysql_stmt_close(stmt);
-        return;
-    }
-
-    mysql_stmt_execute(stmt);
-    mysql_stmt_close(stmt);
+    return stmt_execute(conn, DB_STMT_UPDATE_DECISION, b) ? 0 : -1;
 }
 
 // HTTP Injection 처리 결과를 access_log에 기록
-void update_access_log_inject(
+int update_access_log_inject(
     MYSQL* conn,
     long long log_id,
     int attempted,
@@ -224,21 +336,7 @@ void update_access_log_inject(
     int latency_ms,
     int status_code)
 {
-    if (!conn || log_id <= 0) return;
-
-    const char* sql =
-        "UPDATE access_log SET "
-        "inject_attempted=?, inject_send=?, inject_errno=?, "
-        "inject_latency_ms=?, inject_status_code=? "
-        "WHERE log_id=?";
-
-    MYSQL_STMT* stmt = mysql_stmt_init(conn);
-    if (!stmt) return;
-
-    if (stmt_prepare(stmt, sql) != 0) {
-        mysql_stmt_close(stmt);
-        return;
-    }
+    if (!conn || log_id <= 0) return -1;
 
     MYSQL_BIND b[6];
     memset(b, 0, sizeof(b));
@@ -265,102 +363,63 @@ void update_access_log_inject(
     b[5].buffer_type = MYSQL_TYPE_LONGLONG;
     b[5].buffer = &log_id;
 
-    if (mysql_stmt_bind_param(stmt, b) != 0) {
-        mysql_stmt_close(stmt);
-        return;
-    }
-
-    mysql_stmt_execute(stmt);
-    mysql_stmt_close(stmt);
+    return stmt_execute(conn, DB_STMT_UPDATE_INJECT, b) ? 0 : -1;
 }
 
-// ai_analysis에서 다음 analysis_seq 값을 조회
-static int get_next_analysis_seq(MYSQL* conn, long long log_id, int* out_seq)
+// ai_analysis에서 다음 analysis_seq 값과 같은 model_version 분석 수를 조회
+static int get_next_analysis_seq(MYSQL* conn, long long log_id, const char* mv, int* out_seq, int* out_same)
 {
-    if (!conn || log_id <= 0 || !out_seq) return -1;
+    if (!conn || log_id <= 0 || !mv || !out_seq || !out_same) return -1;
 
-    const char* sql =
-        "SELECT COALESCE(MAX(analysis_seq), -1) + 1 "
-        "FROM ai_analysis WHERE log_id=?";
-
-    MYSQL_STMT* stmt = mysql_stmt_init(conn);
-    if (!stmt) return -1;
-
-    if (stmt_prepare(stmt, sql) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
+    unsigned long l_mv = (unsigned long)strlen(mv);
 
-    MYSQL_BIND inb[1];
+    MYSQL_BIND inb[2];
     memset(inb, 0, sizeof(inb));
 
-    inb[0].buffer_type = MYSQL_TYPE_LONGLONG;
-    inb[0].buffer = &log_id;
+    inb[0].buffer_type = MYSQL_TYPE_STRING;
+    inb[0].buffer = (char*)mv;
+    inb[0].buffer_length = l_mv;
+    inb[0].length = &l_mv;
 
-    if (mysql_stmt_bind_param(stmt, inb) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
+    inb[1].buffer_type = MYSQL_TYPE_LONGLONG;
+    inb[1].buffer = &log_id;
 
-    if (mysql_stmt_execute(stmt) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
+    MYSQL_STMT* stmt = stmt_execute(conn, DB_STMT_NEXT_ANALYSIS_SEQ, inb);
+    if (!stmt) return -1;
 
     int seq = 0;
+    long long same = 0;
 
-    MYSQL_BIND outb[1];
+    MYSQL_BIND outb[2];
     memset(outb, 0, sizeof(outb));
 
     outb[0].buffer_type = MYSQL_TYPE_LONG;
     outb[0].buffer = &seq;
 
-    if (mysql_stmt_bind_result(stmt, outb) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
+    outb[1].buffer_type = MYSQL_TYPE_LONGLONG;
+    outb[1].buffer = &same;
 
-    if (mysql_stmt_fetch(stmt) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
-
-    mysql_stmt_close(stmt);
+    // 캐시된 문장을 다시 실행할 수 있도록 결과는 항상 비움
+    int rc = (mysql_stmt_bind_result(stmt, outb) == 0 && mysql_stmt_fetch(stmt) == 0) ? 0 : -1;
+    if (rc != 0) t_last_errno = mysql_stmt_errno(stmt);
+    mysql_stmt_free_result(stmt);
+    if (rc != 0) return -1;
 
     *out_seq = seq;
+    *out_same = (same > 0) ? 1 : 0;
 
     return 0;
 }
 
-// AI 분석 결과를 ai_analysis 테이블에 저장
-int insert_ai_analysis_auto_seq(
+// ai_analysis INSERT (analysis_seq 지정)
+static int insert_ai_analysis_seq(
     MYSQL* conn,
     long long log_id,
     const ai_result_t* ar,
     int ai_response,
-    const char* error_code)
+    const char* error_code,
+    int seq)
 {
-    if (!conn || log_id <= 0) return -1;
-
-    int seq = 0;
-
-    // 다음 analysis_seq 값 조회
-    if (get_next_analysis_seq(conn, log_id, &seq) != 0)
-        return -1;
-
-    const char* sql =
-        "INSERT INTO ai_analysis "
-        "(log_id, analyzed_at, score, label, ai_response, latency_ms, model_version, error_code, analysis_seq) "
-        "VALUES (?, NOW(), ?, ?, ?, ?, ?, ?, ?)";
-
-    MYSQL_STMT* stmt = mysql_stmt_init(conn);
-    if (!stmt) return -1;
-
-    if (stmt_prepare(stmt, sql) != 0) {
-        mysql_stmt_close(stmt);
-        return -1;
-    }
-
     double score = (ar ? ar->score : 0.0);
     int latency = (ar ? (int)ar->latency_ms : 0);
 
@@ -410,19 +469,52 @@ int insert_ai_analysis_auto_seq(
     b[7].buffer_type = MYSQL_TYPE_LONG;
     b[7].buffer = &seq;
 
-    if (mysql_stmt_bind_param(stmt, b) != 0) {
-        mysql_stmt_close(stmt);
+    if (!stmt_execute(conn, DB_STMT_INSERT_AI_ANALYSIS, b))
         return -1;
-    }
 
-    if (mysql_stmt_execute(stmt) != 0) {
-        mysql_stmt_close(stmt);
+    return 0;
+}
+
+// AI 분석 결과를 ai_analysis 테이블에 저장 (같은 model_version 분석이 이미 있으면 건너뜀)
+int insert_ai_analysis_auto_seq(
+    MYSQL* conn,
+    long long log_id,
+    const ai_result_t* ar,
+    int ai_response,
+    const char* error_code)
+{
+    if (!conn || log_id <= 0) return -1;
+
+    int seq = 0;
+    int same = 0;
+    const char* mv = (ar && ar->model_version[0]) ? ar->model_version : "unknown";
+
+    // 다음 analysis_seq 값 조회
+    if (get_next_analysis_seq(conn, log_id, mv, &seq, &same) != 0)
         return -1;
-    }
 
-    mysql_stmt_close(stmt);
+    // spool 재생으로 같은 늦은 완료 기록이 다시 온 경우
+    if (same) return 0;
 
-    return 0;
+    return insert_ai_analysis_seq(conn, log_id, ar, ai_response, error_code, seq);
+}
+
+// review_event 제안 action / note (decision_stage 기준)
+static void review_event_fields(const char* decision_stage,
+                                char* proposed_action, size_t proposed_size,
+                                char* note, size_t note_size)
+{
+    // AI 단계에서 차단된 경우 정책 생성 제안
+    if (decision_stage && strcmp(decision_stage, "AI_STAGE") == 0)
+        snprintf(proposed_action, proposed_size, "%s", "CREATE_POLICY");
+    else
+        snprintf(proposed_action, proposed_size, "%s", "NO_ACTION");
+
+    // review_event 생성 사유 기록
+    if (decision_stage && decision_stage[0] != '\0')
+        snprintf(note, note_size, "auto-created from BLOCK event (%s)", decision_stage);
+    else
+        snprintf(note, note_size, "auto-created from BLOCK event");
 }
 
 // BLOCK 이벤트 발생 시 review_event 자동 생성
@@ -434,20 +526,6 @@ int insert_review_event_if_needed(
 {
     MYSQL_STMT* stmt = NULL;
 
-    const char* sql =
-        "INSERT INTO review_event ("
-        "log_id, status, proposed_action, reviewer_id, reviewed_at, created_at, note, generated_policy_id"
-        ") "
-        "SELECT "
-        "?, 'OPEN', ?, NULL, NULL, NOW(), ?, NULL "
-        "FROM DUAL "
-        "WHERE NOT EXISTS ("
-        "  SELECT 1 "
-        "  FROM review_event "
-        "  WHERE log_id = ? "
-        "    AND status IN ('OPEN', 'IN_PROGRESS')"
-        ")";
-
     MYSQL_BIND b[4];
 
     char proposed_action[32];
@@ -458,38 +536,12 @@ int insert_review_event_if_needed(
 
     if (!conn || log_id <= 0) return -1;
 
-    memset(proposed_action, 0, sizeof(proposed_action));
-    memset(note, 0, sizeof(note));
     memset(b, 0, sizeof(b));
-
-    // AI 단계에서 차단된 경우 정책 생성 제안
-    if (decision_stage && strcmp(decision_stage, "AI_STAGE") == 0)
-        snprintf(proposed_action, sizeof(proposed_action), "%s", "CREATE_POLICY");
-    else
-        snprintf(proposed_action, sizeof(proposed_action), "%s", "NO_ACTION");
-
-    // review_event 생성 사유 기록
-    if (decision_stage && decision_stage[0] != '\0')
-        snprintf(note, sizeof(note), "auto-created from BLOCK event (%s)", decision_stage);
-    else
-        snprintf(note, sizeof(note), "auto-created from BLOCK event");
+    review_event_fields(decision_stage, proposed_action, sizeof(proposed_action), note, sizeof(note));
 
     proposed_len = (unsigned long)strlen(proposed_action);
     note_len = (unsigned long)strlen(note);
 
-    stmt = mysql_stmt_init(conn);
-
-    if (!stmt) {
-        fprintf(stderr, "[DB] mysql_stmt_init failed for review_event insert\n");
-        return -1;
-    }
-
-    if (mysql_stmt_prepare(stmt, sql, (unsigned long)strlen(sql)) != 0) {
-        fprintf(stderr, "[DB] mysql_stmt_prepare failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        return -1;
-    }
-
     b[0].buffer_type = MYSQL_TYPE_LONGLONG;
     b[0].buffer = &log_id;
 
@@ -506,22 +558,11 @@ int insert_review_event_if_needed(
     b[3].buffer_type = MYSQL_TYPE_LONGLONG;
     b[3].buffer = &log_id;
 
-    if (mysql_stmt_bind_param(stmt, b) != 0) {
-        fprintf(stderr, "[DB] mysql_stmt_bind_param failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        return -1;
-    }
-
-    if (mysql_stmt_execute(stmt) != 0) {
-        fprintf(stderr, "[DB] mysql_stmt_execute failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        return -1;
-    }
+    stmt = stmt_execute(conn, DB_STMT_INSERT_REVIEW_EVENT, b);
+    if (!stmt) return -1;
 
     my_ulonglong affected = mysql_stmt_affected_rows(stmt);
 
-    mysql_stmt_close(stmt);
-
     if (affected > 0) {
         printf("[REVIEW_EVENT] created for log_id=%lld stage=%s\n",
                log_id,
@@ -531,3 +572,563 @@ int insert_review_event_if_needed(
 
     return 0;
 }
+
+static int sql_exec_literal(MYSQL* conn, const char* sql);
+
+// 레코드 1건의 쓰기를 한 트랜잭션으로 (중간 실패 시 rollback: 다시 기록할 때 처음부터)
+static int tx_begin(MYSQL* conn)
+{
+    if (sql_exec_literal(conn, "START TRANSACTION") != 0) return -1;
+    t_in_tx = 1;
+    return 0;
+}
+
+static int tx_end(MYSQL* conn, int rc)
+{
+    t_in_tx = 0;
+    if (rc != 0) {
+        (void)mysql_rollback(conn);
+        return -1;
+    }
+    return sql_exec_literal(conn, "COMMIT");
+}
+
+// 완료된 이벤트를 access_log에 1회 INSERT (+ ai_analysis / review_event), 트랜잭션은 호출자
+static long long insert_access_log_record_tx(MYSQL* conn, const access_log_record_t* rec)
+{
+    // 필수값 확인 (다시 기록해도 같은 결과: DB의 NOT NULL 거부와 같은 오류로 기록)
+    if (!rec->request_id[0] || !rec->client_ip || !rec->host) {
+        t_last_errno = ER_BAD_NULL_ERROR;
+        return -1;
+    }
+
+    MYSQL_BIND b[20];
+    memset(b, 0, sizeof(b));
+
+    // 기본값 보정
+    const char* p = (rec->path && rec->path[0]) ? rec->path : "/";
+    const char* m = (rec->method && rec->method[0]) ? rec->method : NULL;
+    const char* u = (rec->url_norm && rec->url_norm[0]) ? rec->url_norm : NULL;
+    const char* sip = (rec->server_ip && rec->server_ip[0]) ? rec->server_ip : NULL;
+
+    // 판정 전 flush: 기존 최초 INSERT와 같은 placeholder
+    const char* decision = rec->decision ? rec->decision : "ERROR";
+    const char* reason = rec->decision ? rec->reason : "SYSTEM";
+    const char* stage = rec->decision ? rec->decision_stage : "FAIL_STAGE";
+
+    long long detect_sec = rec->detect_ts_ms / 1000;
+    int client_port = rec->client_port;
+    int server_port = rec->server_port;
+    long long policy_id = rec->policy_id;
+    int latency = rec->engine_latency_ms;
+    int inj_attempted = rec->inject_attempted ? 1 : 0;
+    int inj_send = rec->inject_send;
+    int inj_errno = rec->inject_errno;
+    int inj_latency = rec->inject_latency_ms;
+    int inj_status = rec->inject_status_code;
+
+    // 문자열 길이 계산
+    unsigned long l0 = (unsigned long)strlen(rec->request_id);
+    unsigned long l1 = (unsigned long)strlen(rec->client_ip);
+    unsigned long l2 = sip ? (unsigned long)strlen(sip) : 0;
+    unsigned long l3 = (unsigned long)strlen(rec->host);
+    unsigned long l4 = (unsigned long)strlen(p);
+    unsigned long l5 = m ? (unsigned long)strlen(m) : 0;
+    unsigned long l6 = u ? (unsigned long)strlen(u) : 0;
+    unsigned long l7 = (unsigned long)strlen(decision);
+    unsigned long l8 = (unsigned long)strlen(reason);
+    unsigned long l9 = (unsigned long)strlen(stage);
+
+    // NULL 여부 설정
+    my_bool is_null_client_port = (client_port <= 0) ? 1 : 0;
+    my_bool is_null_server_ip = (sip == NULL) ? 1 : 0;
+    my_bool is_null_server_port = (server_port <= 0) ? 1 : 0;
+    my_bool is_null_method = (m == NULL) ? 1 : 0;
+    my_bool is_null_url_norm = (u == NULL) ? 1 : 0;
+    my_bool is_null_policy = (policy_id == 0) ? 1 : 0;
+    my_bool is_null_latency = (latency < 0) ? 1 : 0;
+    my_bool is_null_inject = inj_attempted ? 0 : 1;
+    my_bool is_null_inj_errno = (!inj_attempted || inj_send == 1) ? 1 : 0;
+
+    // request_id
+    b[0].buffer_type = MYSQL_TYPE_STRING;
+    b[0].buffer = (char*)rec->request_id;
+    b[0].buffer_length = l0;
+    b[0].length = &l0;
+
+    // detect_timestamp (FROM_UNIXTIME)
+    b[1].buffer_type = MYSQL_TYPE_LONGLONG;
+    b[1].buffer = &detect_sec;
+
+    // client_ip
+    b[2].buffer_type = MYSQL_TYPE_STRING;
+    b[2].buffer = (char*)rec->client_ip;
+    b[2].buffer_length = l1;
+    b[2].length = &l1;
+
+    // client_port
+    b[3].buffer_type = MYSQL_TYPE_LONG;
+    b[3].buffer = &client_port;
+    b[3].is_null = &is_null_client_port;
+
+    // server_ip
+    b[4].buffer_type = MYSQL_TYPE_STRING;
+    b[4].buffer = (char*)sip;
+    b[4].buffer_length = l2;
+    b[4].length = &l2;
+    b[4].is_null = &is_null_server_ip;
+
+    // server_port
+    b[5].buffer_type = MYSQL_TYPE_LONG;
+    b[5].buffer = &server_port;
+    b[5].is_null = &is_null_server_port;
+
+    // host
+    b[6].buffer_type = MYSQL_TYPE_STRING;
+    b[6].buffer = (char*)rec->host;
+    b[6].buffer_length = l3;
+    b[6].length = &l3;
+
+    // path
+    b[7].buffer_type = MYSQL_TYPE_STRING;
+    b[7].buffer = (char*)p;
+    b[7].buffer_length = l4;
+    b[7].length = &l4;
+
+    // method
+    b[8].buffer_type = MYSQL_TYPE_STRING;
+    b[8].buffer = (char*)m;
+    b[8].buffer_length = l5;
+    b[8].length = &l5;
+    b[8].is_null = &is_null_method;
+
+    // url_norm
+    b[9].buffer_type = MYSQL_TYPE_STRING;
+    b[9].buffer = (char*)u;
+    b[9].buffer_length = l6;
+    b[9].length = &l6;
+    b[9].is_null = &is_null_url_norm;
+
+    // decision / reason / decision_stage
+    b[10].buffer_type = MYSQL_TYPE_STRING;
+    b[10].buffer = (char*)decision;
+    b[10].buffer_length = l7;
+    b[10].length = &l7;
+
+    b[11].buffer_type = MYSQL_TYPE_STRING;
+    b[11].buffer = (char*)reason;
+    b[11].buffer_length = l8;
+    b[11].length = &l8;
+
+    b[12].buffer_type = MYSQL_TYPE_STRING;
+    b[12].buffer = (char*)stage;
+    b[12].buffer_length = l9;
+    b[12].length = &l9;
+
+    // policy_id / engine_latency_ms
+    b[13].buffer_type = MYSQL_TYPE_LONGLONG;
+    b[13].buffer = &policy_id;
+    b[13].is_null = &is_null_policy;
+
+    b[14].buffer_type = MYSQL_TYPE_LONG;
+    b[14].buffer = &latency;
+    b[14].is_null = &is_null_latency;
+
+    // inject_* (주입하지 않은 이벤트는 attempted=0, 나머지 NULL)
+    b[15].buffer_type = MYSQL_TYPE_LONG;
+    b[15].buffer = &inj_attempted;
+
+    b[16].buffer_type = MYSQL_TYPE_LONG;
+    b[16].buffer = &inj_send;
+    b[16].is_null = &is_null_inject;
+
+    b[17].buffer_type = MYSQL_TYPE_LONG;
+    b[17].buffer = &inj_errno;
+    b[17].is_null = &is_null_inj_errno;
+
+    b[18].buffer_type = MYSQL_TYPE_LONG;
+    b[18].buffer = &inj_latency;
+    b[18].is_null = &is_null_inject;
+
+    b[19].buffer_type = MYSQL_TYPE_LONG;
+    b[19].buffer = &inj_status;
+    b[19].is_null = &is_null_inject;
+
+    // SQL 실행
+    MYSQL_STMT* stmt = stmt_execute(conn, DB_STMT_INSERT_ACCESS_LOG, b);
+    if (!stmt) return -1;
+
+    // 생성된 log_id
+    long long log_id = (long long)mysql_stmt_insert_id(stmt);
+
+    // 새 로그의 첫 분석이므로 analysis_seq 조회 없이 0
+    if (rec->has_ai &&
+        insert_ai_analysis_seq(conn, log_id, &rec->ai, rec->ai_response,
+                               rec->ai_response ? NULL : rec->ai_error_code, 0) != 0) {
+        return -1;
+    }
+    if (rec->review_needed && insert_review_event_if_needed(conn, log_id, stage) < 0) return -1;
+
+    return log_id;
+}
+
+long long insert_access_log_record(MYSQL* conn, const access_log_record_t* rec)
+{
+    t_last_errno = 0;
+    if (!conn || !rec) return -1;
+
+    if (tx_begin(conn) != 0) return -1;
+    long long log_id = insert_access_log_record_tx(conn, rec);
+    if (tx_end(conn, log_id < 0 ? -1 : 0) != 0) return -1;
+    return log_id;
+}
+
+// request_id로 log_id 조회 (없으면 0, 실패 시 -1)
+static long long find_access_log_id(MYSQL* conn, const char* request_id)
+{
+    unsigned long l0 = (unsigned long)strlen(request_id);
+
+    MYSQL_BIND inb[1];
+    memset(inb, 0, sizeof(inb));
+
+    inb[0].buffer_type = MYSQL_TYPE_STRING;
+    inb[0].buffer = (char*)request_id;
+    inb[0].buffer_length = l0;
+    inb[0].length = &l0;
+
+    MYSQL_STMT* stmt = stmt_execute(conn, DB_STMT_FIND_LOG_ID, inb);
+    if (!stmt) return -1;
+
+    long long log_id = 0;
+
+    MYSQL_BIND outb[1];
+    memset(outb, 0, sizeof(outb));
+
+    outb[0].buffer_type = MYSQL_TYPE_LONGLONG;
+    outb[0].buffer = &log_id;
+
+    long long rc = -1;
+    if (mysql_stmt_bind_result(stmt, outb) == 0) {
+        int f = mysql_stmt_fetch(stmt);
+        if (f == 0) rc = log_id;
+        else if (f == MYSQL_NO_DATA) rc = 0;
+    }
+    if (rc < 0) t_last_errno = mysql_stmt_errno(stmt);
+    mysql_stmt_free_result(stmt);
+    return rc;
+}
+
+// 늦은 완료 기록 (첫 실패에서 중단, t_last_errno는 실패한 문장의 오류)
+static int update_access_log_record_tx(MYSQL* conn, const access_log_record_t* rec)
+{
+    long long log_id = find_access_log_id(conn, rec->request_id);
+    if (log_id < 0) return -1;
+
+    // flush 기록이 없으면 (버려졌거나 실패) 완료 레코드로 새로 INSERT
+    if (log_id == 0) return insert_access_log_record_tx(conn, rec) < 0 ? -1 : 0;
+
+    if (rec->has_ai &&
+        insert_ai_analysis_auto_seq(conn, log_id, &rec->ai, rec->ai_response,
+                                    rec->ai_response ? NULL : rec->ai_error_code) != 0) {
+        return -1;
+    }
+    if (rec->decision &&
+        update_access_log_decision(conn, log_id, rec->decision, rec->reason, rec->decision_stage,
+                                   rec->policy_id, rec->engine_latency_ms) != 0) {
+        return -1;
+    }
+    if (rec->inject_attempted &&
+        update_access_log_inject(conn, log_id, rec->inject_attempted, rec->inject_send,
+                                 rec->inject_errno, rec->inject_latency_ms, rec->inject_status_code) != 0) {
+        return -1;
+    }
+    if (rec->review_needed && insert_review_event_if_needed(conn, log_id, rec->decision_stage) < 0) return -1;
+    return 0;
+}
+
+// 타임아웃 flush로 먼저 저장된 이벤트에 늦게 끝난 판정 / AI / 주입 결과 추가 기록
+int update_access_log_record(MYSQL* conn, const access_log_record_t* rec)
+{
+    t_last_errno = 0;
+    if (!conn || !rec) return -1;
+    if (!rec->request_id[0]) {
+        t_last_errno = ER_BAD_NULL_ERROR;
+        return -1;
+    }
+
+    if (tx_begin(conn) != 0) return -1;
+    int rc = update_access_log_record_tx(conn, rec);
+    return tx_end(conn, rc);
+}
+
+static int sql_reserve(sql_buf_t* sb, size_t extra)
+{
+    if (sb->oom) return -1;
+    if (sb->len + extra + 1 <= sb->cap) return 0;
+
+    size_t cap = sb->cap ? sb->cap : 16384;
+    while (cap < sb->len + extra + 1) cap *= 2;
+
+    char* p = (char*)realloc(sb->buf, cap);
+    if (!p) {
+        sb->oom = 1;
+        return -1;
+    }
+    sb->buf = p;
+    sb->cap = cap;
+    return 0;
+}
+
+static void sql_printf(sql_buf_t* sb, const char* fmt, ...)
+{
+    for (size_t need = 128;;) {
+        if (sql_reserve(sb, need) != 0) return;
+
+        size_t room = sb->cap - sb->len;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(sb->buf + sb->len, room, fmt, ap);
+        va_end(ap);
+
+        if (n < 0) {
+            sb->oom = 1;
+            return;
+        }
+        if ((size_t)n < room) {
+            sb->len += (size_t)n;
+            return;
+        }
+        need = (size_t)n;
+    }
+}
+
+// 문자열 리터럴 ('...' escape) 또는 NULL
+static void sql_str(sql_buf_t* sb, MYSQL* conn, const char* s)
+{
+    if (!s) {
+        sql_printf(sb, "NULL");
+        return;
+    }
+
+    size_t n = strlen(s);
+    if (sql_reserve(sb, n * 2 + 2) != 0) return;
+
+    sb->buf[sb->len++] = '\'';
+    sb->len += mysql_real_escape_string(conn, sb->buf + sb->len, s, (unsigned long)n);
+    sb->buf[sb->len++] = '\'';
+    sb->buf[sb->len] = '\0';
+}
+
+static void sql_int(sql_buf_t* sb, long long v, int is_null)
+{
+    if (is_null) sql_printf(sb, "NULL");
+    else sql_printf(sb, "%lld", v);
+}
+
+// 새 행의 log_id (같은 배치에서 INSERT한 access_log 행, request_id UNIQUE)
+static void sql_log_id_of(sql_buf_t* sb, MYSQL* conn, const char* request_id)
+{
+    sql_printf(sb, "(SELECT log_id FROM access_log WHERE request_id=");
+    sql_str(sb, conn, request_id);
+    sql_printf(sb, ")");
+}
+
+static int sql_exec(MYSQL* conn, sql_buf_t* sb)
+{
+    if (sb->oom) {
+        fprintf(stderr, "[DB] batch statement buffer allocation failed\n");
+        return -1;
+    }
+
+    engine_metrics_count(EM_COUNT_DB_EXECUTE, 1);
+    if (mysql_real_query(conn, sb->buf, (unsigned long)sb->len) != 0) {
+        t_last_errno = mysql_errno(conn);
+        fprintf(stderr, "[DB] batch insert failed: %s\n", mysql_error(conn));
+        return -1;
+    }
+    return 0;
+}
+
+// insert_access_log_record와 같은 값 (기본값 보정 / NULL 처리)
+static void sql_access_log_row(sql_buf_t* sb, MYSQL* conn, const access_log_record_t* rec)
+{
+    const char* p = (rec->path && rec->path[0]) ? rec->path : "/";
+    const char* m = (rec->method && rec->method[0]) ? rec->method : NULL;
+    const char* u = (rec->url_norm && rec->url_norm[0]) ? rec->url_norm : NULL;
+    const char* sip = (rec->server_ip && rec->server_ip[0]) ? rec->server_ip : NULL;
+
+    const char* decision = rec->decision ? rec->decision : "ERROR";
+    const char* reason = rec->decision ? rec->reason : "SYSTEM";
+    const char* stage = rec->decision ? rec->decision_stage : "FAIL_STAGE";
+
+    int attempted = rec->inject_attempted ? 1 : 0;
+
+    sql_printf(sb, "(");
+    sql_str(sb, conn, rec->request_id);
+    sql_printf(sb, ", FROM_UNIXTIME(%lld), ", (long long)(rec->detect_ts_ms / 1000));
+    sql_str(sb, conn, rec->client_ip);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->client_port, rec->client_port <= 0);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, sip);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->server_port, rec->server_port <= 0);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, rec->host);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, p);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, m);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, u);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, decision);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, reason);
+    sql_printf(sb, ", ");
+    sql_str(sb, conn, stage);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->policy_id, rec->policy_id == 0);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->engine_latency_ms, rec->engine_latency_ms < 0);
+    sql_printf(sb, ", %d, ", attempted);
+    sql_int(sb, rec->inject_send, !attempted);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->inject_errno, !attempted || rec->inject_send == 1);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->inject_latency_ms, !attempted);
+    sql_printf(sb, ", ");
+    sql_int(sb, rec->inject_status_code, !attempted);
+    sql_printf(sb, ")");
+}
+
+static int sql_exec_literal(MYSQL* conn, const char* sql)
+{
+    engine_metrics_count(EM_COUNT_DB_EXECUTE, 1);
+    if (mysql_real_query(conn, sql, (unsigned long)strlen(sql)) != 0) {
+        t_last_errno = mysql_errno(conn);
+        fprintf(stderr, "[DB] %s failed: %s\n", sql, mysql_error(conn));
+        return -1;
+    }
+    return 0;
+}
+
+static int insert_access_log_batch_tx(MYSQL* conn, const access_log_record_t* const* recs, int n);
+
+// 완료된 이벤트 n건 저장: 테이블별 multi-row INSERT 1회 (한 트랜잭션)
+// - 중간 실패 시 rollback: 호출자는 배치 전체를 다시 기록하거나 spool (부분 저장 없음)
+int insert_access_log_batch(MYSQL* conn, const access_log_record_t* const* recs, int n)
+{
+    t_last_errno = 0;
+
+    if (!conn || !recs || n <= 0) return -1;
+
+    if (tx_begin(conn) != 0) return -1;
+    if (tx_end(conn, insert_access_log_batch_tx(conn, recs, n)) != 0) return -1;
+
+    for (int i = 0; i < n; i++) {
+        if (!recs[i]->review_needed) continue;
+        printf("[REVIEW_EVENT] created for request_id=%s stage=%s\n",
+               recs[i]->request_id,
+               recs[i]->decision_stage ? recs[i]->decision_stage : "UNKNOWN");
+    }
+    return 0;
+}
+
+static int insert_access_log_batch_tx(MYSQL* conn, const access_log_record_t* const* recs, int n)
+{
+    sql_buf_t* sb = &t_sql;
+
+    // access_log
+    sb->len = 0;
+    sb->oom = 0;
+    sql_printf(sb,
+        "INSERT INTO access_log "
+        "(request_id, detect_timestamp, client_ip, client_port, server_ip, server_port, "
+        " host, path, method, url_norm, decision, reason, decision_stage, policy_id, engine_latency_ms, "
+        " inject_attempted, inject_send, inject_errno, inject_latency_ms, inject_status_code) VALUES ");
+    for (int i = 0; i < n; i++) {
+        const access_log_record_t* rec = recs[i];
+        if (!rec->request_id[0] || !rec->client_ip || !rec->host) return -1;
+        if (i > 0) sql_printf(sb, ", ");
+        sql_access_log_row(sb, conn, rec);
+    }
+    if (sql_exec(conn, sb) != 0) return -1;
+
+    // ai_analysis (새 로그의 첫 분석: analysis_seq 0)
+    int rows = 0;
+    sb->len = 0;
+    sb->oom = 0;
+    sql_printf(sb,
+        "INSERT INTO ai_analysis "
+        "(log_id, analyzed_at, score, label, ai_response, latency_ms, model_version, error_code, analysis_seq) "
+        "VALUES ");
+    for (int i = 0; i < n; i++) {
+        const access_log_record_t* rec = recs[i];
+        if (!rec->has_ai) continue;
+
+        const ai_result_t* ar = &rec->ai;
+        if (rows++ > 0) sql_printf(sb, ", ");
+        sql_printf(sb, "(");
+        sql_log_id_of(sb, conn, rec->request_id);
+        sql_printf(sb, ", NOW(), %.17g, ", ar->score);
+        sql_str(sb, conn, ar->label[0] ? ar->label : NULL);
+        sql_printf(sb, ", %d, %d, ", rec->ai_response ? 1 : 0, (int)ar->latency_ms);
+        sql_str(sb, conn, ar->model_version[0] ? ar->model_version : "unknown");
+        sql_printf(sb, ", ");
+        sql_str(sb, conn, rec->ai_response ? NULL : rec->ai_error_code);
+        sql_printf(sb, ", 0)");
+    }
+    if (rows > 0 && sql_exec(conn, sb) != 0) return -1;
+
+    // review_event (새 로그라 열린 review가 없으므로 중복 확인 생략)
+    rows = 0;
+    sb->len = 0;
+    sb->oom = 0;
+    sql_printf(sb,
+        "INSERT INTO review_event ("
+        "log_id, status, proposed_action, reviewer_id, reviewed_at, created_at, note, generated_policy_id"
+        ") VALUES ");
+    for (int i = 0; i < n; i++) {
+        const access_log_record_t* rec = recs[i];
+        if (!rec->review_needed) continue;
+
+        char proposed_action[32];
+        char note[255];
+        const char* stage = rec->decision ? rec->decision_stage : "FAIL_STAGE";
+        review_event_fields(stage, proposed_action, sizeof(proposed_action), note, sizeof(note));
+
+        if (rows++ > 0) sql_printf(sb, ", ");
+        sql_printf(sb, "(");
+        sql_log_id_of(sb, conn, rec->request_id);
+        sql_printf(sb, ", 'OPEN', ");
+        sql_str(sb, conn, proposed_action);
+        sql_printf(sb, ", NULL, NULL, NOW(), ");
+        sql_str(sb, conn, note);
+        sql_printf(sb, ", NULL)");
+    }
+    if (rows > 0 && sql_exec(conn, sb) != 0) return -1;
+
+    return 0;
+}
+
+static const char* copy_str(char* dst, size_t dstsz, const char* src)
+{
+    if (!src) return NULL;
+    snprintf(dst, dstsz, "%s", src);
+    return dst;
+}
+
+void access_log_record_copy(access_log_record_copy_t* dst, const access_log_record_t* src)
+{
+    dst->rec = *src;
+    dst->rec.client_ip = copy_str(dst->client_ip, sizeof(dst->client_ip), src->client_ip);
+    dst->rec.server_ip = copy_str(dst->server_ip, sizeof(dst->server_ip), src->server_ip);
+    dst->rec.host = copy_str(dst->host, sizeof(dst->host), src->host);
+    dst->rec.path = copy_str(dst->path, sizeof(dst->path), src->path);
+    dst->rec.method = copy_str(dst->method, sizeof(dst->method), src->method);
+    dst->rec.url_norm = copy_str(dst->url_norm, sizeof(dst->url_norm), src->url_norm);
+    dst->rec.decision = copy_str(dst->decision, sizeof(dst->decision), src->decision);
+    dst->rec.reason = copy_str(dst->reason, sizeof(dst->reason), src->reason);
+    dst->rec.decision_stage = copy_str(dst->decision_stage, sizeof(dst->decision_stage), src->decision_stage);
+}
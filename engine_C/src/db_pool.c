@@ -0,0 +1,335 @@
+// src/db_pool.c
+#include "db_pool.h"
+#include "db_function.h"
+#include "engine_metrics.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    MYSQL*   conn;          // NULL이면 빈 slot (다음 acquire가 연결)
+    int      leased;
+    uint64_t owner;         // 마지막으로 쓴 스레드 (affinity)
+    uint64_t last_used_ns;
+} pool_slot_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int             enabled;
+
+    char host[128];
+    char user[64];
+    char pass[128];
+    char name[64];
+    int  port;
+
+    int      max_conns;
+    uint64_t timeout_ns;
+    uint64_t health_idle_ns;
+    uint64_t backoff_min_ns;
+    uint64_t backoff_max_ns;
+
+    unsigned int connect_timeout_sec;  // 0이면 설정 안 함
+    unsigned int read_timeout_sec;
+    unsigned int write_timeout_sec;
+
+    pool_slot_t* slots;
+    int          open;           // 연결된 slot 수
+    int          waiters;
+    uint64_t     backoff_ns;     // 다음 연결 실패 시 대기 (0이면 backoff 아님)
+    uint64_t     retry_at_ns;    // 이 시각 전에는 새 연결 시도 안 함
+} db_pool_t;
+
+static db_pool_t g_pool = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static uint64_t g_next_token = 0;
+
+// 스레드별 상태: affinity / 중첩 acquire
+static __thread uint64_t t_token = 0;
+static __thread int      t_home = -1;   // 마지막으로 쓴 slot
+static __thread int      t_slot = -1;   // 지금 빌린 slot
+static __thread int      t_depth = 0;
+static __thread int      t_failed = 0;  // 중첩 release 중 실패 보고
+
+static uint64_t thread_token(void)
+{
+    if (t_token == 0) t_token = __atomic_add_fetch(&g_next_token, 1, __ATOMIC_RELAXED);
+    return t_token;
+}
+
+static MYSQL* pool_connect(void)
+{
+    MYSQL* conn = mysql_init(NULL);
+    if (!conn) {
+        fprintf(stderr, "[DB_POOL] mysql_init failed\n");
+        return NULL;
+    }
+
+    mysql_options(conn, MYSQL_SET_CHARSET_NAME, "utf8mb4");
+
+    unsigned int proto = MYSQL_PROTOCOL_TCP;
+    mysql_options(conn, MYSQL_OPT_PROTOCOL, &proto);
+
+    if (g_pool.connect_timeout_sec) mysql_options(conn, MYSQL_OPT_CONNECT_TIMEOUT, &g_pool.connect_timeout_sec);
+    if (g_pool.read_timeout_sec) mysql_options(conn, MYSQL_OPT_READ_TIMEOUT, &g_pool.read_timeout_sec);
+    if (g_pool.write_timeout_sec) mysql_options(conn, MYSQL_OPT_WRITE_TIMEOUT, &g_pool.write_timeout_sec);
+
+    if (!mysql_real_connect(conn, g_pool.host, g_pool.user, g_pool.pass, g_pool.name,
+                            (unsigned int)g_pool.port, NULL, 0)) {
+        fprintf(stderr,
+                "[DB_POOL] mysql connect failed: host=%s port=%d user=%s db=%s err=%s\n",
+                g_pool.host, g_pool.port, g_pool.user, g_pool.name, mysql_error(conn));
+        mysql_close(conn);
+        return NULL;
+    }
+    return conn;
+}
+
+// 연결을 가진 스레드에서 호출 (캐시된 문장 정리 후 닫음)
+static void pool_close(MYSQL* conn)
+{
+    db_release_statements(conn);
+    mysql_close(conn);
+    engine_metrics_count(EM_COUNT_DB_POOL_CLOSE, 1);
+}
+
+int db_pool_init(const db_pool_config_t* cfg)
+{
+    if (!cfg || g_pool.enabled) return -1;
+
+    snprintf(g_pool.host, sizeof(g_pool.host), "%s", cfg->host ? cfg->host : "127.0.0.1");
+    snprintf(g_pool.user, sizeof(g_pool.user), "%s", cfg->user ? cfg->user : "");
+    snprintf(g_pool.pass, sizeof(g_pool.pass), "%s", cfg->pass ? cfg->pass : "");
+    snprintf(g_pool.name, sizeof(g_pool.name), "%s", cfg->name ? cfg->name : "");
+    g_pool.port = cfg->port;
+
+    g_pool.max_conns = cfg->max_conns > 0 ? cfg->max_conns : 1;
+    g_pool.timeout_ns = (uint64_t)(cfg->acquire_timeout_ms > 0 ? cfg->acquire_timeout_ms : 0) * 1000000ull;
+    g_pool.health_idle_ns = (uint64_t)(cfg->health_idle_ms > 0 ? cfg->health_idle_ms : 0) * 1000000ull;
+    g_pool.backoff_min_ns = (uint64_t)(cfg->backoff_min_ms > 0 ? cfg->backoff_min_ms : 100) * 1000000ull;
+    g_pool.backoff_max_ns = (uint64_t)(cfg->backoff_max_ms > 0 ? cfg->backoff_max_ms : 5000) * 1000000ull;
+    if (g_pool.backoff_max_ns < g_pool.backoff_min_ns) g_pool.backoff_max_ns = g_pool.backoff_min_ns;
+    g_pool.connect_timeout_sec = (unsigned int)(cfg->connect_timeout_sec > 0 ? cfg->connect_timeout_sec : 0);
+    g_pool.read_timeout_sec = (unsigned int)(cfg->read_timeout_sec > 0 ? cfg->read_timeout_sec : 0);
+    g_pool.write_timeout_sec = (unsigned int)(cfg->write_timeout_sec > 0 ? cfg->write_timeout_sec : 0);
+
+    g_pool.slots = (pool_slot_t*)calloc((size_t)g_pool.max_conns, sizeof(pool_slot_t));
+    if (!g_pool.slots) return -1;
+
+    // timedwait 기준 시계를 engine_metrics_now_ns와 같은 monotonic으로
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_pool.cond, &ca);
+    pthread_condattr_destroy(&ca);
+
+    g_pool.open = 0;
+    g_pool.waiters = 0;
+    g_pool.backoff_ns = 0;
+    g_pool.retry_at_ns = 0;
+    __atomic_store_n(&g_pool.enabled, 1, __ATOMIC_RELEASE);
+
+    printf("[DB_POOL] max_conns=%d acquire_timeout_ms=%d health_idle_ms=%d backoff_ms=%d..%d "
+           "timeout_sec=connect:%u/read:%u/write:%u\n",
+           g_pool.max_conns, cfg->acquire_timeout_ms, cfg->health_idle_ms,
+           (int)(g_pool.backoff_min_ns / 1000000ull), (int)(g_pool.backoff_max_ns / 1000000ull),
+           g_pool.connect_timeout_sec, g_pool.read_timeout_sec, g_pool.write_timeout_sec);
+    return 0;
+}
+
+// 모든 연결 스레드가 멈춘 뒤 호출
+void db_pool_shutdown(void)
+{
+    if (!g_pool.enabled) return;
+
+    pthread_mutex_lock(&g_pool.lock);
+    __atomic_store_n(&g_pool.enabled, 0, __ATOMIC_RELEASE);
+    for (int i = 0; i < g_pool.max_conns; i++) {
+        pool_slot_t* s = &g_pool.slots[i];
+        if (s->leased) fprintf(stderr, "[DB_POOL] slot %d still leased at shutdown\n", i);
+        if (s->conn) pool_close(s->conn);
+        s->conn = NULL;
+    }
+    g_pool.open = 0;
+    pthread_mutex_unlock(&g_pool.lock);
+
+    pthread_cond_destroy(&g_pool.cond);
+    free(g_pool.slots);
+    g_pool.slots = NULL;
+
+    t_home = -1;
+    t_slot = -1;
+    t_depth = 0;
+}
+
+int db_pool_enabled(void)
+{
+    return __atomic_load_n(&g_pool.enabled, __ATOMIC_ACQUIRE);
+}
+
+// lock 안에서: 빌릴 slot 선택 (-1이면 없음)
+// 우선순위: 자기 slot -> 다른 스레드가 쓰지 않던 idle 연결 -> 아무 idle 연결 -> 빈 slot(연결 가능할 때)
+static int pick_slot_locked(uint64_t now, uint64_t token, int* need_connect)
+{
+    *need_connect = 0;
+
+    if (t_home >= 0 && t_home < g_pool.max_conns) {
+        pool_slot_t* s = &g_pool.slots[t_home];
+        if (!s->leased && s->conn && s->owner == token) return t_home;
+    }
+
+    int idle_free = -1, idle_any = -1, empty = -1;
+    for (int i = 0; i < g_pool.max_conns; i++) {
+        pool_slot_t* s = &g_pool.slots[i];
+        if (s->leased) continue;
+        if (s->conn) {
+            if (s->owner == 0 && idle_free < 0) idle_free = i;
+            if (idle_any < 0) idle_any = i;
+        } else if (empty < 0) {
+            empty = i;
+        }
+    }
+
+    if (idle_free >= 0) return idle_free;
+    if (idle_any >= 0) return idle_any;
+    if (empty >= 0 && now >= g_pool.retry_at_ns) {
+        *need_connect = 1;
+        return empty;
+    }
+    return -1;
+}
+
+static void connect_failed_locked(uint64_t now)
+{
+    g_pool.backoff_ns = g_pool.backoff_ns ? g_pool.backoff_ns * 2 : g_pool.backoff_min_ns;
+    if (g_pool.backoff_ns > g_pool.backoff_max_ns) g_pool.backoff_ns = g_pool.backoff_max_ns;
+    g_pool.retry_at_ns = now + g_pool.backoff_ns;
+}
+
+MYSQL* db_pool_acquire(int timeout_ms)
+{
+    if (!db_pool_enabled()) return NULL;
+
+    // 중첩 acquire: 이미 빌린 연결
+    if (t_depth > 0) {
+        t_depth++;
+        return g_pool.slots[t_slot].conn;
+    }
+
+    uint64_t token = thread_token();
+    uint64_t t0 = engine_metrics_now_ns();
+    uint64_t wait_ns = (timeout_ms < 0) ? g_pool.timeout_ns : (uint64_t)timeout_ms * 1000000ull;
+    uint64_t deadline = t0 + wait_ns;
+
+    int idx, need_connect;
+    pthread_mutex_lock(&g_pool.lock);
+    for (;;) {
+        uint64_t now = engine_metrics_now_ns();
+        idx = pick_slot_locked(now, token, &need_connect);
+        if (idx >= 0) break;
+
+        // 연결 가능한 빈 slot이 있는데 backoff 중: DB 장애로 보고 기다리지 않음
+        int in_backoff = (g_pool.open < g_pool.max_conns);
+        if (in_backoff || now >= deadline) {
+            pthread_mutex_unlock(&g_pool.lock);
+            engine_metrics_count(EM_COUNT_DB_POOL_TIMEOUT, 1);
+            engine_metrics_record(EM_STAGE_DB_POOL_WAIT, engine_metrics_now_ns() - t0);
+            return NULL;
+        }
+
+        struct timespec ts;
+        ts.tv_sec = (time_t)(deadline / 1000000000ull);
+        ts.tv_nsec = (long)(deadline % 1000000000ull);
+        g_pool.waiters++;
+        int rc = pthread_cond_timedwait(&g_pool.cond, &g_pool.lock, &ts);
+        g_pool.waiters--;
+        if (rc != 0 && rc != ETIMEDOUT && rc != EINTR) deadline = now;
+    }
+
+    pool_slot_t* s = &g_pool.slots[idx];
+    int switched = (idx != t_home && t_home >= 0);
+    s->leased = 1;
+    s->owner = token;
+    if (need_connect) g_pool.open++;  // 연결 중인 slot도 상한에 포함
+    pthread_mutex_unlock(&g_pool.lock);
+
+    uint64_t now = engine_metrics_now_ns();
+    engine_metrics_record(EM_STAGE_DB_POOL_WAIT, now - t0);
+    if (switched) engine_metrics_count(EM_COUNT_DB_POOL_SWITCH, 1);
+
+    // 오래 쉬었던 연결: 서버가 닫았을 수 있으므로 확인 후 재연결
+    if (!need_connect && now - s->last_used_ns >= g_pool.health_idle_ns && mysql_ping(s->conn) != 0) {
+        fprintf(stderr, "[DB_POOL] slot %d failed health check: %s\n", idx, mysql_error(s->conn));
+        pool_close(s->conn);
+        s->conn = NULL;
+        need_connect = 1;
+    }
+
+    if (need_connect) {
+        MYSQL* conn = pool_connect();
+
+        pthread_mutex_lock(&g_pool.lock);
+        if (!conn) {
+            connect_failed_locked(engine_metrics_now_ns());
+            s->leased = 0;
+            s->owner = 0;
+            g_pool.open--;
+            pthread_cond_broadcast(&g_pool.cond);
+            pthread_mutex_unlock(&g_pool.lock);
+            engine_metrics_count(EM_COUNT_DB_POOL_CONNECT_FAIL, 1);
+            return NULL;
+        }
+        s->conn = conn;
+        g_pool.backoff_ns = 0;
+        g_pool.retry_at_ns = 0;
+        int open = g_pool.open;
+        pthread_mutex_unlock(&g_pool.lock);
+
+        engine_metrics_count(EM_COUNT_DB_POOL_CONNECT, 1);
+        engine_metrics_gauge_max(EM_GAUGE_DB_POOL_OPEN_MAX, (uint64_t)open);
+        printf("[DB_POOL] slot %d connected (open=%d/%d)\n", idx, open, g_pool.max_conns);
+    }
+
+    t_home = idx;
+    t_slot = idx;
+    t_depth = 1;
+    t_failed = 0;
+    return s->conn;
+}
+
+void db_pool_release(MYSQL* conn, int failed)
+{
+    if (!conn || t_depth <= 0 || t_slot < 0) return;
+
+    pool_slot_t* s = &g_pool.slots[t_slot];
+    if (s->conn != conn) return;
+
+    if (failed) t_failed = 1;
+    if (--t_depth > 0) return;
+
+    // 실패 보고된 연결은 ping으로 확인: 끊겼으면 닫아서 다음 acquire가 재연결
+    int close_it = (t_failed && mysql_ping(conn) != 0);
+    if (close_it) {
+        fprintf(stderr, "[DB_POOL] slot %d connection lost: %s\n", t_slot, mysql_error(conn));
+        pool_close(conn);
+    }
+
+    pthread_mutex_lock(&g_pool.lock);
+    if (close_it) {
+        s->conn = NULL;
+        s->owner = 0;
+        g_pool.open--;
+    }
+    s->leased = 0;
+    s->last_used_ns = engine_metrics_now_ns();
+    if (g_pool.waiters > 0) pthread_cond_signal(&g_pool.cond);
+    pthread_mutex_unlock(&g_pool.lock);
+
+    t_slot = -1;
+    t_failed = 0;
+}
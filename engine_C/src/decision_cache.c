@@ -0,0 +1,258 @@
+// src/decision_cache.c
+#include "decision_cache.h"
+#include "engine_metrics.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DC_NONE 0xFFFFFFFFu
+
+typedef struct {
+    uint64_t key;
+    uint64_t generation;
+    int64_t  expires_ms;
+    uint32_t hnext;      // 해시 체인
+    uint32_t prev;       // LRU (prev 쪽이 최근 사용)
+    uint32_t next;
+    decision_cache_value_t v;
+} dc_entry_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    dc_entry_t* entries;
+    uint32_t*   buckets;
+    uint32_t    bucket_mask;
+    uint32_t    capacity;
+    uint32_t    used;        // entries[0..used) 사용 중 (빈 슬롯은 앞에서부터 채움)
+    uint32_t    lru_head;    // 가장 최근
+    uint32_t    lru_tail;    // 교체 대상
+} __attribute__((aligned(64))) dc_shard_t;
+
+static dc_shard_t* g_shards = NULL;
+static uint32_t    g_shard_count = 0;
+static int         g_positive_ttl_ms = 0;
+static int         g_negative_ttl_ms = 0;
+
+static int64_t mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint32_t pow2_at_least(uint32_t v)
+{
+    uint32_t p = 1;
+    while (p < v && p < (1u << 30)) p <<= 1;
+    return p;
+}
+
+// FNV-1a + 최종 혼합 (상위 비트는 shard, 하위 비트는 bucket에 쓰므로 전체 비트를 섞음)
+uint64_t decision_cache_key(const char* url_norm)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (const unsigned char* p = (const unsigned char*)(url_norm ? url_norm : ""); *p; p++) {
+        h ^= *p;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+static dc_shard_t* shard_of(uint64_t key)
+{
+    return &g_shards[(uint32_t)(key >> 40) & (g_shard_count - 1)];
+}
+
+/* ---------- shard 내부 (lock 보유 상태) ---------- */
+
+static void lru_unlink(dc_shard_t* s, uint32_t i)
+{
+    dc_entry_t* e = &s->entries[i];
+    if (e->prev != DC_NONE) s->entries[e->prev].next = e->next;
+    else s->lru_head = e->next;
+    if (e->next != DC_NONE) s->entries[e->next].prev = e->prev;
+    else s->lru_tail = e->prev;
+    e->prev = e->next = DC_NONE;
+}
+
+static void lru_push_front(dc_shard_t* s, uint32_t i)
+{
+    dc_entry_t* e = &s->entries[i];
+    e->prev = DC_NONE;
+    e->next = s->lru_head;
+    if (s->lru_head != DC_NONE) s->entries[s->lru_head].prev = i;
+    s->lru_head = i;
+    if (s->lru_tail == DC_NONE) s->lru_tail = i;
+}
+
+static uint32_t find(const dc_shard_t* s, uint64_t key)
+{
+    uint32_t i = s->buckets[key & s->bucket_mask];
+    while (i != DC_NONE && s->entries[i].key != key) i = s->entries[i].hnext;
+    return i;
+}
+
+static void hash_unlink(dc_shard_t* s, uint32_t i)
+{
+    uint32_t* link = &s->buckets[s->entries[i].key & s->bucket_mask];
+    while (*link != DC_NONE && *link != i) link = &s->entries[*link].hnext;
+    if (*link == i) *link = s->entries[i].hnext;
+    s->entries[i].hnext = DC_NONE;
+}
+
+// 제거한 슬롯은 마지막 사용 슬롯을 옮겨 채움 (used 구간을 연속으로 유지)
+static void remove_entry(dc_shard_t* s, uint32_t i)
+{
+    hash_unlink(s, i);
+    lru_unlink(s, i);
+
+    uint32_t last = --s->used;
+    if (i == last) return;
+
+    dc_entry_t* m = &s->entries[last];
+    uint32_t* link = &s->buckets[m->key & s->bucket_mask];
+    while (*link != last) link = &s->entries[*link].hnext;
+    *link = i;
+
+    if (m->prev != DC_NONE) s->entries[m->prev].next = i;
+    else s->lru_head = i;
+    if (m->next != DC_NONE) s->entries[m->next].prev = i;
+    else s->lru_tail = i;
+
+    s->entries[i] = *m;
+}
+
+/* ---------- API ---------- */
+
+int decision_cache_init(const decision_cache_config_t* cfg)
+{
+    if (!cfg || cfg->entries <= 0) return 0;
+
+    uint32_t shards = pow2_at_least(cfg->shards > 0 ? (uint32_t)cfg->shards : 1);
+    uint32_t per_shard = ((uint32_t)cfg->entries + shards - 1) / shards;
+    uint32_t buckets = pow2_at_least(per_shard);
+
+    g_shards = (dc_shard_t*)calloc(shards, sizeof(dc_shard_t));
+    if (!g_shards) return -1;
+    g_shard_count = shards;
+
+    for (uint32_t k = 0; k < shards; k++) {
+        dc_shard_t* s = &g_shards[k];
+        pthread_mutex_init(&s->lock, NULL);
+        s->entries = (dc_entry_t*)calloc(per_shard, sizeof(dc_entry_t));
+        s->buckets = (uint32_t*)malloc(buckets * sizeof(uint32_t));
+        if (!s->entries || !s->buckets) {
+            decision_cache_shutdown();
+            return -1;
+        }
+        memset(s->buckets, 0xff, buckets * sizeof(uint32_t));
+        s->bucket_mask = buckets - 1;
+        s->capacity = per_shard;
+        s->lru_head = s->lru_tail = DC_NONE;
+    }
+
+    g_positive_ttl_ms = cfg->positive_ttl_ms;
+    g_negative_ttl_ms = cfg->negative_ttl_ms;
+
+    fprintf(stderr, "[DECISION_CACHE] entries=%u shards=%u positive_ttl=%dms negative_ttl=%dms memory=%zuKB\n",
+            per_shard * shards, shards, g_positive_ttl_ms, g_negative_ttl_ms,
+            (size_t)shards * (sizeof(dc_shard_t) + per_shard * sizeof(dc_entry_t) + buckets * sizeof(uint32_t)) / 1024);
+    return 0;
+}
+
+void decision_cache_shutdown(void)
+{
+    if (!g_shards) return;
+
+    for (uint32_t k = 0; k < g_shard_count; k++) {
+        free(g_shards[k].entries);
+        free(g_shards[k].buckets);
+        pthread_mutex_destroy(&g_shards[k].lock);
+    }
+    free(g_shards);
+    g_shards = NULL;
+    g_shard_count = 0;
+}
+
+int decision_cache_enabled(void)
+{
+    return g_shards != NULL;
+}
+
+int decision_cache_lookup(uint64_t key, uint64_t generation, decision_cache_value_t* out)
+{
+    if (!g_shards || !out) return 0;
+
+    dc_shard_t* s = shard_of(key);
+    engine_counter_t result = EM_COUNT_DCACHE_MISS;
+
+    pthread_mutex_lock(&s->lock);
+    uint32_t i = find(s, key);
+    if (i != DC_NONE) {
+        dc_entry_t* e = &s->entries[i];
+        if (e->generation != generation) {
+            remove_entry(s, i);
+            result = EM_COUNT_DCACHE_STALE;
+        } else if (mono_ms() >= e->expires_ms) {
+            remove_entry(s, i);
+            result = EM_COUNT_DCACHE_EXPIRED;
+        } else {
+            lru_unlink(s, i);
+            lru_push_front(s, i);
+            *out = e->v;
+            result = EM_COUNT_DCACHE_HIT;
+        }
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    // stale/expired도 miss에 포함 (원인별 카운터는 추가로 기록)
+    if (result != EM_COUNT_DCACHE_HIT && result != EM_COUNT_DCACHE_MISS) {
+        engine_metrics_count(EM_COUNT_DCACHE_MISS, 1);
+    }
+    engine_metrics_count(result, 1);
+    return result == EM_COUNT_DCACHE_HIT;
+}
+
+void decision_cache_store(uint64_t key, uint64_t generation, const decision_cache_value_t* v)
+{
+    if (!g_shards || !v) return;
+
+    int positive = (v->stage == DC_STAGE_POLICY || v->action == ACT_BLOCK);
+    int ttl = positive ? g_positive_ttl_ms : g_negative_ttl_ms;
+    if (ttl <= 0) return;
+
+    dc_shard_t* s = shard_of(key);
+    int evicted = 0;
+
+    pthread_mutex_lock(&s->lock);
+    uint32_t i = find(s, key);
+    if (i != DC_NONE) {
+        lru_unlink(s, i);
+    } else {
+        if (s->used == s->capacity) {
+            remove_entry(s, s->lru_tail);
+            evicted = 1;
+        }
+        i = s->used++;
+        s->entries[i].key = key;
+        s->entries[i].hnext = s->buckets[key & s->bucket_mask];
+        s->buckets[key & s->bucket_mask] = i;
+    }
+
+    dc_entry_t* e = &s->entries[i];
+    e->generation = generation;
+    e->expires_ms = mono_ms() + ttl;
+    e->v = *v;
+    lru_push_front(s, i);
+    pthread_mutex_unlock(&s->lock);
+
+    if (evicted) engine_metrics_count(EM_COUNT_DCACHE_EVICT, 1);
+}
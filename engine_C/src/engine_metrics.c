@@ -0,0 +1,343 @@
+// src/engine_metrics.c
+#include "engine_metrics.h"
+
+#include <string.h>
+#include <time.h>
+
+#define EM_SHARDS       16
+#define EM_SUB_BITS     3
+#define EM_SUB_BUCKETS  (1 << EM_SUB_BITS)
+#define EM_BUCKETS      (64 * EM_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t hist[EM_STAGE_COUNT][EM_BUCKETS];
+    uint64_t max_ns[EM_STAGE_COUNT];
+    uint64_t counters[EM_COUNT_COUNT];
+} __attribute__((aligned(64))) em_shard_t;
+
+static em_shard_t g_shards[EM_SHARDS];
+static uint64_t g_gauges[EM_GAUGE_COUNT];
+static unsigned int g_next_shard = 0;
+static int g_report_histogram = 0;
+static __thread int t_shard = -1;
+
+static const char* k_stage_names[EM_STAGE_COUNT] = {
+    "parse",
+    "log_insert",
+    "policy",
+    "ai",
+    "db_update",
+    "inject",
+    "total",
+    "log_write",
+    "db_pool_wait"
+};
+
+uint64_t engine_metrics_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static em_shard_t* my_shard(void)
+{
+    if (t_shard < 0) {
+        t_shard = (int)(__atomic_fetch_add(&g_next_shard, 1, __ATOMIC_RELAXED) % EM_SHARDS);
+    }
+    return &g_shards[t_shard];
+}
+
+// 값 -> 버킷: 상위 비트 위치(exp) + 그 아래 EM_SUB_BITS 비트(sub)
+static int bucket_of(uint64_t v)
+{
+    if (v < EM_SUB_BUCKETS) return (int)v;
+
+    int exp = 63 - __builtin_clzll(v);
+    int sub = (int)((v >> (exp - EM_SUB_BITS)) & (EM_SUB_BUCKETS - 1));
+    return (exp - EM_SUB_BITS + 1) * EM_SUB_BUCKETS + sub;
+}
+
+// 버킷 -> 대표값 (구간 상한)
+static uint64_t bucket_upper(int b)
+{
+    if (b < EM_SUB_BUCKETS) return (uint64_t)b;
+
+    int exp = b / EM_SUB_BUCKETS + EM_SUB_BITS - 1;
+    uint64_t sub = (uint64_t)(b % EM_SUB_BUCKETS);
+    uint64_t base = 1ull << exp;
+    uint64_t step = 1ull << (exp - EM_SUB_BITS);
+    return base + (sub + 1) * step - 1;
+}
+
+void engine_metrics_reset(void)
+{
+    memset(g_shards, 0, sizeof(g_shards));
+    memset(g_gauges, 0, sizeof(g_gauges));
+}
+
+void engine_metrics_record(engine_stage_t stage, uint64_t elapsed_ns)
+{
+    if ((unsigned)stage >= EM_STAGE_COUNT) return;
+
+    em_shard_t* s = my_shard();
+    __atomic_fetch_add(&s->hist[stage][bucket_of(elapsed_ns)], 1, __ATOMIC_RELAXED);
+
+    uint64_t cur = __atomic_load_n(&s->max_ns[stage], __ATOMIC_RELAXED);
+    while (elapsed_ns > cur &&
+           !__atomic_compare_exchange_n(&s->max_ns[stage], &cur, elapsed_ns, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void engine_metrics_count(engine_counter_t counter, uint64_t n)
+{
+    if ((unsigned)counter >= EM_COUNT_COUNT) return;
+    __atomic_fetch_add(&my_shard()->counters[counter], n, __ATOMIC_RELAXED);
+}
+
+void engine_metrics_gauge_max(engine_gauge_t gauge, uint64_t v)
+{
+    if ((unsigned)gauge >= EM_GAUGE_COUNT) return;
+
+    uint64_t cur = __atomic_load_n(&g_gauges[gauge], __ATOMIC_RELAXED);
+    while (v > cur &&
+           !__atomic_compare_exchange_n(&g_gauges[gauge], &cur, v, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+uint64_t engine_metrics_gauge(engine_gauge_t gauge)
+{
+    if ((unsigned)gauge >= EM_GAUGE_COUNT) return 0;
+    return __atomic_load_n(&g_gauges[gauge], __ATOMIC_RELAXED);
+}
+
+uint64_t engine_metrics_counter(engine_counter_t counter)
+{
+    if ((unsigned)counter >= EM_COUNT_COUNT) return 0;
+
+    uint64_t sum = 0;
+    for (int i = 0; i < EM_SHARDS; i++) {
+        sum += __atomic_load_n(&g_shards[i].counters[counter], __ATOMIC_RELAXED);
+    }
+    return sum;
+}
+
+void engine_metrics_stage_summary(engine_stage_t stage, engine_stage_summary_t* out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if ((unsigned)stage >= EM_STAGE_COUNT) return;
+
+    static __thread uint64_t merged[EM_BUCKETS];
+    memset(merged, 0, sizeof(merged));
+
+    for (int i = 0; i < EM_SHARDS; i++) {
+        for (int b = 0; b < EM_BUCKETS; b++) {
+            uint64_t c = __atomic_load_n(&g_shards[i].hist[stage][b], __ATOMIC_RELAXED);
+            merged[b] += c;
+            out->count += c;
+        }
+        uint64_t m = __atomic_load_n(&g_shards[i].max_ns[stage], __ATOMIC_RELAXED);
+        if (m > out->max_ns) out->max_ns = m;
+    }
+
+    if (out->count == 0) return;
+
+    uint64_t r50 = (out->count * 50 + 99) / 100;
+    uint64_t r90 = (out->count * 90 + 99) / 100;
+    uint64_t r99 = (out->count * 99 + 99) / 100;
+
+    uint64_t seen = 0;
+    int found = 0;
+    for (int b = 0; b < EM_BUCKETS && found < 3; b++) {
+        if (merged[b] == 0) continue;
+        seen += merged[b];
+        uint64_t v = bucket_upper(b);
+        if (v > out->max_ns) v = out->max_ns;
+        if (found == 0 && seen >= r50) { out->p50_ns = v; found++; }
+        if (found == 1 && seen >= r90) { out->p90_ns = v; found++; }
+        if (found == 2 && seen >= r99) { out->p99_ns = v; found++; }
+    }
+}
+
+void engine_metrics_set_histogram(int on)
+{
+    g_report_histogram = on;
+}
+
+// 하위 구간을 합쳐 2배 간격으로 출력: [하한, 상한) 건수 누적%
+void engine_metrics_histogram(FILE* fp, engine_stage_t stage)
+{
+    if (!fp || (unsigned)stage >= EM_STAGE_COUNT) return;
+
+    uint64_t merged[64];
+    uint64_t total = 0;
+    memset(merged, 0, sizeof(merged));
+
+    for (int i = 0; i < EM_SHARDS; i++) {
+        for (int b = 0; b < EM_BUCKETS; b++) {
+            uint64_t c = __atomic_load_n(&g_shards[i].hist[stage][b], __ATOMIC_RELAXED);
+            if (c == 0) continue;
+            uint64_t v = bucket_upper(b);
+            merged[v ? 63 - __builtin_clzll(v) : 0] += c;
+            total += c;
+        }
+    }
+    if (total == 0) return;
+
+    uint64_t seen = 0;
+    for (int e = 0; e < 64; e++) {
+        if (merged[e] == 0) continue;
+        seen += merged[e];
+        fprintf(fp, "[METRICS] hist stage=%-10s <%10.1fus %10llu %6.2f%%\n",
+                engine_stage_name(stage), (double)(2ull << e) / 1000.0,
+                (unsigned long long)merged[e], 100.0 * (double)seen / (double)total);
+    }
+}
+
+const char* engine_stage_name(engine_stage_t stage)
+{
+    if ((unsigned)stage >= EM_STAGE_COUNT) return "unknown";
+    return k_stage_names[stage];
+}
+
+void engine_metrics_report(FILE* fp, double elapsed_sec)
+{
+    if (!fp) return;
+
+    uint64_t packets = engine_metrics_counter(EM_COUNT_PACKETS);
+    uint64_t events = engine_metrics_counter(EM_COUNT_HTTP_EVENTS);
+    double secs = (elapsed_sec > 0.0) ? elapsed_sec : 1e-9;
+
+    fprintf(fp, "[METRICS] elapsed=%.3fs packets=%llu (%.0f pkt/s) http_events=%llu (%.0f ev/s)\n",
+            elapsed_sec,
+            (unsigned long long)packets, (double)packets / secs,
+            (unsigned long long)events, (double)events / secs);
+
+    uint64_t hits = engine_metrics_counter(EM_COUNT_DCACHE_HIT);
+    uint64_t misses = engine_metrics_counter(EM_COUNT_DCACHE_MISS);
+    if (hits + misses > 0) {
+        fprintf(fp, "[METRICS] decision_cache hit=%llu miss=%llu (%.1f%% hit) stale=%llu expired=%llu evict=%llu\n",
+                (unsigned long long)hits, (unsigned long long)misses,
+                100.0 * (double)hits / (double)(hits + misses),
+                (unsigned long long)engine_metrics_counter(EM_COUNT_DCACHE_STALE),
+                (unsigned long long)engine_metrics_counter(EM_COUNT_DCACHE_EXPIRED),
+                (unsigned long long)engine_metrics_counter(EM_COUNT_DCACHE_EVICT));
+    }
+
+    uint64_t busy = engine_metrics_counter(EM_COUNT_AI_BACKPRESSURE);
+    if (busy > 0) {
+        fprintf(fp, "[METRICS] ai_backpressure=%llu (events not scored: in-flight limit)\n",
+                (unsigned long long)busy);
+    }
+
+    // AI 단계 tier별 판정 수 (prescore / native는 원격 AI 호출을 줄인 만큼)
+    uint64_t pre_benign = engine_metrics_counter(EM_COUNT_PRESCORE_BENIGN);
+    uint64_t pre_malicious = engine_metrics_counter(EM_COUNT_PRESCORE_MALICIOUS);
+    uint64_t native = engine_metrics_counter(EM_COUNT_AI_NATIVE);
+    uint64_t coalesced = engine_metrics_counter(EM_COUNT_AI_COALESCED);
+    uint64_t fast_fail = engine_metrics_counter(EM_COUNT_AI_FAST_FAIL);
+    uint64_t remote = engine_metrics_counter(EM_COUNT_AI_REMOTE);
+    remote = remote > coalesced + fast_fail ? remote - coalesced - fast_fail : 0;
+    uint64_t avoided = pre_benign + pre_malicious + native + coalesced;
+    if (avoided + remote > 0) {
+        fprintf(fp, "[METRICS] ai_cascade prescore_benign=%llu prescore_malicious=%llu native=%llu "
+                    "native_fallback=%llu coalesced=%llu remote=%llu ai_calls_avoided=%llu (%.1f%%)\n",
+                (unsigned long long)pre_benign, (unsigned long long)pre_malicious,
+                (unsigned long long)native,
+                (unsigned long long)engine_metrics_counter(EM_COUNT_AI_NATIVE_FALLBACK),
+                (unsigned long long)coalesced, (unsigned long long)remote, (unsigned long long)avoided,
+                100.0 * (double)avoided / (double)(avoided + remote));
+    }
+
+    // DB 왕복: prepare + execute (prepared statement 캐시가 동작하면 prepare는 워커당 문장 수만큼)
+    uint64_t db_prepare = engine_metrics_counter(EM_COUNT_DB_PREPARE);
+    uint64_t db_execute = engine_metrics_counter(EM_COUNT_DB_EXECUTE);
+    if (db_execute > 0) {
+        fprintf(fp, "[METRICS] db prepare=%llu execute=%llu round_trips/event=%.2f\n",
+                (unsigned long long)db_prepare, (unsigned long long)db_execute,
+                events ? (double)(db_prepare + db_execute) / (double)events : 0.0);
+    }
+
+    uint64_t flushed = engine_metrics_counter(EM_COUNT_EVENT_TIMEOUT_FLUSH);
+    if (flushed > 0) {
+        fprintf(fp, "[METRICS] event_timeout_flush=%llu (access_log written before the AI result)\n",
+                (unsigned long long)flushed);
+    }
+
+    // log writer: 큐 깊이 / 배치 크기 / overflow (배치 기록 지연은 stage=log_write)
+    uint64_t log_batches = engine_metrics_counter(EM_COUNT_LOG_BATCHES);
+    uint64_t log_written = engine_metrics_counter(EM_COUNT_LOG_WRITTEN);
+    uint64_t log_dropped = engine_metrics_counter(EM_COUNT_LOG_DROPPED);
+    uint64_t log_sync = engine_metrics_counter(EM_COUNT_LOG_SYNC);
+    if (log_batches + log_dropped + log_sync > 0) {
+        fprintf(fp, "[METRICS] log_writer queued=%llu written=%llu batches=%llu avg_batch=%.1f max_batch=%llu "
+                    "max_queue=%llu dropped=%llu sync_overflow=%llu fallback=%llu rejected=%llu\n",
+                (unsigned long long)engine_metrics_counter(EM_COUNT_LOG_QUEUED),
+                (unsigned long long)log_written, (unsigned long long)log_batches,
+                log_batches ? (double)log_written / (double)log_batches : 0.0,
+                (unsigned long long)engine_metrics_gauge(EM_GAUGE_LOG_BATCH_MAX),
+                (unsigned long long)engine_metrics_gauge(EM_GAUGE_LOG_QUEUE_MAX),
+                (unsigned long long)log_dropped, (unsigned long long)log_sync,
+                (unsigned long long)engine_metrics_counter(EM_COUNT_LOG_FALLBACK),
+                (unsigned long long)engine_metrics_counter(EM_COUNT_LOG_REJECTED));
+    }
+
+    // 디스크 spool: DB 장애 / overflow 동안 쌓인 레코드와 재생
+    uint64_t spooled = engine_metrics_counter(EM_COUNT_LOG_SPOOLED);
+    uint64_t replayed = engine_metrics_counter(EM_COUNT_LOG_REPLAYED);
+    if (spooled + replayed > 0) {
+        fprintf(fp, "[METRICS] log_spool spooled=%llu replayed=%llu corrupt=%llu max_pending_bytes=%llu\n",
+                (unsigned long long)spooled, (unsigned long long)replayed,
+                (unsigned long long)engine_metrics_counter(EM_COUNT_SPOOL_CORRUPT),
+                (unsigned long long)engine_metrics_gauge(EM_GAUGE_SPOOL_BYTES_MAX));
+    }
+
+    // DB 풀: 연결 churn (대기 시간은 stage=db_pool_wait)
+    uint64_t pool_connect = engine_metrics_counter(EM_COUNT_DB_POOL_CONNECT);
+    uint64_t pool_fail = engine_metrics_counter(EM_COUNT_DB_POOL_CONNECT_FAIL);
+    if (pool_connect + pool_fail > 0) {
+        fprintf(fp, "[METRICS] db_pool connects=%llu closes=%llu connect_fail=%llu timeouts=%llu "
+                    "affinity_miss=%llu max_open=%llu\n",
+                (unsigned long long)pool_connect,
+                (unsigned long long)engine_metrics_counter(EM_COUNT_DB_POOL_CLOSE),
+                (unsigned long long)pool_fail,
+                (unsigned long long)engine_metrics_counter(EM_COUNT_DB_POOL_TIMEOUT),
+                (unsigned long long)engine_metrics_counter(EM_COUNT_DB_POOL_SWITCH),
+                (unsigned long long)engine_metrics_gauge(EM_GAUGE_DB_POOL_OPEN_MAX));
+    }
+
+    uint64_t ai_fail = engine_metrics_counter(EM_COUNT_AI_FAIL);
+    if (ai_fail > 0) {
+        fprintf(fp, "[METRICS] ai_fail_stage=%llu (events decided without an AI score)\n",
+                (unsigned long long)ai_fail);
+    }
+
+    uint64_t opened = engine_metrics_counter(EM_COUNT_AI_BREAKER_OPEN);
+    if (opened + fast_fail > 0) {
+        fprintf(fp, "[METRICS] ai_breaker opened=%llu half_open=%llu closed=%llu fast_fail=%llu\n",
+                (unsigned long long)opened,
+                (unsigned long long)engine_metrics_counter(EM_COUNT_AI_BREAKER_HALF_OPEN),
+                (unsigned long long)engine_metrics_counter(EM_COUNT_AI_BREAKER_CLOSE),
+                (unsigned long long)fast_fail);
+    }
+
+    for (int s = 0; s < EM_STAGE_COUNT; s++) {
+        engine_stage_summary_t sum;
+        engine_metrics_stage_summary((engine_stage_t)s, &sum);
+        if (sum.count == 0) continue;
+
+        fprintf(fp, "[METRICS] stage=%-10s n=%-9llu p50=%.1fus p90=%.1fus p99=%.1fus max=%.1fus\n",
+                engine_stage_name((engine_stage_t)s),
+                (unsigned long long)sum.count,
+                (double)sum.p50_ns / 1000.0,
+                (double)sum.p90_ns / 1000.0,
+                (double)sum.p99_ns / 1000.0,
+                (double)sum.max_ns / 1000.0);
+    }
+
+    if (g_report_histogram) {
+        for (int s = 0; s < EM_STAGE_COUNT; s++) engine_metrics_histogram(fp, (engine_stage_t)s);
+    }
+}
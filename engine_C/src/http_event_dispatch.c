@@ -4,8 +4,26 @@
 
 // main.c에 구현된 엔진 핸들러로 직접 연결
 extern void engine_handle_http_event(const HttpEvent* ev);
+extern int  engine_worker_init(int worker_id);
+extern void engine_worker_cleanup(void);
+extern void engine_flush(void);
 
 void process_http_event(const HttpEvent* ev)
 {
     engine_handle_http_event(ev);
 }
+
+int process_worker_begin(int worker_id)
+{
+    return engine_worker_init(worker_id);
+}
+
+void process_worker_end(void)
+{
+    engine_worker_cleanup();
+}
+
+void process_flush(void)
+{
+    engine_flush();
+}
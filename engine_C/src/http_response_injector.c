@@ -3,7 +3,6 @@
 #include "policy.h"
 #include "packet_forge_util.h"
 #include "raw_socket_sender.h"
-#include "db_function.h"
 
 #include <stdio.h>
 #include <errno.h>
@@ -45,23 +44,32 @@ static size_t build_http_403(char* out, size_t cap)
     return (size_t)n;
 }
 
-void http_response_inject(const HttpEvent* ev, MYSQL* conn, long long log_id, int status_code)
+static void set_result(http_inject_result_t* out, int send_ok, int inj_errno, int latency, int status_code)
 {
+    if (!out) return;
+    out->attempted = 1;
+    out->send_ok = send_ok;
+    out->inject_errno = inj_errno;
+    out->latency_ms = latency;
+    out->status_code = status_code > 0 ? status_code : 403;
+}
+
+void http_response_inject(const HttpEvent* ev, const char* request_id, int status_code,
+                          http_inject_result_t* out)
+{
+    // 주입 패킷 IP id (이전에는 log_id 하위 16bit, 이제 log_id는 이벤트 완료 후 생성)
+    static uint32_t s_ip_id = 0;
+
     int t0 = now_ms();
 
-    int attempted = 1;
     int send_ok = 0;
     int inj_errno = 0;
-    int latency = 0;
 
     // 1) 403 payload 구성
     char payload[512];
     size_t payload_len = build_http_403(payload, sizeof(payload));
     if (payload_len == 0) {
-        inj_errno = EINVAL;
-        latency = now_ms() - t0;
-        update_access_log_inject(conn, log_id, attempted, send_ok, inj_errno, latency,
-                                 status_code > 0 ? status_code : 403);
+        set_result(out, 0, EINVAL, now_ms() - t0, status_code);
         return;
     }
 
@@ -74,7 +82,7 @@ void http_response_inject(const HttpEvent* ev, MYSQL* conn, long long log_id, in
     uint8_t pkt[1600];
     size_t pkt_len = 0;
 
-    uint16_t ip_id = (uint16_t)(log_id & 0xFFFF);
+    uint16_t ip_id = (uint16_t)__atomic_add_fetch(&s_ip_id, 1, __ATOMIC_RELAXED);
 
     int rc = packet_forge_build_tcp_ipv4(
         pkt, sizeof(pkt), &pkt_len,
@@ -87,10 +95,7 @@ void http_response_inject(const HttpEvent* ev, MYSQL* conn, long long log_id, in
     );
 
     if (rc != 0) {
-        inj_errno = EINVAL;
-        latency = now_ms() - t0;
-        update_access_log_inject(conn, log_id, attempted, send_ok, inj_errno, latency,
-                                 status_code > 0 ? status_code : 403);
+        set_result(out, 0, EINVAL, now_ms() - t0, status_code);
         return;
     }
 
@@ -103,14 +108,6 @@ void http_response_inject(const HttpEvent* ev, MYSQL* conn, long long log_id, in
         if (inj_errno == 0) inj_errno = EIO;
     }
 
-    latency = now_ms() - t0;
-
-    update_access_log_inject(conn,
-                             log_id,
-                             attempted,
-                             send_ok,
-                             inj_errno,
-                             latency,
-                             status_code > 0 ? status_code : 403);
-	printf("[inject] log_id=%lld send_ok=%d errno=%d\n", log_id, send_ok, inj_errno);
+    set_result(out, send_ok, inj_errno, now_ms() - t0, status_code);
+	printf("[inject] request_id=%s send_ok=%d errno=%d\n", request_id ? request_id : "-", send_ok, inj_errno);
 }
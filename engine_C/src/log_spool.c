@@ -0,0 +1,815 @@
+// src/log_spool.c
+#include "log_spool.h"
+#include "engine_metrics.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SPOOL_MAGIC        0x50534747u  // "GGSP"
+#define SPOOL_VERSION      1
+#define SPOOL_HDR_SIZE     12           // magic + payload 길이 + CRC32
+#define SPOOL_MAX_PAYLOAD  16384
+#define SPOOL_STR_NULL     0xFFFFu
+
+typedef struct {
+    pthread_mutex_t lock;
+    int      enabled;
+    char     dir[256];
+    uint64_t segment_bytes;
+    uint64_t max_bytes;
+    int      fsync;
+    int      fsync_ms;
+
+    // append (lock)
+    int      fd;
+    uint64_t active_seq;
+    uint64_t active_size;
+    uint64_t total_bytes;    // 디렉터리 안 segment 크기 합 (삭제 시 차감)
+
+    // 주기 fdatasync (lock): append는 dirty 표시만, 교체된 segment는 retired_fd로 넘김
+    int            dirty;
+    int            retired_fd;
+    int            sync_stop;
+    int            sync_started;
+    pthread_t      sync_thread;
+    pthread_cond_t sync_cond;
+
+    // 재생 (재생 스레드 전용)
+    int      rfd;
+    uint64_t rseq;
+    uint64_t roff;
+    uint64_t cseq;           // commit 위치
+    uint64_t coff;
+} spool_t;
+
+static spool_t g_sp = { .lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1, .rfd = -1,
+                        .retired_fd = -1, .sync_cond = PTHREAD_COND_INITIALIZER };
+
+/* ---------- CRC32 (IEEE) ---------- */
+
+static uint32_t g_crc_table[256];
+static pthread_once_t g_crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init_table(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        g_crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32_of(const uint8_t* p, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--) crc = g_crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+/* ---------- 직렬화 (little endian) ---------- */
+
+typedef struct {
+    uint8_t* p;
+    size_t   len;
+    size_t   cap;
+    int      err;
+} sp_buf_t;
+
+static __thread sp_buf_t t_buf;
+
+static void put_bytes(sp_buf_t* b, const void* data, size_t n)
+{
+    if (b->err) return;
+    if (b->len + n > b->cap) {
+        size_t cap = b->cap ? b->cap : 16384;
+        while (cap < b->len + n) cap *= 2;
+        uint8_t* p = (uint8_t*)realloc(b->p, cap);
+        if (!p) {
+            b->err = 1;
+            return;
+        }
+        b->p = p;
+        b->cap = cap;
+    }
+    memcpy(b->p + b->len, data, n);
+    b->len += n;
+}
+
+static void put_u64(sp_buf_t* b, uint64_t v, int bytes)
+{
+    uint8_t tmp[8];
+    for (int i = 0; i < bytes; i++) tmp[i] = (uint8_t)(v >> (8 * i));
+    put_bytes(b, tmp, (size_t)bytes);
+}
+
+static void put_i32(sp_buf_t* b, int v)
+{
+    put_u64(b, (uint32_t)v, 4);
+}
+
+static void put_i64(sp_buf_t* b, int64_t v)
+{
+    put_u64(b, (uint64_t)v, 8);
+}
+
+static void put_f64(sp_buf_t* b, double v)
+{
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+    put_u64(b, u, 8);
+}
+
+static void put_str(sp_buf_t* b, const char* s)
+{
+    if (!s) {
+        put_u64(b, SPOOL_STR_NULL, 2);
+        return;
+    }
+    size_t n = strlen(s);
+    if (n >= SPOOL_STR_NULL) n = SPOOL_STR_NULL - 1;
+    put_u64(b, n, 2);
+    put_bytes(b, s, n);
+}
+
+static void put_record(sp_buf_t* b, const access_log_record_t* rec, int kind)
+{
+    put_u64(b, SPOOL_VERSION, 1);
+    put_u64(b, (uint64_t)kind, 1);
+
+    put_str(b, rec->request_id);
+    put_i64(b, rec->detect_ts_ms);
+    put_str(b, rec->client_ip);
+    put_i32(b, rec->client_port);
+    put_str(b, rec->server_ip);
+    put_i32(b, rec->server_port);
+    put_str(b, rec->host);
+    put_str(b, rec->path);
+    put_str(b, rec->method);
+    put_str(b, rec->url_norm);
+
+    put_str(b, rec->decision);
+    put_str(b, rec->reason);
+    put_str(b, rec->decision_stage);
+    put_i64(b, rec->policy_id);
+    put_i32(b, rec->engine_latency_ms);
+
+    put_i32(b, rec->inject_attempted);
+    put_i32(b, rec->inject_send);
+    put_i32(b, rec->inject_errno);
+    put_i32(b, rec->inject_latency_ms);
+    put_i32(b, rec->inject_status_code);
+
+    put_i32(b, rec->has_ai);
+    put_i32(b, rec->ai_response);
+    put_f64(b, rec->ai.score);
+    put_str(b, rec->ai.label);
+    put_str(b, rec->ai.model_version);
+    put_i64(b, rec->ai.latency_ms);
+    put_str(b, rec->ai_error_code);
+
+    put_i32(b, rec->review_needed);
+}
+
+typedef struct {
+    const uint8_t* p;
+    size_t         len;
+    size_t         off;
+    int            err;
+} sp_rd_t;
+
+static uint64_t get_u64(sp_rd_t* r, int bytes)
+{
+    if (r->err || r->off + (size_t)bytes > r->len) {
+        r->err = 1;
+        return 0;
+    }
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t)r->p[r->off + (size_t)i] << (8 * i);
+    r->off += (size_t)bytes;
+    return v;
+}
+
+static int get_i32(sp_rd_t* r)
+{
+    return (int)(int32_t)(uint32_t)get_u64(r, 4);
+}
+
+static int64_t get_i64(sp_rd_t* r)
+{
+    return (int64_t)get_u64(r, 8);
+}
+
+static double get_f64(sp_rd_t* r)
+{
+    uint64_t u = get_u64(r, 8);
+    double v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+// dst에 복사 (길면 자름), NULL 문자열이면 NULL 반환
+static const char* get_str(sp_rd_t* r, char* dst, size_t dstsz)
+{
+    uint64_t n = get_u64(r, 2);
+    dst[0] = '\0';
+    if (r->err || n == SPOOL_STR_NULL) return NULL;
+    if (r->off + n > r->len) {
+        r->err = 1;
+        return NULL;
+    }
+    size_t c = (n < dstsz - 1) ? (size_t)n : dstsz - 1;
+    memcpy(dst, r->p + r->off, c);
+    dst[c] = '\0';
+    r->off += (size_t)n;
+    return dst;
+}
+
+static int get_record(sp_rd_t* r, access_log_record_copy_t* out, int* kind)
+{
+    memset(out, 0, sizeof(*out));
+    access_log_record_t* rec = &out->rec;
+
+    if (get_u64(r, 1) != SPOOL_VERSION) return -1;
+    *kind = (int)get_u64(r, 1);
+
+    (void)get_str(r, rec->request_id, sizeof(rec->request_id));
+    rec->detect_ts_ms = get_i64(r);
+    rec->client_ip = get_str(r, out->client_ip, sizeof(out->client_ip));
+    rec->client_port = get_i32(r);
+    rec->server_ip = get_str(r, out->server_ip, sizeof(out->server_ip));
+    rec->server_port = get_i32(r);
+    rec->host = get_str(r, out->host, sizeof(out->host));
+    rec->path = get_str(r, out->path, sizeof(out->path));
+    rec->method = get_str(r, out->method, sizeof(out->method));
+    rec->url_norm = get_str(r, out->url_norm, sizeof(out->url_norm));
+
+    rec->decision = get_str(r, out->decision, sizeof(out->decision));
+    rec->reason = get_str(r, out->reason, sizeof(out->reason));
+    rec->decision_stage = get_str(r, out->decision_stage, sizeof(out->decision_stage));
+    rec->policy_id = get_i64(r);
+    rec->engine_latency_ms = get_i32(r);
+
+    rec->inject_attempted = get_i32(r);
+    rec->inject_send = get_i32(r);
+    rec->inject_errno = get_i32(r);
+    rec->inject_latency_ms = get_i32(r);
+    rec->inject_status_code = get_i32(r);
+
+    rec->has_ai = get_i32(r);
+    rec->ai_response = get_i32(r);
+    rec->ai.score = get_f64(r);
+    (void)get_str(r, rec->ai.label, sizeof(rec->ai.label));
+    (void)get_str(r, rec->ai.model_version, sizeof(rec->ai.model_version));
+    rec->ai.latency_ms = get_i64(r);
+    (void)get_str(r, rec->ai_error_code, sizeof(rec->ai_error_code));
+    rec->ai.ok = rec->ai_response;
+
+    rec->review_needed = get_i32(r);
+
+    return (r->err || !rec->request_id[0]) ? -1 : 0;
+}
+
+/* ---------- 파일 ---------- */
+
+static void segment_path(char* out, size_t outsz, uint64_t seq)
+{
+    snprintf(out, outsz, "%s/%020llu.seg", g_sp.dir, (unsigned long long)seq);
+}
+
+/*
+ * spool 파일 신뢰 확인 (재생한 레코드는 그대로 DB에 들어가므로)
+ * - 디렉터리: symlink 아님 (lstat), 이 사용자 소유, group/other 쓰기 없음
+ * - 파일: O_NOFOLLOW로 열고 fstat / lstat으로 이 사용자 소유 일반 파일, group/other 쓰기 없음
+ */
+static int dir_trusted(const char* dir)
+{
+    struct stat st;
+    if (lstat(dir, &st) != 0) {
+        fprintf(stderr, "[LOG_SPOOL] stat %s failed: %s\n", dir, strerror(errno));
+        return 0;
+    }
+    if (!S_ISDIR(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & (S_IWGRP | S_IWOTH))) {
+        fprintf(stderr, "[LOG_SPOOL] directory %s not trusted (uid=%u mode=%04o), "
+                        "use a directory owned by this user without group/other write\n",
+                dir, (unsigned)st.st_uid, (unsigned)(st.st_mode & 07777));
+        return 0;
+    }
+    return 1;
+}
+
+static int file_trusted(const char* path, const struct stat* st)
+{
+    if (S_ISREG(st->st_mode) && st->st_uid == geteuid() && (st->st_mode & (S_IWGRP | S_IWOTH)) == 0) return 1;
+
+    fprintf(stderr, "[LOG_SPOOL] %s not trusted (uid=%u mode=%04o), skipped\n",
+            path, (unsigned)st->st_uid, (unsigned)(st->st_mode & 07777));
+    return 0;
+}
+
+static int write_full(int fd, const uint8_t* p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+// 항상 새 파일 (이미 있으면 실패: 다른 누군가 미리 만들어 둔 파일에 쓰지 않음)
+static int open_segment_locked(uint64_t seq)
+{
+    char path[320];
+    segment_path(path, sizeof(path), seq);
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_NOFOLLOW | O_CLOEXEC, 0640);
+    if (fd < 0) {
+        fprintf(stderr, "[LOG_SPOOL] open %s failed: %s\n", path, strerror(errno));
+        return -1;
+    }
+    g_sp.fd = fd;
+    g_sp.active_seq = seq;
+    g_sp.active_size = 0;
+    return 0;
+}
+
+static void write_cursor(void)
+{
+    char path[320];
+    char tmp[330];
+    snprintf(path, sizeof(path), "%s/cursor", g_sp.dir);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    // 남은 tmp(이전 실행 중단)는 지우고 한 번만 다시 시도
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0 && errno == EEXIST && unlink(tmp) == 0) {
+        fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    }
+    FILE* fp = (fd >= 0) ? fdopen(fd, "w") : NULL;
+    if (!fp) {
+        fprintf(stderr, "[LOG_SPOOL] cursor write failed: %s\n", strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmp);
+        }
+        return;
+    }
+    fprintf(fp, "%llu %llu\n", (unsigned long long)g_sp.cseq, (unsigned long long)g_sp.coff);
+    int err = (fflush(fp) != 0);
+    if (!err && g_sp.fsync) err = (fdatasync(fileno(fp)) != 0);
+    if (fclose(fp) != 0) err = 1;
+
+    if (err || rename(tmp, path) != 0) {
+        fprintf(stderr, "[LOG_SPOOL] cursor write failed: %s\n", strerror(errno));
+        unlink(tmp);
+    }
+}
+
+/* ---------- 주기 fdatasync ---------- */
+
+// 디스크 flush는 lock 밖에서 (append하는 패킷 / writer 스레드가 기다리지 않도록)
+static void sync_once(void)
+{
+    pthread_mutex_lock(&g_sp.lock);
+    int retired = g_sp.retired_fd;
+    int fd = (g_sp.dirty && g_sp.fd >= 0) ? dup(g_sp.fd) : -1;
+    g_sp.retired_fd = -1;
+    if (fd >= 0) g_sp.dirty = 0;
+    pthread_mutex_unlock(&g_sp.lock);
+
+    if (retired >= 0) {
+        if (fdatasync(retired) != 0) fprintf(stderr, "[LOG_SPOOL] fdatasync failed: %s\n", strerror(errno));
+        close(retired);
+    }
+    if (fd >= 0) {
+        if (fdatasync(fd) != 0) fprintf(stderr, "[LOG_SPOOL] fdatasync failed: %s\n", strerror(errno));
+        close(fd);
+    }
+}
+
+static void* sync_main(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&g_sp.lock);
+    while (!g_sp.sync_stop) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += g_sp.fsync_ms / 1000;
+        ts.tv_nsec += (long)(g_sp.fsync_ms % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        (void)pthread_cond_timedwait(&g_sp.sync_cond, &g_sp.lock, &ts);
+
+        pthread_mutex_unlock(&g_sp.lock);
+        sync_once();
+        pthread_mutex_lock(&g_sp.lock);
+    }
+    pthread_mutex_unlock(&g_sp.lock);
+    return NULL;
+}
+
+int log_spool_open(const log_spool_config_t* cfg)
+{
+    if (!cfg || !cfg->dir || !cfg->dir[0] || g_sp.enabled) return -1;
+
+    pthread_once(&g_crc_once, crc_init_table);
+
+    snprintf(g_sp.dir, sizeof(g_sp.dir), "%s", cfg->dir);
+    g_sp.segment_bytes = cfg->segment_bytes > 0 ? cfg->segment_bytes : (64ull << 20);
+    g_sp.max_bytes = cfg->max_bytes > 0 ? cfg->max_bytes : UINT64_MAX;
+    g_sp.fsync = cfg->fsync;
+    g_sp.fsync_ms = cfg->fsync_ms > 0 ? cfg->fsync_ms : 0;
+
+    if (mkdir(g_sp.dir, 0750) != 0 && errno != EEXIST) {
+        fprintf(stderr, "[LOG_SPOOL] mkdir %s failed: %s\n", g_sp.dir, strerror(errno));
+        return -1;
+    }
+    if (!dir_trusted(g_sp.dir)) return -1;
+
+    DIR* d = opendir(g_sp.dir);
+    if (!d) {
+        fprintf(stderr, "[LOG_SPOOL] opendir %s failed: %s\n", g_sp.dir, strerror(errno));
+        return -1;
+    }
+
+    // 남아 있는 segment (이전 실행에서 재생하지 못한 레코드)
+    // last_seq: 건너뛴 파일까지 포함한 마지막 번호 (새 segment가 겹치지 않도록)
+    uint64_t min_seq = 0, max_seq = 0, last_seq = 0, segments = 0, total = 0;
+    struct dirent* de;
+    while ((de = readdir(d)) != NULL) {
+        unsigned long long seq = 0;
+        size_t len = strlen(de->d_name);
+        if (len != 24 || strcmp(de->d_name + 20, ".seg") != 0 ||
+            sscanf(de->d_name, "%20llu", &seq) != 1) continue;
+        if (seq > last_seq) last_seq = seq;
+
+        char path[320];
+        struct stat st;
+        segment_path(path, sizeof(path), seq);
+        if (lstat(path, &st) != 0 || !file_trusted(path, &st)) continue;
+        if (st.st_size == 0) {
+            // 레코드 없이 종료된 segment (재시작마다 쌓이지 않도록)
+            unlink(path);
+            continue;
+        }
+        total += (uint64_t)st.st_size;
+
+        if (segments == 0 || seq < min_seq) min_seq = seq;
+        if (segments == 0 || seq > max_seq) max_seq = seq;
+        segments++;
+    }
+    closedir(d);
+
+    // cursor: 마지막 commit 위치 (없거나 이미 지운 segment면 남은 것 중 처음부터)
+    g_sp.cseq = segments ? min_seq : 1;
+    g_sp.coff = 0;
+
+    char cpath[320];
+    snprintf(cpath, sizeof(cpath), "%s/cursor", g_sp.dir);
+    int cfd = open(cpath, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    struct stat cst;
+    if (cfd >= 0 && (fstat(cfd, &cst) != 0 || !file_trusted(cpath, &cst))) {
+        close(cfd);
+        cfd = -1;
+    }
+    FILE* fp = (cfd >= 0) ? fdopen(cfd, "r") : NULL;
+    if (!fp && cfd >= 0) close(cfd);
+    if (fp) {
+        unsigned long long seq = 0, off = 0;
+        if (fscanf(fp, "%llu %llu", &seq, &off) == 2 && segments && seq >= min_seq && seq <= max_seq) {
+            g_sp.cseq = seq;
+            g_sp.coff = off;
+        }
+        fclose(fp);
+    }
+    g_sp.rseq = g_sp.cseq;
+    g_sp.roff = g_sp.coff;
+    g_sp.rfd = -1;
+
+    // 새 segment에 append
+    pthread_mutex_lock(&g_sp.lock);
+    g_sp.total_bytes = total;
+    int rc = open_segment_locked(last_seq + 1);
+    if (rc == 0) g_sp.enabled = 1;
+    pthread_mutex_unlock(&g_sp.lock);
+    if (rc != 0) return -1;
+
+    // 주기 fdatasync 스레드 (시작 실패 시 append마다 fdatasync)
+    if (g_sp.fsync && g_sp.fsync_ms > 0) {
+        g_sp.sync_stop = 0;
+        if (pthread_create(&g_sp.sync_thread, NULL, sync_main, NULL) == 0) {
+            pthread_mutex_lock(&g_sp.lock);
+            g_sp.sync_started = 1;
+            pthread_mutex_unlock(&g_sp.lock);
+        } else {
+            fprintf(stderr, "[LOG_SPOOL] sync thread start failed (fdatasync on every append)\n");
+            g_sp.fsync_ms = 0;
+        }
+    }
+
+    engine_metrics_gauge_max(EM_GAUGE_SPOOL_BYTES_MAX, log_spool_pending_bytes());
+    printf("[LOG_SPOOL] opened dir=%s segments=%llu pending_bytes=%llu segment_bytes=%llu fsync=%d fsync_ms=%d\n",
+           g_sp.dir, (unsigned long long)segments, (unsigned long long)log_spool_pending_bytes(),
+           (unsigned long long)g_sp.segment_bytes, g_sp.fsync, g_sp.fsync_ms);
+    return 0;
+}
+
+void log_spool_close(void)
+{
+    if (g_sp.sync_started) {
+        pthread_mutex_lock(&g_sp.lock);
+        g_sp.sync_stop = 1;
+        pthread_cond_signal(&g_sp.sync_cond);
+        pthread_mutex_unlock(&g_sp.lock);
+        pthread_join(g_sp.sync_thread, NULL);
+        g_sp.sync_started = 0;
+        sync_once();
+    }
+
+    pthread_mutex_lock(&g_sp.lock);
+    if (g_sp.enabled) {
+        if (g_sp.fd >= 0) {
+            (void)fdatasync(g_sp.fd);
+            close(g_sp.fd);
+        }
+        g_sp.fd = -1;
+        g_sp.enabled = 0;
+    }
+    pthread_mutex_unlock(&g_sp.lock);
+
+    if (g_sp.rfd >= 0) close(g_sp.rfd);
+    g_sp.rfd = -1;
+
+    log_spool_thread_cleanup();
+}
+
+void log_spool_thread_cleanup(void)
+{
+    free(t_buf.p);
+    memset(&t_buf, 0, sizeof(t_buf));
+}
+
+int log_spool_enabled(void)
+{
+    return __atomic_load_n(&g_sp.enabled, __ATOMIC_ACQUIRE);
+}
+
+int log_spool_append(const access_log_record_t* const* recs, const int* kinds, int n)
+{
+    if (!log_spool_enabled() || !recs || n <= 0) return -1;
+
+    // 직렬화는 lock 밖에서
+    sp_buf_t* b = &t_buf;
+    b->len = 0;
+    b->err = 0;
+    for (int i = 0; i < n; i++) {
+        size_t hdr = b->len;
+        static const uint8_t zero_hdr[SPOOL_HDR_SIZE];
+        put_bytes(b, zero_hdr, sizeof(zero_hdr));  // 자리만 확보, payload 뒤에 채움
+        put_record(b, recs[i], kinds ? kinds[i] : 0);
+        if (b->err) return -1;
+
+        size_t plen = b->len - hdr - SPOOL_HDR_SIZE;
+        if (plen > SPOOL_MAX_PAYLOAD) return -1;
+
+        uint32_t crc = crc32_of(b->p + hdr + SPOOL_HDR_SIZE, plen);
+        uint32_t h[3] = { SPOOL_MAGIC, (uint32_t)plen, crc };
+        for (int k = 0; k < 3; k++) {
+            for (int j = 0; j < 4; j++) b->p[hdr + (size_t)k * 4 + (size_t)j] = (uint8_t)(h[k] >> (8 * j));
+        }
+    }
+
+    int rc = -1;
+    pthread_mutex_lock(&g_sp.lock);
+    if (g_sp.fd < 0) goto out;
+
+    if (g_sp.total_bytes + b->len > g_sp.max_bytes) {
+        fprintf(stderr, "[LOG_SPOOL] full (%llu bytes), %d record(s) not spooled\n",
+                (unsigned long long)g_sp.total_bytes, n);
+        goto out;
+    }
+
+    if (g_sp.active_size > 0 && g_sp.active_size + b->len > g_sp.segment_bytes) {
+        // 주기 모드: 닫기 전 flush는 sync 스레드가 (이전 segment가 아직 남아 있으면 여기서)
+        if (g_sp.sync_started && g_sp.dirty && g_sp.retired_fd < 0) {
+            g_sp.retired_fd = g_sp.fd;
+        } else {
+            (void)fdatasync(g_sp.fd);
+            close(g_sp.fd);
+        }
+        g_sp.fd = -1;
+        g_sp.dirty = 0;
+        if (open_segment_locked(g_sp.active_seq + 1) != 0) goto out;
+    }
+
+    int sync_now = g_sp.fsync && !g_sp.sync_started;
+    if (write_full(g_sp.fd, b->p, b->len) != 0 || (sync_now && fdatasync(g_sp.fd) != 0)) {
+        // 일부만 쓰였으면 잘라냄 (재생 시 뒤 레코드까지 버리지 않도록)
+        fprintf(stderr, "[LOG_SPOOL] write failed: %s\n", strerror(errno));
+        if (ftruncate(g_sp.fd, (off_t)g_sp.active_size) != 0) {
+            close(g_sp.fd);
+            g_sp.fd = -1;
+            (void)open_segment_locked(g_sp.active_seq + 1);
+        }
+        goto out;
+    }
+
+    g_sp.active_size += b->len;
+    g_sp.total_bytes += b->len;
+    g_sp.dirty = 1;
+    engine_metrics_gauge_max(EM_GAUGE_SPOOL_BYTES_MAX, g_sp.total_bytes - g_sp.coff);
+    rc = 0;
+
+out:
+    pthread_mutex_unlock(&g_sp.lock);
+    return rc;
+}
+
+/* ---------- 재생 ---------- */
+
+static void reader_close(void)
+{
+    if (g_sp.rfd >= 0) close(g_sp.rfd);
+    g_sp.rfd = -1;
+}
+
+// 현재 segment 나머지를 건너뜀 (잘린 tail / CRC 불일치)
+static void reader_skip_segment(const char* why, uint64_t limit, uint64_t active_seq)
+{
+    fprintf(stderr, "[LOG_SPOOL] segment %llu offset %llu: %s, skipping rest of segment\n",
+            (unsigned long long)g_sp.rseq, (unsigned long long)g_sp.roff, why);
+    engine_metrics_count(EM_COUNT_SPOOL_CORRUPT, 1);
+
+    if (g_sp.rseq < active_seq) {
+        reader_close();
+        g_sp.rseq++;
+        g_sp.roff = 0;
+    } else {
+        g_sp.roff = limit;
+    }
+}
+
+int log_spool_read(access_log_record_copy_t* out, int* kinds, log_spool_pos_t* ends, int max)
+{
+    if (!log_spool_enabled() || !out || !kinds || max <= 0) return 0;
+
+    uint8_t hdr[SPOOL_HDR_SIZE];
+    uint8_t payload[SPOOL_MAX_PAYLOAD];
+    int n = 0;
+
+    while (n < max) {
+        pthread_mutex_lock(&g_sp.lock);
+        uint64_t active_seq = g_sp.active_seq;
+        uint64_t active_size = g_sp.active_size;
+        pthread_mutex_unlock(&g_sp.lock);
+
+        if (g_sp.rfd < 0) {
+            char path[320];
+            segment_path(path, sizeof(path), g_sp.rseq);
+            g_sp.rfd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+            struct stat st;
+            if (g_sp.rfd >= 0 && (fstat(g_sp.rfd, &st) != 0 || !file_trusted(path, &st))) {
+                reader_close();
+                engine_metrics_count(EM_COUNT_SPOOL_CORRUPT, 1);
+                if (g_sp.rseq >= active_seq) break;
+                g_sp.rseq++;
+                g_sp.roff = 0;
+                continue;
+            }
+            if (g_sp.rfd < 0) {
+                if (g_sp.rseq < active_seq) {
+                    g_sp.rseq++;
+                    g_sp.roff = 0;
+                    continue;
+                }
+                break;
+            }
+        }
+
+        // 현재 쓰는 segment는 append가 끝난 크기까지만
+        uint64_t limit = active_size;
+        if (g_sp.rseq < active_seq) {
+            struct stat st;
+            limit = (fstat(g_sp.rfd, &st) == 0) ? (uint64_t)st.st_size : 0;
+        }
+
+        if (g_sp.roff + SPOOL_HDR_SIZE > limit) {
+            if (g_sp.rseq >= active_seq) break;
+            if (g_sp.roff < limit) {
+                reader_skip_segment("truncated record", limit, active_seq);
+                continue;
+            }
+            reader_close();
+            g_sp.rseq++;
+            g_sp.roff = 0;
+            continue;
+        }
+
+        if (pread(g_sp.rfd, hdr, sizeof(hdr), (off_t)g_sp.roff) != (ssize_t)sizeof(hdr)) {
+            reader_skip_segment("header read failed", limit, active_seq);
+            continue;
+        }
+
+        sp_rd_t hr = { hdr, sizeof(hdr), 0, 0 };
+        uint32_t magic = (uint32_t)get_u64(&hr, 4);
+        uint32_t plen = (uint32_t)get_u64(&hr, 4);
+        uint32_t crc = (uint32_t)get_u64(&hr, 4);
+
+        if (magic != SPOOL_MAGIC || plen > SPOOL_MAX_PAYLOAD || g_sp.roff + SPOOL_HDR_SIZE + plen > limit) {
+            reader_skip_segment(magic != SPOOL_MAGIC ? "bad magic" : "truncated record", limit, active_seq);
+            continue;
+        }
+
+        if (pread(g_sp.rfd, payload, plen, (off_t)(g_sp.roff + SPOOL_HDR_SIZE)) != (ssize_t)plen ||
+            crc32_of(payload, plen) != crc) {
+            reader_skip_segment("crc mismatch", limit, active_seq);
+            continue;
+        }
+
+        g_sp.roff += SPOOL_HDR_SIZE + plen;
+
+        sp_rd_t pr = { payload, plen, 0, 0 };
+        if (get_record(&pr, &out[n], &kinds[n]) != 0) {
+            // CRC는 맞지만 해석할 수 없는 레코드 (버전 불일치 등): 이 레코드만 건너뜀
+            engine_metrics_count(EM_COUNT_SPOOL_CORRUPT, 1);
+            continue;
+        }
+        if (ends) {
+            ends[n].seq = g_sp.rseq;
+            ends[n].off = g_sp.roff;
+        }
+        n++;
+    }
+    return n;
+}
+
+// seq/off까지 DB 기록 완료: cursor 저장, 다 읽은 segment 삭제
+static void commit_at(uint64_t seq_to, uint64_t off_to)
+{
+    for (uint64_t seq = g_sp.cseq; seq < seq_to; seq++) {
+        char path[320];
+        struct stat st;
+        segment_path(path, sizeof(path), seq);
+        if (lstat(path, &st) != 0) continue;
+        if (unlink(path) == 0) {
+            pthread_mutex_lock(&g_sp.lock);
+            g_sp.total_bytes -= ((uint64_t)st.st_size < g_sp.total_bytes) ? (uint64_t)st.st_size : g_sp.total_bytes;
+            pthread_mutex_unlock(&g_sp.lock);
+        }
+    }
+
+    if (g_sp.cseq == seq_to && g_sp.coff == off_to) return;
+
+    pthread_mutex_lock(&g_sp.lock);
+    g_sp.cseq = seq_to;
+    g_sp.coff = off_to;
+    pthread_mutex_unlock(&g_sp.lock);
+    write_cursor();
+}
+
+// 마지막 read까지 DB 기록 완료
+void log_spool_commit(void)
+{
+    if (!log_spool_enabled()) return;
+    commit_at(g_sp.rseq, g_sp.roff);
+}
+
+void log_spool_commit_to(const log_spool_pos_t* pos)
+{
+    if (!log_spool_enabled() || !pos) return;
+
+    // commit 위치보다 앞이거나 읽은 위치를 넘는 값은 무시
+    if (pos->seq < g_sp.cseq || (pos->seq == g_sp.cseq && pos->off < g_sp.coff)) return;
+    if (pos->seq > g_sp.rseq || (pos->seq == g_sp.rseq && pos->off > g_sp.roff)) return;
+    commit_at(pos->seq, pos->off);
+}
+
+void log_spool_rewind(void)
+{
+    reader_close();
+    g_sp.rseq = g_sp.cseq;
+    g_sp.roff = g_sp.coff;
+}
+
+uint64_t log_spool_pending_bytes(void)
+{
+    pthread_mutex_lock(&g_sp.lock);
+    uint64_t total = g_sp.total_bytes;
+    uint64_t done = g_sp.coff;
+    pthread_mutex_unlock(&g_sp.lock);
+    return total > done ? total - done : 0;
+}
@@ -0,0 +1,616 @@
+// src/log_writer.c
+#include "log_writer.h"
+#include "db_pool.h"
+#include "engine_metrics.h"
+#include "log_spool.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LW_REPLAY_IDLE_US  200000  // spool이 비었거나 DB가 없을 때 재생 대기
+
+// 큐 항목: 문자열을 소유하는 레코드 복사본
+typedef struct {
+    access_log_record_copy_t c;
+    log_write_kind_t         kind;
+} log_entry_t;
+
+// 배치 기록용 작업 배열 (batch_max 크기)
+typedef struct {
+    const access_log_record_t** recs;
+    int*                        kinds;
+    unsigned char*              done;
+    const access_log_record_t** ins;
+} lw_batch_t;
+
+// bounded MPSC 큐 셀: seq로 빈 칸 / 찬 칸 구분 (Vyukov 방식)
+// 항목은 셀에 미리 할당 (submit마다 malloc 없음), writer가 배치를 기록한 뒤 셀을 반환
+typedef struct {
+    uint64_t    seq;
+    log_entry_t item;
+} lw_cell_t;
+
+typedef struct {
+    lw_cell_t* cells;
+    uint64_t   mask;
+    uint64_t   head __attribute__((aligned(64)));       // 다음 push 위치 (producer CAS)
+    uint64_t   tail __attribute__((aligned(64)));       // 다음 pop 위치 (writer 전용)
+    uint64_t   release;                                 // 아직 반환하지 않은 첫 셀 (writer 전용)
+    uint64_t   submitted __attribute__((aligned(64)));  // 큐에 넣은 레코드 (drain 기준)
+    uint64_t   completed;                               // 기록을 마친 레코드
+    int        parked;                                  // writer가 빈 큐에서 잠듦 (submit이 깨움)
+
+    pthread_mutex_t park_lock;
+    pthread_cond_t  park_cond;                          // CLOCK_MONOTONIC (flush 기한 대기)
+
+    log_entry_t** batch;
+    lw_batch_t    work;
+
+    pthread_t  thread;
+    int        index;
+    int        started;
+} __attribute__((aligned(64))) lw_worker_t;
+
+static log_writer_config_t g_cfg;
+static lw_worker_t* g_workers = NULL;
+static int          g_worker_count = 0;
+static int          g_running = 0;
+static int          g_stop = 0;
+
+// spool 재생 스레드 (spool이 열려 있을 때만)
+static pthread_t    g_replay_thread;
+static int          g_replay_started = 0;
+
+static uint32_t hash_request_id(const char* s)
+{
+    uint32_t h = 2166136261u;
+    for (; *s; s++) {
+        h ^= (uint8_t)*s;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int lwq_push(lw_worker_t* w, const access_log_record_t* rec, log_write_kind_t kind)
+{
+    uint64_t pos = __atomic_load_n(&w->head, __ATOMIC_RELAXED);
+    for (;;) {
+        lw_cell_t* cell = &w->cells[pos & w->mask];
+        uint64_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int64_t dif = (int64_t)seq - (int64_t)pos;
+
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&w->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                access_log_record_copy(&cell->item.c, rec);
+                cell->item.kind = kind;
+                __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+                return 0;
+            }
+            // 실패 시 pos는 현재 head로 갱신됨
+        } else if (dif < 0) {
+            return -1;  // 가득 참
+        } else {
+            pos = __atomic_load_n(&w->head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// 셀 안의 항목을 그대로 반환 (lwq_release 전까지 producer가 덮어쓰지 않음)
+static log_entry_t* lwq_pop(lw_worker_t* w)
+{
+    uint64_t pos = w->tail;
+    lw_cell_t* cell = &w->cells[pos & w->mask];
+    uint64_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+    if ((int64_t)seq - (int64_t)(pos + 1) < 0) return NULL;
+
+    __atomic_store_n(&w->tail, pos + 1, __ATOMIC_RELAXED);
+    return &cell->item;
+}
+
+// 다음 셀이 찼는지만 확인 (writer 전용)
+static int lwq_ready(lw_worker_t* w)
+{
+    uint64_t pos = w->tail;
+    uint64_t seq = __atomic_load_n(&w->cells[pos & w->mask].seq, __ATOMIC_ACQUIRE);
+    return (int64_t)seq - (int64_t)(pos + 1) >= 0;
+}
+
+// pop한 순서대로 n개 셀을 빈 칸으로 반환
+static void lwq_release(lw_worker_t* w, int n)
+{
+    for (int i = 0; i < n; i++) {
+        uint64_t pos = w->release++;
+        __atomic_store_n(&w->cells[pos & w->mask].seq, pos + w->mask + 1, __ATOMIC_RELEASE);
+    }
+}
+
+static int batch_alloc(lw_batch_t* b, int n)
+{
+    b->recs = (const access_log_record_t**)calloc((size_t)n, sizeof(*b->recs));
+    b->kinds = (int*)calloc((size_t)n, sizeof(*b->kinds));
+    b->done = (unsigned char*)calloc((size_t)n, sizeof(*b->done));
+    b->ins = (const access_log_record_t**)calloc((size_t)n, sizeof(*b->ins));
+    return (b->recs && b->kinds && b->done && b->ins) ? 0 : -1;
+}
+
+static void batch_free(lw_batch_t* b)
+{
+    free(b->recs);
+    free(b->kinds);
+    free(b->done);
+    free(b->ins);
+    memset(b, 0, sizeof(*b));
+}
+
+// 행 단위 실패: 영구 오류(중복 / 잘못된 데이터)만 그 행의 거부로 처리 (spool에 다시 넣어도 같은 결과)
+// 그 밖의 오류는 -1 -> 기록 못 한 레코드로 spool / 재생 재시도
+// spool 재생 중 request_id 중복은 rewind 이전(또는 종료 전)에 이미 기록된 레코드: 거부가 아니라 기록됨
+static int row_failed(unsigned char* done, const access_log_record_t* rec, const char* what, int replay)
+{
+    unsigned int err = db_last_errno();
+    if (!db_error_is_permanent(err)) return -1;
+
+    if (replay && db_error_is_duplicate(err)) {
+        *done = 1;
+        return 0;
+    }
+
+    fprintf(stderr, "[LOG_WRITER] %s rejected request_id=%s: error %u\n", what, rec->request_id, err);
+    engine_metrics_count(EM_COUNT_LOG_REJECTED, 1);
+    *done = 1;
+    return 0;
+}
+
+/*
+ * n건 기록: 새 행 multi-row INSERT -> 늦은 완료 추가 기록
+ * - done[i]: 기록했거나 DB가 거부한 레코드
+ * - replay: spool 재생 (이미 기록된 레코드가 다시 올 수 있음)
+ * 반환값: 0 (모두 처리), -1 (연결 끊김 / 일시적 오류: done이 0인 레코드는 기록되지 않음)
+ */
+static int write_records(MYSQL* conn, lw_batch_t* b, int n, int replay)
+{
+    memset(b->done, 0, (size_t)n);
+
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (b->kinds[i] == LOG_WRITE_INSERT) b->ins[m++] = b->recs[i];
+    }
+
+    if (m > 0 && insert_access_log_batch(conn, b->ins, m) == 0) {
+        for (int i = 0; i < n; i++) {
+            if (b->kinds[i] == LOG_WRITE_INSERT) b->done[i] = 1;
+        }
+    } else if (m > 0) {
+        // 한 행도 들어가지 않았으므로 1건씩 다시 기록 (잘못된 행만 실패)
+        engine_metrics_count(EM_COUNT_LOG_FALLBACK, 1);
+        for (int i = 0; i < n; i++) {
+            if (b->kinds[i] != LOG_WRITE_INSERT) continue;
+            if (insert_access_log_record(conn, b->recs[i]) >= 0) {
+                b->done[i] = 1;
+            } else if (row_failed(&b->done[i], b->recs[i], "access_log insert", replay) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    // 같은 배치의 flush 레코드가 먼저 저장된 뒤 처리
+    for (int i = 0; i < n; i++) {
+        if (b->kinds[i] != LOG_WRITE_LATE) continue;
+        if (update_access_log_record(conn, b->recs[i]) == 0) {
+            b->done[i] = 1;
+        } else if (row_failed(&b->done[i], b->recs[i], "late update", replay) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// spool에 넣기 (spool이 없거나 가득 차면 버림), 반환값: spool에 넣은 건수
+static int spill(const access_log_record_t* const* recs, const int* kinds, int n)
+{
+    if (n <= 0) return 0;
+
+    if (log_spool_enabled() && log_spool_append(recs, kinds, n) == 0) {
+        engine_metrics_count(EM_COUNT_LOG_SPOOLED, (uint64_t)n);
+        return n;
+    }
+    engine_metrics_count(EM_COUNT_LOG_DROPPED, (uint64_t)n);
+    return 0;
+}
+
+// 배치 1회 기록: DB에 기록하지 못한 레코드(연결 없음 / 끊김)는 spool로
+static void write_batch(lw_worker_t* w, int n)
+{
+    uint64_t t0 = engine_metrics_now_ns();
+    lw_batch_t* b = &w->work;
+
+    for (int i = 0; i < n; i++) {
+        b->recs[i] = &w->batch[i]->c.rec;
+        b->kinds[i] = (int)w->batch[i]->kind;
+        b->done[i] = 0;
+    }
+
+    // 풀 연결 (affinity로 보통 같은 연결, DB 장애면 backoff 동안 바로 NULL)
+    MYSQL* conn = db_pool_acquire(-1);
+    if (conn) db_pool_release(conn, write_records(conn, b, n, 0) != 0);
+
+    int written = 0;
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (b->done[i]) {
+            written++;
+        } else {
+            // 기록 못 한 레코드를 앞으로 모음 (done 기준으로 이미 판정했으므로 덮어써도 됨)
+            b->recs[m] = b->recs[i];
+            b->kinds[m] = b->kinds[i];
+            m++;
+        }
+    }
+    (void)spill(b->recs, b->kinds, m);
+
+    if (written > 0) {
+        engine_metrics_record(EM_STAGE_LOG_WRITE, engine_metrics_now_ns() - t0);
+        engine_metrics_count(EM_COUNT_LOG_WRITTEN, (uint64_t)written);
+        engine_metrics_count(EM_COUNT_LOG_BATCHES, 1);
+        engine_metrics_gauge_max(EM_GAUGE_LOG_BATCH_MAX, (uint64_t)written);
+    }
+
+    for (int i = 0; i < n; i++) w->batch[i] = NULL;
+    lwq_release(w, n);
+    __atomic_add_fetch(&w->completed, (uint64_t)n, __ATOMIC_RELEASE);
+}
+
+/*
+ * 큐가 비었을 때 대기 (deadline_ns가 0이 아니면 모으는 중인 배치의 flush 기한까지)
+ * - parked를 올린 뒤 큐를 다시 확인, submit은 push 후 parked를 확인 (둘 다 SEQ_CST)
+ *   -> 빈 큐 -> 레코드 전환 시 한쪽은 반드시 상대를 봄 (깨우기 누락 없음)
+ * - 레코드가 계속 들어오는 동안에는 잠들지 않으므로 submit은 신호를 보내지 않음
+ */
+static void writer_park(lw_worker_t* w, uint64_t deadline_ns)
+{
+    pthread_mutex_lock(&w->park_lock);
+    __atomic_store_n(&w->parked, 1, __ATOMIC_SEQ_CST);
+
+    while (__atomic_load_n(&w->parked, __ATOMIC_SEQ_CST) &&
+           !__atomic_load_n(&g_stop, __ATOMIC_SEQ_CST) && !lwq_ready(w)) {
+        if (deadline_ns == 0) {
+            pthread_cond_wait(&w->park_cond, &w->park_lock);
+            continue;
+        }
+        if (engine_metrics_now_ns() >= deadline_ns) break;
+
+        struct timespec ts;
+        ts.tv_sec = (time_t)(deadline_ns / 1000000000ull);
+        ts.tv_nsec = (long)(deadline_ns % 1000000000ull);
+        (void)pthread_cond_timedwait(&w->park_cond, &w->park_lock, &ts);
+    }
+
+    __atomic_store_n(&w->parked, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&w->park_lock);
+}
+
+// 잠든 writer만 깨움 (여러 producer가 동시에 봐도 신호는 한 번)
+static void writer_wake(lw_worker_t* w)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&w->parked, __ATOMIC_RELAXED)) return;
+    if (!__atomic_exchange_n(&w->parked, 0, __ATOMIC_SEQ_CST)) return;
+
+    pthread_mutex_lock(&w->park_lock);
+    pthread_cond_signal(&w->park_cond);
+    pthread_mutex_unlock(&w->park_lock);
+}
+
+static void* writer_main(void* arg)
+{
+    lw_worker_t* w = (lw_worker_t*)arg;
+
+    if (g_cfg.thread_begin && g_cfg.thread_begin(w->index) != 0) {
+        fprintf(stderr, "[LOG_WRITER %d] thread init failed\n", w->index);
+    }
+
+    uint64_t flush_ns = (uint64_t)g_cfg.flush_ms * 1000000ull;
+    uint64_t first_ns = 0;
+    int n = 0;
+
+    for (;;) {
+        // stop 확인 후 pop: 종료 요청 전에 들어온 레코드는 모두 이번 루프에서 보임
+        int stopping = __atomic_load_n(&g_stop, __ATOMIC_ACQUIRE);
+
+        log_entry_t* e;
+        while (n < g_cfg.batch_max && (e = lwq_pop(w)) != NULL) {
+            if (n == 0) first_ns = engine_metrics_now_ns();
+            w->batch[n++] = e;
+        }
+
+        if (n > 0 && (n >= g_cfg.batch_max || stopping || engine_metrics_now_ns() - first_ns >= flush_ns)) {
+            write_batch(w, n);
+            n = 0;
+            continue;
+        }
+        if (stopping && n == 0) break;
+
+        writer_park(w, n > 0 ? first_ns + flush_ns : 0);
+    }
+
+    db_thread_cleanup();
+    log_spool_thread_cleanup();
+    if (g_cfg.thread_end) g_cfg.thread_end();
+    return NULL;
+}
+
+/*
+ * spool 재생: read -> DB 기록 -> commit
+ * 연결이 끊기면 앞에서부터 기록된 레코드까지 commit 후 rewind (풀이 재연결)
+ * 레코드별 트랜잭션이므로 기록 안 된 레코드는 처음부터 다시 기록
+ */
+static void* replay_main(void* arg)
+{
+    (void)arg;
+    int index = g_cfg.threads;
+
+    if (g_cfg.thread_begin && g_cfg.thread_begin(index) != 0) {
+        fprintf(stderr, "[LOG_WRITER %d] thread init failed\n", index);
+    }
+
+    lw_batch_t b;
+    memset(&b, 0, sizeof(b));
+    access_log_record_copy_t* buf =
+        (access_log_record_copy_t*)calloc((size_t)g_cfg.batch_max, sizeof(access_log_record_copy_t));
+    log_spool_pos_t* ends = (log_spool_pos_t*)calloc((size_t)g_cfg.batch_max, sizeof(log_spool_pos_t));
+    if (!buf || !ends || batch_alloc(&b, g_cfg.batch_max) != 0) {
+        fprintf(stderr, "[LOG_WRITER %d] spool replay disabled (out of memory)\n", index);
+        goto out;
+    }
+
+    while (!__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE)) {
+        MYSQL* conn = (log_spool_pending_bytes() > 0) ? db_pool_acquire(-1) : NULL;
+        if (!conn) {
+            usleep(LW_REPLAY_IDLE_US);
+            continue;
+        }
+
+        int n = log_spool_read(buf, b.kinds, ends, g_cfg.batch_max);
+        if (n == 0) {
+            // 건너뛴 손상 구간 / 다 읽은 segment 정리
+            db_pool_release(conn, 0);
+            log_spool_commit();
+            usleep(LW_REPLAY_IDLE_US);
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) b.recs[i] = &buf[i].rec;
+
+        uint64_t t0 = engine_metrics_now_ns();
+        int rc = write_records(conn, &b, n, 1);
+        db_pool_release(conn, rc != 0);
+        if (rc == 0) {
+            log_spool_commit();
+            engine_metrics_record(EM_STAGE_LOG_WRITE, engine_metrics_now_ns() - t0);
+            engine_metrics_count(EM_COUNT_LOG_REPLAYED, (uint64_t)n);
+        } else {
+            // 일시적 오류: 기록된 앞부분은 commit (오류가 잦아도 진행), 나머지는 잠시 대기 후 다시 읽음
+            int k = 0;
+            while (k < n && b.done[k]) k++;
+            if (k > 0) {
+                log_spool_commit_to(&ends[k - 1]);
+                engine_metrics_count(EM_COUNT_LOG_REPLAYED, (uint64_t)k);
+            }
+            log_spool_rewind();
+            usleep(LW_REPLAY_IDLE_US);
+        }
+    }
+
+out:
+    db_thread_cleanup();
+    batch_free(&b);
+    free(buf);
+    free(ends);
+    if (g_cfg.thread_end) g_cfg.thread_end();
+    return NULL;
+}
+
+static void free_workers(void)
+{
+    for (int i = 0; i < g_worker_count; i++) {
+        pthread_mutex_destroy(&g_workers[i].park_lock);
+        pthread_cond_destroy(&g_workers[i].park_cond);
+        free(g_workers[i].cells);
+        free(g_workers[i].batch);
+        batch_free(&g_workers[i].work);
+    }
+    free(g_workers);
+    g_workers = NULL;
+    g_worker_count = 0;
+}
+
+static const char* overflow_name(log_writer_overflow_t o)
+{
+    switch (o) {
+    case LOG_WRITER_OVERFLOW_SYNC:  return "sync";
+    case LOG_WRITER_OVERFLOW_SPOOL: return "spool";
+    default:                        return "drop";
+    }
+}
+
+int log_writer_start(const log_writer_config_t* cfg)
+{
+    if (!cfg || cfg->threads <= 0 || g_running) return -1;
+
+    g_cfg = *cfg;
+    if (g_cfg.batch_max <= 0) g_cfg.batch_max = 1;
+    if (g_cfg.flush_ms < 0) g_cfg.flush_ms = 0;
+    if (g_cfg.overflow == LOG_WRITER_OVERFLOW_SPOOL && !log_spool_enabled()) {
+        fprintf(stderr, "[LOG_WRITER] overflow=spool without spool, using sync\n");
+        g_cfg.overflow = LOG_WRITER_OVERFLOW_SYNC;
+    }
+
+    // 기록 중인 배치도 셀을 잡고 있으므로 batch_max의 2배 이상
+    uint64_t qsize = 64;
+    while (qsize < (uint64_t)(cfg->queue_size > 0 ? cfg->queue_size : 1) ||
+           qsize < 2 * (uint64_t)g_cfg.batch_max) {
+        qsize <<= 1;
+    }
+
+    g_workers = (lw_worker_t*)calloc((size_t)cfg->threads, sizeof(lw_worker_t));
+    if (!g_workers) return -1;
+    g_worker_count = cfg->threads;
+
+    // park 기한을 engine_metrics_now_ns와 같은 monotonic 시계로
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    for (int i = 0; i < g_worker_count; i++) {
+        pthread_mutex_init(&g_workers[i].park_lock, NULL);
+        pthread_cond_init(&g_workers[i].park_cond, &ca);
+    }
+    pthread_condattr_destroy(&ca);
+
+    for (int i = 0; i < g_worker_count; i++) {
+        lw_worker_t* w = &g_workers[i];
+        w->index = i;
+        w->mask = qsize - 1;
+        w->cells = (lw_cell_t*)calloc((size_t)qsize, sizeof(lw_cell_t));
+        w->batch = (log_entry_t**)calloc((size_t)g_cfg.batch_max, sizeof(log_entry_t*));
+        if (!w->cells || !w->batch || batch_alloc(&w->work, g_cfg.batch_max) != 0) {
+            free_workers();
+            return -1;
+        }
+        for (uint64_t s = 0; s < qsize; s++) w->cells[s].seq = s;
+    }
+
+    g_stop = 0;
+    for (int i = 0; i < g_worker_count; i++) {
+        if (pthread_create(&g_workers[i].thread, NULL, writer_main, &g_workers[i]) != 0) {
+            fprintf(stderr, "[LOG_WRITER] thread start failed\n");
+            __atomic_store_n(&g_stop, 1, __ATOMIC_SEQ_CST);
+            for (int j = 0; j < i; j++) {
+                writer_wake(&g_workers[j]);
+                pthread_join(g_workers[j].thread, NULL);
+            }
+            free_workers();
+            return -1;
+        }
+        g_workers[i].started = 1;
+    }
+
+    if (log_spool_enabled()) {
+        if (pthread_create(&g_replay_thread, NULL, replay_main, NULL) == 0) {
+            g_replay_started = 1;
+        } else {
+            fprintf(stderr, "[LOG_WRITER] spool replay thread start failed (spooled records wait for restart)\n");
+        }
+    }
+
+    __atomic_store_n(&g_running, 1, __ATOMIC_RELEASE);
+    printf("[LOG_WRITER] started threads=%d queue=%llu batch_max=%d flush_ms=%d overflow=%s replay=%d\n",
+           g_worker_count, (unsigned long long)qsize, g_cfg.batch_max, g_cfg.flush_ms,
+           overflow_name(g_cfg.overflow), g_replay_started);
+    return 0;
+}
+
+// 제출하는 스레드(캡처 / AI 콜백 / flush)가 모두 멈춘 뒤 호출
+void log_writer_stop(void)
+{
+    if (!g_running) return;
+
+    __atomic_store_n(&g_running, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_stop, 1, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < g_worker_count; i++) writer_wake(&g_workers[i]);
+
+    uint64_t written = 0;
+    for (int i = 0; i < g_worker_count; i++) {
+        if (g_workers[i].started) pthread_join(g_workers[i].thread, NULL);
+        written += g_workers[i].completed;
+    }
+    if (g_replay_started) pthread_join(g_replay_thread, NULL);
+    g_replay_started = 0;
+    printf("[LOG_WRITER] stopped records=%llu\n", (unsigned long long)written);
+
+    free_workers();
+}
+
+int log_writer_enabled(void)
+{
+    return __atomic_load_n(&g_running, __ATOMIC_ACQUIRE);
+}
+
+void log_writer_drain(void)
+{
+    if (!log_writer_enabled()) return;
+
+    for (int i = 0; i < g_worker_count; i++) {
+        lw_worker_t* w = &g_workers[i];
+        while (__atomic_load_n(&w->completed, __ATOMIC_ACQUIRE) <
+               __atomic_load_n(&w->submitted, __ATOMIC_ACQUIRE)) {
+            usleep(1000);
+        }
+    }
+}
+
+static int overflow_result(const access_log_record_t* rec, log_write_kind_t kind)
+{
+    if (g_cfg.overflow == LOG_WRITER_OVERFLOW_SYNC) {
+        engine_metrics_count(EM_COUNT_LOG_SYNC, 1);
+        return LOG_WRITER_DIRECT;
+    }
+    if (g_cfg.overflow == LOG_WRITER_OVERFLOW_SPOOL) {
+        return (log_writer_spill(rec, kind) == 0) ? LOG_WRITER_SPOOLED : LOG_WRITER_DROPPED;
+    }
+    engine_metrics_count(EM_COUNT_LOG_DROPPED, 1);
+    return LOG_WRITER_DROPPED;
+}
+
+int log_writer_spill(const access_log_record_t* rec, log_write_kind_t kind)
+{
+    if (!rec) return -1;
+
+    int k = (int)kind;
+    return (spill(&rec, &k, 1) == 1) ? 0 : -1;
+}
+
+int log_writer_submit(const access_log_record_t* rec, log_write_kind_t kind)
+{
+    if (!rec || !log_writer_enabled()) return LOG_WRITER_DIRECT;
+
+    lw_worker_t* w = &g_workers[hash_request_id(rec->request_id) % (uint32_t)g_worker_count];
+
+    // push 전에 올림 (writer가 먼저 완료해도 drain이 submitted보다 앞서지 않도록)
+    __atomic_add_fetch(&w->submitted, 1, __ATOMIC_RELEASE);
+    if (lwq_push(w, rec, kind) != 0) {
+        __atomic_sub_fetch(&w->submitted, 1, __ATOMIC_RELEASE);
+        return overflow_result(rec, kind);
+    }
+
+    writer_wake(w);
+
+    engine_metrics_count(EM_COUNT_LOG_QUEUED, 1);
+    uint64_t tail = __atomic_load_n(&w->tail, __ATOMIC_RELAXED);
+    uint64_t head = __atomic_load_n(&w->head, __ATOMIC_RELAXED);
+    engine_metrics_gauge_max(EM_GAUGE_LOG_QUEUE_MAX, head - tail);
+    return LOG_WRITER_QUEUED;
+}
+
+int log_writer_overflow_from_str(const char* s, log_writer_overflow_t* out)
+{
+    if (!s || !out) return -1;
+
+    if (strcasecmp(s, "drop") == 0) {
+        *out = LOG_WRITER_OVERFLOW_DROP;
+        return 0;
+    }
+    if (strcasecmp(s, "sync") == 0 || strcasecmp(s, "block") == 0) {
+        *out = LOG_WRITER_OVERFLOW_SYNC;
+        return 0;
+    }
+    if (strcasecmp(s, "spool") == 0) {
+        *out = LOG_WRITER_OVERFLOW_SPOOL;
+        return 0;
+    }
+    return -1;
+}
@@ -1,16 +1,29 @@
 // engine_C/src/main.c
 #include "policy.h"
+#include "policy_snapshot.h"
 #include "packet_manager.h"
+#include "packet_extractor.h"
 #include "http_response_injector.h"
+#include "raw_socket_sender.h"
 #include "engine_struct.h"
 #include "url_classification_client.h"
+#include "url_native_model.h"
+#include "url_prescore.h"
 #include "decision_manager.h"
+#include "decision_cache.h"
 #include "db_function.h"
+#include "db_pool.h"
+#include "log_spool.h"
+#include "log_writer.h"
+#include "engine_metrics.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
 #include <sys/time.h>
 #include <uuid/uuid.h>
 #include <mysql/mysql.h>
@@ -62,16 +75,16 @@ static int calc_engine_latency_ms(const HttpEvent* ev)
     return (int)(cur - ev->detect_ts_ms);
 }
 
-static void build_score_endpoint(char* out, size_t outsz)
+static void build_score_endpoint(char* out, size_t outsz, const char* api_path)
 {
     const char* base = get_env_str("AI_BASE_URL", "http://127.0.0.1:8000");
     if (!out || outsz == 0) return;
 
     size_t len = strlen(base);
     if (len > 0 && base[len - 1] == '/')
-        snprintf(out, outsz, "%sv1/score", base);
+        snprintf(out, outsz, "%s%s", base, api_path);
     else
-        snprintf(out, outsz, "%s/v1/score", base);
+        snprintf(out, outsz, "%s/%s", base, api_path);
 }
 
 /* -------------------------
@@ -171,38 +184,37 @@ static int should_bypass_policy_for_ai_test(const HttpEvent* ev)
 }
 
 // globals
-static MYSQL* g_conn = NULL;
-static policy_cache_t g_cache;
+// - DB 연결은 db_pool에서 빌려 씀 (MYSQL 핸들은 한 번에 한 스레드만 사용)
+// - 정책은 policy_snapshot이 관리 (재로드 스레드가 교체, 워커는 acquire/release로 읽기)
 
-// DB 연결
-static MYSQL* db_connect(void)
+// AI circuit breaker OPEN 시 판정 (AI_CIRCUIT_OPEN_ACTION, 기본 REVIEW)
+static action_t g_circuit_open_action = ACT_REVIEW;
+
+// ENGINE_DRY_RUN=1: DB 없이 실행 (부하 테스트/벤치마크, engine_C/bench)
+// - access_log 저장과 차단 응답 주입은 생략
+static int g_dry_run = 0;
+
+// 캡처 워커 스레드 시작 시 DB 클라이언트 스레드 준비 (연결은 쓸 때 풀에서)
+int engine_worker_init(int worker_id)
 {
-    const char* db_host = get_env_str("DB_HOST", "127.0.0.1");
-    int db_port = get_env_int("DB_PORT", 3306);
-    const char* db_user = get_env_str("DB_USER", "gateguard");
-    const char* db_pass = get_env_str("DB_PASSWORD", "");
-    const char* db_name = get_env_str("DB_NAME", "gateguard");
+    if (g_dry_run) return 0;
 
-    MYSQL* conn = mysql_init(NULL);
-    if (!conn) {
-        fprintf(stderr, "mysql_init failed\n");
-        exit(1);
+    if (mysql_thread_init() != 0) {
+        fprintf(stderr, "[WORKER %d] mysql_thread_init failed\n", worker_id);
+        return -1;
     }
+    return 0;
+}
 
-    mysql_options(conn, MYSQL_SET_CHARSET_NAME, "utf8mb4");
-
-    unsigned int proto = MYSQL_PROTOCOL_TCP;
-    mysql_options(conn, MYSQL_OPT_PROTOCOL, &proto);
+void engine_worker_cleanup(void)
+{
+    ai_client_thread_cleanup();
+    log_spool_thread_cleanup();
+    db_thread_cleanup();
+    policy_snapshot_thread_cleanup();
+    raw_sender_close();  // 스레드별 raw 소켓 (주입한 스레드만 보유)
 
-    if (!mysql_real_connect(conn, db_host, db_user, db_pass, db_name, (unsigned int)db_port, NULL, 0))
-    {
-        fprintf(stderr,
-                "mysql connect failed: host=%s port=%d user=%s db=%s err=%s\n",
-                db_host, db_port, db_user, db_name, mysql_error(conn));
-        mysql_close(conn);
-        exit(1);
-    }
-    return conn;
+    if (!g_dry_run) mysql_thread_end();
 }
 
 static const char* ai_error_to_code(const ai_result_t* ar, char* out, size_t outsz)
@@ -232,6 +244,12 @@ static const char* ai_error_to_code(const ai_result_t* ar, char* out, size_t out
         case AI_ERR_CURL:
             snprintf(out, outsz, "AI_CURL");
             break;
+        case AI_ERR_BUSY:
+            snprintf(out, outsz, "AI_BUSY");
+            break;
+        case AI_ERR_CIRCUIT_OPEN:
+            snprintf(out, outsz, "AI_CIRCUIT_OPEN");
+            break;
         case AI_ERR_EMPTY:
         default:
             snprintf(out, outsz, "AI_EMPTY");
@@ -240,14 +258,408 @@ static const char* ai_error_to_code(const ai_result_t* ar, char* out, size_t out
     return out;
 }
 
-// 핵심 엔진 처리
-void engine_handle_http_event(const HttpEvent* ev)
+// 이벤트 기록 시작: 요청 필드 (문자열은 ev를 가리킴)
+static void record_init(access_log_record_t* rec, const HttpEvent* ev, const char* request_id, int64_t detect_ts_ms)
 {
-    if (!ev || !ev->is_http) return;
+    memset(rec, 0, sizeof(*rec));
+    snprintf(rec->request_id, sizeof(rec->request_id), "%s", request_id);
+    rec->detect_ts_ms = detect_ts_ms;
+    rec->client_ip = ev->meta.client_ip;
+    rec->client_port = (int)ev->meta.client_port;
+    rec->server_ip = ev->meta.server_ip;
+    rec->server_port = (int)ev->meta.server_port;
+    rec->host = ev->host;
+    rec->path = ev->path;
+    rec->method = ev->method;
+    rec->url_norm = ev->url_norm;
+    rec->engine_latency_ms = -1;
+}
+
+// decision 기록 (완료 시 access_log INSERT에 포함)
+static void record_decision(const HttpEvent* ev,
+                            access_log_record_t* rec,
+                            const char* decision,
+                            const char* reason,
+                            const char* stage,
+                            long long policy_id)
+{
+    rec->decision = decision;
+    rec->reason = reason;
+    rec->decision_stage = stage;
+    rec->policy_id = policy_id;
+    rec->engine_latency_ms = calc_engine_latency_ms(ev);
+}
+
+// ai_analysis 기록 (완료 시 access_log와 함께 INSERT)
+static void record_ai(access_log_record_t* rec, const ai_result_t* ar, int ai_response, const char* error_code)
+{
+    rec->has_ai = 1;
+    rec->ai = *ar;
+    rec->ai_response = ai_response;
+    snprintf(rec->ai_error_code, sizeof(rec->ai_error_code), "%s", error_code ? error_code : "");
+}
+
+// 직접 기록 (writer 미사용 / 큐 가득 참(sync)): 풀 연결로 기록, 실패하면 spool
+static int persist_direct(const access_log_record_t* rec, log_write_kind_t kind)
+{
+    MYSQL* conn = db_pool_acquire(-1);
+    int rc = -1;
+    if (conn) {
+        rc = (kind == LOG_WRITE_LATE) ? update_access_log_record(conn, rec)
+                                      : (insert_access_log_record(conn, rec) < 0 ? -1 : 0);
+        db_pool_release(conn, rc != 0);
+    }
+    return (rc == 0) ? 0 : log_writer_spill(rec, kind);
+}
+
+// 이벤트 완료: log writer 큐에 제출 (writer 미사용 / 큐 가득 참(sync)이면 직접 INSERT, 실패하면 spool)
+static void persist_record(const access_log_record_t* rec)
+{
+    if (g_dry_run) return;
+
+    uint64_t t0 = engine_metrics_now_ns();
+    if (log_writer_submit(rec, LOG_WRITE_INSERT) == LOG_WRITER_DIRECT &&
+        persist_direct(rec, LOG_WRITE_INSERT) != 0) {
+        fprintf(stderr, "[EVENT] access_log insert failed request_id=%s\n", rec->request_id);
+    }
+    engine_metrics_record(EM_STAGE_LOG_INSERT, engine_metrics_now_ns() - t0);
+}
+
+// 차단 이벤트: 응답 주입 (review_event는 완료 시 기록)
+static void enforce_block(const HttpEvent* ev, access_log_record_t* rec, int status_code)
+{
+    if (g_dry_run) return;
+
+    rec->review_needed = 1;
+
+    uint64_t t0 = engine_metrics_now_ns();
+    http_inject_result_t inj;
+    memset(&inj, 0, sizeof(inj));
+    http_response_inject(ev, rec->request_id, status_code, &inj);
+    engine_metrics_record(EM_STAGE_INJECT, engine_metrics_now_ns() - t0);
+
+    rec->inject_attempted = inj.attempted;
+    rec->inject_send = inj.send_ok;
+    rec->inject_errno = inj.inject_errno;
+    rec->inject_latency_ms = inj.latency_ms;
+    rec->inject_status_code = inj.status_code;
+}
+
+// 정책 단계 action 적용 (처리할 action이 아니면 0 -> AI 단계로)
+static int apply_policy_action(const HttpEvent* ev, access_log_record_t* rec, action_t action,
+                               long long policy_id, int status_code)
+{
+    switch (action) {
+        case ACT_BLOCK:
+            record_decision(ev, rec, "BLOCK", "POLICY", "POLICY_STAGE", policy_id);
+            enforce_block(ev, rec, status_code);
+            return 1;
+        case ACT_ALLOW:
+            record_decision(ev, rec, "ALLOW", "POLICY", "POLICY_STAGE", policy_id);
+            return 1;
+        case ACT_REDIRECT:
+        case ACT_REVIEW:
+            record_decision(ev, rec, "REVIEW", "POLICY", "POLICY_STAGE", policy_id);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// AI 단계 최종 action 적용
+static void apply_ai_action(const HttpEvent* ev, access_log_record_t* rec, action_t final)
+{
+    if (final == ACT_BLOCK)
+    {
+        record_decision(ev, rec, "BLOCK", "AI", "AI_STAGE", 0);
+        enforce_block(ev, rec, 403);
+    }
+    else if (final == ACT_ALLOW)
+    {
+        record_decision(ev, rec, "ALLOW", "AI", "AI_STAGE", 0);
+    }
+    else
+    {
+        record_decision(ev, rec, "REVIEW", "AI", "AI_STAGE", 0);
+    }
+}
+
+// 판정 캐시 적중: 캐시 없이 처리했을 때와 같은 기록/차단 수행 (AI 단계는 ai_analysis도 남김)
+static void apply_cached_decision(const HttpEvent* ev, access_log_record_t* rec, const decision_cache_value_t* cv)
+{
+    if (cv->stage == DC_STAGE_POLICY) {
+        (void)apply_policy_action(ev, rec, cv->action, cv->policy_id, cv->block_status_code);
+        return;
+    }
+
+    ai_result_t ar;
+    memset(&ar, 0, sizeof(ar));
+    ar.ok = 1;
+    ar.error_code = AI_OK;
+    ar.score = cv->ai_score;
+    snprintf(ar.label, sizeof(ar.label), "%s", cv->ai_label);
+    snprintf(ar.model_version, sizeof(ar.model_version), "%s", cv->ai_model_version);
+
+    record_ai(rec, &ar, 1, NULL);
+    apply_ai_action(ev, rec, cv->action);
+}
+
+#define EV_SKIPPED 0
+#define EV_DONE    1
+#define EV_PENDING 2
+
+#define EVENT_FLUSH_WORKER_ID 1001  // 타임아웃 flush 스레드
+#define LOG_WRITER_WORKER_ID  1100  // log writer 스레드 (+index)
+#define AI_CALLBACK_WORKER_ID 1200  // 비동기 AI 완료 콜백 스레드 (+index)
+
+// AI 단계로 넘어간 이벤트 (비동기 호출이면 완료 콜백이 소유/해제)
+typedef struct ai_pending {
+    HttpEvent ev;          // payload 포인터는 비움 (주입 ack 계산은 payload_len만 사용)
+    access_log_record_t rec;  // 문자열 필드는 위 ev를 가리킴
+    int       use_cache;
+    uint64_t  cache_key;
+    uint64_t  generation;  // match_policy에 쓴 스냅샷
+    uint64_t  t_start_ns;  // 이벤트 처리 시작 (total 계측)
+    uint64_t  t_ai_ns;     // AI 요청 시작
+
+    // 비동기 대기 목록 (g_pending_lock)
+    struct ai_pending* prev;
+    struct ai_pending* next;
+    int       flushed;     // 타임아웃 flush 대상 (flush 스레드가 저장)
+    int       flush_done;  // flush 저장 제출 끝 (그 전에는 완료 콜백이 rec를 건드리지 않음)
+} ai_pending_t;
+
+/*
+ * 비동기 AI 대기 이벤트 목록
+ * - 완료 콜백이 오지 않는 이벤트도 access_log에 남도록 EVENT_FLUSH_TIMEOUT_MS 후 flush 스레드가 저장
+ *   (판정 전이므로 'ERROR','SYSTEM','FAIL_STAGE', 기존 최초 INSERT와 같은 값)
+ * - flush 후 늦게 완료되면 같은 request_id 행에 추가 기록 (LOG_WRITE_LATE)
+ */
+static pthread_mutex_t g_pending_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  g_pending_cond = PTHREAD_COND_INITIALIZER;  // flush_done 알림
+static ai_pending_t*   g_pending_head = NULL;
+static int             g_flush_timeout_ms = 10000;
+static pthread_t       g_flush_thread;
+static volatile int    g_flush_stop = 0;
+static int             g_flush_started = 0;
+
+static void pending_add(ai_pending_t* pe)
+{
+    pthread_mutex_lock(&g_pending_lock);
+    pe->prev = NULL;
+    pe->next = g_pending_head;
+    if (g_pending_head) g_pending_head->prev = pe;
+    g_pending_head = pe;
+    pthread_mutex_unlock(&g_pending_lock);
+}
+
+static void pending_unlink_locked(ai_pending_t* pe)
+{
+    if (pe->prev) pe->prev->next = pe->next;
+    else g_pending_head = pe->next;
+    if (pe->next) pe->next->prev = pe->prev;
+    pe->prev = pe->next = NULL;
+}
+
+// 1이면 완료 콜백이 기록 (0이면 이미 flush됨 -> persist_late)
+// flush 저장이 진행 중이면 끝날 때까지 대기 (rec 동시 접근 방지, LATE 기록이 최초 INSERT 뒤에 오도록)
+static int pending_claim(ai_pending_t* pe)
+{
+    pthread_mutex_lock(&g_pending_lock);
+    int flushed = pe->flushed;
+    if (!flushed) pending_unlink_locked(pe);
+    while (flushed && !pe->flush_done) pthread_cond_wait(&g_pending_cond, &g_pending_lock);
+    pthread_mutex_unlock(&g_pending_lock);
+    return !flushed;
+}
+
+// age_ns 이상 대기 중인 이벤트 저장
+// - lock 안에서는 flushed 표시 + 목록에서 떼어 내기만, 저장은 lock 밖 (등록 / 다른 완료 콜백이 DB 쓰기를 기다리지 않도록)
+static int pending_flush_older(uint64_t age_ns)
+{
+    uint64_t now = engine_metrics_now_ns();
+    int n = 0;
+    ai_pending_t* batch = NULL;
+
+    pthread_mutex_lock(&g_pending_lock);
+    ai_pending_t* pe = g_pending_head;
+    while (pe) {
+        ai_pending_t* next = pe->next;
+        if (now - pe->t_start_ns >= age_ns) {
+            pe->flushed = 1;
+            pending_unlink_locked(pe);
+            pe->next = batch;
+            batch = pe;
+            n++;
+        }
+        pe = next;
+    }
+    pthread_mutex_unlock(&g_pending_lock);
+
+    while (batch) {
+        pe = batch;
+        batch = pe->next;
+        persist_record(&pe->rec);
+
+        // 이후 pe는 완료 콜백이 해제할 수 있음
+        pthread_mutex_lock(&g_pending_lock);
+        pe->next = NULL;
+        pe->flush_done = 1;
+        pthread_cond_broadcast(&g_pending_cond);
+        pthread_mutex_unlock(&g_pending_lock);
+    }
+
+    if (n > 0) {
+        engine_metrics_count(EM_COUNT_EVENT_TIMEOUT_FLUSH, (uint64_t)n);
+        fprintf(stderr, "[EVENT] flushed %d event(s) still waiting for AI after %llums\n",
+                n, (unsigned long long)(age_ns / 1000000ull));
+    }
+    return n;
+}
+
+static void* event_flush_main(void* arg)
+{
+    (void)arg;
+    if (engine_worker_init(EVENT_FLUSH_WORKER_ID) != 0) return NULL;
+
+    while (!g_flush_stop) {
+        usleep(200 * 1000);
+        (void)pending_flush_older((uint64_t)g_flush_timeout_ms * 1000000ull);
+    }
+
+    // 종료: 남은 이벤트 모두 저장
+    (void)pending_flush_older(0);
+    engine_worker_cleanup();
+    return NULL;
+}
+
+static void event_flush_start(void)
+{
+    if (g_dry_run || g_flush_timeout_ms <= 0 || !ai_async_enabled()) return;
+
+    g_flush_stop = 0;
+    if (pthread_create(&g_flush_thread, NULL, event_flush_main, NULL) != 0) {
+        fprintf(stderr, "[EVENT] flush thread start failed (pending events are written on completion only)\n");
+        return;
+    }
+    g_flush_started = 1;
+}
+
+static void event_flush_stop(void)
+{
+    if (!g_flush_started) return;
+    g_flush_stop = 1;
+    pthread_join(g_flush_thread, NULL);
+    g_flush_started = 0;
+}
+
+// flush 이후 완료: 이미 저장된 행(request_id)에 판정/AI/주입 결과 추가 기록
+static void persist_late(const access_log_record_t* rec)
+{
+    if (g_dry_run) return;
+
+    uint64_t t0 = engine_metrics_now_ns();
+    if (log_writer_submit(rec, LOG_WRITE_LATE) == LOG_WRITER_DIRECT &&
+        persist_direct(rec, LOG_WRITE_LATE) != 0) {
+        fprintf(stderr, "[EVENT] late update failed request_id=%s\n", rec->request_id);
+    }
+    engine_metrics_record(EM_STAGE_DB_UPDATE, engine_metrics_now_ns() - t0);
+}
+
+// AI 결과로 판정 마무리: ai_analysis / decision 기록, 차단, 캐시 저장 (저장은 호출자)
+// - forced != ACT_UNKNOWN: 1차 휴리스틱처럼 action이 이미 정해진 경우 (threshold 판정 생략)
+static void finish_ai_decision(ai_pending_t* pe, int ok, ai_result_t* ar, action_t forced)
+{
+    const HttpEvent* ev = &pe->ev;
+    access_log_record_t* rec = &pe->rec;
+
+    if (ar->model_version[0] == '\0') {
+        strncpy(ar->model_version, "unknown", sizeof(ar->model_version) - 1);
+        ar->model_version[sizeof(ar->model_version) - 1] = '\0';
+    }
+
+    char err_code[32];
+    const char* ec = NULL;
+    if (!ok) {
+        ai_error_to_code(ar, err_code, sizeof(err_code));
+        ec = err_code;
+    }
+
+    record_ai(rec, ar, ok ? 1 : 0, ec);
+
+    if (!ok)
+    {
+        engine_metrics_count(EM_COUNT_AI_FAIL, 1);
+
+        // breaker OPEN: 설정된 기본 action (캐시하지 않음 -> 회복 후 다시 AI 판정)
+        action_t fail_action = (ar->error_code == AI_ERR_CIRCUIT_OPEN) ? g_circuit_open_action : ACT_REVIEW;
+        if (fail_action == ACT_BLOCK) {
+            record_decision(ev, rec, "BLOCK", "SYSTEM", "FAIL_STAGE", 0);
+            enforce_block(ev, rec, 403);
+        } else if (fail_action == ACT_ALLOW) {
+            record_decision(ev, rec, "ALLOW", "SYSTEM", "FAIL_STAGE", 0);
+        } else {
+            record_decision(ev, rec, "REVIEW", "SYSTEM", "FAIL_STAGE", 0);
+        }
+        return;
+    }
 
+    action_t final = forced;
+    if (final == ACT_UNKNOWN) {
+        double threshold = get_env_double("THRESHOLD", 0.50);
+        final = decision_manager_decide(ar, threshold);
+    }
+    apply_ai_action(ev, rec, final);
+
+    if (pe->use_cache) {
+        decision_cache_value_t cv;
+        memset(&cv, 0, sizeof(cv));
+        cv.stage = DC_STAGE_AI;
+        cv.action = final;
+        cv.ai_score = ar->score;
+        snprintf(cv.ai_label, sizeof(cv.ai_label), "%s", ar->label);
+        snprintf(cv.ai_model_version, sizeof(cv.ai_model_version), "%s", ar->model_version);
+        decision_cache_store(pe->cache_key, pe->generation, &cv);
+    }
+}
+
+// 동기 경로 AI 단계 완료: 판정 + 저장 + 해제
+static void complete_ai_event(ai_pending_t* pe, int ok, ai_result_t* ar, action_t forced)
+{
+    finish_ai_decision(pe, ok, ar, forced);
+    persist_record(&pe->rec);
+    free(pe);
+}
+
+// 비동기 AI 완료 콜백 (AI 콜백 스레드: 판정 기록 / 주입 / 저장)
+static void on_ai_done(int ok, const ai_result_t* result, void* ctx)
+{
+    ai_pending_t* pe = (ai_pending_t*)ctx;
+    engine_metrics_record(EM_STAGE_AI, engine_metrics_now_ns() - pe->t_ai_ns);
+
+    int claimed = pending_claim(pe);
+
+    ai_result_t ar = *result;
+    finish_ai_decision(pe, ok, &ar, ACT_UNKNOWN);
+
+    if (claimed) persist_record(&pe->rec);
+    else persist_late(&pe->rec);
+
+    engine_metrics_record(EM_STAGE_TOTAL, engine_metrics_now_ns() - pe->t_start_ns);
+    free(pe);
+}
+
+/*
+ * 이벤트 1건 처리
+ * - EV_SKIPPED: 노이즈로 제외
+ * - EV_DONE: 판정 + access_log 저장까지 완료
+ * - EV_PENDING: 비동기 AI 대기 (완료 콜백이 마무리 + 저장 + total 계측)
+ */
+static int engine_process_event(const HttpEvent* ev, uint64_t t_start_ns)
+{
     /* 관리 UI / 내부 요청 노이즈는 여기서 조기 제외 */
     if (should_skip_noise_event(ev) && !is_ai_test_signature(ev)) {
-        return;
+        return EV_SKIPPED;
     }
 
     uuid_t uuid;
@@ -256,99 +668,244 @@ void engine_handle_http_event(const HttpEvent* ev)
     char request_id[37];
     uuid_unparse(uuid, request_id);
 
-    long long log_id =
-        insert_access_log(g_conn,
-                          request_id,
-                          ev->meta.client_ip,
-                          (int)ev->meta.client_port,
-                          ev->meta.server_ip,
-                          (int)ev->meta.server_port,
-                          ev->host,
-                          ev->path,
-                          ev->method,
-                          ev->url_norm);
-
-    if (log_id < 0) return;
+    // access_log는 완료 시 1회 INSERT (request_id로 AI 요청/로그 연결)
+    int64_t detect_ts_ms = now_ms();
+    access_log_record_t rec;
+    record_init(&rec, ev, request_id, detect_ts_ms);
+
+    uint64_t t1 = engine_metrics_now_ns();
+
+    /* 판정 캐시 (AI 테스트 요청은 항상 실제 AI 호출) */
+    int use_cache = decision_cache_enabled() && !should_bypass_policy_for_ai_test(ev);
+    uint64_t cache_key = 0;
+    if (use_cache) {
+        decision_cache_value_t cv;
+        cache_key = decision_cache_key(ev->url_norm);
+        if (decision_cache_lookup(cache_key, policy_snapshot_generation(), &cv)) {
+            apply_cached_decision(ev, &rec, &cv);
+            persist_record(&rec);
+            return EV_DONE;
+        }
+        t1 = engine_metrics_now_ns();
+    }
 
+    const policy_snapshot_t* snap = policy_snapshot_acquire();
+    uint64_t generation = snap ? snap->generation : 0;
     policy_decision_t d =
-        match_policy(&g_cache,
+        match_policy(snap ? &snap->cache : NULL,
                      ev->host,
                      ev->path,
                      ev->url_norm);
+    policy_snapshot_release();
+    engine_metrics_record(EM_STAGE_POLICY, engine_metrics_now_ns() - t1);
 	
 	if (should_bypass_policy_for_ai_test(ev)) {
 		 memset(&d, 0, sizeof(d));
 	}
 
-    if (d.matched)
+    if (d.matched && apply_policy_action(ev, &rec, d.action, d.policy_id, d.block_status_code))
     {
-        if (d.action == ACT_BLOCK)
-        {
-            update_access_log_decision(g_conn, log_id, "BLOCK", "POLICY", "POLICY_STAGE", d.policy_id, calc_engine_latency_ms(ev));
-            (void)insert_review_event_if_needed(g_conn, log_id, "POLICY_STAGE");
-            http_response_inject(ev, g_conn, log_id, d.block_status_code);
-            return;
+        persist_record(&rec);
+        if (use_cache) {
+            decision_cache_value_t cv;
+            memset(&cv, 0, sizeof(cv));
+            cv.stage = DC_STAGE_POLICY;
+            cv.action = d.action;
+            cv.policy_id = d.policy_id;
+            cv.block_status_code = d.block_status_code;
+            decision_cache_store(cache_key, generation, &cv);
+        }
+        return EV_DONE;
+    }
+
+    // AI 단계에 필요한 상태 (비동기면 완료 콜백까지 보관)
+    ai_pending_t* pe = (ai_pending_t*)calloc(1, sizeof(ai_pending_t));
+    if (!pe) {
+        record_decision(ev, &rec, "REVIEW", "SYSTEM", "FAIL_STAGE", 0);
+        persist_record(&rec);
+        return EV_DONE;
+    }
+    pe->ev = *ev;
+    pe->ev.payload = NULL;
+    record_init(&pe->rec, &pe->ev, request_id, detect_ts_ms);
+    pe->use_cache = use_cache;
+    pe->cache_key = cache_key;
+    pe->generation = generation;
+    pe->t_start_ns = t_start_ns;
+    pe->t_ai_ns = engine_metrics_now_ns();
+
+    /*
+     * AI 단계 cascade
+     * 1) 휴리스틱 점수: 명백한 정상/악성은 여기서 판정 (AI 호출 없음)
+     * 2) 내장 분류기: 네트워크 없이 판정
+     * 3) 원격 AI (/v1/score): 비동기 또는 동기 호출
+     * AI 테스트 요청은 항상 원격 AI까지 진행
+     */
+    int ai_test = should_bypass_policy_for_ai_test(ev);
+    if (url_prescore_enabled() && !ai_test) {
+        double score = 0.0;
+        url_prescore_tier_t tier = url_prescore_classify(ev, &score);
+        if (tier != PRESCORE_ESCALATE) {
+            int benign = (tier == PRESCORE_BENIGN);
+            engine_metrics_count(benign ? EM_COUNT_PRESCORE_BENIGN : EM_COUNT_PRESCORE_MALICIOUS, 1);
+
+            ai_result_t ar;
+            memset(&ar, 0, sizeof(ar));
+            ar.ok = 1;
+            ar.score = score;
+            snprintf(ar.label, sizeof(ar.label), "%s", benign ? "benign" : "malicious");
+            snprintf(ar.model_version, sizeof(ar.model_version), "%s", URL_PRESCORE_MODEL_VERSION);
+
+            engine_metrics_record(EM_STAGE_AI, engine_metrics_now_ns() - pe->t_ai_ns);
+            complete_ai_event(pe, 1, &ar, benign ? ACT_ALLOW : ACT_BLOCK);
+            return EV_DONE;
         }
+    }
 
-        if (d.action == ACT_ALLOW)
-        {
-            update_access_log_decision(g_conn, log_id, "ALLOW", "POLICY", "POLICY_STAGE", d.policy_id, calc_engine_latency_ms(ev));
-            return;
+    if (url_native_model_loaded() && !ai_test) {
+        ai_result_t ar;
+        if (url_native_classify(ev, &ar)) {
+            engine_metrics_count(EM_COUNT_AI_NATIVE, 1);
+            engine_metrics_record(EM_STAGE_AI, engine_metrics_now_ns() - pe->t_ai_ns);
+            complete_ai_event(pe, 1, &ar, ACT_UNKNOWN);
+            return EV_DONE;
         }
+        engine_metrics_count(EM_COUNT_AI_NATIVE_FALLBACK, 1);
+    }
 
-        if (d.action == ACT_REDIRECT)
-        {
-            update_access_log_decision(g_conn, log_id, "REVIEW", "POLICY", "POLICY_STAGE", d.policy_id, calc_engine_latency_ms(ev));
-            return;
+    if (ai_async_enabled()) {
+        // 콜백이 호출 중에 올 수도 있으므로 먼저 대기 목록에 등록
+        pending_add(pe);
+        int rc = ai_classify_url_async(&pe->ev, request_id, on_ai_done, pe);
+        if (rc == AI_ASYNC_QUEUED) {
+            engine_metrics_count(EM_COUNT_AI_REMOTE, 1);
+            return EV_PENDING;
         }
+        (void)pending_claim(pe);
 
-        if (d.action == ACT_REVIEW)
-        {
-            update_access_log_decision(g_conn, log_id, "REVIEW", "POLICY", "POLICY_STAGE", d.policy_id, calc_engine_latency_ms(ev));
-            return;
+        if (rc == AI_ASYNC_BUSY) {
+            // in-flight 한도 초과: 캡처 스레드는 기다리지 않고 REVIEW로 처리
+            engine_metrics_count(EM_COUNT_AI_BACKPRESSURE, 1);
+
+            ai_result_t ar;
+            memset(&ar, 0, sizeof(ar));
+            ar.error_code = AI_ERR_BUSY;
+            complete_ai_event(pe, 0, &ar, ACT_UNKNOWN);
+            return EV_DONE;
         }
+        // 비동기 사용 불가 (종료 중 등): 동기 호출로 진행
     }
 
+    engine_metrics_count(EM_COUNT_AI_REMOTE, 1);
+
     ai_result_t ar;
     int ok = ai_classify_url_ex(ev, request_id, &ar);
+    engine_metrics_record(EM_STAGE_AI, engine_metrics_now_ns() - pe->t_ai_ns);
 
-    if (ar.model_version[0] == '\0') {
-        strncpy(ar.model_version, "unknown", sizeof(ar.model_version) - 1);
-        ar.model_version[sizeof(ar.model_version) - 1] = '\0';
-    }
+    complete_ai_event(pe, ok, &ar, ACT_UNKNOWN);
+    return EV_DONE;
+}
 
-    char err_code[32];
-    const char* ec = NULL;
-    if (!ok) {
-        ai_error_to_code(&ar, err_code, sizeof(err_code));
-        ec = err_code;
+// 핵심 엔진 처리
+void engine_handle_http_event(const HttpEvent* ev)
+{
+    if (!ev || !ev->is_http) return;
+
+    uint64_t t0 = engine_metrics_now_ns();
+    if (engine_process_event(ev, t0) == EV_DONE) {
+        engine_metrics_record(EM_STAGE_TOTAL, engine_metrics_now_ns() - t0);
     }
+}
 
-    (void)insert_ai_analysis_auto_seq(g_conn, log_id, &ar, ok ? 1 : 0, ec);
+// 비동기 AI 완료 + log writer 기록 대기
+void engine_flush(void)
+{
+    ai_async_drain();
+    log_writer_drain();
+}
 
-    if (!ok)
-    {
-        update_access_log_decision(g_conn, log_id, "REVIEW", "SYSTEM", "FAIL_STAGE", 0, calc_engine_latency_ms(ev));
-        return;
+// AI 완료 콜백 스레드: 콜백이 쓰는 스레드 로컬 DB 자원 준비/정리
+static int ai_callback_thread_begin(int index)
+{
+    return engine_worker_init(AI_CALLBACK_WORKER_ID + index);
+}
+
+static void ai_callback_thread_end(void)
+{
+    engine_worker_cleanup();
+}
+
+// log writer / spool 재생 스레드: 연결은 배치마다 풀에서 (DB 장애 중에는 spool)
+static int log_writer_thread_begin(int index)
+{
+    if (mysql_thread_init() != 0) {
+        fprintf(stderr, "[WORKER %d] mysql_thread_init failed\n", LOG_WRITER_WORKER_ID + index);
+        return -1;
     }
+    return 0;
+}
 
-    double threshold = get_env_double("THRESHOLD", 0.50);
-    action_t final = decision_manager_decide(&ar, threshold);
+static void log_writer_thread_end(void)
+{
+    mysql_thread_end();
+}
 
-    if (final == ACT_BLOCK)
-    {
-        update_access_log_decision(g_conn, log_id, "BLOCK", "AI", "AI_STAGE", 0, calc_engine_latency_ms(ev));
-        (void)insert_review_event_if_needed(g_conn, log_id, "AI_STAGE");
-        http_response_inject(ev, g_conn, log_id, 403);
+static void on_stop_signal(int sig)
+{
+    (void)sig;
+    packet_extractor_request_stop();
+}
+
+static void on_reload_signal(int sig)
+{
+    (void)sig;
+    policy_snapshot_request_reload();
+}
+
+// 캡처 설정 (CAP_*)
+static int load_capture_config(packet_manager_config_t* cap, const char* ifname)
+{
+    memset(cap, 0, sizeof(*cap));
+    cap->ifname = ifname;
+
+    const char* backend = get_env_str("CAP_BACKEND", "pcap");
+    if (capture_backend_from_str(backend, &cap->backend) != 0) {
+        fprintf(stderr, "unknown CAP_BACKEND=%s (expected pcap|tpacket_v3)\n", backend);
+        return -1;
     }
-    else if (final == ACT_ALLOW)
-    {
-        update_access_log_decision(g_conn, log_id, "ALLOW", "AI", "AI_STAGE", 0, calc_engine_latency_ms(ev));
+
+    cap->ring_block_size = (unsigned int)get_env_int("CAP_RING_BLOCK_SIZE", 1 << 22);
+    cap->ring_block_count = (unsigned int)get_env_int("CAP_RING_BLOCK_COUNT", 64);
+    cap->ring_frame_size = (unsigned int)get_env_int("CAP_RING_FRAME_SIZE", 2048);
+    cap->ring_block_timeout_ms = (unsigned int)get_env_int("CAP_RING_BLOCK_TIMEOUT_MS", 10);
+    cap->stats_interval_sec = get_env_int("CAP_STATS_INTERVAL_SEC", 60);
+
+    // 멀티 워커 (PACKET_FANOUT, tpacket_v3 전용)
+    cap->workers = get_env_int("CAP_WORKERS", 1);
+    cap->fanout_id = get_env_int("CAP_FANOUT_ID", (int)(getpid() & 0xffff));
+    cap->cpu_list = get_env_str("CAP_CPU_LIST", "");
+
+    // 오프라인 재생 (CAP_BACKEND=replay)
+    cap->replay.path = get_env_str("CAP_REPLAY_FILE", "");
+    cap->replay.pps = get_env_double("CAP_REPLAY_PPS", 0.0);
+    cap->replay.loops = get_env_int("CAP_REPLAY_LOOPS", 1);
+
+    const char* pace = get_env_str("CAP_REPLAY_PACE", "fast");
+    if (replay_pace_from_str(pace, &cap->replay.pace) != 0) {
+        fprintf(stderr, "unknown CAP_REPLAY_PACE=%s (expected fast|original|pps)\n", pace);
+        return -1;
     }
-    else
-    {
-        update_access_log_decision(g_conn, log_id, "REVIEW", "AI", "AI_STAGE", 0, calc_engine_latency_ms(ev));
+
+    if (cap->backend == CAP_BACKEND_REPLAY && !cap->replay.path[0]) {
+        fprintf(stderr, "CAP_BACKEND=replay requires CAP_REPLAY_FILE\n");
+        return -1;
+    }
+
+    if (cap->workers > 1 && cap->backend != CAP_BACKEND_TPACKET_V3) {
+        fprintf(stderr, "CAP_WORKERS=%d requires CAP_BACKEND=tpacket_v3\n", cap->workers);
+        return -1;
     }
+    return 0;
 }
 
 // main
@@ -359,6 +916,11 @@ int main(int argc, char** argv)
         ifname = argv[1];
     }
 
+    packet_manager_config_t cap;
+    if (load_capture_config(&cap, ifname) != 0) {
+        return 1;
+    }
+
     const char* db_host = get_env_str("DB_HOST", "127.0.0.1");
     int db_port = get_env_int("DB_PORT", 3306);
     const char* db_user = get_env_str("DB_USER", "gateguard");
@@ -367,41 +929,276 @@ int main(int argc, char** argv)
 
     char score_endpoint[256];
     memset(score_endpoint, 0, sizeof(score_endpoint));
-    build_score_endpoint(score_endpoint, sizeof(score_endpoint));
+    build_score_endpoint(score_endpoint, sizeof(score_endpoint), "v1/score");
 
     printf("GateGuard Engine Start\n");
-    printf("engine config: iface=%s db_host=%s db_port=%d db_user=%s db_name=%s ai_url=%s\n",
-           ifname, db_host, db_port, db_user, db_name, score_endpoint);
-
-    g_conn = db_connect();
-
-    if (load_policy_cache(&g_cache, db_host, db_port, db_user, get_env_str("DB_PASSWORD", ""), db_name) != 0)
+    printf("engine config: iface=%s backend=%s workers=%d db_host=%s db_port=%d db_user=%s db_name=%s ai_url=%s\n",
+           ifname, capture_backend_to_str(cap.backend), cap.workers, db_host, db_port, db_user, db_name, score_endpoint);
+
+    /*
+     * 정책 스냅샷 (무중단 재로드)
+     * - POLICY_RELOAD_INTERVAL_SEC: 주기적 전체 재로드 = 정합성 점검 (0이면 끔)
+     * - POLICY_VERSION_POLL_SEC: DB 정책 버전 확인 주기, 바뀌면 policy_audit 델타 동기화 (0이면 끔)
+     * - POLICY_DELTA_MAX: 델타 1회 최대 변경 policy 수, 넘으면 전체 재로드 (0이면 항상 전체)
+     * - POLICY_SNAPSHOT_FILE: 컴파일된 정책 바이너리 스냅샷 경로, 시작 시 매핑해 즉시 적용 (기본 끔)
+     *   DB 풀보다 먼저 매핑하므로 DB 장애 중에도 기동 가능, DB 대조는 재로드 스레드가 연결되는 대로 수행
+     *   디렉터리는 엔진 실행 사용자 또는 root 소유 + group/other 쓰기 불가여야 함 (예: /var/lib/gateguard, 0700)
+     * - POLICY_SNAPSHOT_WRITE_SEC: 스냅샷 파일 재기록 최소 간격
+     * - SIGHUP: 즉시 재로드
+     */
+    policy_reload_config_t rcfg;
+    memset(&rcfg, 0, sizeof(rcfg));
+    rcfg.db_host = db_host;
+    rcfg.db_port = db_port;
+    rcfg.db_user = db_user;
+    rcfg.db_pass = get_env_str("DB_PASSWORD", "");
+    rcfg.db_name = db_name;
+    rcfg.interval_sec = get_env_int("POLICY_RELOAD_INTERVAL_SEC", 3600);
+    rcfg.version_poll_sec = get_env_int("POLICY_VERSION_POLL_SEC", 5);
+    rcfg.delta_max_policies = get_env_int("POLICY_DELTA_MAX", 1000);
+    rcfg.snapshot_path = get_env_str("POLICY_SNAPSHOT_FILE", "");
+    rcfg.snapshot_write_sec = get_env_int("POLICY_SNAPSHOT_WRITE_SEC", 30);
+
+    int policy_ok = (policy_snapshot_init(&rcfg) == 0);
+    if (!policy_ok)
     {
         printf("policy load failed\n");
     }
 
-    printf("policy loaded: %zu\n", g_cache.policy_count);
+    const policy_snapshot_t* snap = policy_snapshot_acquire();
+    printf("policy loaded: %zu\n", snap ? snap->cache.policy_count : (size_t)0);
+    policy_snapshot_release();
+
+    /*
+     * DB 연결 풀 (워커 / AI 콜백 / flush / log writer / 정책 재로드 공용)
+     * - DB_POOL_MAX: 최대 연결 수
+     * - DB_POOL_ACQUIRE_TIMEOUT_MS: 연결이 모두 사용 중일 때 대기 시간
+     * - DB_POOL_HEALTH_IDLE_MS: 이 시간 이상 쉬었던 연결은 ping 확인 후 사용
+     * - DB_POOL_BACKOFF_MIN_MS / DB_POOL_BACKOFF_MAX_MS: 연결 실패 후 재시도 간격 (2배씩 증가)
+     * - DB_POOL_CONNECT_TIMEOUT_SEC / DB_POOL_READ_TIMEOUT_SEC / DB_POOL_WRITE_TIMEOUT_SEC:
+     *   연결 / 응답 읽기 / 쓰기 timeout (0이면 라이브러리 기본값, 응답 없는 DB에 스레드가 묶이지 않도록)
+     * 시작 시 DB에 연결하지 못하면 정책을 적재하지 못한 경우에만 종료
+     * (정책이 적재됐으면 계속 실행: 풀 backoff로 재연결, 로그는 spool / writer 재시도가 보관)
+     */
+    g_dry_run = get_env_int("ENGINE_DRY_RUN", 0);
+    if (g_dry_run) {
+        printf("engine dry run: no DB writes, no block injection\n");
+    } else {
+        db_pool_config_t pcfg;
+        memset(&pcfg, 0, sizeof(pcfg));
+        pcfg.host = db_host;
+        pcfg.port = db_port;
+        pcfg.user = db_user;
+        pcfg.pass = get_env_str("DB_PASSWORD", "");
+        pcfg.name = db_name;
+        pcfg.max_conns = get_env_int("DB_POOL_MAX", 8);
+        pcfg.acquire_timeout_ms = get_env_int("DB_POOL_ACQUIRE_TIMEOUT_MS", 1000);
+        pcfg.health_idle_ms = get_env_int("DB_POOL_HEALTH_IDLE_MS", 30000);
+        pcfg.backoff_min_ms = get_env_int("DB_POOL_BACKOFF_MIN_MS", 100);
+        pcfg.backoff_max_ms = get_env_int("DB_POOL_BACKOFF_MAX_MS", 5000);
+        pcfg.connect_timeout_sec = get_env_int("DB_POOL_CONNECT_TIMEOUT_SEC", 3);
+        pcfg.read_timeout_sec = get_env_int("DB_POOL_READ_TIMEOUT_SEC", 10);
+        pcfg.write_timeout_sec = get_env_int("DB_POOL_WRITE_TIMEOUT_SEC", 10);
+
+        if (db_pool_init(&pcfg) != 0) {
+            fprintf(stderr, "db pool start failed\n");
+            return 1;
+        }
+        MYSQL* conn = db_pool_acquire(0);
+        if (conn) {
+            db_pool_release(conn, 0);
+        } else if (policy_ok) {
+            fprintf(stderr, "[DB_POOL] DB unreachable at startup, running on policy snapshot\n");
+        } else {
+            fprintf(stderr, "db pool start failed\n");
+            return 1;
+        }
+    }
+
+    // METRICS_HISTOGRAM=1: 리포트에 단계별 지연 히스토그램 포함
+    engine_metrics_set_histogram(get_env_int("METRICS_HISTOGRAM", 0));
+
+    if (!g_dry_run) (void)policy_snapshot_start_reloader();
+
+    /*
+     * 판정 캐시 (url_norm 단위, 정책 generation이 바뀌면 무효)
+     * - DECISION_CACHE_ENTRIES: 전체 엔트리 수 (0이면 끔)
+     * - DECISION_CACHE_SHARDS: shard 수 (워커 간 lock 경합 분산)
+     * - DECISION_CACHE_POSITIVE_TTL_SEC: 정책 적중 / AI 차단 결과 유지 시간
+     * - DECISION_CACHE_NEGATIVE_TTL_SEC: AI가 차단하지 않은 결과 유지 시간
+     */
+    decision_cache_config_t dcfg;
+    memset(&dcfg, 0, sizeof(dcfg));
+    dcfg.entries = get_env_int("DECISION_CACHE_ENTRIES", 65536);
+    dcfg.shards = get_env_int("DECISION_CACHE_SHARDS", 16);
+    dcfg.positive_ttl_ms = get_env_int("DECISION_CACHE_POSITIVE_TTL_SEC", 300) * 1000;
+    dcfg.negative_ttl_ms = get_env_int("DECISION_CACHE_NEGATIVE_TTL_SEC", 60) * 1000;
+
+    if (decision_cache_init(&dcfg) != 0) {
+        fprintf(stderr, "decision_cache_init failed (cache disabled)\n");
+    }
 
     ai_client_config_t cfg;
     memset(&cfg, 0, sizeof(cfg));
     snprintf(cfg.endpoint, sizeof(cfg.endpoint), "%s", score_endpoint);
     snprintf(cfg.token, sizeof(cfg.token), "%s", api_token);
     cfg.connect_timeout_ms = 1500;
-    cfg.timeout_ms = 3000;
+    cfg.pool_size = get_env_int("AI_CONN_POOL_SIZE", 2);
+    cfg.keepalive_idle_sec = get_env_int("AI_KEEPALIVE_IDLE_SEC", 30);
+    build_score_endpoint(cfg.batch_endpoint, sizeof(cfg.batch_endpoint), "v1/score_batch");
+    cfg.coalesce = get_env_int("AI_COALESCE", 1);
+
+    // AI_UDS_PATH: 같은 호스트의 채점 API Unix socket (지정하면 HTTP/JSON 대신 바이너리 프로토콜)
+    snprintf(cfg.uds_path, sizeof(cfg.uds_path), "%s", get_env_str("AI_UDS_PATH", ""));
+
+    /*
+     * AI circuit breaker + 적응형 timeout
+     * - AI_BREAKER_WINDOW: 실패율 계산 최근 결과 수 (0이면 breaker 끔)
+     * - AI_BREAKER_MIN_REQUESTS / AI_BREAKER_ERROR_RATE: 이 수 이상 중 실패율 이상이면 OPEN
+     * - AI_BREAKER_OPEN_MS: OPEN 유지 후 HALF_OPEN, AI_BREAKER_HALF_OPEN_PROBES개 probe로 회복 확인
+     * - AI_CIRCUIT_OPEN_ACTION: OPEN 동안 판정 (REVIEW / ALLOW / BLOCK)
+     * - AI_TIMEOUT_ADAPTIVE: 최근 응답 p99 * AI_TIMEOUT_P99_FACTOR 를 timeout으로 사용
+     *   (AI_TIMEOUT_MIN_MS ~ AI_TIMEOUT_MS)
+     */
+    cfg.timeout_ms = get_env_int("AI_TIMEOUT_MS", 3000);
+    cfg.breaker.window = get_env_int("AI_BREAKER_WINDOW", 50);
+    cfg.breaker.min_requests = get_env_int("AI_BREAKER_MIN_REQUESTS", 20);
+    cfg.breaker.error_rate = get_env_double("AI_BREAKER_ERROR_RATE", 0.5);
+    cfg.breaker.open_ms = get_env_int("AI_BREAKER_OPEN_MS", 5000);
+    cfg.breaker.half_open_probes = get_env_int("AI_BREAKER_HALF_OPEN_PROBES", 2);
+    cfg.breaker.adaptive_timeout = get_env_int("AI_TIMEOUT_ADAPTIVE", 1);
+    cfg.breaker.min_timeout_ms = get_env_int("AI_TIMEOUT_MIN_MS", 250);
+    cfg.breaker.p99_factor = get_env_double("AI_TIMEOUT_P99_FACTOR", 3.0);
+
+    const char* open_action = get_env_str("AI_CIRCUIT_OPEN_ACTION", "REVIEW");
+    if (strcasecmp(open_action, "ALLOW") == 0) g_circuit_open_action = ACT_ALLOW;
+    else if (strcasecmp(open_action, "BLOCK") == 0) g_circuit_open_action = ACT_BLOCK;
+    else g_circuit_open_action = ACT_REVIEW;
 
     if (!ai_client_init(&cfg)) {
         fprintf(stderr, "ai_client_init failed\n");
     }
 
-    packet_manager_run(ifname);
+    /*
+     * 1차 휴리스틱 점수 (AI 호출 전 단계)
+     * - AI_PRESCORE_LOW: 이 점수 미만은 AI 없이 ALLOW (0이면 끔, 기본 끔: 미탐 검증 후 켬)
+     * - AI_PRESCORE_HIGH: 이 점수 이상은 AI 없이 BLOCK (1 초과면 끔, 기본 끔)
+     */
+    url_prescore_config_t pcfg;
+    pcfg.low = get_env_double("AI_PRESCORE_LOW", 0.0);
+    pcfg.high = get_env_double("AI_PRESCORE_HIGH", 2.0);
+    url_prescore_init(&pcfg);
+
+    /*
+     * 내장 분류기 (ai_trainer가 내보낸 model_native.bin)
+     * - AI_NATIVE_MODEL_PATH: 지정하면 엔진 안에서 점수 계산, 비우면 HTTP AI만 사용
+     * - 로드 실패 / 분류 실패 시 HTTP AI(/v1/score)로 대체
+     */
+    const char* native_model = get_env_str("AI_NATIVE_MODEL_PATH", "");
+    if (native_model[0] && url_native_model_load(native_model) != 0) {
+        fprintf(stderr, "url_native_model_load failed (HTTP AI only)\n");
+    }
 
-    ai_client_cleanup();
-    free_policy_cache(&g_cache);
+    /*
+     * 비동기 AI 분류 (curl multi 이벤트 루프)
+     * - AI_ASYNC_MAX_INFLIGHT: 동시 진행 요청 상한 (0이면 캡처 스레드에서 동기 호출)
+     * - 상한을 넘으면 캡처 스레드는 기다리지 않고 REVIEW(AI_BUSY) 처리 + ai_backpressure 카운트
+     * - AI_BATCH_MAX / AI_BATCH_WAIT_MS: /v1/score_batch 마이크로 배치 크기/대기 (AI_BATCH_MAX=1이면 단건)
+     * - AI_ASYNC_CALLBACK_THREADS: 완료 콜백(판정 기록 / 주입 / 저장) 스레드 수, 루프 스레드는 네트워크만 처리
+     */
+    ai_async_config_t acfg;
+    memset(&acfg, 0, sizeof(acfg));
+    acfg.max_inflight = get_env_int("AI_ASYNC_MAX_INFLIGHT", 256);
+    acfg.batch_max = get_env_int("AI_BATCH_MAX", 64);
+    acfg.batch_wait_ms = get_env_int("AI_BATCH_WAIT_MS", 2);
+    acfg.callback_threads = get_env_int("AI_ASYNC_CALLBACK_THREADS", 2);
+    acfg.thread_begin = ai_callback_thread_begin;
+    acfg.thread_end = ai_callback_thread_end;
+
+    if (acfg.max_inflight > 0 && ai_async_start(&acfg) != 0) {
+        fprintf(stderr, "ai_async_start failed (synchronous AI calls)\n");
+    }
 
-    if (g_conn) {
-        mysql_close(g_conn);
-        g_conn = NULL;
+    /*
+     * access_log 비동기 배치 기록 (log writer)
+     * - LOG_WRITER_THREADS: writer 스레드 수 (0이면 이벤트 처리 스레드에서 직접 INSERT)
+     * - LOG_WRITER_QUEUE: 스레드별 큐 크기 (칸당 레코드 복사본 약 2.5KB를 시작 시 할당)
+     * - LOG_WRITER_BATCH_MAX / LOG_WRITER_FLUSH_MS: multi-row INSERT 최대 행 수 / 배치 대기 시간
+     * - LOG_WRITER_OVERFLOW: 큐가 가득 찼을 때 spool(디스크 spool, spool 사용 시 기본) /
+     *   sync(직접 기록, spool 미사용 시 기본) / drop(버리고 카운트)
+     * - LOG_SPOOL_DIR: DB가 느리거나 내려갔을 때 레코드를 쌓는 디렉터리 (빈 값이면 사용 안 함, 기본 끔)
+     *   엔진 사용자 소유 + group/other 쓰기 없는 디렉터리만 사용 (/var/tmp 같은 공용 위치 아래 두지 않음)
+     *   writer의 재생 스레드가 DB 복구 후 다시 기록, 재시작해도 남은 spool부터 재생
+     * - LOG_SPOOL_SEGMENT_MB / LOG_SPOOL_MAX_MB: segment 교체 크기 / 재생 대기 상한 (넘으면 버림)
+     * - LOG_SPOOL_FSYNC: 1이면 spool을 fdatasync
+     * - LOG_SPOOL_FSYNC_MS: fdatasync 주기 (sync 스레드가 모아서, 장애 시 최대 이 시간만큼 유실 가능)
+     *   0이면 append마다 (패킷 / writer 스레드가 디스크 flush를 기다림)
+     */
+    if (!g_dry_run) {
+        log_writer_config_t lcfg;
+        memset(&lcfg, 0, sizeof(lcfg));
+        lcfg.threads = get_env_int("LOG_WRITER_THREADS", 1);
+        lcfg.queue_size = get_env_int("LOG_WRITER_QUEUE", 16384);
+        lcfg.batch_max = get_env_int("LOG_WRITER_BATCH_MAX", 200);
+        lcfg.flush_ms = get_env_int("LOG_WRITER_FLUSH_MS", 50);
+        lcfg.thread_begin = log_writer_thread_begin;
+        lcfg.thread_end = log_writer_thread_end;
+
+        log_spool_config_t scfg;
+        memset(&scfg, 0, sizeof(scfg));
+        scfg.dir = get_env_str("LOG_SPOOL_DIR", "");
+        scfg.segment_bytes = (uint64_t)get_env_int("LOG_SPOOL_SEGMENT_MB", 64) << 20;
+        scfg.max_bytes = (uint64_t)get_env_int("LOG_SPOOL_MAX_MB", 4096) << 20;
+        scfg.fsync = get_env_int("LOG_SPOOL_FSYNC", 1);
+        scfg.fsync_ms = get_env_int("LOG_SPOOL_FSYNC_MS", 100);
+
+        // spool은 writer 스레드가 재생하므로 writer를 쓸 때만
+        if (lcfg.threads > 0 && scfg.dir[0] && log_spool_open(&scfg) != 0) {
+            fprintf(stderr, "log_spool_open failed (records are dropped while DB is down)\n");
+        }
+
+        const char* overflow = get_env_str("LOG_WRITER_OVERFLOW", log_spool_enabled() ? "spool" : "sync");
+        if (log_writer_overflow_from_str(overflow, &lcfg.overflow) != 0) {
+            fprintf(stderr, "unknown LOG_WRITER_OVERFLOW=%s (expected spool|sync|drop), using sync\n", overflow);
+            lcfg.overflow = LOG_WRITER_OVERFLOW_SYNC;
+        }
+
+        if (lcfg.threads > 0 && log_writer_start(&lcfg) != 0) {
+            fprintf(stderr, "log_writer_start failed (direct access_log INSERT)\n");
+        }
+    }
+
+    /*
+     * access_log는 이벤트 완료 시 1회 기록
+     * - EVENT_FLUSH_TIMEOUT_MS: 비동기 AI 결과가 이 시간 안에 오지 않으면 판정 전 상태로 먼저 저장 (0이면 끔)
+     */
+    g_flush_timeout_ms = get_env_int("EVENT_FLUSH_TIMEOUT_MS", 10000);
+    event_flush_start();
+
+    signal(SIGINT, on_stop_signal);
+    signal(SIGTERM, on_stop_signal);
+    signal(SIGHUP, on_reload_signal);
+
+    uint64_t run_t0 = engine_metrics_now_ns();
+    packet_manager_run(&cap);
+
+    // 진행 중 AI 요청의 판정/기록까지 마친 뒤 리포트 (콜백이 오지 않은 이벤트는 flush 스레드가 저장)
+    ai_async_stop();
+    event_flush_stop();
+    log_writer_stop();
+    log_spool_close();
+
+    // replay는 자체 리포트를 출력하므로 라이브 캡처 종료 시에만 출력
+    if (cap.backend != CAP_BACKEND_REPLAY) {
+        engine_metrics_report(stdout, (double)(engine_metrics_now_ns() - run_t0) / 1e9);
     }
 
+    ai_client_cleanup();
+    url_native_model_unload();
+    decision_cache_shutdown();
+    policy_snapshot_shutdown();
+    db_pool_shutdown();
+    db_thread_cleanup();
+
     return 0;
 }
@@ -2,17 +2,24 @@
 #include "packet_extractor.h"
 #include "engine_struct.h"
 #include "http_event_dispatch.h"
+#include "engine_metrics.h"
 
 #include <pcap.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
 #include <arpa/inet.h>
 
 #include <netinet/if_ether.h>
 #include <netinet/ip.h>
 #include <netinet/tcp.h>
 
+static volatile sig_atomic_t g_stop = 0;
+
 static const unsigned char*
 gg_memmem(const unsigned char* haystack,
           size_t haystack_len,
@@ -145,13 +152,11 @@ static int parse_http_host_path_method(const unsigned char* payload,
     return 1;
 }
 
-static void on_packet(u_char* user,
-                      const struct pcap_pkthdr* hdr,
-                      const u_char* pkt)
+void packet_extractor_handle_frame(const unsigned char* pkt, size_t caplen, int64_t ts_ms)
 {
-    (void)user;
+    engine_metrics_count(EM_COUNT_PACKETS, 1);
 
-    if (hdr->caplen < sizeof(struct ether_header)) return;
+    if (!pkt || caplen < sizeof(struct ether_header)) return;
 
     const struct ether_header* eth = (const struct ether_header*)pkt;
     if (ntohs(eth->ether_type) != ETHERTYPE_IP) return;
@@ -167,16 +172,18 @@ static void on_packet(u_char* user,
     int tcp_hdr_len = tcp->th_off * 4;
 
     const unsigned char* payload = (const unsigned char*)tcp + tcp_hdr_len;
-    int payload_len = (int)(hdr->caplen - (payload - pkt));
+    int payload_len = (int)(caplen - (size_t)(payload - pkt));
     if (payload_len <= 0) return;
 
     if (!looks_like_http_request(payload, (size_t)payload_len)) return;
 
+    uint64_t t_parse = engine_metrics_now_ns();
+
     HttpEvent ev;
     memset(&ev, 0, sizeof(ev));
 
     /* 패킷 캡처 시각을 엔진 latency 계산 기준으로 사용 */
-    ev.detect_ts_ms = (int64_t)hdr->ts.tv_sec * 1000 + (int64_t)hdr->ts.tv_usec / 1000;
+    ev.detect_ts_ms = ts_ms;
     ev.is_http = 1;
 
     if (!parse_http_host_path_method(payload,
@@ -207,10 +214,43 @@ static void on_packet(u_char* user,
 
     snprintf(ev.url_norm, sizeof(ev.url_norm), "%s%s", ev.host, ev.path);
 
+    engine_metrics_record(EM_STAGE_PARSE, engine_metrics_now_ns() - t_parse);
+    engine_metrics_count(EM_COUNT_HTTP_EVENTS, 1);
+
     process_http_event(&ev);
 }
 
-int packet_extractor_run_pcap_loop(const char* ifname)
+static void on_packet(u_char* user,
+                      const struct pcap_pkthdr* hdr,
+                      const u_char* pkt)
+{
+    (void)user;
+
+    int64_t ts_ms = (int64_t)hdr->ts.tv_sec * 1000 + (int64_t)hdr->ts.tv_usec / 1000;
+    packet_extractor_handle_frame(pkt, hdr->caplen, ts_ms);
+}
+
+void packet_extractor_request_stop(void)
+{
+    g_stop = 1;
+}
+
+int packet_extractor_stop_requested(void)
+{
+    return g_stop != 0;
+}
+
+static void report_pcap_stats(pcap_t* p)
+{
+    struct pcap_stat st;
+    memset(&st, 0, sizeof(st));
+    if (pcap_stats(p, &st) != 0) return;
+
+    printf("[CAPTURE] backend=pcap recv=%u drop=%u ifdrop=%u\n",
+           st.ps_recv, st.ps_drop, st.ps_ifdrop);
+}
+
+int packet_extractor_run_pcap_loop(const char* ifname, int stats_interval_sec)
 {
     char errbuf[PCAP_ERRBUF_SIZE];
 
@@ -223,7 +263,7 @@ int packet_extractor_run_pcap_loop(const char* ifname)
     }
 
     struct bpf_program fp;
-    if (pcap_compile(p, &fp, "tcp and (port 80 or port 8080 or port 18080)", 1, PCAP_NETMASK_UNKNOWN) != 0)
+    if (pcap_compile(p, &fp, PACKET_EXTRACTOR_BPF, 1, PCAP_NETMASK_UNKNOWN) != 0)
     {
         printf("pcap_compile failed\n");
         pcap_close(p);
@@ -233,13 +273,166 @@ int packet_extractor_run_pcap_loop(const char* ifname)
     if (pcap_setfilter(p, &fp) != 0)
     {
         printf("pcap_setfilter failed\n");
+        pcap_freecode(&fp);
+        pcap_close(p);
+        return -1;
+    }
+    pcap_freecode(&fp);
+
+    printf("sniffing on %s (backend=pcap)\n", ifname);
+
+    /* pcap_loop 대신 dispatch 반복: 종료 요청/통계 출력 시점을 확보 */
+    time_t last_report = time(NULL);
+    while (!packet_extractor_stop_requested())
+    {
+        if (pcap_dispatch(p, -1, on_packet, NULL) < 0)
+        {
+            printf("pcap_dispatch failed: %s\n", pcap_geterr(p));
+            break;
+        }
+
+        time_t now = time(NULL);
+        if (stats_interval_sec > 0 && now - last_report >= stats_interval_sec)
+        {
+            report_pcap_stats(p);
+            last_report = now;
+        }
+    }
+
+    report_pcap_stats(p);
+    pcap_close(p);
+    return 0;
+}
+
+int replay_pace_from_str(const char* s, replay_pace_t* out)
+{
+    if (!s || !out) return -1;
+    if (strcasecmp(s, "fast") == 0) { *out = REPLAY_PACE_FAST; return 0; }
+    if (strcasecmp(s, "original") == 0) { *out = REPLAY_PACE_ORIGINAL; return 0; }
+    if (strcasecmp(s, "pps") == 0) { *out = REPLAY_PACE_PPS; return 0; }
+    return -1;
+}
+
+static uint64_t mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int64_t wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + (int64_t)ts.tv_nsec / 1000000;
+}
+
+// 재생 시작 기준 due_ns 시점까지 대기 (이미 지났으면 바로 반환)
+static void sleep_until_ns(uint64_t due_ns)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(due_ns / 1000000000ull);
+    ts.tv_nsec = (long)(due_ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        if (packet_extractor_stop_requested()) return;
+    }
+}
+
+static int replay_one_pass(const packet_replay_config_t* cfg, uint64_t* sent)
+{
+    char errbuf[PCAP_ERRBUF_SIZE];
+
+    /* pcap_open_offline은 pcap / pcapng 모두 지원 */
+    pcap_t* p = pcap_open_offline(cfg->path, errbuf);
+    if (!p)
+    {
+        printf("pcap_open_offline failed: %s\n", errbuf);
+        return -1;
+    }
+
+    if (pcap_datalink(p) != DLT_EN10MB)
+    {
+        printf("replay: unsupported datalink %d (Ethernet only)\n", pcap_datalink(p));
         pcap_close(p);
         return -1;
     }
 
-    printf("sniffing on %s\n", ifname);
-    pcap_loop(p, -1, on_packet, NULL);
+    struct bpf_program fp;
+    if (pcap_compile(p, &fp, PACKET_EXTRACTOR_BPF, 1, PCAP_NETMASK_UNKNOWN) != 0)
+    {
+        printf("replay: filter compile failed: %s\n", pcap_geterr(p));
+        pcap_close(p);
+        return -1;
+    }
+    if (pcap_setfilter(p, &fp) != 0)
+    {
+        printf("replay: filter setup failed: %s\n", pcap_geterr(p));
+        pcap_freecode(&fp);
+        pcap_close(p);
+        return -1;
+    }
+    pcap_freecode(&fp);
+
+    uint64_t start_ns = mono_ns();
+    int64_t first_ts_us = -1;
+
+    struct pcap_pkthdr* hdr = NULL;
+    const u_char* pkt = NULL;
+    int rc;
+
+    while (!packet_extractor_stop_requested() && (rc = pcap_next_ex(p, &hdr, &pkt)) >= 0)
+    {
+        if (rc == 0) continue;
+
+        if (cfg->pace == REPLAY_PACE_ORIGINAL)
+        {
+            int64_t ts_us = (int64_t)hdr->ts.tv_sec * 1000000 + hdr->ts.tv_usec;
+            if (first_ts_us < 0) first_ts_us = ts_us;
+            if (ts_us > first_ts_us)
+                sleep_until_ns(start_ns + (uint64_t)(ts_us - first_ts_us) * 1000ull);
+        }
+        else if (cfg->pace == REPLAY_PACE_PPS && cfg->pps > 0.0)
+        {
+            sleep_until_ns(start_ns + (uint64_t)((double)*sent * 1e9 / cfg->pps));
+        }
+
+        /* 파일 타임스탬프 대신 현재 시각을 넣어야 engine latency가 의미를 가짐 */
+        packet_extractor_handle_frame(pkt, hdr->caplen, wall_ms());
+        (*sent)++;
+    }
 
     pcap_close(p);
     return 0;
 }
+
+int packet_extractor_run_replay(const packet_replay_config_t* cfg)
+{
+    if (!cfg || !cfg->path || !cfg->path[0]) return -1;
+
+    int loops = cfg->loops > 0 ? cfg->loops : 1;
+
+    static const char* pace_names[] = { "fast", "original", "pps" };
+    printf("replaying %s (pace=%s pps=%.0f loops=%d)\n",
+           cfg->path, pace_names[cfg->pace <= REPLAY_PACE_PPS ? cfg->pace : 0], cfg->pps, loops);
+
+    engine_metrics_reset();
+    uint64_t t0 = mono_ns();
+    int rc = 0;
+
+    for (int i = 0; i < loops && !packet_extractor_stop_requested(); i++)
+    {
+        uint64_t sent = 0;
+        if (replay_one_pass(cfg, &sent) != 0)
+        {
+            rc = -1;
+            break;
+        }
+    }
+
+    // 비동기 AI 완료까지 포함해 측정
+    process_flush();
+
+    double elapsed = (double)(mono_ns() - t0) / 1e9;
+    engine_metrics_report(stdout, elapsed);
+    return rc;
+}
@@ -1,7 +1,203 @@
+#define _GNU_SOURCE
 #include "packet_manager.h"
 #include "packet_extractor.h"
+#include "packet_ring_capture.h"
+#include "http_event_dispatch.h"
 
-int packet_manager_run(const char* ifname)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define PM_MAX_WORKERS 64
+
+typedef struct {
+    int                  worker_id;
+    int                  cpu;          // -1이면 고정 안 함
+    packet_ring_config_t ring;
+    packet_ring_stats_t  stats;
+    int                  rc;
+} capture_worker_t;
+
+int capture_backend_from_str(const char* s, capture_backend_t* out)
+{
+    if (!s || !out) return -1;
+
+    if (strcasecmp(s, "pcap") == 0 || strcasecmp(s, "libpcap") == 0) {
+        *out = CAP_BACKEND_PCAP;
+        return 0;
+    }
+    if (strcasecmp(s, "tpacket_v3") == 0 || strcasecmp(s, "ring") == 0) {
+        *out = CAP_BACKEND_TPACKET_V3;
+        return 0;
+    }
+    if (strcasecmp(s, "replay") == 0) {
+        *out = CAP_BACKEND_REPLAY;
+        return 0;
+    }
+    return -1;
+}
+
+const char* capture_backend_to_str(capture_backend_t b)
+{
+    if (b == CAP_BACKEND_TPACKET_V3) return "tpacket_v3";
+    if (b == CAP_BACKEND_REPLAY) return "replay";
+    return "pcap";
+}
+
+// "0,2,4-7" -> [0,2,4,5,6,7], 반환값: CPU 개수
+static int parse_cpu_list(const char* s, int* out, int cap)
+{
+    int n = 0;
+    if (!s) return 0;
+
+    while (*s && n < cap) {
+        char* end = NULL;
+        long a = strtol(s, &end, 10);
+        if (end == s) break;
+
+        long b = a;
+        s = end;
+        if (*s == '-') {
+            s++;
+            b = strtol(s, &end, 10);
+            if (end == s) break;
+            s = end;
+        }
+
+        for (long c = a; c <= b && n < cap; c++) out[n++] = (int)c;
+
+        if (*s == ',') s++;
+        else break;
+    }
+    return n;
+}
+
+static void ring_config_from(packet_ring_config_t* rc, const packet_manager_config_t* cfg)
+{
+    memset(rc, 0, sizeof(*rc));
+    rc->ifname = cfg->ifname;
+    rc->block_size = cfg->ring_block_size;
+    rc->block_count = cfg->ring_block_count;
+    rc->frame_size = cfg->ring_frame_size;
+    rc->block_timeout_ms = cfg->ring_block_timeout_ms;
+    rc->stats_interval_sec = cfg->stats_interval_sec;
+    rc->fanout_id = -1;
+    rc->worker_id = 0;
+}
+
+static void* capture_worker_main(void* arg)
 {
-    return packet_extractor_run_pcap_loop(ifname);
+    capture_worker_t* w = (capture_worker_t*)arg;
+
+    if (w->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w->cpu, &set);
+        int prc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (prc != 0) {
+            fprintf(stderr, "[WORKER %d] pin to cpu %d failed (rc=%d)\n", w->worker_id, w->cpu, prc);
+        }
+    }
+
+    if (process_worker_begin(w->worker_id) != 0) {
+        w->rc = -1;
+        packet_extractor_request_stop();
+        return NULL;
+    }
+
+    printf("[WORKER %d] started cpu=%d fanout=%d\n", w->worker_id, w->cpu, w->ring.fanout_id);
+
+    w->rc = packet_ring_run_loop(&w->ring, &w->stats);
+
+    // 한 워커라도 링 생성에 실패하면 전체 종료 (분배 대상이 빠진 채로 돌지 않도록)
+    if (w->rc != 0) packet_extractor_request_stop();
+
+    process_worker_end();
+    return NULL;
+}
+
+static int run_fanout_workers(const packet_manager_config_t* cfg)
+{
+    int n = cfg->workers;
+    if (n > PM_MAX_WORKERS) n = PM_MAX_WORKERS;
+
+    int cpus[PM_MAX_WORKERS];
+    int cpu_count = parse_cpu_list(cfg->cpu_list, cpus, PM_MAX_WORKERS);
+
+    capture_worker_t* workers = (capture_worker_t*)calloc((size_t)n, sizeof(capture_worker_t));
+    pthread_t* tids = (pthread_t*)calloc((size_t)n, sizeof(pthread_t));
+    if (!workers || !tids) {
+        free(workers);
+        free(tids);
+        return -1;
+    }
+
+    int started = 0;
+    for (int i = 0; i < n; i++) {
+        capture_worker_t* w = &workers[i];
+        w->worker_id = i;
+        w->cpu = (cpu_count > 0) ? cpus[i % cpu_count] : -1;
+
+        ring_config_from(&w->ring, cfg);
+        w->ring.fanout_id = cfg->fanout_id & 0xffff;
+        w->ring.worker_id = i;
+
+        if (pthread_create(&tids[i], NULL, capture_worker_main, w) != 0) {
+            fprintf(stderr, "[CAPTURE] pthread_create(worker %d) failed\n", i);
+            packet_extractor_request_stop();
+            break;
+        }
+        started++;
+    }
+
+    packet_ring_stats_t total;
+    memset(&total, 0, sizeof(total));
+    int rc = (started == n) ? 0 : -1;
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+
+        total.packets += workers[i].stats.packets;
+        total.drops += workers[i].stats.drops;
+        total.freeze_q_cnt += workers[i].stats.freeze_q_cnt;
+        total.blocks += workers[i].stats.blocks;
+        total.frames += workers[i].stats.frames;
+        if (workers[i].rc != 0) rc = -1;
+    }
+
+    printf("[CAPTURE] backend=tpacket_v3 workers=%d total packets=%llu drops=%llu freeze_q=%llu\n",
+           started,
+           (unsigned long long)total.packets,
+           (unsigned long long)total.drops,
+           (unsigned long long)total.freeze_q_cnt);
+
+    free(workers);
+    free(tids);
+    return rc;
+}
+
+int packet_manager_run(const packet_manager_config_t* cfg)
+{
+    if (!cfg) return -1;
+
+    if (cfg->backend == CAP_BACKEND_REPLAY) {
+        return packet_extractor_run_replay(&cfg->replay);
+    }
+
+    if (!cfg->ifname) return -1;
+
+    if (cfg->backend == CAP_BACKEND_TPACKET_V3) {
+        if (cfg->workers > 1) {
+            return run_fanout_workers(cfg);
+        }
+
+        packet_ring_config_t rc;
+        ring_config_from(&rc, cfg);
+        return packet_ring_run_loop(&rc, NULL);
+    }
+
+    return packet_extractor_run_pcap_loop(cfg->ifname, cfg->stats_interval_sec);
 }
@@ -0,0 +1,267 @@
+// src/packet_ring_capture.c
+#include "packet_ring_capture.h"
+#include "packet_extractor.h"
+
+#include <pcap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+
+typedef struct {
+    int fd;
+    uint8_t* map;
+    size_t map_len;
+    unsigned int block_size;
+    unsigned int block_count;
+} ring_t;
+
+static void ring_close(ring_t* r)
+{
+    if (!r) return;
+    if (r->map && r->map != MAP_FAILED) munmap(r->map, r->map_len);
+    if (r->fd >= 0) close(r->fd);
+    r->map = NULL;
+    r->fd = -1;
+}
+
+// libpcap 컴파일러로 BPF를 만들어 소켓에 직접 부착 (pcap 백엔드와 동일 필터)
+static int ring_attach_filter(int fd)
+{
+    pcap_t* dead = pcap_open_dead(DLT_EN10MB, 65535);
+    if (!dead) return -1;
+
+    struct bpf_program fp;
+    if (pcap_compile(dead, &fp, PACKET_EXTRACTOR_BPF, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        fprintf(stderr, "[RING] pcap_compile failed: %s\n", pcap_geterr(dead));
+        pcap_close(dead);
+        return -1;
+    }
+
+    struct sock_fprog prog;
+    memset(&prog, 0, sizeof(prog));
+    prog.len = (unsigned short)fp.bf_len;
+    prog.filter = (struct sock_filter*)fp.bf_insns;
+
+    int rc = setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog));
+    if (rc != 0) fprintf(stderr, "[RING] SO_ATTACH_FILTER failed: %s\n", strerror(errno));
+
+    pcap_freecode(&fp);
+    pcap_close(dead);
+    return rc == 0 ? 0 : -1;
+}
+
+static int ring_open(ring_t* r, const packet_ring_config_t* cfg)
+{
+    memset(r, 0, sizeof(*r));
+    r->fd = -1;
+
+    unsigned int ifindex = if_nametoindex(cfg->ifname);
+    if (ifindex == 0) {
+        fprintf(stderr, "[RING] unknown interface: %s\n", cfg->ifname);
+        return -1;
+    }
+
+    r->fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    if (r->fd < 0) {
+        fprintf(stderr, "[RING] socket(AF_PACKET) failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    int ver = TPACKET_V3;
+    if (setsockopt(r->fd, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver)) != 0) {
+        fprintf(stderr, "[RING] PACKET_VERSION(V3) failed: %s\n", strerror(errno));
+        ring_close(r);
+        return -1;
+    }
+
+    // 링 생성 전에 필터를 걸어야 필터 밖 트래픽이 링을 채우지 않음
+    if (ring_attach_filter(r->fd) != 0) {
+        ring_close(r);
+        return -1;
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = cfg->block_size;
+    req.tp_block_nr = cfg->block_count;
+    req.tp_frame_size = cfg->frame_size;
+    req.tp_frame_nr = (cfg->block_size / cfg->frame_size) * cfg->block_count;
+    req.tp_retire_blk_tov = cfg->block_timeout_ms;
+    req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+
+    if (setsockopt(r->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        fprintf(stderr, "[RING] PACKET_RX_RING failed: %s (block_size=%u block_count=%u)\n",
+                strerror(errno), cfg->block_size, cfg->block_count);
+        ring_close(r);
+        return -1;
+    }
+
+    r->block_size = cfg->block_size;
+    r->block_count = cfg->block_count;
+    r->map_len = (size_t)cfg->block_size * cfg->block_count;
+    r->map = (uint8_t*)mmap(NULL, r->map_len, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_LOCKED, r->fd, 0);
+    if (r->map == MAP_FAILED) {
+        // MAP_LOCKED는 RLIMIT_MEMLOCK에 걸릴 수 있으므로 일반 매핑으로 재시도
+        r->map = (uint8_t*)mmap(NULL, r->map_len, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, r->fd, 0);
+    }
+    if (r->map == MAP_FAILED) {
+        fprintf(stderr, "[RING] mmap failed: %s\n", strerror(errno));
+        ring_close(r);
+        return -1;
+    }
+
+    struct sockaddr_ll sll;
+    memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_ALL);
+    sll.sll_ifindex = (int)ifindex;
+
+    if (bind(r->fd, (struct sockaddr*)&sll, sizeof(sll)) != 0) {
+        fprintf(stderr, "[RING] bind(%s) failed: %s\n", cfg->ifname, strerror(errno));
+        ring_close(r);
+        return -1;
+    }
+
+    /*
+     * 멀티 워커: 같은 fanout 그룹에 조인
+     * - PACKET_FANOUT_HASH: 커널 flow hash(대칭) 기준 분배 -> 같은 TCP 4-tuple은 항상 같은 워커
+     * - DEFRAG: IP 조각은 재조립 후 분배 (조각별로 워커가 갈리지 않게)
+     */
+    if (cfg->fanout_id >= 0) {
+        int fanout_arg = (cfg->fanout_id & 0xffff) |
+                         ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16);
+        if (setsockopt(r->fd, SOL_PACKET, PACKET_FANOUT, &fanout_arg, sizeof(fanout_arg)) != 0) {
+            fprintf(stderr, "[RING] PACKET_FANOUT(id=%d) failed: %s\n", cfg->fanout_id, strerror(errno));
+            ring_close(r);
+            return -1;
+        }
+    }
+
+    // pcap_open_live(promisc=1)와 동일하게 promiscuous 모드
+    struct packet_mreq mr;
+    memset(&mr, 0, sizeof(mr));
+    mr.mr_ifindex = (int)ifindex;
+    mr.mr_type = PACKET_MR_PROMISC;
+    if (setsockopt(r->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mr, sizeof(mr)) != 0) {
+        fprintf(stderr, "[RING] promisc failed: %s (continuing)\n", strerror(errno));
+    }
+
+    return 0;
+}
+
+// PACKET_STATISTICS는 읽을 때마다 커널 카운터가 리셋되므로 누적해서 보관
+static void ring_collect_stats(const ring_t* r, packet_ring_stats_t* st)
+{
+    struct tpacket_stats_v3 ks;
+    socklen_t len = sizeof(ks);
+    memset(&ks, 0, sizeof(ks));
+
+    if (getsockopt(r->fd, SOL_PACKET, PACKET_STATISTICS, &ks, &len) != 0) return;
+
+    st->packets += ks.tp_packets;
+    st->drops += ks.tp_drops;
+    st->freeze_q_cnt += ks.tp_freeze_q_cnt;
+}
+
+static void ring_report_stats(const packet_ring_config_t* cfg, const packet_ring_stats_t* st)
+{
+    printf("[CAPTURE] backend=tpacket_v3 iface=%s worker=%d packets=%llu drops=%llu freeze_q=%llu blocks=%llu frames=%llu\n",
+           cfg->ifname,
+           cfg->worker_id,
+           (unsigned long long)st->packets,
+           (unsigned long long)st->drops,
+           (unsigned long long)st->freeze_q_cnt,
+           (unsigned long long)st->blocks,
+           (unsigned long long)st->frames);
+}
+
+// block 하나의 프레임을 모두 순회한 뒤 커널에 반환
+static void ring_walk_block(struct tpacket_block_desc* bd, packet_ring_stats_t* st)
+{
+    uint32_t num_pkts = bd->hdr.bh1.num_pkts;
+    struct tpacket3_hdr* ppd =
+        (struct tpacket3_hdr*)((uint8_t*)bd + bd->hdr.bh1.offset_to_first_pkt);
+
+    for (uint32_t i = 0; i < num_pkts; i++) {
+        const unsigned char* frame = (const unsigned char*)ppd + ppd->tp_mac;
+        int64_t ts_ms = (int64_t)ppd->tp_sec * 1000 + (int64_t)ppd->tp_nsec / 1000000;
+
+        packet_extractor_handle_frame(frame, ppd->tp_snaplen, ts_ms);
+
+        ppd = (struct tpacket3_hdr*)((uint8_t*)ppd + ppd->tp_next_offset);
+    }
+
+    st->frames += num_pkts;
+    st->blocks++;
+
+    __sync_synchronize();
+    bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+}
+
+int packet_ring_run_loop(const packet_ring_config_t* cfg, packet_ring_stats_t* out_stats)
+{
+    if (!cfg || !cfg->ifname || cfg->block_size == 0 || cfg->block_count == 0 || cfg->frame_size == 0)
+        return -1;
+
+    ring_t r;
+    if (ring_open(&r, cfg) != 0) return -1;
+
+    packet_ring_stats_t st;
+    memset(&st, 0, sizeof(st));
+
+    printf("sniffing on %s (backend=tpacket_v3 worker=%d fanout=%d block_size=%u block_count=%u)\n",
+           cfg->ifname, cfg->worker_id, cfg->fanout_id, cfg->block_size, cfg->block_count);
+
+    struct pollfd pfd;
+    memset(&pfd, 0, sizeof(pfd));
+    pfd.fd = r.fd;
+    pfd.events = POLLIN | POLLERR;
+
+    unsigned int cur = 0;
+    time_t last_report = time(NULL);
+
+    while (!packet_extractor_stop_requested()) {
+        struct tpacket_block_desc* bd =
+            (struct tpacket_block_desc*)(r.map + (size_t)cur * r.block_size);
+
+        if ((bd->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+            // block이 아직 커널 소유: 100ms 단위로 대기 (종료 요청 확인용)
+            int prc = poll(&pfd, 1, 100);
+            if (prc < 0 && errno != EINTR) {
+                fprintf(stderr, "[RING] poll failed: %s\n", strerror(errno));
+                break;
+            }
+        } else {
+            ring_walk_block(bd, &st);
+            cur = (cur + 1) % r.block_count;
+        }
+
+        time_t now = time(NULL);
+        if (cfg->stats_interval_sec > 0 && now - last_report >= cfg->stats_interval_sec) {
+            ring_collect_stats(&r, &st);
+            ring_report_stats(cfg, &st);
+            last_report = now;
+        }
+    }
+
+    ring_collect_stats(&r, &st);
+    ring_report_stats(cfg, &st);
+
+    if (out_stats) *out_stats = st;
+
+    ring_close(&r);
+    return 0;
+}
@@ -1,102 +1,111 @@
 #include "policy.h"
+#include "policy_index.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <regex.h>
+#include <sys/mman.h>
 
 /* ---------- 유틸 ---------- */
 
-static int streq_ci(const char* a, const char* b)
+static void lower_copy(char* dst, const char* src, size_t n)
 {
-    if (!a || !b) return 0;
-    while (*a && *b) {
-        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) return 0;
-        a++; b++;
-    }
-    return (*a == '\0' && *b == '\0');
+    for (size_t i = 0; i < n; i++) dst[i] = (char)tolower((unsigned char)src[i]);
+    dst[n] = '\0';
 }
 
-static int starts_with(const char* s, const char* p, int case_sensitive)
+/*
+ * 매칭 대상(host/path/url_norm)을 이벤트당 1회만 소문자화
+ * - case-insensitive 룰은 모두 소문자 패턴 vs 소문자 대상으로 비교
+ */
+#define MATCH_TARGET_COUNT 3
+#define MATCH_INLINE_CAP   1024
+
+typedef struct {
+    const char* raw[MATCH_TARGET_COUNT];
+    const char* lc[MATCH_TARGET_COUNT];
+    char*       heap[MATCH_TARGET_COUNT];
+    size_t      host_len;   // 포트/끝 점 제외 host 길이 (raw/lc[RT_HOST] 앞부분)
+    char        inline_buf[MATCH_TARGET_COUNT][MATCH_INLINE_CAP];
+} match_ctx_t;
+
+static void match_ctx_init(match_ctx_t* m, const char* host, const char* path, const char* url_norm)
 {
-    if (!s || !p) return 0;
-    size_t ps = strlen(p);
-    if (strlen(s) < ps) return 0;
-
-    if (case_sensitive) return (strncmp(s, p, ps) == 0);
+    m->raw[RT_HOST] = host;
+    m->raw[RT_PATH] = path;
+    m->raw[RT_URL] = url_norm;
+
+    for (int t = 0; t < MATCH_TARGET_COUNT; t++) {
+        size_t n = strlen(m->raw[t]);
+        char* buf = m->inline_buf[t];
+        m->heap[t] = NULL;
+
+        if (n >= MATCH_INLINE_CAP) {
+            m->heap[t] = (char*)malloc(n + 1);
+            buf = m->heap[t];
+        }
 
-    for (size_t i = 0; i < ps; i++) {
-        if (tolower((unsigned char)s[i]) != tolower((unsigned char)p[i])) return 0;
+        if (buf) {
+            lower_copy(buf, m->raw[t], n);
+            m->lc[t] = buf;
+        } else {
+            m->lc[t] = "";
+        }
     }
-    return 1;
+
+    m->host_len = policy_host_norm_len(m->raw[RT_HOST], strlen(m->raw[RT_HOST]));
 }
 
-static int contains_substr(const char* s, const char* sub, int case_sensitive)
+static void match_ctx_free(match_ctx_t* m)
 {
-    if (!s || !sub) return 0;
-
-    if (case_sensitive) return (strstr(s, sub) != NULL);
-
-    /* case-insensitive strstr */
-    size_t n = strlen(s);
-    size_t m = strlen(sub);
-    if (m == 0) return 1;
-    if (n < m) return 0;
-
-    for (size_t i = 0; i + m <= n; i++) {
-        size_t k = 0;
-        for (; k < m; k++) {
-            if (tolower((unsigned char)s[i+k]) != tolower((unsigned char)sub[k])) break;
-        }
-        if (k == m) return 1;
-    }
-    return 0;
+    for (int t = 0; t < MATCH_TARGET_COUNT; t++) free(m->heap[t]);
 }
 
-static int match_regex(const char* s, const char* pat, int case_sensitive)
+/* target이 domain 자신이거나 그 하위 도메인인지 ("a.example.com" / "example.com") */
+static int domain_match(const char* target, size_t n, const char* domain, size_t dlen)
 {
-    if (!s || !pat) return 0;
-
-    regex_t re;
-    int cflags = REG_EXTENDED | REG_NOSUB;
-    if (!case_sensitive) cflags |= REG_ICASE;
-
-    if (regcomp(&re, pat, cflags) != 0) return 0;
-    int ok = (regexec(&re, s, 0, NULL, 0) == 0);
-    regfree(&re);
-    return ok;
+    if (dlen == 0 || n < dlen) return 0;
+    if (memcmp(target + n - dlen, domain, dlen) != 0) return 0;
+    return n == dlen || target[n - dlen - 1] == '.';
 }
 
-static int rule_match_one(const policy_rule_t* r,
-                          const char* host,
-                          const char* path,
-                          const char* url_norm)
+static int rule_match_one(const policy_rule_t* r, const match_ctx_t* m)
 {
     if (!r || !r->is_enabled) return 0;
 
-    const char* target = NULL;
-    if (r->rule_type == RT_HOST) target = host;
-    else if (r->rule_type == RT_PATH) target = path;
-    else target = url_norm;
+    int t = (r->rule_type == RT_HOST || r->rule_type == RT_PATH) ? (int)r->rule_type : RT_URL;
+    int case_sensitive = (r->is_case_sensitive != 0);
 
-    if (!target) target = "";
+    /* case-insensitive 룰은 미리 소문자화한 대상/패턴끼리 비교 */
+    const char* target = case_sensitive ? m->raw[t] : m->lc[t];
+    const char* pat = case_sensitive ? r->pattern : r->pattern_lc;
 
-    int case_sensitive = (r->is_case_sensitive != 0);
     int matched = 0;
 
     switch (r->match_type) {
         case MT_EXACT:
-            matched = case_sensitive ? (strcmp(target, r->pattern) == 0) : streq_ci(target, r->pattern);
+            matched = (strcmp(target, pat) == 0);
+            /* host는 포트/끝 점을 뗀 형태로도 비교 */
+            if (!matched && t == RT_HOST) {
+                matched = (m->host_len == r->pattern_len && memcmp(target, pat, m->host_len) == 0);
+            }
             break;
         case MT_PREFIX:
-            matched = starts_with(target, r->pattern, case_sensitive);
+            matched = (strncmp(target, pat, r->pattern_len) == 0);
             break;
         case MT_CONTAINS:
-            matched = contains_substr(target, r->pattern, case_sensitive);
+            matched = (strstr(target, pat) != NULL);
             break;
         case MT_REGEX:
-            matched = match_regex(target, r->pattern, case_sensitive);
+            /* REG_ICASE로 컴파일했으므로 원문 대상에 실행 */
+            matched = (r->re && regexec(r->re, m->raw[t], 0, NULL, 0) == 0);
+            break;
+        case MT_DOMAIN:
+            /* 도메인은 항상 대소문자 무시, host는 정규화 길이 사용 */
+            matched = domain_match(m->lc[t], (t == RT_HOST) ? m->host_len : strlen(m->lc[t]),
+                                   r->pattern_lc, r->pattern_len);
             break;
         default:
             matched = 0;
@@ -107,6 +116,67 @@ static int rule_match_one(const policy_rule_t* r,
     return matched;
 }
 
+/*
+ * 룰 1개를 실행 가능한 형태로 컴파일
+ * - 패턴 길이, 소문자 패턴, 정규식 컴파일 결과를 룰에 저장
+ * - 반환값: 0 성공, -1 실패(err에 사유)
+ */
+int policy_rule_compile(policy_rule_t* r, char* err, size_t errsz)
+{
+    r->pattern_len = strlen(r->pattern);
+    lower_copy(r->pattern_lc, r->pattern, r->pattern_len);
+    r->re = NULL;
+
+    if (r->match_type == MT_DOMAIN) {
+        /* "*.example.com" / ".example.com" / "example.com." -> "example.com" */
+        const char* d = r->pattern_lc;
+        size_t n = r->pattern_len;
+        if (n >= 2 && d[0] == '*' && d[1] == '.') { d += 2; n -= 2; }
+        else if (n >= 1 && d[0] == '.') { d += 1; n -= 1; }
+        if (n > 0 && d[n - 1] == '.') n--;
+
+        if (n == 0) {
+            snprintf(err, errsz, "empty domain pattern");
+            return -1;
+        }
+
+        memmove(r->pattern_lc, d, n);
+        r->pattern_lc[n] = '\0';
+        r->pattern_len = n;
+        return 0;
+    }
+
+    if (r->match_type != MT_REGEX) return 0;
+
+    regex_t* re = (regex_t*)malloc(sizeof(regex_t));
+    if (!re) {
+        snprintf(err, errsz, "out of memory");
+        return -1;
+    }
+
+    int cflags = REG_EXTENDED | REG_NOSUB;
+    if (!r->is_case_sensitive) cflags |= REG_ICASE;
+
+    int rc = regcomp(re, r->pattern, cflags);
+    if (rc != 0) {
+        regerror(rc, re, err, errsz);
+        free(re);
+        return -1;
+    }
+
+    r->re = re;
+    return 0;
+}
+
+void policy_rule_release(policy_rule_t* r)
+{
+    if (r->re) {
+        regfree(r->re);
+        free(r->re);
+        r->re = NULL;
+    }
+}
+
 static action_t action_from_str(const char* s)
 {
     if (!s) return ACT_UNKNOWN;
@@ -133,27 +203,89 @@ static match_type_t match_type_from_str(const char* s)
     if (strcasecmp(s, "PREFIX") == 0) return MT_PREFIX;
     if (strcasecmp(s, "CONTAINS") == 0) return MT_CONTAINS;
     if (strcasecmp(s, "REGEX") == 0) return MT_REGEX;
+    if (strcasecmp(s, "DOMAIN") == 0) return MT_DOMAIN;
     return MT_EXACT;
 }
 
 /* ---------- 정책 캐시 ---------- */
 
+static void policy_cache_drop_index(policy_cache_t* cache)
+{
+    if (!cache->index) return;
+
+    policy_index_free(cache->index);
+    free(cache->index);
+    cache->index = NULL;
+}
+
+int policy_cache_build_index(policy_cache_t* cache)
+{
+    if (!cache) return -1;
+
+    policy_cache_drop_index(cache);
+
+    policy_index_t* idx = (policy_index_t*)calloc(1, sizeof(policy_index_t));
+    if (!idx) return -1;
+
+    if (policy_index_build(idx, cache) != 0) {
+        fprintf(stderr, "[POLICY] index build failed, falling back to linear match\n");
+        free(idx);
+        return -1;
+    }
+
+    cache->index = idx;
+    fprintf(stderr, "[POLICY] index built: indexed_rules=%zu residual_policies=%zu\n",
+            idx->indexed_rule_count, idx->residual_count);
+    return 0;
+}
+
 void free_policy_cache(policy_cache_t* cache)
 {
     if (!cache) return;
 
+    policy_cache_drop_index(cache);
+
     for (size_t i = 0; i < cache->policy_count; i++) {
-        free(cache->policies[i].rules);
-        cache->policies[i].rules = NULL;
-        cache->policies[i].rule_count = 0;
+        policy_t* p = &cache->policies[i];
+
+        /* 스냅샷 파일 매핑 안의 룰 배열은 해제 대상 아님 (munmap으로 일괄 해제) */
+        const char* rp = (const char*)p->rules;
+        if (cache->map_base && rp >= (const char*)cache->map_base &&
+            rp < (const char*)cache->map_base + cache->map_len) {
+            p->rules = NULL;
+            p->rule_count = 0;
+            continue;
+        }
+
+        /* 델타 동기화로 다른 스냅샷과 공유 중인 룰 배열은 마지막 참조가 해제 */
+        int last = 1;
+        if (p->rules_refcnt) {
+            last = (__atomic_sub_fetch(p->rules_refcnt, 1, __ATOMIC_ACQ_REL) == 0);
+            if (last) free(p->rules_refcnt);
+            p->rules_refcnt = NULL;
+        }
+
+        if (last) {
+            for (size_t k = 0; k < p->rule_count; k++) policy_rule_release(&p->rules[k]);
+            free(p->rules);
+        }
+        p->rules = NULL;
+        p->rule_count = 0;
     }
 
     free(cache->policies);
     cache->policies = NULL;
     cache->policy_count = 0;
+    cache->rejected_rule_count = 0;
+
+    if (cache->map_base) {
+        munmap(cache->map_base, cache->map_len);
+        cache->map_base = NULL;
+        cache->map_len = 0;
+    }
 }
 
-static MYSQL* policy_db_connect(const char* host, int port, const char* user, const char* pass, const char* db)
+MYSQL* policy_db_connect(const char* host, int port, const char* user, const char* pass, const char* db)
 {
     MYSQL* conn = mysql_init(NULL);
     if (!conn) return NULL;
@@ -174,50 +306,74 @@ static MYSQL* policy_db_connect(const char* host, int port, const char* user, co
     return conn;
 }
 
-int load_policy_cache(policy_cache_t* cache,
-                      const char* host,
-                      int port,
-                      const char* user,
-                      const char* pass,
-                      const char* db)
-{
-    if (!cache) return -1;
+/* policy_id -> policies[] 위치 (policy_id 오름차순 정렬 후 이진 탐색) */
+typedef struct {
+    long long policy_id;
+    size_t    idx;
+} policy_pos_t;
 
-    free_policy_cache(cache);
+static int cmp_policy_pos(const void* a, const void* b)
+{
+    const policy_pos_t* x = (const policy_pos_t*)a;
+    const policy_pos_t* y = (const policy_pos_t*)b;
+    return (x->policy_id > y->policy_id) - (x->policy_id < y->policy_id);
+}
 
-    MYSQL* conn = policy_db_connect(host, port, user, pass, db);
-    if (!conn) return -1;
+static const policy_pos_t* find_policy_pos(const policy_pos_t* pos, size_t n, long long pid)
+{
+    policy_pos_t key;
+    key.policy_id = pid;
+    key.idx = 0;
+    return (const policy_pos_t*)bsearch(&key, pos, n, sizeof(policy_pos_t), cmp_policy_pos);
+}
 
+/*
+ * policy / policy_rule 조회 결과로 cache 채우기 (인덱스는 만들지 않음)
+ * - filter: 두 쿼리의 WHERE에 그대로 덧붙는 조건 (예: " AND policy_id IN (1,2)")
+ */
+static int policy_cache_fill(MYSQL* conn, policy_cache_t* cache, const char* filter)
+{
     /*
      * policy: is_enabled=1 인 것만
      * - policy_id, policy_name, policy_type, action, priority, is_enabled, risk_level, category, block_status_code, redirect_url
      */
-    const char* q1 =
-        "SELECT policy_id, policy_name, policy_type, action, priority, is_enabled, "
-        "       risk_level, category, block_status_code, redirect_url "
-        "FROM policy "
-        "WHERE is_enabled=1 "
-        "ORDER BY priority ASC, policy_id ASC";
-
-    if (mysql_query(conn, q1) != 0) {
+    size_t filter_len = filter ? strlen(filter) : 0;
+    size_t qcap = filter_len + 512;
+    char* q = (char*)malloc(qcap);
+    if (!q) return -1;
+
+    snprintf(q, qcap,
+             "SELECT policy_id, policy_name, policy_type, action, priority, is_enabled, "
+             "       risk_level, category, block_status_code, redirect_url "
+             "FROM policy "
+             "WHERE is_enabled=1%s "
+             "ORDER BY priority ASC, policy_id ASC",
+             filter ? filter : "");
+
+    if (mysql_query(conn, q) != 0) {
         fprintf(stderr, "[POLICY_DB] query policy failed: %s\n", mysql_error(conn));
-        mysql_close(conn);
+        free(q);
         return -1;
     }
 
     MYSQL_RES* res = mysql_store_result(conn);
     if (!res) {
         fprintf(stderr, "[POLICY_DB] store_result failed: %s\n", mysql_error(conn));
-        mysql_close(conn);
+        free(q);
         return -1;
     }
 
     size_t n = (size_t)mysql_num_rows(res);
-    cache->policies = (policy_t*)calloc(n, sizeof(policy_t));
+    cache->policies = (policy_t*)calloc(n ? n : 1, sizeof(policy_t));
     cache->policy_count = 0;
+    if (!cache->policies) {
+        mysql_free_result(res);
+        free(q);
+        return -1;
+    }
 
     MYSQL_ROW row;
-    while ((row = mysql_fetch_row(res)) != NULL) {
+    while ((row = mysql_fetch_row(res)) != NULL && cache->policy_count < n) {
         policy_t* p = &cache->policies[cache->policy_count];
 
         p->policy_id = row[0] ? atoll(row[0]) : 0;
@@ -233,6 +389,8 @@ int load_policy_cache(policy_cache_t* cache,
 
         p->rules = NULL;
         p->rule_count = 0;
+        p->rules_refcnt = NULL;
+        p->rejected_rule_count = 0;
 
         cache->policy_count++;
     }
@@ -243,59 +401,67 @@ int load_policy_cache(policy_cache_t* cache,
      * policy_rule: is_enabled=1 인 룰을 policy_id별로 읽어서 각 policy.rules에 넣음
      * - rule_id, policy_id, rule_type, match_type, pattern, is_case_sensitive, is_negated, rule_order, is_enabled
      */
-    const char* q2 =
-        "SELECT rule_id, policy_id, rule_type, match_type, pattern, "
-        "       is_case_sensitive, is_negated, rule_order, is_enabled "
-        "FROM policy_rule "
-        "WHERE is_enabled=1 "
-        "ORDER BY policy_id ASC, rule_order ASC, rule_id ASC";
-
-    if (mysql_query(conn, q2) != 0) {
+    snprintf(q, qcap,
+             "SELECT rule_id, policy_id, rule_type, match_type, pattern, "
+             "       is_case_sensitive, is_negated, rule_order, is_enabled "
+             "FROM policy_rule "
+             "WHERE is_enabled=1%s "
+             "ORDER BY policy_id ASC, rule_order ASC, rule_id ASC",
+             filter ? filter : "");
+
+    int qrc = mysql_query(conn, q);
+    free(q);
+    if (qrc != 0) {
         fprintf(stderr, "[POLICY_DB] query policy_rule failed: %s\n", mysql_error(conn));
-        mysql_close(conn);
-        free_policy_cache(cache);
         return -1;
     }
 
     MYSQL_RES* res2 = mysql_store_result(conn);
     if (!res2) {
         fprintf(stderr, "[POLICY_DB] store_result(rule) failed: %s\n", mysql_error(conn));
-        mysql_close(conn);
-        free_policy_cache(cache);
         return -1;
     }
 
-    /* 1-pass: policy별 rule_count 계산 */
-    size_t* counts = (size_t*)calloc(cache->policy_count, sizeof(size_t));
-    if (!counts) {
+    /* policy_id 정렬 위치표 + policy별 rule_count */
+    policy_pos_t* pos = (policy_pos_t*)calloc(cache->policy_count ? cache->policy_count : 1, sizeof(policy_pos_t));
+    size_t* counts = (size_t*)calloc(cache->policy_count ? cache->policy_count : 1, sizeof(size_t));
+    if (!pos || !counts) {
+        free(pos);
+        free(counts);
         mysql_free_result(res2);
-        mysql_close(conn);
-        free_policy_cache(cache);
         return -1;
     }
 
+    for (size_t i = 0; i < cache->policy_count; i++) {
+        pos[i].policy_id = cache->policies[i].policy_id;
+        pos[i].idx = i;
+    }
+    qsort(pos, cache->policy_count, sizeof(policy_pos_t), cmp_policy_pos);
+
+    /* 1-pass: policy별 rule_count 계산 */
     MYSQL_ROW rrow;
     while ((rrow = mysql_fetch_row(res2)) != NULL) {
         long long pid = rrow[1] ? atoll(rrow[1]) : 0;
-        for (size_t i = 0; i < cache->policy_count; i++) {
-            if (cache->policies[i].policy_id == pid) {
-                counts[i]++;
-                break;
-            }
-        }
+        const policy_pos_t* pp = find_policy_pos(pos, cache->policy_count, pid);
+        if (pp) counts[pp->idx]++;
     }
 
-    /* allocate rules */
-    for (size_t i = 0; i < cache->policy_count; i++) {
-        if (counts[i] > 0) {
-            cache->policies[i].rules = (policy_rule_t*)calloc(counts[i], sizeof(policy_rule_t));
-            cache->policies[i].rule_count = 0;
-        }
+    /* allocate rules (refcount는 델타 동기화 시 스냅샷 간 공유용) */
+    int rc = 0;
+    for (size_t i = 0; i < cache->policy_count && rc == 0; i++) {
+        if (counts[i] == 0) continue;
+
+        policy_t* p = &cache->policies[i];
+        p->rules = (policy_rule_t*)calloc(counts[i], sizeof(policy_rule_t));
+        p->rules_refcnt = (int*)malloc(sizeof(int));
+        p->rule_count = 0;
+        if (!p->rules || !p->rules_refcnt) rc = -1;
+        else *p->rules_refcnt = 1;
     }
 
     /* 2-pass: fill */
     mysql_data_seek(res2, 0);
-    while ((rrow = mysql_fetch_row(res2)) != NULL) {
+    while (rc == 0 && (rrow = mysql_fetch_row(res2)) != NULL) {
         policy_rule_t rr;
         memset(&rr, 0, sizeof(rr));
 
@@ -309,23 +475,237 @@ int load_policy_cache(policy_cache_t* cache,
         rr.rule_order = rrow[7] ? atoi(rrow[7]) : 0;
         rr.is_enabled = rrow[8] ? atoi(rrow[8]) : 1;
 
-        for (size_t i = 0; i < cache->policy_count; i++) {
-            if (cache->policies[i].policy_id == rr.policy_id && cache->policies[i].rules) {
-                size_t idx = cache->policies[i].rule_count;
-                cache->policies[i].rules[idx] = rr;
-                cache->policies[i].rule_count++;
-                break;
-            }
+        /* 소속 policy가 없으면 (비활성 policy의 룰) 건너뜀 */
+        const policy_pos_t* pp = find_policy_pos(pos, cache->policy_count, rr.policy_id);
+        if (!pp || !cache->policies[pp->idx].rules) continue;
+
+        /* 잘못된 패턴은 hot path에서 조용히 불일치 처리하지 않고 로드 시 제외 + 보고 */
+        char err[256];
+        if (policy_rule_compile(&rr, err, sizeof(err)) != 0) {
+            fprintf(stderr, "[POLICY] rule rejected: rule_id=%lld policy_id=%lld pattern=\"%s\" err=%s\n",
+                    rr.rule_id, rr.policy_id, rr.pattern, err);
+            cache->rejected_rule_count++;
+            cache->policies[pp->idx].rejected_rule_count++;
+            continue;
         }
+
+        policy_t* p = &cache->policies[pp->idx];
+        p->rules[p->rule_count++] = rr;
+    }
+
+    if (cache->rejected_rule_count > 0) {
+        fprintf(stderr, "[POLICY] %zu rule(s) rejected at load time\n", cache->rejected_rule_count);
     }
 
+    free(pos);
     free(counts);
     mysql_free_result(res2);
+    return rc;
+}
+
+int load_policy_cache(policy_cache_t* cache,
+                      const char* host,
+                      int port,
+                      const char* user,
+                      const char* pass,
+                      const char* db)
+{
+    if (!cache) return -1;
+
+    MYSQL* conn = policy_db_connect(host, port, user, pass, db);
+    if (!conn) {
+        free_policy_cache(cache);
+        return -1;
+    }
+
+    int rc = load_policy_cache_conn(cache, conn);
     mysql_close(conn);
+    return rc;
+}
+
+int load_policy_cache_conn(policy_cache_t* cache, MYSQL* conn)
+{
+    if (!cache) return -1;
+
+    free_policy_cache(cache);
+    if (!conn) return -1;
+
+    int rc = policy_cache_fill(conn, cache, NULL);
+    if (rc != 0) {
+        free_policy_cache(cache);
+        return -1;
+    }
+
+    /* 인덱스 생성 실패는 치명적이지 않음 (선형 평가로 동작) */
+    (void)policy_cache_build_index(cache);
 
     return 0;
 }
 
+int policy_cache_load_subset(MYSQL* conn, policy_cache_t* out, const long long* policy_ids, size_t n)
+{
+    if (!conn || !out) return -1;
+    memset(out, 0, sizeof(*out));
+    if (n == 0) return 0;
+
+    /* " AND policy_id IN (...)" : id당 최대 20자 + 구분자 */
+    size_t cap = n * 21 + 32;
+    char* filter = (char*)malloc(cap);
+    if (!filter) return -1;
+
+    size_t len = (size_t)snprintf(filter, cap, " AND policy_id IN (");
+    for (size_t i = 0; i < n; i++) {
+        len += (size_t)snprintf(filter + len, cap - len, "%s%lld", i ? "," : "", policy_ids[i]);
+    }
+    snprintf(filter + len, cap - len, ")");
+
+    int rc = policy_cache_fill(conn, out, filter);
+    free(filter);
+
+    if (rc != 0) free_policy_cache(out);
+    return rc;
+}
+
+static int cmp_ll(const void* a, const void* b)
+{
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/* (priority, policy_id) 순서 = 로드 쿼리의 ORDER BY */
+static int policy_before(const policy_t* a, const policy_t* b)
+{
+    if (a->priority != b->priority) return a->priority < b->priority;
+    return a->policy_id < b->policy_id;
+}
+
+int policy_cache_merge(policy_cache_t* out,
+                       const policy_cache_t* base,
+                       policy_cache_t* delta,
+                       const long long* changed_ids,
+                       size_t changed_count)
+{
+    if (!out || !base || !delta) return -1;
+    memset(out, 0, sizeof(*out));
+
+    /* 매핑된 룰 배열은 refcount가 없어 공유 불가 (호출자는 전체 재로드) */
+    if (base->map_base) return -1;
+
+    long long* ids = (long long*)malloc((changed_count ? changed_count : 1) * sizeof(long long));
+    out->policies = (policy_t*)calloc(base->policy_count + delta->policy_count + 1, sizeof(policy_t));
+    if (!ids || !out->policies) {
+        free(ids);
+        free(out->policies);
+        out->policies = NULL;
+        return -1;
+    }
+
+    if (changed_count) memcpy(ids, changed_ids, changed_count * sizeof(long long));
+    qsort(ids, changed_count, sizeof(long long), cmp_ll);
+
+    /* 두 정렬 목록 병합: base의 변경 안 된 policy(룰 배열 공유) + delta policy(소유권 이동) */
+    size_t i = 0, k = 0;
+    while (i < base->policy_count || k < delta->policy_count) {
+        const policy_t* bp = NULL;
+        while (i < base->policy_count) {
+            long long pid = base->policies[i].policy_id;
+            if (!bsearch(&pid, ids, changed_count, sizeof(long long), cmp_ll)) {
+                bp = &base->policies[i];
+                break;
+            }
+            i++;
+        }
+
+        policy_t* dp = (k < delta->policy_count) ? &delta->policies[k] : NULL;
+        if (!bp && !dp) break;
+
+        policy_t* dst = &out->policies[out->policy_count++];
+        if (bp && (!dp || policy_before(bp, dp))) {
+            *dst = *bp;
+            /* 룰이 있는 policy는 policy_cache_fill에서 항상 refcount를 가짐 */
+            if (dst->rules_refcnt) __atomic_add_fetch(dst->rules_refcnt, 1, __ATOMIC_RELAXED);
+            i++;
+        } else {
+            *dst = *dp;
+            memset(dp, 0, sizeof(*dp));
+            k++;
+        }
+    }
+
+    /* base 합계에는 교체된 policy의 제외 룰도 들어 있으므로 남은 policy 기준으로 다시 합산 */
+    for (size_t p = 0; p < out->policy_count; p++) {
+        out->rejected_rule_count += out->policies[p].rejected_rule_count;
+    }
+
+    free(ids);
+    free_policy_cache(delta);
+    return 0;
+}
+
+int policy_cache_build_index_delta(policy_cache_t* cache,
+                                  const policy_cache_t* base,
+                                  const long long* changed_ids,
+                                  size_t changed_count)
+{
+    if (!cache || !base) return -1;
+    if (!base->index) return policy_cache_build_index(cache);
+
+    policy_cache_drop_index(cache);
+
+    uint32_t* remap = (uint32_t*)malloc((base->policy_count ? base->policy_count : 1) * sizeof(uint32_t));
+    unsigned char* fresh = (unsigned char*)calloc(cache->policy_count ? cache->policy_count : 1, 1);
+    policy_index_t* idx = (policy_index_t*)calloc(1, sizeof(policy_index_t));
+    if (!remap || !fresh || !idx) {
+        free(remap);
+        free(fresh);
+        free(idx);
+        return -1;
+    }
+
+    /* merge 결과에서 바뀌지 않은 policy는 base와 같은 상대 순서: 두 목록을 나란히 따라가며 위치 대응 */
+    size_t j = 0;
+    for (size_t i = 0; i < base->policy_count; i++) {
+        long long pid = base->policies[i].policy_id;
+        remap[i] = UINT32_MAX;
+        if (bsearch(&pid, changed_ids, changed_count, sizeof(long long), cmp_ll)) continue;
+
+        while (j < cache->policy_count && cache->policies[j].policy_id != pid) j++;
+        if (j < cache->policy_count) remap[i] = (uint32_t)j++;
+    }
+    for (size_t k = 0; k < cache->policy_count; k++) {
+        long long pid = cache->policies[k].policy_id;
+        fresh[k] = bsearch(&pid, changed_ids, changed_count, sizeof(long long), cmp_ll) != NULL;
+    }
+
+    size_t rebuilt = 0;
+    int rc = policy_index_build_delta(idx, cache, base->index, base->policy_count, remap, fresh, &rebuilt);
+    free(remap);
+    free(fresh);
+
+    if (rc != 0) {
+        fprintf(stderr, "[POLICY] delta index build failed\n");
+        free(idx);
+        return -1;
+    }
+
+    cache->index = idx;
+    fprintf(stderr, "[POLICY] index updated: rebuilt_parts=%zu indexed_rules=%zu residual_policies=%zu\n",
+            rebuilt, idx->indexed_rule_count, idx->residual_count);
+    return 0;
+}
+
+/* policy 1개의 룰 평가 (skip_indexed=1 이면 인덱스가 이미 처리한 룰 제외) */
+static int policy_rules_match(const policy_t* pol, const match_ctx_t* m, int skip_indexed)
+{
+    for (size_t k = 0; k < pol->rule_count; k++) {
+        const policy_rule_t* r = &pol->rules[k];
+        if (skip_indexed && r->is_indexed) continue;
+        if (rule_match_one(r, m)) return 1;
+    }
+    return 0;
+}
+
 policy_decision_t match_policy(const policy_cache_t* cache,
                                const char* host,
                                const char* path,
@@ -340,30 +720,53 @@ policy_decision_t match_policy(const policy_cache_t* cache,
     const char* p = path ? path : "/";
     const char* u = url_norm ? url_norm : "";
 
-    for (size_t i = 0; i < cache->policy_count; i++) {
-        const policy_t* pol = &cache->policies[i];
-        if (!pol->is_enabled) continue;
+    match_ctx_t m;
+    match_ctx_init(&m, h, p, u);
+
+    const policy_t* hit = NULL;
+
+    if (cache->index) {
+        /*
+         * 1) 인덱스 룰: 한 번의 순회로 매칭되는 최상위 policy 위치
+         * 2) residual 룰: 그보다 우선순위가 높은 policy만 선형 평가
+         * -> policy 내 룰 OR, priority 순 첫 매칭이라는 기존 의미와 동일
+         */
+        const policy_index_t* idx = cache->index;
+        uint32_t best = policy_index_best(idx, m.raw, m.lc, m.host_len);
+
+        for (size_t r = 0; r < idx->residual_count; r++) {
+            uint32_t pi = idx->residual_policies[r];
+            if (pi >= best) break;
+            if (policy_rules_match(&cache->policies[pi], &m, 1)) {
+                best = pi;
+                break;
+            }
+        }
+
+        if (best < cache->policy_count) hit = &cache->policies[best];
+    } else {
+        for (size_t i = 0; i < cache->policy_count; i++) {
+            const policy_t* pol = &cache->policies[i];
+            if (!pol->is_enabled) continue;
 
-        /* 룰이 0개면 매칭 불가 */
-        if (!pol->rules || pol->rule_count == 0) continue;
+            /* 룰이 0개면 매칭 불가 */
+            if (!pol->rules || pol->rule_count == 0) continue;
 
-        int any_match = 0;
-        for (size_t k = 0; k < pol->rule_count; k++) {
-            if (rule_match_one(&pol->rules[k], h, p, u)) {
-                any_match = 1;
+            if (policy_rules_match(pol, &m, 0)) {
+                hit = pol;
                 break;
             }
         }
+    }
 
-        if (any_match) {
-            d.matched = 1;
-            d.policy_id = pol->policy_id;
-            d.action = pol->action;
-            d.block_status_code = (pol->block_status_code > 0 ? pol->block_status_code : 403);
-            snprintf(d.redirect_url, sizeof(d.redirect_url), "%s", pol->redirect_url);
-            return d;
-        }
+    if (hit) {
+        d.matched = 1;
+        d.policy_id = hit->policy_id;
+        d.action = hit->action;
+        d.block_status_code = (hit->block_status_code > 0 ? hit->block_status_code : 403);
+        snprintf(d.redirect_url, sizeof(d.redirect_url), "%s", hit->redirect_url);
     }
 
+    match_ctx_free(&m);
     return d;
 }
@@ -0,0 +1,276 @@
+// src/policy_ac.c
+#include "policy_ac.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ---------- 빌더 (동적 트라이) ---------- */
+
+typedef struct {
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint32_t fail;
+    uint32_t dict;
+    uint32_t out_head;   // b_out_t 연결 리스트
+    uint32_t out_count;
+    uint8_t  byte;
+} b_node_t;
+
+typedef struct {
+    policy_rule_ref_t ref;
+    uint32_t          next;
+} b_out_t;
+
+struct policy_ac_builder {
+    b_node_t* nodes;
+    uint32_t  node_count;
+    uint32_t  node_cap;
+
+    b_out_t*  outs;
+    uint32_t  out_count;
+    uint32_t  out_cap;
+};
+
+static int grow(void** arr, uint32_t* cap, size_t elem, uint32_t need)
+{
+    if (need <= *cap) return 0;
+
+    uint32_t ncap = *cap ? *cap : 64;
+    while (ncap < need) ncap *= 2;
+
+    void* p = realloc(*arr, (size_t)ncap * elem);
+    if (!p) return -1;
+
+    *arr = p;
+    *cap = ncap;
+    return 0;
+}
+
+static uint32_t b_new_node(policy_ac_builder_t* b, uint8_t byte)
+{
+    if (grow((void**)&b->nodes, &b->node_cap, sizeof(b_node_t), b->node_count + 1) != 0)
+        return POLICY_AC_NONE;
+
+    uint32_t id = b->node_count++;
+    b_node_t* n = &b->nodes[id];
+    n->first_child = POLICY_AC_NONE;
+    n->next_sibling = POLICY_AC_NONE;
+    n->fail = 0;
+    n->dict = POLICY_AC_NONE;
+    n->out_head = POLICY_AC_NONE;
+    n->out_count = 0;
+    n->byte = byte;
+    return id;
+}
+
+static uint32_t b_child(const policy_ac_builder_t* b, uint32_t node, uint8_t byte)
+{
+    for (uint32_t c = b->nodes[node].first_child; c != POLICY_AC_NONE; c = b->nodes[c].next_sibling) {
+        if (b->nodes[c].byte == byte) return c;
+    }
+    return POLICY_AC_NONE;
+}
+
+policy_ac_builder_t* policy_ac_builder_new(void)
+{
+    policy_ac_builder_t* b = (policy_ac_builder_t*)calloc(1, sizeof(policy_ac_builder_t));
+    if (!b) return NULL;
+
+    if (b_new_node(b, 0) != 0) {
+        policy_ac_builder_free(b);
+        return NULL;
+    }
+    return b;
+}
+
+void policy_ac_builder_free(policy_ac_builder_t* b)
+{
+    if (!b) return;
+    free(b->nodes);
+    free(b->outs);
+    free(b);
+}
+
+int policy_ac_builder_add(policy_ac_builder_t* b, const char* pattern, size_t len, policy_rule_ref_t ref)
+{
+    if (!b || !pattern) return -1;
+    if (len == 0) return 0;
+
+    uint32_t cur = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)pattern[i];
+        uint32_t nxt = b_child(b, cur, c);
+        if (nxt == POLICY_AC_NONE) {
+            nxt = b_new_node(b, c);
+            if (nxt == POLICY_AC_NONE) return -1;
+            b->nodes[nxt].next_sibling = b->nodes[cur].first_child;
+            b->nodes[cur].first_child = nxt;
+        }
+        cur = nxt;
+    }
+
+    if (grow((void**)&b->outs, &b->out_cap, sizeof(b_out_t), b->out_count + 1) != 0) return -1;
+
+    uint32_t o = b->out_count++;
+    b->outs[o].ref = ref;
+    b->outs[o].next = b->nodes[cur].out_head;
+    b->nodes[cur].out_head = o;
+    b->nodes[cur].out_count++;
+    return 0;
+}
+
+// BFS로 fail / dict 링크 계산
+static int b_link(policy_ac_builder_t* b)
+{
+    uint32_t* queue = (uint32_t*)malloc((size_t)b->node_count * sizeof(uint32_t));
+    if (!queue) return -1;
+
+    uint32_t qh = 0, qt = 0;
+    for (uint32_t c = b->nodes[0].first_child; c != POLICY_AC_NONE; c = b->nodes[c].next_sibling) {
+        b->nodes[c].fail = 0;
+        b->nodes[c].dict = POLICY_AC_NONE;
+        queue[qt++] = c;
+    }
+
+    while (qh < qt) {
+        uint32_t u = queue[qh++];
+
+        for (uint32_t v = b->nodes[u].first_child; v != POLICY_AC_NONE; v = b->nodes[v].next_sibling) {
+            uint8_t c = b->nodes[v].byte;
+            uint32_t f = b->nodes[u].fail;
+            uint32_t t;
+
+            while ((t = b_child(b, f, c)) == POLICY_AC_NONE && f != 0) f = b->nodes[f].fail;
+            if (t == POLICY_AC_NONE || t == v) t = 0;
+
+            b->nodes[v].fail = t;
+            b->nodes[v].dict = (b->nodes[t].out_count > 0) ? t : b->nodes[t].dict;
+            queue[qt++] = v;
+        }
+    }
+
+    free(queue);
+    return 0;
+}
+
+static int cmp_edge(const void* a, const void* b)
+{
+    const policy_ac_edge_t* x = (const policy_ac_edge_t*)a;
+    const policy_ac_edge_t* y = (const policy_ac_edge_t*)b;
+    return (int)x->byte - (int)y->byte;
+}
+
+int policy_ac_builder_finish(policy_ac_builder_t* b, policy_ac_t* out)
+{
+    if (!out) {
+        policy_ac_builder_free(b);
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!b) return -1;
+
+    if (b_link(b) != 0) {
+        policy_ac_builder_free(b);
+        return -1;
+    }
+
+    out->node_count = b->node_count;
+    out->edge_count = b->node_count - 1;   // 루트 제외 모든 노드는 부모 간선 1개
+    out->ref_count = b->out_count;
+    out->owns_memory = 1;
+
+    out->nodes = (policy_ac_node_t*)calloc(out->node_count, sizeof(policy_ac_node_t));
+    out->edges = (policy_ac_edge_t*)calloc(out->edge_count ? out->edge_count : 1, sizeof(policy_ac_edge_t));
+    out->refs = (policy_rule_ref_t*)calloc(out->ref_count ? out->ref_count : 1, sizeof(policy_rule_ref_t));
+    if (!out->nodes || !out->edges || !out->refs) {
+        policy_ac_free(out);
+        policy_ac_builder_free(b);
+        return -1;
+    }
+
+    uint32_t e = 0, r = 0;
+    for (uint32_t i = 0; i < b->node_count; i++) {
+        const b_node_t* bn = &b->nodes[i];
+        policy_ac_node_t* n = &out->nodes[i];
+
+        n->fail = bn->fail;
+        n->dict = bn->dict;
+
+        n->edge_start = e;
+        for (uint32_t c = bn->first_child; c != POLICY_AC_NONE; c = b->nodes[c].next_sibling) {
+            out->edges[e].byte = b->nodes[c].byte;
+            out->edges[e].target = c;
+            e++;
+        }
+        n->edge_count = e - n->edge_start;
+        qsort(&out->edges[n->edge_start], n->edge_count, sizeof(policy_ac_edge_t), cmp_edge);
+
+        n->out_start = r;
+        for (uint32_t o = bn->out_head; o != POLICY_AC_NONE; o = b->outs[o].next) {
+            out->refs[r++] = b->outs[o].ref;
+        }
+        n->out_count = r - n->out_start;
+    }
+
+    for (int c = 0; c < 256; c++) out->root_next[c] = POLICY_AC_NONE;
+    for (uint32_t k = 0; k < out->nodes[0].edge_count; k++) {
+        const policy_ac_edge_t* ed = &out->edges[out->nodes[0].edge_start + k];
+        out->root_next[ed->byte] = ed->target;
+    }
+
+    policy_ac_builder_free(b);
+    return 0;
+}
+
+void policy_ac_free(policy_ac_t* ac)
+{
+    if (!ac) return;
+    if (ac->owns_memory) {
+        free(ac->nodes);
+        free(ac->edges);
+        free(ac->refs);
+    }
+    memset(ac, 0, sizeof(*ac));
+}
+
+/* ---------- 탐색 ---------- */
+
+static uint32_t ac_goto(const policy_ac_t* ac, uint32_t node, uint8_t c)
+{
+    if (node == 0) return ac->root_next[c];
+
+    const policy_ac_node_t* n = &ac->nodes[node];
+    const policy_ac_edge_t* e = &ac->edges[n->edge_start];
+    uint32_t lo = 0, hi = n->edge_count;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (e[mid].byte == c) return e[mid].target;
+        if (e[mid].byte < c) lo = mid + 1;
+        else hi = mid;
+    }
+    return POLICY_AC_NONE;
+}
+
+void policy_ac_scan(const policy_ac_t* ac, const char* text, policy_ref_hit_fn fn, void* ctx)
+{
+    if (!ac || !ac->nodes || ac->ref_count == 0 || !text || !fn) return;
+
+    uint32_t cur = 0;
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        uint32_t nxt;
+        while ((nxt = ac_goto(ac, cur, *p)) == POLICY_AC_NONE && cur != 0) {
+            cur = ac->nodes[cur].fail;
+        }
+        cur = (nxt == POLICY_AC_NONE) ? 0 : nxt;
+
+        uint32_t o = (ac->nodes[cur].out_count > 0) ? cur : ac->nodes[cur].dict;
+        while (o != POLICY_AC_NONE) {
+            const policy_ac_node_t* on = &ac->nodes[o];
+            for (uint32_t k = 0; k < on->out_count; k++) {
+                fn(&ac->refs[on->out_start + k], ctx);
+            }
+            o = on->dict;
+        }
+    }
+}
@@ -0,0 +1,347 @@
+// src/policy_host_index.c
+#include "policy_host_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_NONE POLICY_AC_NONE
+
+static uint64_t key_hash(uint32_t parent, const char* key, size_t len)
+{
+    uint64_t h = 1469598103934665603ull;   // FNV-1a 64
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)key[i];
+        h *= 1099511628211ull;
+    }
+    return h ^ ((uint64_t)parent * 0x9E3779B97F4A7C15ull);
+}
+
+/* ---------- 빌더 ---------- */
+
+typedef struct {
+    policy_rule_ref_t ref;
+    uint32_t          next;
+} b_out_t;
+
+struct policy_host_builder {
+    policy_host_entry_t* entries;
+    uint32_t             entry_count;
+    uint32_t             entry_cap;
+
+    uint32_t*            out_head;     // 노드 id별 b_out_t 연결 리스트 (entry_cap + 1)
+    uint32_t*            out_count;
+
+    char*                keys;
+    uint32_t             keys_len;
+    uint32_t             keys_cap;
+
+    uint32_t*            buckets;
+    uint32_t             bucket_count;
+
+    b_out_t*             outs;
+    uint32_t             outs_count;
+    uint32_t             outs_cap;
+};
+
+static int grow(void** arr, uint32_t* cap, size_t elem, uint32_t need)
+{
+    if (need <= *cap) return 0;
+
+    uint32_t ncap = *cap ? *cap : 64;
+    while (ncap < need) ncap *= 2;
+
+    void* p = realloc(*arr, (size_t)ncap * elem);
+    if (!p) return -1;
+
+    *arr = p;
+    *cap = ncap;
+    return 0;
+}
+
+// 버킷 재구성 (entry 수가 버킷 수를 넘으면 2배)
+static int b_rehash(policy_host_builder_t* b, uint32_t nbuckets)
+{
+    uint32_t* nb = (uint32_t*)malloc((size_t)nbuckets * sizeof(uint32_t));
+    if (!nb) return -1;
+
+    for (uint32_t i = 0; i < nbuckets; i++) nb[i] = HOST_NONE;
+    for (uint32_t e = 0; e < b->entry_count; e++) {
+        uint32_t slot = (uint32_t)(b->entries[e].hash & (nbuckets - 1));
+        b->entries[e].next = nb[slot];
+        nb[slot] = e;
+    }
+
+    free(b->buckets);
+    b->buckets = nb;
+    b->bucket_count = nbuckets;
+    return 0;
+}
+
+static uint32_t find_entry(const policy_host_entry_t* entries, const uint32_t* buckets, uint32_t bucket_count,
+                           const char* keys, uint32_t parent, const char* key, size_t len)
+{
+    if (bucket_count == 0) return HOST_NONE;
+
+    uint64_t h = key_hash(parent, key, len);
+    for (uint32_t e = buckets[h & (bucket_count - 1)]; e != HOST_NONE; e = entries[e].next) {
+        const policy_host_entry_t* en = &entries[e];
+        if (en->hash == h && en->parent == parent && en->key_len == len &&
+            memcmp(keys + en->key_off, key, len) == 0) {
+            return e;
+        }
+    }
+    return HOST_NONE;
+}
+
+// (parent, key) 노드 id 반환, 없으면 생성
+static uint32_t b_intern(policy_host_builder_t* b, uint32_t parent, const char* key, size_t len)
+{
+    uint32_t e = find_entry(b->entries, b->buckets, b->bucket_count, b->keys, parent, key, len);
+    if (e != HOST_NONE) return e + 1;
+
+    if (len > UINT32_MAX - b->keys_len) return HOST_NONE;
+
+    uint32_t old_cap = b->entry_cap;
+    if (grow((void**)&b->entries, &b->entry_cap, sizeof(policy_host_entry_t), b->entry_count + 1) != 0)
+        return HOST_NONE;
+
+    if (b->entry_cap != old_cap) {
+        uint32_t* nh = (uint32_t*)realloc(b->out_head, ((size_t)b->entry_cap + 1) * sizeof(uint32_t));
+        if (!nh) return HOST_NONE;
+        b->out_head = nh;
+
+        uint32_t* nc = (uint32_t*)realloc(b->out_count, ((size_t)b->entry_cap + 1) * sizeof(uint32_t));
+        if (!nc) return HOST_NONE;
+        b->out_count = nc;
+
+        for (uint32_t i = old_cap + 1; i <= b->entry_cap; i++) {
+            b->out_head[i] = HOST_NONE;
+            b->out_count[i] = 0;
+        }
+    }
+
+    if (grow((void**)&b->keys, &b->keys_cap, 1, b->keys_len + (uint32_t)len + 1) != 0) return HOST_NONE;
+
+    e = b->entry_count++;
+    policy_host_entry_t* en = &b->entries[e];
+    en->hash = key_hash(parent, key, len);
+    en->parent = parent;
+    en->key_off = b->keys_len;
+    en->key_len = (uint32_t)len;
+
+    memcpy(b->keys + b->keys_len, key, len);
+    b->keys_len += (uint32_t)len;
+    b->keys[b->keys_len] = '\0';
+
+    if (b->entry_count > b->bucket_count) {
+        if (b_rehash(b, b->bucket_count ? b->bucket_count * 2 : 64) != 0) return HOST_NONE;
+    } else {
+        uint32_t slot = (uint32_t)(en->hash & (b->bucket_count - 1));
+        en->next = b->buckets[slot];
+        b->buckets[slot] = e;
+    }
+
+    return e + 1;
+}
+
+static int b_attach(policy_host_builder_t* b, uint32_t node, policy_rule_ref_t ref)
+{
+    if (grow((void**)&b->outs, &b->outs_cap, sizeof(b_out_t), b->outs_count + 1) != 0) return -1;
+
+    uint32_t o = b->outs_count++;
+    b->outs[o].ref = ref;
+    b->outs[o].next = b->out_head[node];
+    b->out_head[node] = o;
+    b->out_count[node]++;
+    return 0;
+}
+
+policy_host_builder_t* policy_host_builder_new(void)
+{
+    policy_host_builder_t* b = (policy_host_builder_t*)calloc(1, sizeof(policy_host_builder_t));
+    if (!b) return NULL;
+
+    // 루트(노드 0) 출력 슬롯
+    b->out_head = (uint32_t*)malloc(sizeof(uint32_t));
+    b->out_count = (uint32_t*)calloc(1, sizeof(uint32_t));
+    if (!b->out_head || !b->out_count) {
+        policy_host_builder_free(b);
+        return NULL;
+    }
+    b->out_head[0] = HOST_NONE;
+    return b;
+}
+
+void policy_host_builder_free(policy_host_builder_t* b)
+{
+    if (!b) return;
+    free(b->entries);
+    free(b->out_head);
+    free(b->out_count);
+    free(b->keys);
+    free(b->buckets);
+    free(b->outs);
+    free(b);
+}
+
+int policy_host_builder_add_exact(policy_host_builder_t* b, const char* key, size_t len, policy_rule_ref_t ref)
+{
+    if (!b || !key) return -1;
+
+    uint32_t node = b_intern(b, 0, key, len);
+    if (node == HOST_NONE) return -1;
+    return b_attach(b, node, ref);
+}
+
+int policy_host_builder_add_domain(policy_host_builder_t* b, const char* domain, size_t len, policy_rule_ref_t ref)
+{
+    if (!b || !domain) return -1;
+    if (len == 0) return 0;
+
+    uint32_t node = 0;
+    size_t end = len;
+    for (;;) {
+        size_t start = end;
+        while (start > 0 && domain[start - 1] != '.') start--;
+
+        node = b_intern(b, node, domain + start, end - start);
+        if (node == HOST_NONE) return -1;
+
+        if (start == 0) break;
+        end = start - 1;
+    }
+    return b_attach(b, node, ref);
+}
+
+int policy_host_builder_finish(policy_host_builder_t* b, policy_host_map_t* out)
+{
+    if (!b || !out) {
+        policy_host_builder_free(b);
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+
+    // 빈 맵도 lookup이 분기 없이 동작하도록 최소 버킷 확보
+    if (b->bucket_count == 0 && b_rehash(b, 1) != 0) {
+        policy_host_builder_free(b);
+        return -1;
+    }
+
+    uint32_t n = b->entry_count;
+    out->owns_memory = 1;
+    out->bucket_count = b->bucket_count;
+    out->entry_count = n;
+    out->keys_len = b->keys_len;
+    out->ref_count = b->outs_count;
+
+    // 버킷/entry/key는 빌더 배열을 그대로 넘겨받음
+    out->buckets = b->buckets;
+    out->entries = b->entries;
+    out->keys = b->keys;
+    b->buckets = NULL;
+    b->entries = NULL;
+    b->keys = NULL;
+
+    out->nodes = (policy_ref_range_t*)calloc((size_t)n + 1, sizeof(policy_ref_range_t));
+    out->refs = (policy_rule_ref_t*)calloc(out->ref_count ? out->ref_count : 1, sizeof(policy_rule_ref_t));
+    if (!out->nodes || !out->refs) {
+        policy_host_builder_free(b);
+        policy_host_map_free(out);
+        return -1;
+    }
+
+    uint32_t r = 0;
+    for (uint32_t node = 0; node <= n; node++) {
+        out->nodes[node].start = r;
+        for (uint32_t o = b->out_head[node]; o != HOST_NONE; o = b->outs[o].next) {
+            out->refs[r++] = b->outs[o].ref;
+        }
+        out->nodes[node].count = r - out->nodes[node].start;
+    }
+
+    policy_host_builder_free(b);
+    return 0;
+}
+
+void policy_host_map_free(policy_host_map_t* m)
+{
+    if (!m) return;
+    if (m->owns_memory) {
+        free(m->buckets);
+        free(m->entries);
+        free(m->keys);
+        free(m->nodes);
+        free(m->refs);
+    }
+    memset(m, 0, sizeof(*m));
+}
+
+/* ---------- 탐색 ---------- */
+
+static uint32_t map_find(const policy_host_map_t* m, uint32_t parent, const char* key, size_t len)
+{
+    uint32_t e = find_entry(m->entries, m->buckets, m->bucket_count, m->keys, parent, key, len);
+    return (e == HOST_NONE) ? HOST_NONE : e + 1;
+}
+
+static void emit_node(const policy_host_map_t* m, uint32_t node, policy_ref_hit_fn fn, void* ctx)
+{
+    const policy_ref_range_t* rg = &m->nodes[node];
+    for (uint32_t k = 0; k < rg->count; k++) fn(&m->refs[rg->start + k], ctx);
+}
+
+void policy_host_lookup_exact(const policy_host_map_t* m, const char* key, size_t len,
+                              policy_ref_hit_fn fn, void* ctx)
+{
+    if (!m || m->ref_count == 0 || !key || !fn) return;
+
+    uint32_t node = map_find(m, 0, key, len);
+    if (node != HOST_NONE) emit_node(m, node, fn, ctx);
+}
+
+void policy_host_lookup_domain(const policy_host_map_t* m, const char* host, size_t len,
+                               policy_ref_hit_fn fn, void* ctx)
+{
+    if (!m || m->ref_count == 0 || !host || !fn || len == 0) return;
+
+    // 오른쪽 라벨부터 내려가며 경로상의 모든 노드 출력 (= 등록된 상위 도메인 전부)
+    uint32_t node = 0;
+    size_t end = len;
+    for (;;) {
+        size_t start = end;
+        while (start > 0 && host[start - 1] != '.') start--;
+
+        node = map_find(m, node, host + start, end - start);
+        if (node == HOST_NONE) return;
+
+        emit_node(m, node, fn, ctx);
+
+        if (start == 0) return;
+        end = start - 1;
+    }
+}
+
+size_t policy_host_norm_len(const char* host, size_t len)
+{
+    if (!host) return 0;
+
+    size_t n = len;
+
+    if (n > 0 && host[0] == '[') {
+        // IPv6 리터럴: "]" 뒤는 포트
+        const char* close = (const char*)memchr(host, ']', n);
+        if (close) n = (size_t)(close - host) + 1;
+    } else {
+        // ':'가 정확히 1개이고 뒤가 숫자(또는 빈 값)일 때만 포트로 간주
+        const char* colon = (const char*)memchr(host, ':', n);
+        if (colon && !memchr(colon + 1, ':', n - (size_t)(colon - host) - 1)) {
+            size_t pos = (size_t)(colon - host);
+            size_t i = pos + 1;
+            while (i < n && host[i] >= '0' && host[i] <= '9') i++;
+            if (i == n) n = pos;
+        }
+    }
+
+    if (n > 0 && host[n - 1] == '.') n--;
+    return n;
+}
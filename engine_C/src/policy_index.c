@@ -0,0 +1,464 @@
+// src/policy_index.c
+#include "policy_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int target_of(const policy_rule_t* r)
+{
+    if (r->rule_type == RT_HOST) return RT_HOST;
+    if (r->rule_type == RT_PATH) return RT_PATH;
+    return RT_URL;
+}
+
+typedef enum {
+    IDX_NONE = 0,
+    IDX_CONTAINS,   // Aho-Corasick
+    IDX_PREFIX,     // 압축 radix tree
+    IDX_EXACT,      // 해시 테이블
+    IDX_DOMAIN      // 역순 라벨 트라이
+} index_kind_t;
+
+// 부정 룰은 "불일치 시 매칭"이라 인덱스 hit로 표현할 수 없으므로 항상 선형 평가
+static index_kind_t index_kind_of(const policy_rule_t* r)
+{
+    if (!r->is_enabled || r->is_negated) return IDX_NONE;
+
+    switch (r->match_type) {
+        case MT_CONTAINS:
+            return r->pattern_len > 0 ? IDX_CONTAINS : IDX_NONE;
+        case MT_PREFIX:
+            return IDX_PREFIX;
+        case MT_EXACT:
+            return IDX_EXACT;
+        case MT_DOMAIN:
+            return (r->rule_type == RT_HOST && r->pattern_len > 0) ? IDX_DOMAIN : IDX_NONE;
+        default:
+            return IDX_NONE;
+    }
+}
+
+/*
+ * 인덱스 구획: 종류 x target x case_sensitive 별 자료구조 1개 (+ domain 1개)
+ * 델타 재생성은 바뀐 룰이 속한 구획만 다시 만들고 나머지는 위치만 옮겨 복사
+ */
+#define PART_CONTAINS  0
+#define PART_PREFIX    (PART_CONTAINS + POLICY_INDEX_TARGETS * 2)
+#define PART_EXACT     (PART_PREFIX + POLICY_INDEX_TARGETS * 2)
+#define PART_DOMAIN    (PART_EXACT + POLICY_INDEX_TARGETS * 2)
+#define PART_COUNT     (PART_DOMAIN + 1)
+
+// 룰이 들어가는 구획 (인덱스 대상이 아니면 -1)
+static int part_of(const policy_rule_t* r)
+{
+    int tc = target_of(r) * 2 + (r->is_case_sensitive ? 1 : 0);
+
+    switch (index_kind_of(r)) {
+        case IDX_CONTAINS: return PART_CONTAINS + tc;
+        case IDX_PREFIX:   return PART_PREFIX + tc;
+        case IDX_EXACT:    return PART_EXACT + tc;
+        case IDX_DOMAIN:   return PART_DOMAIN;
+        default:           return -1;
+    }
+}
+
+void policy_index_free(policy_index_t* idx)
+{
+    if (!idx) return;
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            policy_ac_free(&idx->contains[t][cs]);
+            policy_radix_free(&idx->prefix[t][cs]);
+            policy_host_map_free(&idx->exact[t][cs]);
+        }
+    }
+    policy_host_map_free(&idx->domain);
+
+    free(idx->residual_policies);
+    memset(idx, 0, sizeof(*idx));
+}
+
+// need: 만들 구획 (NULL이면 전부), 나머지 구획의 룰은 건너뜀
+static int build_contains(policy_index_t* idx, const policy_cache_t* cache, const unsigned char* need)
+{
+    policy_ac_builder_t* b[POLICY_INDEX_TARGETS][2];
+    memset(b, 0, sizeof(b));
+
+    int rc = 0;
+    for (int t = 0; t < POLICY_INDEX_TARGETS && rc == 0; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (need && !need[PART_CONTAINS + t * 2 + cs]) continue;
+            b[t][cs] = policy_ac_builder_new();
+            if (!b[t][cs]) rc = -1;
+        }
+    }
+
+    for (size_t i = 0; i < cache->policy_count && rc == 0; i++) {
+        const policy_t* pol = &cache->policies[i];
+        if (!pol->is_enabled) continue;
+
+        for (size_t k = 0; k < pol->rule_count && rc == 0; k++) {
+            const policy_rule_t* r = &pol->rules[k];
+            if (index_kind_of(r) != IDX_CONTAINS) continue;
+
+            int cs = r->is_case_sensitive ? 1 : 0;
+            if (!b[target_of(r)][cs]) continue;
+
+            policy_rule_ref_t ref;
+            ref.policy_idx = (uint32_t)i;
+            ref.rule_idx = (uint32_t)k;
+
+            const char* pat = cs ? r->pattern : r->pattern_lc;
+            rc = policy_ac_builder_add(b[target_of(r)][cs], pat, r->pattern_len, ref);
+        }
+    }
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (!b[t][cs]) continue;
+            if (rc == 0) rc = policy_ac_builder_finish(b[t][cs], &idx->contains[t][cs]);
+            else policy_ac_builder_free(b[t][cs]);
+        }
+    }
+    return rc;
+}
+
+static int build_prefix(policy_index_t* idx, const policy_cache_t* cache, const unsigned char* need)
+{
+    policy_radix_builder_t* b[POLICY_INDEX_TARGETS][2];
+    memset(b, 0, sizeof(b));
+
+    int rc = 0;
+    for (int t = 0; t < POLICY_INDEX_TARGETS && rc == 0; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (need && !need[PART_PREFIX + t * 2 + cs]) continue;
+            b[t][cs] = policy_radix_builder_new();
+            if (!b[t][cs]) rc = -1;
+        }
+    }
+
+    for (size_t i = 0; i < cache->policy_count && rc == 0; i++) {
+        const policy_t* pol = &cache->policies[i];
+        if (!pol->is_enabled) continue;
+
+        for (size_t k = 0; k < pol->rule_count && rc == 0; k++) {
+            const policy_rule_t* r = &pol->rules[k];
+            if (index_kind_of(r) != IDX_PREFIX) continue;
+
+            int cs = r->is_case_sensitive ? 1 : 0;
+            if (!b[target_of(r)][cs]) continue;
+
+            policy_rule_ref_t ref;
+            ref.policy_idx = (uint32_t)i;
+            ref.rule_idx = (uint32_t)k;
+
+            const char* pat = cs ? r->pattern : r->pattern_lc;
+            rc = policy_radix_builder_add(b[target_of(r)][cs], pat, r->pattern_len, ref);
+        }
+    }
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (!b[t][cs]) continue;
+            if (rc == 0) rc = policy_radix_builder_finish(b[t][cs], &idx->prefix[t][cs]);
+            else policy_radix_builder_free(b[t][cs]);
+        }
+    }
+    return rc;
+}
+
+static int build_host_maps(policy_index_t* idx, const policy_cache_t* cache, const unsigned char* need)
+{
+    policy_host_builder_t* ex[POLICY_INDEX_TARGETS][2];
+    policy_host_builder_t* dom = NULL;
+    memset(ex, 0, sizeof(ex));
+
+    int rc = 0;
+    for (int t = 0; t < POLICY_INDEX_TARGETS && rc == 0; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (need && !need[PART_EXACT + t * 2 + cs]) continue;
+            ex[t][cs] = policy_host_builder_new();
+            if (!ex[t][cs]) rc = -1;
+        }
+    }
+    if (rc == 0 && (!need || need[PART_DOMAIN])) {
+        dom = policy_host_builder_new();
+        if (!dom) rc = -1;
+    }
+
+    for (size_t i = 0; i < cache->policy_count && rc == 0; i++) {
+        const policy_t* pol = &cache->policies[i];
+        if (!pol->is_enabled) continue;
+
+        for (size_t k = 0; k < pol->rule_count && rc == 0; k++) {
+            const policy_rule_t* r = &pol->rules[k];
+            index_kind_t kind = index_kind_of(r);
+
+            policy_rule_ref_t ref;
+            ref.policy_idx = (uint32_t)i;
+            ref.rule_idx = (uint32_t)k;
+
+            if (kind == IDX_EXACT) {
+                int cs = r->is_case_sensitive ? 1 : 0;
+                if (!ex[target_of(r)][cs]) continue;
+                const char* pat = cs ? r->pattern : r->pattern_lc;
+                rc = policy_host_builder_add_exact(ex[target_of(r)][cs], pat, r->pattern_len, ref);
+            } else if (kind == IDX_DOMAIN && dom) {
+                // 도메인은 대소문자 구분 없음 (pattern_lc는 컴파일 시 정규화됨)
+                rc = policy_host_builder_add_domain(dom, r->pattern_lc, r->pattern_len, ref);
+            }
+        }
+    }
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (!ex[t][cs]) continue;
+            if (rc == 0) rc = policy_host_builder_finish(ex[t][cs], &idx->exact[t][cs]);
+            else policy_host_builder_free(ex[t][cs]);
+        }
+    }
+    if (dom) {
+        if (rc == 0) rc = policy_host_builder_finish(dom, &idx->domain);
+        else policy_host_builder_free(dom);
+    }
+    return rc;
+}
+
+static void mark_indexed_rules(policy_index_t* idx, policy_cache_t* cache)
+{
+    idx->indexed_rule_count = 0;
+
+    for (size_t i = 0; i < cache->policy_count; i++) {
+        policy_t* pol = &cache->policies[i];
+        for (size_t k = 0; k < pol->rule_count; k++) {
+            policy_rule_t* r = &pol->rules[k];
+            // 룰 배열은 스냅샷 간 공유될 수 있음: 값은 룰 자체로 결정되므로 바뀔 때만 기록
+            int v = (index_kind_of(r) != IDX_NONE);
+            if (r->is_indexed != v) r->is_indexed = v;
+            if (v) idx->indexed_rule_count++;
+        }
+    }
+}
+
+static int build_residual(policy_index_t* idx, const policy_cache_t* cache)
+{
+    idx->residual_policies = (uint32_t*)calloc(cache->policy_count ? cache->policy_count : 1, sizeof(uint32_t));
+    if (!idx->residual_policies) return -1;
+
+    idx->residual_count = 0;
+    for (size_t i = 0; i < cache->policy_count; i++) {
+        const policy_t* pol = &cache->policies[i];
+        if (!pol->is_enabled) continue;
+
+        for (size_t k = 0; k < pol->rule_count; k++) {
+            if (pol->rules[k].is_enabled && !pol->rules[k].is_indexed) {
+                idx->residual_policies[idx->residual_count++] = (uint32_t)i;
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+int policy_index_build(policy_index_t* idx, policy_cache_t* cache)
+{
+    if (!idx || !cache) return -1;
+    memset(idx, 0, sizeof(*idx));
+
+    if (build_contains(idx, cache, NULL) != 0 ||
+        build_prefix(idx, cache, NULL) != 0 ||
+        build_host_maps(idx, cache, NULL) != 0) {
+        policy_index_free(idx);
+        return -1;
+    }
+
+    mark_indexed_rules(idx, cache);
+
+    // 실패 시 cache->index가 NULL로 남아 선형 평가 (is_indexed는 인덱스 경로에서만 참조)
+    if (build_residual(idx, cache) != 0) {
+        policy_index_free(idx);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* ---------- 델타 재생성 ---------- */
+
+static void* dup_array(const void* src, size_t n, size_t elem)
+{
+    if (!src) return NULL;
+    void* p = malloc(n ? n * elem : 1);
+    if (p && n) memcpy(p, src, n * elem);
+    return p;
+}
+
+// 구획의 룰 참조 policy 위치를 새 위치로 (remap에 없는 위치가 있으면 -1: 재생성 대상)
+static int refs_remap(policy_rule_ref_t* refs, uint32_t n, const uint32_t* remap, size_t base_count)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t p = refs[i].policy_idx;
+        if (p >= base_count || remap[p] == UINT32_MAX) return -1;
+        refs[i].policy_idx = remap[p];
+    }
+    return 0;
+}
+
+static int refs_removed(const policy_rule_ref_t* refs, uint32_t n, const uint32_t* remap, size_t base_count)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t p = refs[i].policy_idx;
+        if (p >= base_count || remap[p] == UINT32_MAX) return 1;
+    }
+    return 0;
+}
+
+static int ac_copy(policy_ac_t* dst, const policy_ac_t* src, const uint32_t* remap, size_t base_count)
+{
+    *dst = *src;
+    dst->nodes = (policy_ac_node_t*)dup_array(src->nodes, src->node_count, sizeof(*src->nodes));
+    dst->edges = (policy_ac_edge_t*)dup_array(src->edges, src->edge_count, sizeof(*src->edges));
+    dst->refs = (policy_rule_ref_t*)dup_array(src->refs, src->ref_count, sizeof(*src->refs));
+    dst->owns_memory = 1;
+    if ((src->nodes && !dst->nodes) || (src->edges && !dst->edges) || (src->refs && !dst->refs)) return -1;
+    return dst->refs ? refs_remap(dst->refs, dst->ref_count, remap, base_count) : 0;
+}
+
+static int radix_copy(policy_radix_t* dst, const policy_radix_t* src, const uint32_t* remap, size_t base_count)
+{
+    *dst = *src;
+    dst->nodes = (policy_radix_node_t*)dup_array(src->nodes, src->node_count, sizeof(*src->nodes));
+    dst->labels = (char*)dup_array(src->labels, src->labels_len, 1);
+    dst->refs = (policy_rule_ref_t*)dup_array(src->refs, src->ref_count, sizeof(*src->refs));
+    dst->owns_memory = 1;
+    if ((src->nodes && !dst->nodes) || (src->labels && !dst->labels) || (src->refs && !dst->refs)) return -1;
+    return dst->refs ? refs_remap(dst->refs, dst->ref_count, remap, base_count) : 0;
+}
+
+static int host_copy(policy_host_map_t* dst, const policy_host_map_t* src, const uint32_t* remap, size_t base_count)
+{
+    *dst = *src;
+    dst->buckets = (uint32_t*)dup_array(src->buckets, src->bucket_count, sizeof(*src->buckets));
+    dst->entries = (policy_host_entry_t*)dup_array(src->entries, src->entry_count, sizeof(*src->entries));
+    dst->keys = (char*)dup_array(src->keys, src->keys_len, 1);
+    dst->nodes = (policy_ref_range_t*)dup_array(src->nodes, (size_t)src->entry_count + 1, sizeof(*src->nodes));
+    dst->refs = (policy_rule_ref_t*)dup_array(src->refs, src->ref_count, sizeof(*src->refs));
+    dst->owns_memory = 1;
+    if ((src->buckets && !dst->buckets) || (src->entries && !dst->entries) || (src->keys && !dst->keys) ||
+        (src->nodes && !dst->nodes) || (src->refs && !dst->refs)) {
+        return -1;
+    }
+    return dst->refs ? refs_remap(dst->refs, dst->ref_count, remap, base_count) : 0;
+}
+
+int policy_index_build_delta(policy_index_t* idx, policy_cache_t* cache,
+                             const policy_index_t* base, size_t base_count,
+                             const uint32_t* remap, const unsigned char* fresh,
+                             size_t* rebuilt_parts)
+{
+    if (!idx || !cache || !base || !remap || !fresh) return -1;
+    memset(idx, 0, sizeof(*idx));
+
+    // 재생성 구획: 새로 들어온 policy의 룰이 속한 구획 + 빠진 policy를 참조하던 구획
+    unsigned char need[PART_COUNT];
+    memset(need, 0, sizeof(need));
+
+    for (size_t i = 0; i < cache->policy_count; i++) {
+        const policy_t* pol = &cache->policies[i];
+        if (!fresh[i] || !pol->is_enabled) continue;
+        for (size_t k = 0; k < pol->rule_count; k++) {
+            int part = part_of(&pol->rules[k]);
+            if (part >= 0) need[part] = 1;
+        }
+    }
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            int tc = t * 2 + cs;
+            if (refs_removed(base->contains[t][cs].refs, base->contains[t][cs].ref_count, remap, base_count))
+                need[PART_CONTAINS + tc] = 1;
+            if (refs_removed(base->prefix[t][cs].refs, base->prefix[t][cs].ref_count, remap, base_count))
+                need[PART_PREFIX + tc] = 1;
+            if (refs_removed(base->exact[t][cs].refs, base->exact[t][cs].ref_count, remap, base_count))
+                need[PART_EXACT + tc] = 1;
+        }
+    }
+    if (refs_removed(base->domain.refs, base->domain.ref_count, remap, base_count)) need[PART_DOMAIN] = 1;
+
+    int rc = 0;
+    size_t rebuilt = 0;
+    for (int t = 0; t < POLICY_INDEX_TARGETS && rc == 0; t++) {
+        for (int cs = 0; cs < 2 && rc == 0; cs++) {
+            int tc = t * 2 + cs;
+            if (!need[PART_CONTAINS + tc])
+                rc = ac_copy(&idx->contains[t][cs], &base->contains[t][cs], remap, base_count);
+            if (rc == 0 && !need[PART_PREFIX + tc])
+                rc = radix_copy(&idx->prefix[t][cs], &base->prefix[t][cs], remap, base_count);
+            if (rc == 0 && !need[PART_EXACT + tc])
+                rc = host_copy(&idx->exact[t][cs], &base->exact[t][cs], remap, base_count);
+        }
+    }
+    if (rc == 0 && !need[PART_DOMAIN]) rc = host_copy(&idx->domain, &base->domain, remap, base_count);
+    for (int part = 0; part < PART_COUNT; part++) rebuilt += need[part];
+
+    if (rc != 0 ||
+        build_contains(idx, cache, need) != 0 ||
+        build_prefix(idx, cache, need) != 0 ||
+        build_host_maps(idx, cache, need) != 0) {
+        policy_index_free(idx);
+        return -1;
+    }
+
+    mark_indexed_rules(idx, cache);
+
+    if (build_residual(idx, cache) != 0) {
+        policy_index_free(idx);
+        return -1;
+    }
+
+    if (rebuilt_parts) *rebuilt_parts = rebuilt;
+    return 0;
+}
+
+typedef struct {
+    uint32_t best;
+} best_ctx_t;
+
+static void on_hit(const policy_rule_ref_t* ref, void* ctx)
+{
+    best_ctx_t* bc = (best_ctx_t*)ctx;
+    if (ref->policy_idx < bc->best) bc->best = ref->policy_idx;
+}
+
+uint32_t policy_index_best(const policy_index_t* idx,
+                           const char* const raw[POLICY_INDEX_TARGETS],
+                           const char* const lc[POLICY_INDEX_TARGETS],
+                           size_t host_len)
+{
+    best_ctx_t bc;
+    bc.best = UINT32_MAX;
+
+    if (!idx) return bc.best;
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        policy_ac_scan(&idx->contains[t][0], lc[t], on_hit, &bc);
+        policy_ac_scan(&idx->contains[t][1], raw[t], on_hit, &bc);
+
+        policy_radix_scan(&idx->prefix[t][0], lc[t], on_hit, &bc);
+        policy_radix_scan(&idx->prefix[t][1], raw[t], on_hit, &bc);
+
+        size_t len = strlen(raw[t]);
+        policy_host_lookup_exact(&idx->exact[t][0], lc[t], len, on_hit, &bc);
+        policy_host_lookup_exact(&idx->exact[t][1], raw[t], len, on_hit, &bc);
+
+        // host는 포트/끝 점을 뗀 형태로도 비교 ("example.com:8080" == "example.com")
+        if (t == RT_HOST && host_len < len) {
+            policy_host_lookup_exact(&idx->exact[t][0], lc[t], host_len, on_hit, &bc);
+            policy_host_lookup_exact(&idx->exact[t][1], raw[t], host_len, on_hit, &bc);
+        }
+    }
+
+    policy_host_lookup_domain(&idx->domain, lc[RT_HOST], host_len, on_hit, &bc);
+    return bc.best;
+}
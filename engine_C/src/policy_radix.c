@@ -0,0 +1,224 @@
+// src/policy_radix.c
+#include "policy_radix.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ---------- 빌더 ---------- */
+
+typedef struct {
+    const char*       s;     // finish 시점에 pool + off 로 설정
+    uint32_t          off;
+    uint32_t          len;
+    policy_rule_ref_t ref;
+} b_entry_t;
+
+struct policy_radix_builder {
+    b_entry_t* entries;
+    uint32_t   entry_count;
+    uint32_t   entry_cap;
+
+    char*      pool;
+    uint32_t   pool_len;
+    uint32_t   pool_cap;
+};
+
+static int grow(void** arr, uint32_t* cap, size_t elem, uint32_t need)
+{
+    if (need <= *cap) return 0;
+
+    uint32_t ncap = *cap ? *cap : 64;
+    while (ncap < need) ncap *= 2;
+
+    void* p = realloc(*arr, (size_t)ncap * elem);
+    if (!p) return -1;
+
+    *arr = p;
+    *cap = ncap;
+    return 0;
+}
+
+policy_radix_builder_t* policy_radix_builder_new(void)
+{
+    return (policy_radix_builder_t*)calloc(1, sizeof(policy_radix_builder_t));
+}
+
+void policy_radix_builder_free(policy_radix_builder_t* b)
+{
+    if (!b) return;
+    free(b->entries);
+    free(b->pool);
+    free(b);
+}
+
+int policy_radix_builder_add(policy_radix_builder_t* b, const char* pattern, size_t len, policy_rule_ref_t ref)
+{
+    if (!b || !pattern) return -1;
+    if (len > UINT32_MAX - b->pool_len - 1) return -1;
+
+    if (grow((void**)&b->entries, &b->entry_cap, sizeof(b_entry_t), b->entry_count + 1) != 0) return -1;
+    if (grow((void**)&b->pool, &b->pool_cap, 1, b->pool_len + (uint32_t)len + 1) != 0) return -1;
+
+    b_entry_t* e = &b->entries[b->entry_count++];
+    e->s = NULL;
+    e->off = b->pool_len;
+    e->len = (uint32_t)len;
+    e->ref = ref;
+
+    memcpy(b->pool + b->pool_len, pattern, len);
+    b->pool_len += (uint32_t)len;
+    b->pool[b->pool_len++] = '\0';
+    return 0;
+}
+
+// 사전순, 같은 패턴은 policy 우선순위 순
+static int cmp_entry(const void* a, const void* b)
+{
+    const b_entry_t* x = (const b_entry_t*)a;
+    const b_entry_t* y = (const b_entry_t*)b;
+
+    uint32_t n = x->len < y->len ? x->len : y->len;
+    int c = memcmp(x->s, y->s, n);
+    if (c != 0) return c;
+    if (x->len != y->len) return x->len < y->len ? -1 : 1;
+    if (x->ref.policy_idx != y->ref.policy_idx) return x->ref.policy_idx < y->ref.policy_idx ? -1 : 1;
+    return (x->ref.rule_idx < y->ref.rule_idx) ? -1 : (x->ref.rule_idx > y->ref.rule_idx);
+}
+
+/*
+ * [lo, hi) 는 앞 depth byte가 같은 정렬 구간
+ * - len == depth 인 패턴(구간 맨 앞)이 이 노드의 출력
+ * - 나머지는 depth 위치 byte로 묶어 자식 1개씩, 자식 label은 묶음 첫/끝 패턴의 공통 prefix
+ *   (정렬 구간의 공통 prefix = 첫 원소와 끝 원소의 공통 prefix)
+ */
+static void build_node(const policy_radix_builder_t* b, policy_radix_t* rt,
+                       uint32_t node, uint32_t lo, uint32_t hi, uint32_t depth)
+{
+    const b_entry_t* e = b->entries;
+
+    uint32_t i = lo;
+    while (i < hi && e[i].len == depth) i++;
+
+    rt->nodes[node].out_start = lo;
+    rt->nodes[node].out_count = i - lo;
+
+    uint32_t groups = 0;
+    for (uint32_t j = i; j < hi; ) {
+        uint8_t c = (uint8_t)e[j].s[depth];
+        while (j < hi && (uint8_t)e[j].s[depth] == c) j++;
+        groups++;
+    }
+
+    rt->nodes[node].child_start = rt->node_count;
+    rt->nodes[node].child_count = groups;
+    rt->node_count += groups;
+
+    uint32_t child = rt->nodes[node].child_start;
+    for (uint32_t j = i; j < hi; child++) {
+        uint8_t c = (uint8_t)e[j].s[depth];
+        uint32_t k = j;
+        while (k < hi && (uint8_t)e[k].s[depth] == c) k++;
+
+        const b_entry_t* first = &e[j];
+        const b_entry_t* last = &e[k - 1];
+        uint32_t end = depth + 1;
+        uint32_t lim = first->len < last->len ? first->len : last->len;
+        while (end < lim && first->s[end] == last->s[end]) end++;
+
+        rt->nodes[child].label_off = first->off + depth;
+        rt->nodes[child].label_len = end - depth;
+
+        build_node(b, rt, child, j, k, end);
+        j = k;
+    }
+}
+
+int policy_radix_builder_finish(policy_radix_builder_t* b, policy_radix_t* out)
+{
+    if (!b || !out) {
+        policy_radix_builder_free(b);
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+
+    uint32_t n = b->entry_count;
+    for (uint32_t i = 0; i < n; i++) b->entries[i].s = b->pool + b->entries[i].off;
+    if (n > 1) qsort(b->entries, n, sizeof(b_entry_t), cmp_entry);
+
+    out->owns_memory = 1;
+    out->nodes = (policy_radix_node_t*)calloc((size_t)n * 2 + 1, sizeof(policy_radix_node_t));
+    out->refs = (policy_rule_ref_t*)calloc(n ? n : 1, sizeof(policy_rule_ref_t));
+    if (!out->nodes || !out->refs) {
+        policy_radix_builder_free(b);
+        policy_radix_free(out);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n; i++) out->refs[i] = b->entries[i].ref;
+    out->ref_count = n;
+
+    out->node_count = 1;
+    build_node(b, out, 0, 0, n, 0);
+
+    // label은 빌더 pool을 그대로 넘겨받음 (label_off는 pool 기준)
+    out->labels = b->pool;
+    out->labels_len = b->pool_len;
+    b->pool = NULL;
+
+    policy_radix_builder_free(b);
+    return 0;
+}
+
+void policy_radix_free(policy_radix_t* rt)
+{
+    if (!rt) return;
+    if (rt->owns_memory) {
+        free(rt->nodes);
+        free(rt->labels);
+        free(rt->refs);
+    }
+    memset(rt, 0, sizeof(*rt));
+}
+
+/* ---------- 탐색 ---------- */
+
+static void emit_node(const policy_radix_t* rt, const policy_radix_node_t* n, policy_ref_hit_fn fn, void* ctx)
+{
+    for (uint32_t k = 0; k < n->out_count; k++) fn(&rt->refs[n->out_start + k], ctx);
+}
+
+void policy_radix_scan(const policy_radix_t* rt, const char* text, policy_ref_hit_fn fn, void* ctx)
+{
+    if (!rt || !rt->nodes || rt->ref_count == 0 || !text || !fn) return;
+
+    const policy_radix_node_t* n = &rt->nodes[0];
+    const unsigned char* p = (const unsigned char*)text;
+
+    emit_node(rt, n, fn, ctx);
+
+    while (*p && n->child_count > 0) {
+        // 자식 label 첫 byte로 이진 탐색
+        uint32_t lo = 0, hi = n->child_count;
+        const policy_radix_node_t* next = NULL;
+
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            const policy_radix_node_t* c = &rt->nodes[n->child_start + mid];
+            uint8_t b0 = (uint8_t)rt->labels[c->label_off];
+            if (b0 == *p) { next = c; break; }
+            if (b0 < *p) lo = mid + 1;
+            else hi = mid;
+        }
+        if (!next) return;
+
+        // label 나머지 비교 (text가 먼저 끝나면 '\0'에서 불일치)
+        const unsigned char* lab = (const unsigned char*)rt->labels + next->label_off;
+        for (uint32_t k = 1; k < next->label_len; k++) {
+            if (p[k] != lab[k]) return;
+        }
+
+        p += next->label_len;
+        n = next;
+        emit_node(rt, n, fn, ctx);
+    }
+}
@@ -0,0 +1,602 @@
+// src/policy_snapshot.c
+#include "policy_snapshot.h"
+#include "policy_snapshot_file.h"
+#include "db_pool.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * epoch 기반 회수
+ * - reader: 슬롯에 현재 epoch 기록 -> 포인터 load, 끝나면 슬롯 0
+ * - writer: 포인터 교체 -> epoch 증가(E) -> 모든 슬롯이 0 또는 >= E 가 될 때까지 대기 후 해제
+ *   (E 이후에 들어온 reader는 교체 이후 포인터만 볼 수 있음)
+ * - 슬롯은 스레드 최초 acquire 시 빈 슬롯을 잡고 스레드 종료 시 반환 (policy_snapshot_thread_cleanup)
+ *   슬롯이 모자라면 공용 카운터로 대체
+ * - reader의 슬롯 기록 -> 포인터 load, writer의 포인터 교체 -> 슬롯 scan 은 모두 SEQ_CST
+ *   (둘 중 하나는 반드시 상대의 기록을 봄: reader가 이전 포인터를 봤다면 writer가 그 슬롯을 봄)
+ */
+#define SNAP_READER_SLOTS 128
+
+typedef struct {
+    uint64_t epoch;   // 0 = reader 구간 밖
+    int      used;    // 스레드가 점유 중
+} __attribute__((aligned(64))) reader_slot_t;
+
+static policy_snapshot_t* g_current = NULL;
+static uint64_t g_epoch = 1;
+static uint64_t g_generation = 0;
+
+static reader_slot_t g_slots[SNAP_READER_SLOTS];
+static unsigned int g_overflow_readers = 0;
+static __thread int t_slot = -1;   // -1: 미배정, -2: 공용 카운터 사용
+
+static policy_reload_config_t g_cfg;
+static char g_db_host[128];
+static char g_db_user[64];
+static char g_db_pass[128];
+static char g_db_name[64];
+static char g_snapshot_path[512];
+
+static pthread_mutex_t g_reload_lock = PTHREAD_MUTEX_INITIALIZER;
+static char g_loaded_version[128];   // 마지막으로 게시한 스냅샷의 버전 (g_reload_lock)
+static long long g_last_audit_id = -1;  // 반영 완료한 policy_audit 최대 id (-1: 모름 -> 전체 재로드)
+
+#define DELTA_AUDIT_ROW_LIMIT 4096
+#define RECONCILE_RETRY_SEC   5
+
+static int    g_snapshot_dirty = 0;       // 게시 후 아직 파일에 기록 안 됨 (g_reload_lock)
+static double g_snapshot_written = -1e9;  // 마지막 파일 기록 시각 (mono, g_reload_lock)
+static volatile int g_reconcile_pending = 0;  // 파일에서 시작: DB 대조 전
+
+static volatile sig_atomic_t g_reload_requested = 0;
+static volatile int g_reloader_stop = 0;
+static pthread_t g_reloader;
+static int g_reloader_started = 0;
+
+static int64_t wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static double mono_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void sleep_ms(long ms)
+{
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+/* ---------- reader ---------- */
+
+static int claim_slot(void)
+{
+    for (int i = 0; i < SNAP_READER_SLOTS; i++) {
+        int expected = 0;
+        if (__atomic_load_n(&g_slots[i].used, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&g_slots[i].used, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return i;
+        }
+    }
+    return -2;
+}
+
+const policy_snapshot_t* policy_snapshot_acquire(void)
+{
+    if (t_slot == -1) t_slot = claim_slot();
+
+    if (t_slot >= 0) {
+        uint64_t e = __atomic_load_n(&g_epoch, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&g_slots[t_slot].epoch, e, __ATOMIC_SEQ_CST);
+    } else {
+        __atomic_fetch_add(&g_overflow_readers, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return __atomic_load_n(&g_current, __ATOMIC_SEQ_CST);
+}
+
+void policy_snapshot_release(void)
+{
+    if (t_slot >= 0) {
+        __atomic_store_n(&g_slots[t_slot].epoch, 0, __ATOMIC_RELEASE);
+    } else if (t_slot == -2) {
+        __atomic_fetch_sub(&g_overflow_readers, 1, __ATOMIC_RELEASE);
+    }
+}
+
+void policy_snapshot_thread_cleanup(void)
+{
+    if (t_slot >= 0) {
+        __atomic_store_n(&g_slots[t_slot].epoch, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&g_slots[t_slot].used, 0, __ATOMIC_RELEASE);
+    }
+    t_slot = -1;
+}
+
+uint64_t policy_snapshot_generation(void)
+{
+    return __atomic_load_n(&g_generation, __ATOMIC_ACQUIRE);
+}
+
+/* ---------- writer ---------- */
+
+static void wait_readers(uint64_t target)
+{
+    for (;;) {
+        int busy = (__atomic_load_n(&g_overflow_readers, __ATOMIC_SEQ_CST) != 0);
+
+        // 빈 슬롯의 epoch는 0이므로 점유 여부와 관계없이 전체 scan
+        for (unsigned int i = 0; i < SNAP_READER_SLOTS && !busy; i++) {
+            uint64_t e = __atomic_load_n(&g_slots[i].epoch, __ATOMIC_SEQ_CST);
+            if (e != 0 && e < target) busy = 1;
+        }
+
+        if (!busy) return;
+        sleep_ms(1);
+    }
+}
+
+static void snapshot_free(policy_snapshot_t* snap)
+{
+    if (!snap) return;
+    free_policy_cache(&snap->cache);
+    free(snap);
+}
+
+// 게시 + 이전 스냅샷 회수 (g_reload_lock 보유 상태에서 호출)
+static void publish(policy_snapshot_t* snap)
+{
+    policy_snapshot_t* old = __atomic_exchange_n(&g_current, snap, __ATOMIC_SEQ_CST);
+    if (snap) __atomic_store_n(&g_generation, snap->generation, __ATOMIC_RELEASE);
+    if (!old) return;
+
+    uint64_t target = __atomic_add_fetch(&g_epoch, 1, __ATOMIC_SEQ_CST);
+    wait_readers(target);
+    snapshot_free(old);
+}
+
+/*
+ * 현재 스냅샷을 파일로 기록 (g_reload_lock 보유 상태에서 호출)
+ * - 매핑으로 시작한 스냅샷은 파일 내용 그대로라 기록 안 함
+ * - force가 아니면 snapshot_write_sec 간격 유지, 밀린 기록은 재로드 스레드 주기에서 처리
+ */
+static void persist_locked(int force)
+{
+    if (!g_snapshot_path[0] || !g_snapshot_dirty) return;
+
+    double now = mono_sec();
+    if (!force && now - g_snapshot_written < g_cfg.snapshot_write_sec) return;
+
+    policy_snapshot_t* cur = __atomic_load_n(&g_current, __ATOMIC_ACQUIRE);
+    g_snapshot_dirty = 0;
+    g_snapshot_written = now;
+    if (!cur || cur->cache.map_base || !cur->cache.index) return;
+
+    double t0 = mono_sec();
+    if (policy_snapshot_file_write(g_snapshot_path, &cur->cache, cur->generation, cur->version) == 0) {
+        fprintf(stderr, "[POLICY_RELOAD] snapshot file updated generation=%llu took=%.1fms\n",
+                (unsigned long long)cur->generation, (mono_sec() - t0) * 1000.0);
+    }
+}
+
+int policy_snapshot_db_version(MYSQL* conn, char* out, size_t outsz)
+{
+    if (!conn || !out || outsz == 0) return -1;
+    out[0] = '\0';
+
+    const char* q =
+        "SELECT (SELECT COALESCE(MAX(audit_id), 0) FROM policy_audit), "
+        "       (SELECT COALESCE(MAX(policy_id), 0) FROM policy), "
+        "       (SELECT COALESCE(MAX(rule_id), 0) FROM policy_rule)";
+
+    if (mysql_query(conn, q) != 0) {
+        fprintf(stderr, "[POLICY_RELOAD] version query failed: %s\n", mysql_error(conn));
+        return -1;
+    }
+
+    MYSQL_RES* res = mysql_store_result(conn);
+    if (!res) return -1;
+
+    MYSQL_ROW row = mysql_fetch_row(res);
+    if (row) {
+        snprintf(out, outsz, "audit=%s policy=%s rule=%s",
+                 row[0] ? row[0] : "0", row[1] ? row[1] : "0", row[2] ? row[2] : "0");
+    }
+
+    mysql_free_result(res);
+    return row ? 0 : -1;
+}
+
+static long long query_max_audit_id(MYSQL* conn)
+{
+    if (!conn || mysql_query(conn, "SELECT COALESCE(MAX(audit_id), 0) FROM policy_audit") != 0) return -1;
+
+    MYSQL_RES* res = mysql_store_result(conn);
+    if (!res) return -1;
+
+    MYSQL_ROW row = mysql_fetch_row(res);
+    long long v = (row && row[0]) ? atoll(row[0]) : -1;
+    mysql_free_result(res);
+    return v;
+}
+
+static int reload_locked(MYSQL* vconn, const char* reason)
+{
+    double t0 = mono_sec();
+    long long audit_id = query_max_audit_id(vconn);
+
+    policy_snapshot_t* snap = (policy_snapshot_t*)calloc(1, sizeof(policy_snapshot_t));
+    if (!snap) return -1;
+
+    // 버전을 먼저 읽음: 로드 도중 바뀐 변경은 다음 확인에서 다시 감지됨
+    if (vconn) (void)policy_snapshot_db_version(vconn, snap->version, sizeof(snap->version));
+
+    // 엔진은 버전 확인 연결(DB 풀)로 로드, 풀이 없을 때만 로드용 연결을 따로 엶
+    int loaded = vconn ? load_policy_cache_conn(&snap->cache, vconn)
+                       : db_pool_enabled() ? -1
+                       : load_policy_cache(&snap->cache, g_cfg.db_host, g_cfg.db_port,
+                                           g_cfg.db_user, g_cfg.db_pass, g_cfg.db_name);
+    if (loaded != 0) {
+        fprintf(stderr, "[POLICY_RELOAD] load failed (reason=%s), keeping generation=%llu\n",
+                reason, (unsigned long long)policy_snapshot_generation());
+        snapshot_free(snap);
+        return -1;
+    }
+
+    snap->generation = policy_snapshot_generation() + 1;
+    snap->loaded_at_ms = wall_ms();
+    size_t policy_count = snap->cache.policy_count;
+
+    uint64_t generation = snap->generation;
+
+    snprintf(g_loaded_version, sizeof(g_loaded_version), "%s", snap->version);
+    g_last_audit_id = audit_id;
+    g_reconcile_pending = 0;
+    publish(snap);
+
+    fprintf(stderr, "[POLICY_RELOAD] published generation=%llu policies=%zu reason=%s load=%.1fms version=\"%s\"\n",
+            (unsigned long long)generation, policy_count, reason,
+            (mono_sec() - t0) * 1000.0, g_loaded_version);
+
+    g_snapshot_dirty = 1;
+    persist_locked(0);
+    return 0;
+}
+
+static int cmp_ll(const void* a, const void* b)
+{
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * 델타 동기화: g_last_audit_id 이후 감사 기록의 policy만 다시 읽어 현재 스냅샷과 병합
+ * - 반환: 0 반영, 1 반영할 기록 없음, -1 불가(전체 재로드 필요)
+ * - DB 부하는 변경 건수에 비례 (policy_audit PK 범위 + 변경 policy IN 조회)
+ * - CPU 비용: 룰 재컴파일 없음, policy 배열 복사 + 바뀐 룰이 속한 인덱스 구획만 재생성
+ *   (나머지 구획은 복사 후 policy 위치만 옮김, 재로드 스레드에서만 수행되고 패킷 경로는 교체된 포인터만 봄)
+ * - 인덱스 생성이 실패하면 게시하지 않고 -1 (전체 재로드)
+ * - 커밋 순서가 id 순서와 달라 늦게 보이는 기록은 주기적 전체 재로드가 보정
+ */
+static int delta_locked(MYSQL* conn, const char* version)
+{
+    policy_snapshot_t* cur = __atomic_load_n(&g_current, __ATOMIC_ACQUIRE);
+    if (!conn || !cur || g_last_audit_id < 0 || g_cfg.delta_max_policies <= 0) return -1;
+
+    double t0 = mono_sec();
+
+    char q[256];
+    snprintf(q, sizeof(q),
+             "SELECT audit_id, policy_id FROM policy_audit "
+             "WHERE audit_id > %lld ORDER BY audit_id ASC LIMIT %d",
+             g_last_audit_id, DELTA_AUDIT_ROW_LIMIT);
+
+    if (mysql_query(conn, q) != 0) {
+        fprintf(stderr, "[POLICY_RELOAD] audit query failed: %s\n", mysql_error(conn));
+        return -1;
+    }
+
+    MYSQL_RES* res = mysql_store_result(conn);
+    if (!res) return -1;
+
+    size_t rows = (size_t)mysql_num_rows(res);
+    if (rows >= DELTA_AUDIT_ROW_LIMIT) {
+        mysql_free_result(res);
+        return -1;
+    }
+    if (rows == 0) {
+        mysql_free_result(res);
+        return 1;
+    }
+
+    long long* ids = (long long*)malloc(rows * sizeof(long long));
+    if (!ids) {
+        mysql_free_result(res);
+        return -1;
+    }
+
+    size_t n = 0;
+    long long max_audit = g_last_audit_id;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res)) != NULL && n < rows) {
+        long long aid = row[0] ? atoll(row[0]) : 0;
+        if (aid > max_audit) max_audit = aid;
+        ids[n++] = row[1] ? atoll(row[1]) : 0;
+    }
+    mysql_free_result(res);
+
+    qsort(ids, n, sizeof(long long), cmp_ll);
+    size_t uniq = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (uniq == 0 || ids[uniq - 1] != ids[i]) ids[uniq++] = ids[i];
+    }
+
+    if (uniq > (size_t)g_cfg.delta_max_policies) {
+        free(ids);
+        return -1;
+    }
+
+    policy_cache_t delta;
+    if (policy_cache_load_subset(conn, &delta, ids, uniq) != 0) {
+        free(ids);
+        return -1;
+    }
+
+    policy_snapshot_t* snap = (policy_snapshot_t*)calloc(1, sizeof(policy_snapshot_t));
+    if (!snap || policy_cache_merge(&snap->cache, &cur->cache, &delta, ids, uniq) != 0) {
+        free_policy_cache(&delta);
+        free(snap);
+        free(ids);
+        return -1;
+    }
+
+    int built = policy_cache_build_index_delta(&snap->cache, &cur->cache, ids, uniq);
+    free(ids);
+    if (built != 0) {
+        free_policy_cache(&snap->cache);
+        free(snap);
+        return -1;
+    }
+
+    snprintf(snap->version, sizeof(snap->version), "%s", version ? version : "");
+    snap->generation = policy_snapshot_generation() + 1;
+    snap->loaded_at_ms = wall_ms();
+    size_t policy_count = snap->cache.policy_count;
+    uint64_t generation = snap->generation;
+    long long from_audit = g_last_audit_id;
+
+    snprintf(g_loaded_version, sizeof(g_loaded_version), "%s", snap->version);
+    g_last_audit_id = max_audit;
+    publish(snap);
+
+    fprintf(stderr, "[POLICY_RELOAD] delta published generation=%llu changed_policies=%zu audit=(%lld,%lld] policies=%zu took=%.1fms\n",
+            (unsigned long long)generation, uniq, from_audit, max_audit, policy_count,
+            (mono_sec() - t0) * 1000.0);
+
+    g_snapshot_dirty = 1;
+    persist_locked(0);
+    return 0;
+}
+
+// 버전 변화 처리: 델타 우선, 불가하거나 감사 기록 없는 변화면 전체 재로드
+static int sync_with(MYSQL* vconn, const char* version)
+{
+    pthread_mutex_lock(&g_reload_lock);
+    int rc = delta_locked(vconn, version);
+    if (rc != 0) rc = reload_locked(vconn, rc > 0 ? "version" : "version_full");
+    pthread_mutex_unlock(&g_reload_lock);
+    return rc;
+}
+
+static int reload_with(MYSQL* vconn, const char* reason)
+{
+    pthread_mutex_lock(&g_reload_lock);
+    int rc = reload_locked(vconn, reason);
+    pthread_mutex_unlock(&g_reload_lock);
+    return rc;
+}
+
+// 정책 DB 연결: DB 풀이 있으면 풀에서 빌림 (엔진), 없으면 직접 연결
+static MYSQL* version_connect(void)
+{
+    if (db_pool_enabled()) return db_pool_acquire(-1);
+    return policy_db_connect(g_cfg.db_host, g_cfg.db_port, g_cfg.db_user, g_cfg.db_pass, g_cfg.db_name);
+}
+
+static void version_release(MYSQL* conn, int failed)
+{
+    if (!conn) return;
+    if (db_pool_enabled()) db_pool_release(conn, failed);
+    else mysql_close(conn);
+}
+
+int policy_snapshot_reload_now(void)
+{
+    MYSQL* conn = version_connect();
+    int rc = reload_with(conn, "manual");
+    version_release(conn, rc != 0);
+    return rc;
+}
+
+/*
+ * 스냅샷 파일로 시작
+ * - g_last_audit_id = -1 이라 첫 DB 대조는 항상 전체 재로드 (매핑된 룰 배열은 병합 base로 쓰지 않음)
+ * - 대조 전까지 version 문자열은 파일 기록 시점 값 (버전 확인이 바로 변화를 감지하지 않도록 g_loaded_version은 비움)
+ */
+static int init_from_file(void)
+{
+    policy_snapshot_t* snap = (policy_snapshot_t*)calloc(1, sizeof(policy_snapshot_t));
+    if (!snap) return -1;
+
+    policy_snapshot_file_info_t info;
+    if (policy_snapshot_file_load(g_snapshot_path, &snap->cache, &info) != 0) {
+        free(snap);
+        return -1;
+    }
+
+    snprintf(snap->version, sizeof(snap->version), "%s", info.db_version);
+    snap->loaded_at_ms = wall_ms();
+
+    pthread_mutex_lock(&g_reload_lock);
+    snap->generation = policy_snapshot_generation() + 1;
+    uint64_t generation = snap->generation;
+    size_t policy_count = snap->cache.policy_count;
+    g_loaded_version[0] = '\0';
+    g_last_audit_id = -1;
+    g_reconcile_pending = 1;
+    publish(snap);
+    pthread_mutex_unlock(&g_reload_lock);
+
+    fprintf(stderr, "[POLICY_RELOAD] published generation=%llu policies=%zu reason=snapshot_file "
+                    "file_generation=%llu age=%llds version=\"%s\" (DB reconcile pending)\n",
+            (unsigned long long)generation, policy_count, (unsigned long long)info.generation,
+            (long long)((wall_ms() - info.created_at_ms) / 1000), info.db_version);
+    return 0;
+}
+
+int policy_snapshot_init(const policy_reload_config_t* cfg)
+{
+    if (!cfg) return -1;
+
+    g_cfg = *cfg;
+    snprintf(g_db_host, sizeof(g_db_host), "%s", cfg->db_host ? cfg->db_host : "");
+    snprintf(g_db_user, sizeof(g_db_user), "%s", cfg->db_user ? cfg->db_user : "");
+    snprintf(g_db_pass, sizeof(g_db_pass), "%s", cfg->db_pass ? cfg->db_pass : "");
+    snprintf(g_db_name, sizeof(g_db_name), "%s", cfg->db_name ? cfg->db_name : "");
+    g_cfg.db_host = g_db_host;
+    g_cfg.db_user = g_db_user;
+    g_cfg.db_pass = g_db_pass;
+    g_cfg.db_name = g_db_name;
+    snprintf(g_snapshot_path, sizeof(g_snapshot_path), "%s", cfg->snapshot_path ? cfg->snapshot_path : "");
+    g_cfg.snapshot_path = g_snapshot_path;
+
+    if (g_snapshot_path[0] && init_from_file() == 0) return 0;
+
+    MYSQL* conn = version_connect();
+    int rc = reload_with(conn, "startup");
+    version_release(conn, rc != 0);
+    return rc;
+}
+
+void policy_snapshot_request_reload(void)
+{
+    g_reload_requested = 1;
+}
+
+/* ---------- 재로드 스레드 ---------- */
+
+static void* reloader_main(void* arg)
+{
+    (void)arg;
+
+    if (mysql_thread_init() != 0) {
+        fprintf(stderr, "[POLICY_RELOAD] mysql_thread_init failed\n");
+        return NULL;
+    }
+
+    MYSQL* vconn = NULL;
+    double last_load = mono_sec();
+    double last_poll = last_load;
+    double last_reconcile = -1e9;
+
+    while (!g_reloader_stop) {
+        sleep_ms(200);
+
+        double now = mono_sec();
+        const char* reason = NULL;
+
+        if (__atomic_exchange_n(&g_reload_requested, 0, __ATOMIC_ACQ_REL)) {
+            reason = "signal";
+        } else if (g_reconcile_pending && now - last_reconcile >= RECONCILE_RETRY_SEC) {
+            last_reconcile = now;
+            reason = "reconcile";
+        } else if (g_cfg.interval_sec > 0 && now - last_load >= g_cfg.interval_sec) {
+            reason = "interval";
+        } else if (g_cfg.version_poll_sec > 0 && now - last_poll >= g_cfg.version_poll_sec) {
+            last_poll = now;
+
+            if (!vconn) vconn = version_connect();
+
+            char v[128];
+            if (vconn && policy_snapshot_db_version(vconn, v, sizeof(v)) == 0) {
+                pthread_mutex_lock(&g_reload_lock);
+                int changed = (strcmp(v, g_loaded_version) != 0);
+                pthread_mutex_unlock(&g_reload_lock);
+                if (changed) (void)sync_with(vconn, v);
+            } else if (vconn) {
+                // 연결 끊김 등: 다음 주기에 재연결
+                version_release(vconn, 1);
+                vconn = NULL;
+            }
+        }
+
+        if (reason) {
+            if (!vconn && db_pool_enabled()) vconn = version_connect();
+            (void)reload_with(vconn, reason);
+            last_load = mono_sec();
+        }
+
+        // 풀 연결은 주기마다 반납 (직접 연결은 다음 버전 확인까지 유지)
+        if (vconn && db_pool_enabled()) {
+            version_release(vconn, 0);
+            vconn = NULL;
+        }
+
+        pthread_mutex_lock(&g_reload_lock);
+        persist_locked(0);
+        pthread_mutex_unlock(&g_reload_lock);
+    }
+
+    version_release(vconn, 0);
+    mysql_thread_end();
+    return NULL;
+}
+
+int policy_snapshot_start_reloader(void)
+{
+    if (g_reloader_started) return 0;
+
+    if (g_cfg.interval_sec <= 0 && g_cfg.version_poll_sec <= 0) {
+        fprintf(stderr, "[POLICY_RELOAD] periodic/version reload disabled (SIGHUP only)\n");
+    }
+
+    g_reloader_stop = 0;
+    if (pthread_create(&g_reloader, NULL, reloader_main, NULL) != 0) {
+        fprintf(stderr, "[POLICY_RELOAD] pthread_create failed\n");
+        return -1;
+    }
+
+    g_reloader_started = 1;
+    fprintf(stderr, "[POLICY_RELOAD] reloader started: interval=%ds version_poll=%ds delta_max=%d\n",
+            g_cfg.interval_sec, g_cfg.version_poll_sec, g_cfg.delta_max_policies);
+    return 0;
+}
+
+void policy_snapshot_shutdown(void)
+{
+    if (g_reloader_started) {
+        g_reloader_stop = 1;
+        pthread_join(g_reloader, NULL);
+        g_reloader_started = 0;
+    }
+
+    pthread_mutex_lock(&g_reload_lock);
+    persist_locked(1);
+    publish(NULL);
+    g_loaded_version[0] = '\0';
+    pthread_mutex_unlock(&g_reload_lock);
+}
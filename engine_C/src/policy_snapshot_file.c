@@ -0,0 +1,868 @@
+// src/policy_snapshot_file.c
+#include "policy_snapshot_file.h"
+#include "policy_index.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SNAP_MAGIC      "GGPSNAP"
+#define SNAP_ENDIAN_TAG 0x01020304u
+#define SNAP_ALIGN      8
+
+typedef struct {
+    char     magic[8];
+    uint32_t format_version;
+    uint32_t endian_tag;
+    uint32_t header_size;
+    uint32_t section_count;
+    uint32_t sz_policy;         // sizeof(policy_t) 등: 구조체 배치가 바뀐 빌드의 파일은 거부
+    uint32_t sz_rule;
+    uint32_t sz_index;
+    uint32_t crc32;             // section table + 모든 섹션
+    uint64_t generation;
+    int64_t  created_at_ms;
+    uint64_t file_size;
+    uint64_t policy_count;
+    uint64_t rule_count;
+    uint64_t rejected_rule_count;
+    char     db_version[128];
+} snap_header_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+} snap_section_t;
+
+/* 섹션 id: 인덱스 배열은 (종류, slot, 필드)로 구분, slot = target * 2 + case_sensitive */
+#define SEC_ID_POLICIES        1
+#define SEC_ID_RULE_START      2
+#define SEC_ID_RULES           3
+#define SEC_ID_INDEX           4
+#define SEC_ID_RESIDUAL        5
+#define SEC_ID_AC(slot, f)     (0x100u + (unsigned)(slot) * 8u + (unsigned)(f))
+#define SEC_ID_RADIX(slot, f)  (0x200u + (unsigned)(slot) * 8u + (unsigned)(f))
+#define SEC_ID_HMAP(slot, f)   (0x300u + (unsigned)(slot) * 8u + (unsigned)(f))
+#define HMAP_DOMAIN_SLOT       (POLICY_INDEX_TARGETS * 2)
+
+#define SNAP_MAX_SECTIONS 128
+
+/* ---------- CRC32 (IEEE, slicing-by-8) ---------- */
+
+// 룰 배열이 커서(룰당 약 2KB) byte 단위 CRC는 로드 시간 대부분을 차지함 -> 8 byte씩 처리
+static uint32_t g_crc_table[8][256];
+static pthread_once_t g_crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init_tables(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        g_crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            uint32_t c = g_crc_table[t - 1][i];
+            g_crc_table[t][i] = g_crc_table[0][c & 0xff] ^ (c >> 8);
+        }
+    }
+}
+
+static void crc_init(void)
+{
+    pthread_once(&g_crc_once, crc_init_tables);
+}
+
+static uint32_t crc_update(uint32_t crc, const void* data, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+
+    while (len >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        crc = g_crc_table[7][lo & 0xff] ^ g_crc_table[6][(lo >> 8) & 0xff] ^
+              g_crc_table[5][(lo >> 16) & 0xff] ^ g_crc_table[4][lo >> 24] ^
+              g_crc_table[3][p[4]] ^ g_crc_table[2][p[5]] ^
+              g_crc_table[1][p[6]] ^ g_crc_table[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = g_crc_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint64_t align_up(uint64_t v)
+{
+    return (v + (SNAP_ALIGN - 1)) & ~(uint64_t)(SNAP_ALIGN - 1);
+}
+
+// 파일의 개수 필드 * 구조체 크기 (넘치면 -1)
+static int mul_size(uint64_t count, uint64_t elem, uint64_t* out)
+{
+    return __builtin_mul_overflow(count, elem, out) ? -1 : 0;
+}
+
+/* ---------- 디렉터리 신뢰 확인 ---------- */
+
+/*
+ * 스냅샷 내용은 검증 후 룰/인덱스로 그대로 쓰이므로 다른 사용자가 파일을 바꿀 수 있는 위치는 거부
+ * - path가 있는 디렉터리: 심볼릭 링크 아님, 소유자 = 실행 uid 또는 root, group/other 쓰기 권한 없음
+ * - 파일 자체는 O_NOFOLLOW로 열고 fstat으로 확인 (file_trusted)
+ */
+static int dir_trusted(const char* path)
+{
+    char dir[1024];
+    const char* slash = strrchr(path, '/');
+    int n;
+    if (!slash) n = snprintf(dir, sizeof(dir), ".");
+    else if (slash == path) n = snprintf(dir, sizeof(dir), "/");
+    else n = snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+    if (n < 0 || (size_t)n >= sizeof(dir)) return 0;
+
+    struct stat st;
+    if (lstat(dir, &st) != 0) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] stat %s failed: %s\n", dir, strerror(errno));
+        return 0;
+    }
+    if (!S_ISDIR(st.st_mode) || (st.st_uid != geteuid() && st.st_uid != 0) ||
+        (st.st_mode & (S_IWGRP | S_IWOTH))) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] directory %s not trusted (uid=%u mode=%04o), "
+                        "use a directory owned by this user or root without group/other write\n",
+                dir, (unsigned)st.st_uid, (unsigned)(st.st_mode & 07777));
+        return 0;
+    }
+    return 1;
+}
+
+static int file_trusted(const char* path, const struct stat* st)
+{
+    if (S_ISREG(st->st_mode) && st->st_uid == geteuid() && (st->st_mode & (S_IWGRP | S_IWOTH)) == 0) return 1;
+
+    fprintf(stderr, "[POLICY_SNAPSHOT] %s not trusted (uid=%u mode=%04o)\n",
+            path, (unsigned)st->st_uid, (unsigned)(st->st_mode & 07777));
+    return 0;
+}
+
+/* ---------- 쓰기 ---------- */
+
+typedef enum {
+    SEC_RAW = 0,
+    SEC_POLICIES,    // policy_t (포인터 필드 0)
+    SEC_RULE_START,  // policy별 rules 시작 위치 (uint64)
+    SEC_RULES,       // policy_rule_t (re = NULL)
+    SEC_INDEX        // policy_index_t (포인터 필드 0)
+} sec_kind_t;
+
+typedef struct {
+    uint32_t    id;
+    sec_kind_t  kind;
+    const void* ptr;
+    uint64_t    size;
+} out_sec_t;
+
+typedef struct {
+    out_sec_t secs[SNAP_MAX_SECTIONS];
+    uint32_t  count;
+} sec_list_t;
+
+static int sec_add(sec_list_t* l, uint32_t id, sec_kind_t kind, const void* ptr, uint64_t size)
+{
+    if (l->count >= SNAP_MAX_SECTIONS) return -1;
+    out_sec_t* s = &l->secs[l->count++];
+    s->id = id;
+    s->kind = kind;
+    s->ptr = ptr;
+    s->size = size;
+    return 0;
+}
+
+typedef struct {
+    FILE*    fp;
+    uint32_t crc;
+    int      err;
+} writer_t;
+
+static void w_bytes(writer_t* w, const void* p, size_t n)
+{
+    if (w->err || n == 0) return;
+    if (fwrite(p, 1, n, w->fp) != n) {
+        w->err = 1;
+        return;
+    }
+    w->crc = crc_update(w->crc, p, n);
+}
+
+static void w_zeros(writer_t* w, size_t n)
+{
+    static const char zeros[SNAP_ALIGN] = {0};
+    while (n > 0 && !w->err) {
+        size_t k = n < sizeof(zeros) ? n : sizeof(zeros);
+        w_bytes(w, zeros, k);
+        n -= k;
+    }
+}
+
+static void strip_index_pointers(policy_index_t* x)
+{
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            policy_ac_t* ac = &x->contains[t][cs];
+            ac->nodes = NULL;
+            ac->edges = NULL;
+            ac->refs = NULL;
+            ac->owns_memory = 0;
+
+            policy_radix_t* rt = &x->prefix[t][cs];
+            rt->nodes = NULL;
+            rt->labels = NULL;
+            rt->refs = NULL;
+            rt->owns_memory = 0;
+
+            policy_host_map_t* m = &x->exact[t][cs];
+            m->buckets = NULL;
+            m->entries = NULL;
+            m->keys = NULL;
+            m->nodes = NULL;
+            m->refs = NULL;
+            m->owns_memory = 0;
+        }
+    }
+
+    policy_host_map_t* d = &x->domain;
+    d->buckets = NULL;
+    d->entries = NULL;
+    d->keys = NULL;
+    d->nodes = NULL;
+    d->refs = NULL;
+    d->owns_memory = 0;
+
+    x->residual_policies = NULL;
+}
+
+static void w_section(writer_t* w, const out_sec_t* s, const policy_cache_t* cache)
+{
+    switch (s->kind) {
+        case SEC_POLICIES:
+            for (size_t i = 0; i < cache->policy_count; i++) {
+                policy_t p = cache->policies[i];
+                p.rules = NULL;
+                p.rules_refcnt = NULL;
+                w_bytes(w, &p, sizeof(p));
+            }
+            break;
+        case SEC_RULE_START: {
+            uint64_t start = 0;
+            for (size_t i = 0; i < cache->policy_count; i++) {
+                w_bytes(w, &start, sizeof(start));
+                start += cache->policies[i].rule_count;
+            }
+            break;
+        }
+        case SEC_RULES:
+            for (size_t i = 0; i < cache->policy_count; i++) {
+                const policy_t* p = &cache->policies[i];
+                for (size_t k = 0; k < p->rule_count; k++) {
+                    policy_rule_t r = p->rules[k];
+                    r.re = NULL;
+                    w_bytes(w, &r, sizeof(r));
+                }
+            }
+            break;
+        case SEC_INDEX: {
+            policy_index_t x = *(const policy_index_t*)s->ptr;
+            strip_index_pointers(&x);
+            w_bytes(w, &x, sizeof(x));
+            break;
+        }
+        case SEC_RAW:
+        default:
+            w_bytes(w, s->ptr, (size_t)s->size);
+            break;
+    }
+}
+
+static int collect_sections(sec_list_t* l, const policy_cache_t* cache, uint64_t rule_total)
+{
+    const policy_index_t* idx = cache->index;
+    int rc = 0;
+
+    rc |= sec_add(l, SEC_ID_POLICIES, SEC_POLICIES, NULL, (uint64_t)cache->policy_count * sizeof(policy_t));
+    rc |= sec_add(l, SEC_ID_RULE_START, SEC_RULE_START, NULL, (uint64_t)cache->policy_count * sizeof(uint64_t));
+    rc |= sec_add(l, SEC_ID_RULES, SEC_RULES, NULL, rule_total * sizeof(policy_rule_t));
+    rc |= sec_add(l, SEC_ID_INDEX, SEC_INDEX, idx, sizeof(policy_index_t));
+    rc |= sec_add(l, SEC_ID_RESIDUAL, SEC_RAW, idx->residual_policies,
+                  (uint64_t)idx->residual_count * sizeof(uint32_t));
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            int slot = t * 2 + cs;
+
+            const policy_ac_t* ac = &idx->contains[t][cs];
+            rc |= sec_add(l, SEC_ID_AC(slot, 0), SEC_RAW, ac->nodes, (uint64_t)ac->node_count * sizeof(policy_ac_node_t));
+            rc |= sec_add(l, SEC_ID_AC(slot, 1), SEC_RAW, ac->edges, (uint64_t)ac->edge_count * sizeof(policy_ac_edge_t));
+            rc |= sec_add(l, SEC_ID_AC(slot, 2), SEC_RAW, ac->refs, (uint64_t)ac->ref_count * sizeof(policy_rule_ref_t));
+
+            const policy_radix_t* rt = &idx->prefix[t][cs];
+            rc |= sec_add(l, SEC_ID_RADIX(slot, 0), SEC_RAW, rt->nodes, (uint64_t)rt->node_count * sizeof(policy_radix_node_t));
+            rc |= sec_add(l, SEC_ID_RADIX(slot, 1), SEC_RAW, rt->labels, rt->labels_len);
+            rc |= sec_add(l, SEC_ID_RADIX(slot, 2), SEC_RAW, rt->refs, (uint64_t)rt->ref_count * sizeof(policy_rule_ref_t));
+        }
+    }
+
+    for (int slot = 0; slot <= HMAP_DOMAIN_SLOT; slot++) {
+        const policy_host_map_t* m = (slot == HMAP_DOMAIN_SLOT) ? &idx->domain
+                                                                : &idx->exact[slot / 2][slot % 2];
+        rc |= sec_add(l, SEC_ID_HMAP(slot, 0), SEC_RAW, m->buckets, (uint64_t)m->bucket_count * sizeof(uint32_t));
+        rc |= sec_add(l, SEC_ID_HMAP(slot, 1), SEC_RAW, m->entries, (uint64_t)m->entry_count * sizeof(policy_host_entry_t));
+        rc |= sec_add(l, SEC_ID_HMAP(slot, 2), SEC_RAW, m->keys, m->keys_len);
+        rc |= sec_add(l, SEC_ID_HMAP(slot, 3), SEC_RAW, m->nodes,
+                      m->bucket_count ? ((uint64_t)m->entry_count + 1) * sizeof(policy_ref_range_t) : 0);
+        rc |= sec_add(l, SEC_ID_HMAP(slot, 4), SEC_RAW, m->refs, (uint64_t)m->ref_count * sizeof(policy_rule_ref_t));
+    }
+
+    return rc ? -1 : 0;
+}
+
+static int64_t wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int policy_snapshot_file_write(const char* path,
+                               const policy_cache_t* cache,
+                               uint64_t generation,
+                               const char* db_version)
+{
+    if (!path || !path[0] || !cache || !cache->index) return -1;
+    if (!dir_trusted(path)) return -1;
+    crc_init();
+
+    uint64_t rule_total = 0;
+    for (size_t i = 0; i < cache->policy_count; i++) rule_total += cache->policies[i].rule_count;
+
+    sec_list_t l;
+    memset(&l, 0, sizeof(l));
+    if (collect_sections(&l, cache, rule_total) != 0) return -1;
+
+    snap_section_t table[SNAP_MAX_SECTIONS];
+    memset(table, 0, sizeof(table));
+
+    uint64_t off = align_up(sizeof(snap_header_t) + (uint64_t)l.count * sizeof(snap_section_t));
+    for (uint32_t i = 0; i < l.count; i++) {
+        table[i].id = l.secs[i].id;
+        table[i].offset = off;
+        table[i].size = l.secs[i].size;
+        off = align_up(off + l.secs[i].size);
+    }
+
+    snap_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAP_MAGIC, sizeof(SNAP_MAGIC));
+    h.format_version = POLICY_SNAPSHOT_FILE_VERSION;
+    h.endian_tag = SNAP_ENDIAN_TAG;
+    h.header_size = sizeof(snap_header_t);
+    h.section_count = l.count;
+    h.sz_policy = sizeof(policy_t);
+    h.sz_rule = sizeof(policy_rule_t);
+    h.sz_index = sizeof(policy_index_t);
+    h.generation = generation;
+    h.created_at_ms = wall_ms();
+    h.file_size = off;
+    h.policy_count = cache->policy_count;
+    h.rule_count = rule_total;
+    h.rejected_rule_count = cache->rejected_rule_count;
+    snprintf(h.db_version, sizeof(h.db_version), "%s", db_version ? db_version : "");
+
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path, (int)getpid());
+
+    // 새 파일로만 생성 (미리 만들어 둔 파일/링크를 따라가지 않음), 디렉터리는 신뢰 확인됨
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        // 같은 pid로 남은 이전 기록 실패 파일
+        unlink(tmp);
+        fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    }
+    FILE* fp = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+    if (!fp) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] open %s failed: %s\n", tmp, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmp);
+        }
+        return -1;
+    }
+
+    writer_t w;
+    memset(&w, 0, sizeof(w));
+    w.fp = fp;
+
+    // header는 CRC 계산 후 다시 기록
+    if (fwrite(&h, 1, sizeof(h), fp) != sizeof(h)) w.err = 1;
+
+    uint64_t pos = sizeof(h);
+    w_bytes(&w, table, (size_t)l.count * sizeof(snap_section_t));
+    pos += (uint64_t)l.count * sizeof(snap_section_t);
+
+    for (uint32_t i = 0; i < l.count && !w.err; i++) {
+        w_zeros(&w, (size_t)(table[i].offset - pos));
+        w_section(&w, &l.secs[i], cache);
+        pos = table[i].offset + table[i].size;
+    }
+    w_zeros(&w, (size_t)(off - pos));
+
+    h.crc32 = w.crc;
+    if (!w.err && (fseek(fp, 0, SEEK_SET) != 0 || fwrite(&h, 1, sizeof(h), fp) != sizeof(h))) w.err = 1;
+    if (!w.err && (fflush(fp) != 0 || fsync(fileno(fp)) != 0)) w.err = 1;
+    if (fclose(fp) != 0) w.err = 1;
+
+    if (w.err || rename(tmp, path) != 0) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] write %s failed: %s\n", path, strerror(errno));
+        unlink(tmp);
+        return -1;
+    }
+
+    fprintf(stderr, "[POLICY_SNAPSHOT] written %s: generation=%llu policies=%zu rules=%llu bytes=%llu\n",
+            path, (unsigned long long)generation, cache->policy_count,
+            (unsigned long long)rule_total, (unsigned long long)off);
+    return 0;
+}
+
+/* ---------- 읽기 ---------- */
+
+typedef struct {
+    const uint8_t*        base;
+    const snap_section_t* table;
+    uint32_t              count;
+} reader_t;
+
+// 섹션 포인터 (크기가 expected와 정확히 같아야 함)
+// - 빈 섹션도 매핑 내 주소를 돌려줌 (길이 0 memcmp 등에 NULL이 넘어가지 않도록)
+static int sec_bind(const reader_t* r, uint32_t id, uint64_t expected, const void** out)
+{
+    *out = NULL;
+    for (uint32_t i = 0; i < r->count; i++) {
+        if (r->table[i].id != id) continue;
+        if (r->table[i].size != expected) return -1;
+        *out = r->base + r->table[i].offset;
+        return 0;
+    }
+    return expected == 0 ? 0 : -1;
+}
+
+static int bind_index(const reader_t* r, policy_index_t* idx)
+{
+    const void* p;
+
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            int slot = t * 2 + cs;
+
+            policy_ac_t* ac = &idx->contains[t][cs];
+            if (sec_bind(r, SEC_ID_AC(slot, 0), (uint64_t)ac->node_count * sizeof(policy_ac_node_t), &p) != 0) return -1;
+            ac->nodes = (policy_ac_node_t*)p;
+            if (sec_bind(r, SEC_ID_AC(slot, 1), (uint64_t)ac->edge_count * sizeof(policy_ac_edge_t), &p) != 0) return -1;
+            ac->edges = (policy_ac_edge_t*)p;
+            if (sec_bind(r, SEC_ID_AC(slot, 2), (uint64_t)ac->ref_count * sizeof(policy_rule_ref_t), &p) != 0) return -1;
+            ac->refs = (policy_rule_ref_t*)p;
+
+            policy_radix_t* rt = &idx->prefix[t][cs];
+            if (sec_bind(r, SEC_ID_RADIX(slot, 0), (uint64_t)rt->node_count * sizeof(policy_radix_node_t), &p) != 0) return -1;
+            rt->nodes = (policy_radix_node_t*)p;
+            if (sec_bind(r, SEC_ID_RADIX(slot, 1), rt->labels_len, &p) != 0) return -1;
+            rt->labels = (char*)p;
+            if (sec_bind(r, SEC_ID_RADIX(slot, 2), (uint64_t)rt->ref_count * sizeof(policy_rule_ref_t), &p) != 0) return -1;
+            rt->refs = (policy_rule_ref_t*)p;
+        }
+    }
+
+    for (int slot = 0; slot <= HMAP_DOMAIN_SLOT; slot++) {
+        policy_host_map_t* m = (slot == HMAP_DOMAIN_SLOT) ? &idx->domain : &idx->exact[slot / 2][slot % 2];
+
+        if (sec_bind(r, SEC_ID_HMAP(slot, 0), (uint64_t)m->bucket_count * sizeof(uint32_t), &p) != 0) return -1;
+        m->buckets = (uint32_t*)p;
+        if (sec_bind(r, SEC_ID_HMAP(slot, 1), (uint64_t)m->entry_count * sizeof(policy_host_entry_t), &p) != 0) return -1;
+        m->entries = (policy_host_entry_t*)p;
+        if (sec_bind(r, SEC_ID_HMAP(slot, 2), m->keys_len, &p) != 0) return -1;
+        m->keys = (char*)p;
+        if (sec_bind(r, SEC_ID_HMAP(slot, 3), m->bucket_count ? ((uint64_t)m->entry_count + 1) * sizeof(policy_ref_range_t) : 0, &p) != 0) return -1;
+        m->nodes = (policy_ref_range_t*)p;
+        if (sec_bind(r, SEC_ID_HMAP(slot, 4), (uint64_t)m->ref_count * sizeof(policy_rule_ref_t), &p) != 0) return -1;
+        m->refs = (policy_rule_ref_t*)p;
+    }
+
+    // residual 목록은 policy_index_free가 해제하므로 힙으로 복사
+    uint64_t residual_size;
+    if (mul_size(idx->residual_count, sizeof(uint32_t), &residual_size) != 0 ||
+        sec_bind(r, SEC_ID_RESIDUAL, residual_size, &p) != 0) return -1;
+    idx->residual_policies = (uint32_t*)malloc((idx->residual_count ? idx->residual_count : 1) * sizeof(uint32_t));
+    if (!idx->residual_policies) return -1;
+    if (idx->residual_count) memcpy(idx->residual_policies, p, idx->residual_count * sizeof(uint32_t));
+    return 0;
+}
+
+// REGEX 룰이 있는 policy: 매핑은 읽기 전용이므로 룰 배열을 힙으로 복사해 정규식 컴파일
+static int privatize_regex_rules(policy_t* p, size_t* rejected)
+{
+    int has_regex = 0;
+    for (size_t k = 0; k < p->rule_count; k++) {
+        if (p->rules[k].match_type == MT_REGEX) has_regex = 1;
+    }
+    if (!has_regex) return 0;
+
+    policy_rule_t* rules = (policy_rule_t*)malloc(p->rule_count * sizeof(policy_rule_t));
+    int* refcnt = (int*)malloc(sizeof(int));
+    if (!rules || !refcnt) {
+        free(rules);
+        free(refcnt);
+        return -1;
+    }
+    memcpy(rules, p->rules, p->rule_count * sizeof(policy_rule_t));
+
+    for (size_t k = 0; k < p->rule_count; k++) {
+        policy_rule_t* r = &rules[k];
+        r->re = NULL;   // 파일에 기록된 포인터 값은 의미 없음 (해제 시 free 대상이 되지 않도록)
+        if (r->match_type != MT_REGEX) continue;
+
+        char err[256];
+        if (policy_rule_compile(r, err, sizeof(err)) != 0) {
+            // 같은 패턴이 로드 시 컴파일됐으므로 정상적으로는 발생하지 않음
+            fprintf(stderr, "[POLICY_SNAPSHOT] regex recompile failed: rule_id=%lld err=%s\n", r->rule_id, err);
+            r->is_enabled = 0;
+            p->rejected_rule_count++;
+            (*rejected)++;
+        }
+    }
+
+    *refcnt = 1;
+    p->rules = rules;
+    p->rules_refcnt = refcnt;
+    return 0;
+}
+
+/* ---------- 내용 검증 ---------- */
+
+/*
+ * CRC는 손상만 걸러냄: 인덱스 값은 탐색 중 배열 위치 / 반복 조건으로 바로 쓰이므로
+ * 모든 노드 / 간선 / 룰 참조의 범위, 문자열 종료, 탐색 종료성(실패 링크 깊이 감소, 체인 순환 없음)을 확인
+ */
+static int range_ok(uint32_t start, uint32_t count, uint32_t total)
+{
+    return start <= total && count <= total - start;
+}
+
+static int str_ok(const char* s, size_t cap)
+{
+    return memchr(s, '\0', cap) != NULL;
+}
+
+static int policy_ok(const policy_t* p)
+{
+    return str_ok(p->policy_name, sizeof(p->policy_name)) && str_ok(p->policy_type, sizeof(p->policy_type)) &&
+           str_ok(p->risk_level, sizeof(p->risk_level)) && str_ok(p->category, sizeof(p->category)) &&
+           str_ok(p->redirect_url, sizeof(p->redirect_url));
+}
+
+static int rule_ok(const policy_rule_t* r)
+{
+    return str_ok(r->pattern, sizeof(r->pattern)) && str_ok(r->pattern_lc, sizeof(r->pattern_lc)) &&
+           r->pattern_len < sizeof(r->pattern_lc);
+}
+
+static int refs_ok(const policy_rule_ref_t* refs, uint32_t n, const policy_cache_t* c)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        if (refs[i].policy_idx >= c->policy_count ||
+            refs[i].rule_idx >= c->policies[refs[i].policy_idx].rule_count) return 0;
+    }
+    return 1;
+}
+
+// 간선은 루트에서 시작하는 트리 (모든 노드 1회 도달), fail/dict는 더 얕은 노드 -> 실패 링크 반복이 루트에서 끝남
+static int ac_ok(const policy_ac_t* ac, const policy_cache_t* c)
+{
+    uint32_t n = ac->node_count;
+    if (n == 0) return ac->ref_count == 0;
+    if (!refs_ok(ac->refs, ac->ref_count, c)) return 0;
+
+    for (int b = 0; b < 256; b++) {
+        if (ac->root_next[b] != POLICY_AC_NONE && ac->root_next[b] >= n) return 0;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        const policy_ac_node_t* nd = &ac->nodes[i];
+        if (!range_ok(nd->edge_start, nd->edge_count, ac->edge_count) ||
+            !range_ok(nd->out_start, nd->out_count, ac->ref_count) || nd->fail >= n ||
+            (nd->dict != POLICY_AC_NONE && nd->dict >= n)) return 0;
+    }
+    for (uint32_t e = 0; e < ac->edge_count; e++) {
+        if (ac->edges[e].target == 0 || ac->edges[e].target >= n) return 0;
+    }
+    if (ac->nodes[0].dict != POLICY_AC_NONE) return 0;
+
+    uint32_t* depth = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    uint32_t* queue = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    int ok = (depth && queue);
+
+    if (ok) {
+        for (uint32_t i = 0; i < n; i++) depth[i] = POLICY_AC_NONE;
+        depth[0] = 0;
+
+        uint32_t qh = 0, qt = 0;
+        queue[qt++] = 0;
+        while (ok && qh < qt) {
+            const policy_ac_node_t* nd = &ac->nodes[queue[qh]];
+            uint32_t d = depth[queue[qh++]] + 1;
+            for (uint32_t k = 0; k < nd->edge_count; k++) {
+                uint32_t v = ac->edges[nd->edge_start + k].target;
+                if (depth[v] != POLICY_AC_NONE) { ok = 0; break; }
+                depth[v] = d;
+                queue[qt++] = v;
+            }
+        }
+        if (ok && qt != n) ok = 0;
+
+        for (uint32_t i = 1; ok && i < n; i++) {
+            const policy_ac_node_t* nd = &ac->nodes[i];
+            if (depth[nd->fail] >= depth[i]) ok = 0;
+            if (nd->dict != POLICY_AC_NONE && depth[nd->dict] >= depth[i]) ok = 0;
+        }
+    }
+
+    free(depth);
+    free(queue);
+    return ok;
+}
+
+// 자식 label은 1 byte 이상이고 '\0' 없음 -> 하강마다 text를 소비하고 text 끝('\0')에서 멈춤
+static int radix_ok(const policy_radix_t* rt, const policy_cache_t* c)
+{
+    uint32_t n = rt->node_count;
+    if (n == 0) return rt->ref_count == 0;
+    if (!refs_ok(rt->refs, rt->ref_count, c)) return 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const policy_radix_node_t* nd = &rt->nodes[i];
+        if (!range_ok(nd->label_off, nd->label_len, rt->labels_len) ||
+            !range_ok(nd->child_start, nd->child_count, n) ||
+            !range_ok(nd->out_start, nd->out_count, rt->ref_count)) return 0;
+        if (nd->label_len && memchr(rt->labels + nd->label_off, '\0', nd->label_len)) return 0;
+
+        for (uint32_t k = 0; k < nd->child_count; k++) {
+            if (rt->nodes[nd->child_start + k].label_len == 0) return 0;
+        }
+    }
+    return 1;
+}
+
+// 버킷 체인은 서로 겹치지 않고 순환 없음 (entry는 많아야 한 번 방문)
+static int host_map_ok(const policy_host_map_t* m, const policy_cache_t* c)
+{
+    if (m->bucket_count & (m->bucket_count - 1)) return 0;
+    if (!refs_ok(m->refs, m->ref_count, c)) return 0;
+
+    uint32_t n = m->entry_count;
+    for (uint32_t e = 0; e < n; e++) {
+        const policy_host_entry_t* en = &m->entries[e];
+        if (!range_ok(en->key_off, en->key_len, m->keys_len) || en->parent > n ||
+            (en->next != POLICY_AC_NONE && en->next >= n)) return 0;
+    }
+    if (m->bucket_count) {
+        for (uint32_t node = 0; node <= n; node++) {
+            if (!range_ok(m->nodes[node].start, m->nodes[node].count, m->ref_count)) return 0;
+        }
+    }
+
+    uint8_t* seen = (uint8_t*)calloc(n ? n : 1, 1);
+    if (!seen) return 0;
+
+    int ok = 1;
+    for (uint32_t b = 0; ok && b < m->bucket_count; b++) {
+        for (uint32_t e = m->buckets[b]; e != POLICY_AC_NONE; e = m->entries[e].next) {
+            if (e >= n || seen[e]) { ok = 0; break; }
+            seen[e] = 1;
+        }
+    }
+    free(seen);
+    return ok;
+}
+
+static int index_ok(const policy_index_t* idx, const policy_cache_t* c)
+{
+    for (int t = 0; t < POLICY_INDEX_TARGETS; t++) {
+        for (int cs = 0; cs < 2; cs++) {
+            if (!ac_ok(&idx->contains[t][cs], c) || !radix_ok(&idx->prefix[t][cs], c) ||
+                !host_map_ok(&idx->exact[t][cs], c)) return 0;
+        }
+    }
+    if (!host_map_ok(&idx->domain, c)) return 0;
+
+    for (size_t i = 0; i < idx->residual_count; i++) {
+        if (idx->residual_policies[i] >= c->policy_count) return 0;
+    }
+    return 1;
+}
+
+int policy_snapshot_file_load(const char* path,
+                              policy_cache_t* out,
+                              policy_snapshot_file_info_t* info)
+{
+    if (!path || !path[0] || !out) return -1;
+    memset(out, 0, sizeof(*out));
+    crc_init();
+
+    if (!dir_trusted(path)) return -1;
+
+    int fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno != ENOENT) fprintf(stderr, "[POLICY_SNAPSHOT] open %s failed: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !file_trusted(path, &st) || (size_t)st.st_size < sizeof(snap_header_t)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t len = (size_t)st.st_size;
+    void* map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] mmap %s failed: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    const uint8_t* base = (const uint8_t*)map;
+    const snap_header_t* h = (const snap_header_t*)base;
+    const char* why = NULL;
+
+    if (memcmp(h->magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) != 0) why = "bad magic";
+    else if (h->format_version != POLICY_SNAPSHOT_FILE_VERSION) why = "format version mismatch";
+    else if (h->endian_tag != SNAP_ENDIAN_TAG || h->header_size != sizeof(snap_header_t) ||
+             h->sz_policy != sizeof(policy_t) || h->sz_rule != sizeof(policy_rule_t) ||
+             h->sz_index != sizeof(policy_index_t)) why = "layout mismatch (different build)";
+    else if (h->file_size != len) why = "size mismatch";
+    else if (h->section_count > SNAP_MAX_SECTIONS ||
+             sizeof(snap_header_t) + (uint64_t)h->section_count * sizeof(snap_section_t) > len) why = "bad section table";
+    else if (crc_update(0, base + sizeof(snap_header_t), len - sizeof(snap_header_t)) != h->crc32) why = "checksum mismatch";
+    else if (!str_ok(h->db_version, sizeof(h->db_version))) why = "bad header string";
+
+    reader_t r;
+    r.base = base;
+    r.table = (const snap_section_t*)(base + sizeof(snap_header_t));
+    r.count = why ? 0 : h->section_count;
+
+    for (uint32_t i = 0; i < r.count && !why; i++) {
+        if (r.table[i].offset > len || r.table[i].size > len - r.table[i].offset ||
+            (r.table[i].offset % SNAP_ALIGN) != 0) why = "section out of range";
+    }
+
+    if (why) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] %s rejected: %s\n", path, why);
+        munmap(map, len);
+        return -1;
+    }
+
+    out->map_base = map;
+    out->map_len = len;
+
+    const void* pol_p;
+    const void* start_p;
+    const void* rules_p;
+    const void* idx_p;
+    size_t pc = (size_t)h->policy_count;
+    uint64_t pol_size, start_size, rules_size;
+
+    if (mul_size(h->policy_count, sizeof(policy_t), &pol_size) != 0 ||
+        mul_size(h->policy_count, sizeof(uint64_t), &start_size) != 0 ||
+        mul_size(h->rule_count, sizeof(policy_rule_t), &rules_size) != 0) {
+        why = "count overflow";
+    } else if (sec_bind(&r, SEC_ID_POLICIES, pol_size, &pol_p) != 0 ||
+               sec_bind(&r, SEC_ID_RULE_START, start_size, &start_p) != 0 ||
+               sec_bind(&r, SEC_ID_RULES, rules_size, &rules_p) != 0 ||
+               sec_bind(&r, SEC_ID_INDEX, sizeof(policy_index_t), &idx_p) != 0) {
+        why = "missing section";
+    }
+
+    if (!why) {
+        out->policies = (policy_t*)calloc(pc ? pc : 1, sizeof(policy_t));
+        if (!out->policies) why = "out of memory";
+    }
+
+    policy_rule_t* rules = (policy_rule_t*)rules_p;
+    const uint64_t* starts = (const uint64_t*)start_p;
+
+    for (size_t i = 0; i < pc && !why; i++) {
+        policy_t* p = &out->policies[i];
+        *p = ((const policy_t*)pol_p)[i];
+        p->rules = NULL;
+        p->rules_refcnt = NULL;
+        out->policy_count++;
+
+        if (starts[i] > h->rule_count || p->rule_count > h->rule_count - starts[i]) {
+            p->rule_count = 0;
+            why = "rule range out of bounds";
+            break;
+        }
+
+        p->rules = p->rule_count ? rules + starts[i] : NULL;
+        for (size_t k = 0; k < p->rule_count && !why; k++) {
+            if (!rule_ok(&p->rules[k])) why = "bad rule string";
+        }
+        if (!why && !policy_ok(p)) why = "bad policy string";
+        if (why) break;
+        if (privatize_regex_rules(p, &out->rejected_rule_count) != 0) why = "out of memory";
+    }
+
+    if (!why) {
+        policy_index_t* idx = (policy_index_t*)malloc(sizeof(policy_index_t));
+        if (!idx) why = "out of memory";
+        else {
+            memcpy(idx, idx_p, sizeof(policy_index_t));
+            strip_index_pointers(idx);
+            if (bind_index(&r, idx) != 0) {
+                free(idx->residual_policies);
+                free(idx);
+                why = "index section mismatch";
+            } else if (!index_ok(idx, out)) {
+                free(idx->residual_policies);
+                free(idx);
+                why = "index out of range";
+            } else {
+                out->index = idx;
+            }
+        }
+    }
+
+    if (why) {
+        fprintf(stderr, "[POLICY_SNAPSHOT] %s rejected: %s\n", path, why);
+        free_policy_cache(out);
+        return -1;
+    }
+
+    out->rejected_rule_count += (size_t)h->rejected_rule_count;
+
+    if (info) {
+        memset(info, 0, sizeof(*info));
+        info->generation = h->generation;
+        info->created_at_ms = h->created_at_ms;
+        info->file_size = h->file_size;
+        snprintf(info->db_version, sizeof(info->db_version), "%s", h->db_version);
+    }
+
+    fprintf(stderr, "[POLICY_SNAPSHOT] mapped %s: generation=%llu policies=%zu rules=%llu bytes=%zu\n",
+            path, (unsigned long long)h->generation, out->policy_count,
+            (unsigned long long)h->rule_count, len);
+    return 0;
+}
@@ -7,7 +7,8 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 
-static int g_raw_fd = -1;
+// 캡처 워커마다 raw 소켓을 따로 보유 (lazy init 경합 방지)
+static __thread int g_raw_fd = -1;
 
 int raw_sender_init(void) {
     if (g_raw_fd >= 0) return 0;
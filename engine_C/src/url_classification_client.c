@@ -1,10 +1,19 @@
 // src/url_classification_client.c
 #include "url_classification_client.h"
+#include "ai_score_proto.h"
+#include "url_features.h"
+#include "engine_metrics.h"
 
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
+#include <pthread.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include <curl/curl.h>
 
@@ -82,6 +91,129 @@ static int json_get_string(const char* json, const char* key, char* out, size_t
     return 1;
 }
 
+/*
+ * 재사용 연결 (CURL easy handle + 응답 버퍼)
+ * - libcurl은 handle 안에 keep-alive 연결을 유지하므로 같은 handle을 다시 쓰면 TCP/TLS 재수립 없음
+ * - 고정 옵션(URL/헤더/timeout/콜백)은 생성 시 1회만 설정, 요청마다 body만 바꿈
+ * - 워커 스레드별 idle 목록에서 꺼내 쓰고 반납 (스레드 간 handle 공유 없음)
+ */
+typedef struct ai_conn {
+    CURL* curl;
+    mem_t mem;
+    struct ai_conn* next_idle;  // 스레드 idle 목록
+    struct ai_conn* next_all;   // 전체 목록 (cleanup용, g_conns_lock)
+} ai_conn_t;
+
+#define AI_RESP_BUF_INIT 4096
+#define AI_RESP_BUF_KEEP (64 * 1024)  // 이보다 커진 버퍼는 반납 시 줄임
+
+static struct curl_slist* g_headers = NULL;  // init에서 1회 생성, 모든 handle 공용 (읽기 전용)
+
+static pthread_mutex_t g_conns_lock = PTHREAD_MUTEX_INITIALIZER;
+static ai_conn_t* g_conns = NULL;
+
+static __thread ai_conn_t* t_idle = NULL;
+static __thread int t_idle_count = 0;
+static __thread int t_idle_keep = 0;   // 0이면 g_cfg.pool_size (비동기 루프 스레드는 max_inflight)
+
+// Unix socket 바이너리 프로토콜: 워커 스레드별 연결 1개 (uds_path 설정 시)
+static __thread int      t_uds_fd = -1;
+static __thread uint32_t t_uds_seq = 0;
+
+static void conn_destroy(ai_conn_t* c) {
+    if (!c) return;
+
+    pthread_mutex_lock(&g_conns_lock);
+    ai_conn_t** link = &g_conns;
+    while (*link && *link != c) link = &(*link)->next_all;
+    if (*link) *link = c->next_all;
+    pthread_mutex_unlock(&g_conns_lock);
+
+    if (c->curl) curl_easy_cleanup(c->curl);
+    free(c->mem.buf);
+    free(c);
+}
+
+static ai_conn_t* conn_create(void) {
+    ai_conn_t* c = (ai_conn_t*)calloc(1, sizeof(ai_conn_t));
+    if (!c) return NULL;
+
+    c->mem.cap = AI_RESP_BUF_INIT;
+    c->mem.buf = (char*)malloc(c->mem.cap);
+    c->curl = curl_easy_init();
+    if (!c->mem.buf || !c->curl) {
+        if (c->curl) curl_easy_cleanup(c->curl);
+        free(c->mem.buf);
+        free(c);
+        return NULL;
+    }
+
+    CURL* curl = c->curl;
+    curl_easy_setopt(curl, CURLOPT_URL, g_cfg.endpoint);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, g_headers);
+
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, (long)g_cfg.connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)g_cfg.timeout_ms);
+
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&c->mem);
+
+    // 멀티스레드 안전 (timeout에서 SIGALRM 방지)
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    // idle 연결이 중간 장비에서 끊기지 않도록 TCP keep-alive
+    if (g_cfg.keepalive_idle_sec > 0) {
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, (long)g_cfg.keepalive_idle_sec);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, (long)g_cfg.keepalive_idle_sec);
+    }
+
+    pthread_mutex_lock(&g_conns_lock);
+    c->next_all = g_conns;
+    g_conns = c;
+    pthread_mutex_unlock(&g_conns_lock);
+    return c;
+}
+
+static ai_conn_t* conn_acquire(void) {
+    ai_conn_t* c = t_idle;
+    if (c) {
+        t_idle = c->next_idle;
+        t_idle_count--;
+        c->next_idle = NULL;
+    } else {
+        c = conn_create();
+        if (!c) return NULL;
+    }
+
+    c->mem.len = 0;
+    c->mem.buf[0] = '\0';
+    return c;
+}
+
+static void conn_release(ai_conn_t* c) {
+    if (!c) return;
+
+    // pool_size < 0: 재사용 안 함 (요청마다 새 연결, keep-alive 효과 비교 측정용)
+    int keep = t_idle_keep > 0 ? t_idle_keep : (g_cfg.pool_size > 0 ? g_cfg.pool_size : (g_cfg.pool_size < 0 ? 0 : 1));
+    if (t_idle_count >= keep) {
+        conn_destroy(c);
+        return;
+    }
+
+    if (c->mem.cap > AI_RESP_BUF_KEEP) {
+        char* nb = (char*)realloc(c->mem.buf, AI_RESP_BUF_INIT);
+        if (nb) {
+            c->mem.buf = nb;
+            c->mem.cap = AI_RESP_BUF_INIT;
+        }
+    }
+
+    c->next_idle = t_idle;
+    t_idle = c;
+    t_idle_count++;
+}
+
 int ai_client_init(const ai_client_config_t* cfg) {
     if (!cfg) return 0;
     memset(&g_cfg, 0, sizeof(g_cfg));
@@ -90,12 +222,65 @@ int ai_client_init(const ai_client_config_t* cfg) {
     if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
         return 0;
     }
+
+    g_headers = curl_slist_append(NULL, "Content-Type: application/json");
+    if (g_headers && g_cfg.token[0] != '\0') {
+        char auth[256];
+        snprintf(auth, sizeof(auth), "Authorization: Bearer %s", g_cfg.token);
+        struct curl_slist* h = curl_slist_append(g_headers, auth);
+        if (h) g_headers = h;
+    }
+    if (!g_headers) {
+        curl_global_cleanup();
+        return 0;
+    }
+
+    ai_breaker_init(&g_cfg.breaker, g_cfg.timeout_ms);
+
+    if (g_cfg.uds_path[0] != '\0') {
+        fprintf(stderr, "[AI_CLIENT] scoring over unix socket %s (binary protocol)\n", g_cfg.uds_path);
+    }
+
     g_inited = 1;
     return 1;
 }
 
+void ai_client_thread_cleanup(void) {
+    while (t_idle) {
+        ai_conn_t* c = t_idle;
+        t_idle = c->next_idle;
+        conn_destroy(c);
+    }
+    t_idle_count = 0;
+
+    if (t_uds_fd >= 0) {
+        close(t_uds_fd);
+        t_uds_fd = -1;
+    }
+}
+
 void ai_client_cleanup(void) {
     if (!g_inited) return;
+
+    ai_client_thread_cleanup();
+
+    // 종료된 워커 스레드가 남긴 handle
+    pthread_mutex_lock(&g_conns_lock);
+    ai_conn_t* c = g_conns;
+    g_conns = NULL;
+    pthread_mutex_unlock(&g_conns_lock);
+
+    while (c) {
+        ai_conn_t* next = c->next_all;
+        if (c->curl) curl_easy_cleanup(c->curl);
+        free(c->mem.buf);
+        free(c);
+        c = next;
+    }
+
+    curl_slist_free_all(g_headers);
+    g_headers = NULL;
+
     curl_global_cleanup();
     g_inited = 0;
 }
@@ -112,11 +297,9 @@ static void out_reset(ai_result_t* out) {
     out->raw[0] = '\0';
 }
 
-int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t* out) {
-    if (!out) return 0;
-    out_reset(out);
-
-    if (!g_inited || g_cfg.endpoint[0] == '\0') {
+// 요청 검증 (실패 시 0, out에 에러 기록)
+static int validate_event(const HttpEvent* ev, ai_result_t* out) {
+    if (!g_inited || (g_cfg.endpoint[0] == '\0' && g_cfg.uds_path[0] == '\0')) {
         out->error_code = AI_ERR_CURL;
         snprintf(out->raw, sizeof(out->raw), "ai_client_not_initialized");
         return 0;
@@ -127,66 +310,49 @@ int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t*
         snprintf(out->raw, sizeof(out->raw), "empty_event");
         return 0;
     }
+    return 1;
+}
+
+// 요청 검증 + payload 작성 (실패 시 0, out에 에러 기록)
+static int build_payload(const HttpEvent* ev, const char* request_id, char* payload, size_t cap, ai_result_t* out) {
+    if (!validate_event(ev, out)) return 0;
 
     // FastAPI ScoreRequest 스키마에 맞춤: request_id(optional), host, path
     // (path 없으면 "/")
     const char* path = (ev->path[0] ? ev->path : "/");
 
-    char payload[1024];
     if (request_id && request_id[0]) {
-        snprintf(payload, sizeof(payload),
+        snprintf(payload, cap,
                  "{\"request_id\":\"%s\",\"host\":\"%s\",\"path\":\"%s\"}",
                  request_id, ev->host, path);
     } else {
-        snprintf(payload, sizeof(payload),
+        snprintf(payload, cap,
                  "{\"host\":\"%s\",\"path\":\"%s\"}",
                  ev->host, path);
     }
+    return 1;
+}
 
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        out->error_code = AI_ERR_CURL;
-        snprintf(out->raw, sizeof(out->raw), "curl_easy_init_failed");
-        return 0;
-    }
-
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    if (g_cfg.token[0] != '\0') {
-        char auth[256];
-        snprintf(auth, sizeof(auth), "Authorization: Bearer %s", g_cfg.token);
-        headers = curl_slist_append(headers, auth);
-    }
-
-    mem_t mem;
-    mem.cap = 4096;
-    mem.len = 0;
-    mem.buf = (char*)malloc(mem.cap);
-    if (!mem.buf) {
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-        out->error_code = AI_ERR_CURL;
-        snprintf(out->raw, sizeof(out->raw), "malloc_failed");
-        return 0;
-    }
-    mem.buf[0] = '\0';
-
-    int64_t t0 = now_ms();
-
-    curl_easy_setopt(curl, CURLOPT_URL, g_cfg.endpoint);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload);
-
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, (long)g_cfg.connect_timeout_ms);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)g_cfg.timeout_ms);
+// breaker 실패로 셀 결과: 서비스 상태 문제 (timeout / 연결 / 5xx / 429)
+static int breaker_failure(ai_error_t code, int http_status) {
+    if (code == AI_ERR_TIMEOUT || code == AI_ERR_CURL) return 1;
+    return code == AI_ERR_HTTP && (http_status >= 500 || http_status == 429);
+}
 
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&mem);
+static void breaker_record_result(const ai_result_t* r, uint32_t epoch) {
+    ai_breaker_record(epoch, breaker_failure(r->error_code, r->http_status),
+                      r->error_code == AI_ERR_TIMEOUT, r->latency_ms);
+}
 
-    // 멀티스레드 안전 (timeout에서 SIGALRM 방지)
-    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+static void set_circuit_open(ai_result_t* out) {
+    out->error_code = AI_ERR_CIRCUIT_OPEN;
+    snprintf(out->raw, sizeof(out->raw), "ai_circuit_open");
+}
 
-    CURLcode res = curl_easy_perform(curl);
+// 전송 완료된 연결의 응답 해석 (동기/비동기 공용, 성공 시 1)
+static int finish_result(ai_conn_t* conn, CURLcode res, int64_t t0, ai_result_t* out) {
+    CURL* curl = conn->curl;
+    mem_t* mem = &conn->mem;
 
     int64_t t1 = now_ms();
     out->latency_ms = (t1 - t0);
@@ -195,23 +361,21 @@ int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t*
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
     out->http_status = (int)http_code;
 
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    // POSTFIELDS는 복사하지 않으므로 요청 버퍼 참조를 남기지 않음
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, NULL);
 
     if (res != CURLE_OK) {
         if (res == CURLE_OPERATION_TIMEDOUT) out->error_code = AI_ERR_TIMEOUT;
         else out->error_code = AI_ERR_CURL;
 
         snprintf(out->raw, sizeof(out->raw), "curl_error:%s", curl_easy_strerror(res));
-        free(mem.buf);
         return 0;
     }
 
     if (http_code < 200 || http_code >= 300) {
         out->error_code = AI_ERR_HTTP;
         snprintf(out->raw, sizeof(out->raw), "%.*s",
-                 (int)sizeof(out->raw) - 1, mem.buf ? mem.buf : "");
-        free(mem.buf);
+                 (int)sizeof(out->raw) - 1, mem->buf);
         return 0;
     }
 
@@ -220,16 +384,15 @@ int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t*
     char label[32] = {0};
     char mv[64] = {0};
 
-    int ok_score = json_get_double(mem.buf, "score", &score);
-    int ok_label = json_get_string(mem.buf, "label", label, sizeof(label));
-    int ok_mv    = json_get_string(mem.buf, "model_version", mv, sizeof(mv));
+    int ok_score = json_get_double(mem->buf, "score", &score);
+    int ok_label = json_get_string(mem->buf, "label", label, sizeof(label));
+    int ok_mv    = json_get_string(mem->buf, "model_version", mv, sizeof(mv));
 
     if (!ok_score || !ok_label) {
         // invalid_test 같은 깨진 JSON은 여기로 들어옴
         out->error_code = AI_ERR_PARSE;
         snprintf(out->raw, sizeof(out->raw), "%.*s",
-                 (int)sizeof(out->raw) - 1, mem.buf ? mem.buf : "");
-        free(mem.buf);
+                 (int)sizeof(out->raw) - 1, mem->buf);
         return 0;
     }
 
@@ -243,11 +406,1206 @@ int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t*
 	} else {
 		out->model_version[0] = '\0';
 	}
+    return 1;
+}
+
+/* ---------- 동일 URL 요청 합치기 (single-flight) ---------- */
+
+/*
+ * 같은 URL(url_features_build_url 결과 = API가 점수를 매기는 문자열)에 대한 요청이 진행 중이면
+ * 새 요청을 보내지 않고 그 결과를 함께 받음
+ * - 동기 follower: 선행 요청 완료까지 cond 대기
+ * - 비동기 follower: 선행 요청 완료 시 각자의 done 콜백 호출 (선행 요청을 완료한 스레드에서)
+ * - follower도 호출자 쪽 기록(access_log / ai_analysis)은 각자 수행
+ */
+#define FLIGHT_BUCKETS 1024
+
+struct ai_async_req;
+
+typedef struct ai_flight {
+    uint64_t             hash;
+    char                 url[URL_FEATURES_URL_MAX];
+    int                  done;
+    int                  ok;
+    ai_result_t          result;
+    int                  sync_waiters;
+    pthread_cond_t       cond;
+    struct ai_async_req* followers;  // 비동기 follower (next로 연결)
+    struct ai_flight*    next;       // bucket chain
+} ai_flight_t;
+
+static pthread_mutex_t g_flight_lock = PTHREAD_MUTEX_INITIALIZER;
+static ai_flight_t*    g_flights[FLIGHT_BUCKETS];
+
+static void async_dispatch_followers(struct ai_async_req* list, int ok, const ai_result_t* r);
+
+static uint64_t flight_hash(const char* s) {
+    uint64_t h = 1469598103934665603ull;
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        h ^= *p;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
 
-    free(mem.buf);
+// 합치기 대상 키 (끔 / 잘못된 입력이면 0)
+static int flight_key(const HttpEvent* ev, char* url, size_t cap, uint64_t* hash) {
+    if (!g_cfg.coalesce || !ev || ev->host[0] == '\0') return 0;
+    if (url_features_build_url(ev->host, ev->path, url, cap) == 0) return 0;
+    *hash = flight_hash(url);
     return 1;
 }
 
+static ai_flight_t* flight_find_locked(uint64_t hash, const char* url) {
+    for (ai_flight_t* f = g_flights[hash & (FLIGHT_BUCKETS - 1)]; f; f = f->next) {
+        if (f->hash == hash && strcmp(f->url, url) == 0) return f;
+    }
+    return NULL;
+}
+
+static ai_flight_t* flight_open_locked(uint64_t hash, const char* url) {
+    ai_flight_t* f = (ai_flight_t*)calloc(1, sizeof(ai_flight_t));
+    if (!f) return NULL;
+
+    f->hash = hash;
+    snprintf(f->url, sizeof(f->url), "%s", url);
+    pthread_cond_init(&f->cond, NULL);
+
+    ai_flight_t** head = &g_flights[hash & (FLIGHT_BUCKETS - 1)];
+    f->next = *head;
+    *head = f;
+    return f;
+}
+
+static void flight_free(ai_flight_t* f) {
+    pthread_cond_destroy(&f->cond);
+    free(f);
+}
+
+// 동기 follower: 결과가 나올 때까지 대기 (lock 보유 상태로 호출, 반환 시 lock 해제)
+static int flight_wait_unlock(ai_flight_t* f, ai_result_t* out) {
+    f->sync_waiters++;
+    while (!f->done) pthread_cond_wait(&f->cond, &g_flight_lock);
+
+    int ok = f->ok;
+    *out = f->result;
+    int last = (--f->sync_waiters == 0);
+    pthread_mutex_unlock(&g_flight_lock);
+
+    if (last) flight_free(f);
+    return ok;
+}
+
+/*
+ * 선행 요청 완료: 목록에서 제거하고 대기 중인 follower에 결과 전달
+ * - 동기 follower가 남아 있으면 마지막 follower가 해제
+ */
+static void flight_finish(ai_flight_t* f, int ok, const ai_result_t* r) {
+    if (!f) return;
+
+    pthread_mutex_lock(&g_flight_lock);
+    ai_flight_t** link = &g_flights[f->hash & (FLIGHT_BUCKETS - 1)];
+    while (*link && *link != f) link = &(*link)->next;
+    if (*link) *link = f->next;
+
+    f->done = 1;
+    f->ok = ok;
+    f->result = *r;
+    struct ai_async_req* followers = f->followers;
+    f->followers = NULL;
+    int free_now = (f->sync_waiters == 0);
+    if (!free_now) pthread_cond_broadcast(&f->cond);
+    pthread_mutex_unlock(&g_flight_lock);
+
+    async_dispatch_followers(followers, ok, r);
+    if (free_now) flight_free(f);
+}
+
+/* ---------- Unix socket 바이너리 프로토콜 (동기) ---------- */
+
+// deadline까지 fd 준비 대기 (0 = 준비, -1 = timeout/에러)
+static int uds_wait(int fd, short events, int64_t deadline) {
+    for (;;) {
+        int64_t left = deadline - now_ms();
+        if (left <= 0) return -1;
+
+        struct pollfd pfd = { fd, events, 0 };
+        int pr = poll(&pfd, 1, (int)left);
+        if (pr > 0) return 0;
+        if (pr == 0 || errno != EINTR) return -1;
+    }
+}
+
+/*
+ * 요청 1건 송수신
+ * - 재사용한 연결이 응답 전에 끊겨 있으면 (API 재시작 등) 새 연결로 1회 재시도
+ * - timeout / 잘못된 응답이면 연결을 버림 (이후 응답 순서가 어긋나므로)
+ */
+static int uds_classify(const HttpEvent* ev, const char* request_id, ai_result_t* out) {
+    int64_t t0 = now_ms();
+    int64_t deadline = t0 + ai_breaker_timeout_ms();
+
+    uint8_t req[AI_PROTO_REQ_MAX];
+    uint32_t seq = ++t_uds_seq;
+    size_t req_len = ai_proto_encode_request(req, sizeof(req), seq, ev->host,
+                                             ev->path[0] ? ev->path : "/", request_id);
+    if (req_len == 0) {
+        out->error_code = AI_ERR_EMPTY;
+        snprintf(out->raw, sizeof(out->raw), "request_too_large");
+        return 0;
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int reused = (t_uds_fd >= 0);
+        if (!reused) {
+            char err[128];
+            t_uds_fd = ai_proto_connect(g_cfg.uds_path, g_cfg.token, g_cfg.connect_timeout_ms, err, sizeof(err));
+            if (t_uds_fd < 0) {
+                out->error_code = AI_ERR_CURL;
+                snprintf(out->raw, sizeof(out->raw), "%s", err);
+                break;
+            }
+        }
+
+        int fd = t_uds_fd;
+        const char* fail = NULL;
+        ai_error_t fail_code = AI_ERR_CURL;
+
+        size_t off = 0;
+        while (!fail && off < req_len) {
+            ssize_t n = send(fd, req + off, req_len - off, MSG_NOSIGNAL);
+            if (n > 0) {
+                off += (size_t)n;
+            } else if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+                if (uds_wait(fd, POLLOUT, deadline) != 0) {
+                    fail = "uds_timeout";
+                    fail_code = AI_ERR_TIMEOUT;
+                }
+            } else {
+                fail = "uds_send_failed";
+            }
+        }
+
+        uint8_t resp[4 + AI_PROTO_RESP_MAX];
+        size_t len = 0;
+        while (!fail) {
+            uint32_t rseq = 0;
+            size_t used = 0;
+            int rc = ai_proto_decode_response(resp, len, &rseq, out, &used);
+            if (rc > 0 && rseq == seq) {
+                out->latency_ms = now_ms() - t0;
+                return out->ok;
+            }
+            if (rc != 0) {
+                fail = "uds_bad_frame";
+                fail_code = AI_ERR_PARSE;
+                break;
+            }
+
+            ssize_t n = recv(fd, resp + len, sizeof(resp) - len, 0);
+            if (n > 0) {
+                len += (size_t)n;
+            } else if (n == 0) {
+                fail = "uds_closed";
+            } else if (errno == EAGAIN || errno == EINTR) {
+                if (uds_wait(fd, POLLIN, deadline) != 0) {
+                    fail = "uds_timeout";
+                    fail_code = AI_ERR_TIMEOUT;
+                }
+            } else {
+                fail = "uds_recv_failed";
+            }
+        }
+
+        close(fd);
+        t_uds_fd = -1;
+        out->error_code = fail_code;
+        snprintf(out->raw, sizeof(out->raw), "%s", fail);
+
+        // 재사용 연결이 이미 끊겨 있던 경우만 재시도 (응답을 일부라도 받았으면 재시도 안 함)
+        if (!reused || fail_code != AI_ERR_CURL || len > 0) break;
+    }
+
+    out->latency_ms = now_ms() - t0;
+    return 0;
+}
+
+int ai_classify_url_ex(const HttpEvent* ev, const char* request_id, ai_result_t* out) {
+    if (!out) return 0;
+    out_reset(out);
+
+    char payload[1024];
+    int uds = (g_cfg.uds_path[0] != '\0');
+    if (uds ? !validate_event(ev, out) : !build_payload(ev, request_id, payload, sizeof(payload), out)) return 0;
+
+    ai_flight_t* flight = NULL;
+    char url[URL_FEATURES_URL_MAX];
+    uint64_t hash = 0;
+    if (flight_key(ev, url, sizeof(url), &hash)) {
+        pthread_mutex_lock(&g_flight_lock);
+        ai_flight_t* f = flight_find_locked(hash, url);
+        if (f) {
+            engine_metrics_count(EM_COUNT_AI_COALESCED, 1);
+            return flight_wait_unlock(f, out);
+        }
+        flight = flight_open_locked(hash, url);
+        pthread_mutex_unlock(&g_flight_lock);
+    }
+
+    // breaker OPEN: 네트워크 호출 없이 즉시 실패 (합쳐진 대기자도 같은 결과)
+    uint32_t epoch = 0;
+    int allow = ai_breaker_allow(&epoch);
+    if (!allow) {
+        set_circuit_open(out);
+        flight_finish(flight, 0, out);
+        return 0;
+    }
+
+    int ok = 0;
+    if (uds) {
+        ok = uds_classify(ev, request_id, out);
+        breaker_record_result(out, epoch);
+        flight_finish(flight, ok, out);
+        return ok;
+    }
+
+    ai_conn_t* conn = conn_acquire();
+    if (!conn) {
+        // 로컬 자원 실패: 서비스 상태와 무관하므로 기록하지 않고 probe만 반환
+        if (allow == AI_BREAKER_PROBE) ai_breaker_release_probe();
+        out->error_code = AI_ERR_CURL;
+        snprintf(out->raw, sizeof(out->raw), "curl_easy_init_failed");
+    } else {
+        int64_t t0 = now_ms();
+        curl_easy_setopt(conn->curl, CURLOPT_POSTFIELDS, payload);
+        curl_easy_setopt(conn->curl, CURLOPT_TIMEOUT_MS, (long)ai_breaker_timeout_ms());
+        CURLcode res = curl_easy_perform(conn->curl);
+
+        ok = finish_result(conn, res, t0, out);
+        breaker_record_result(out, epoch);
+        conn_release(conn);
+    }
+
+    flight_finish(flight, ok, out);
+    return ok;
+}
+
+/* ---------- 비동기 (curl multi) ---------- */
+
+#define AI_XFER_SINGLE 1
+#define AI_XFER_BATCH  2
+
+typedef struct ai_async_req {
+    int                 kind;        // AI_XFER_SINGLE (CURLOPT_PRIVATE 구분용, 첫 필드)
+    char                payload[1024];
+    char                request_id[40];
+    char                host[256];
+    char                path[512];
+    ai_result_t         result;
+    ai_conn_t*          conn;
+    int64_t             t0;
+    ai_classify_done_fn done;
+    void*               ctx;
+    int                 ok;          // 완료 결과 (콜백 스레드로 넘길 때)
+    int                 probe;       // breaker HALF_OPEN probe 슬롯 사용 (보내지 못하면 반환)
+    uint32_t            epoch;       // breaker epoch (allow 시점)
+    ai_flight_t*        flight;      // 선행 요청이면 완료 시 follower에 결과 전달
+    uint32_t            seq;         // Unix socket 요청 번호
+    int64_t             deadline;    // Unix socket 응답 기한
+    struct ai_async_req* next;
+} ai_async_req_t;
+
+// /v1/score_batch 요청 1건 (items 순서 = 응답 results 순서)
+typedef struct {
+    int              kind;           // AI_XFER_BATCH
+    ai_async_req_t** items;
+    int              count;
+    char*            payload;
+    ai_conn_t*       conn;
+    int64_t          t0;
+} ai_async_batch_t;
+
+static struct {
+    ai_async_config_t cfg;
+    CURLM*            multi;
+    pthread_t         thread;
+    int               running;   // 루프 스레드 동작 중
+
+    pthread_mutex_t   lock;      // queue, stopping
+    ai_async_req_t*   queue_head;
+    ai_async_req_t*   queue_tail;
+    int               stopping;
+
+    int               inflight;  // 제출 ~ 완료 콜백 종료 (atomic)
+    int               uds_on;    // Unix socket pipelining (curl multi는 poll/wakeup에만 사용)
+
+    // 완료 콜백 스레드: 루프 스레드는 완료된 요청을 done 큐에 넣기만 함
+    pthread_mutex_t   cb_lock;   // done 큐, cb_stop, 시작 결과
+    pthread_cond_t    cb_cond;   // done 큐 항목 / cb_stop
+    pthread_cond_t    ctl_cond;  // 콜백 스레드 시작 결과 / inflight 0 (start, drain 대기)
+    ai_async_req_t*   done_head;
+    ai_async_req_t*   done_tail;
+    pthread_t*        cb_threads;
+    int               cb_count;  // 생성된 콜백 스레드 수
+    int               cb_ready;
+    int               cb_failed;
+    int               cb_stop;
+
+    // 마이크로 배치 (루프 스레드 전용)
+    int               batch_on;
+    ai_async_req_t*   batch_head;
+    ai_async_req_t*   batch_tail;
+    int               batch_count;
+    int64_t           batch_deadline;  // 첫 항목 도착 + batch_wait_ms
+} g_async = { .lock = PTHREAD_MUTEX_INITIALIZER,
+              .cb_lock = PTHREAD_MUTEX_INITIALIZER,
+              .cb_cond = PTHREAD_COND_INITIALIZER,
+              .ctl_cond = PTHREAD_COND_INITIALIZER };
+
+// in-flight 1건 종료 (0이 되면 ai_async_drain 대기자 깨움)
+static void inflight_release(void) {
+    if (__atomic_sub_fetch(&g_async.inflight, 1, __ATOMIC_ACQ_REL) == 0) {
+        pthread_mutex_lock(&g_async.cb_lock);
+        pthread_cond_broadcast(&g_async.ctl_cond);
+        pthread_mutex_unlock(&g_async.cb_lock);
+    }
+}
+
+// 완료된 요청을 콜백 스레드로 넘김
+static void done_push(ai_async_req_t* req, int ok) {
+    req->ok = ok;
+    req->next = NULL;
+
+    pthread_mutex_lock(&g_async.cb_lock);
+    if (g_async.done_tail) g_async.done_tail->next = req;
+    else g_async.done_head = req;
+    g_async.done_tail = req;
+    pthread_cond_signal(&g_async.cb_cond);
+    pthread_mutex_unlock(&g_async.cb_lock);
+}
+
+static void async_dispatch_followers(ai_async_req_t* list, int ok, const ai_result_t* r) {
+    while (list) {
+        ai_async_req_t* next = list->next;
+        list->result = *r;
+        done_push(list, ok);
+        list = next;
+    }
+}
+
+// handle 반납 / follower 분배는 호출 스레드(루프)에서, 콜백은 콜백 스레드에서
+static void async_complete(ai_async_req_t* req, int ok) {
+    if (req->conn) conn_release(req->conn);
+    req->conn = NULL;
+    flight_finish(req->flight, ok, &req->result);
+    req->flight = NULL;
+    done_push(req, ok);
+}
+
+// 보내기 전 로컬 실패: breaker에는 기록하지 않고 probe 슬롯만 반환
+static void async_fail(ai_async_req_t* req, ai_error_t code, const char* why) {
+    if (req->probe) ai_breaker_release_probe();
+    req->probe = 0;
+    req->result.error_code = code;
+    snprintf(req->result.raw, sizeof(req->result.raw), "%s", why);
+    async_complete(req, 0);
+}
+
+// 단건 요청 -> multi 등록
+static void async_send_single(ai_async_req_t* req) {
+    req->conn = conn_acquire();
+    if (!req->conn) {
+        async_fail(req, AI_ERR_CURL, "curl_easy_init_failed");
+        return;
+    }
+
+    CURL* curl = req->conn->curl;
+    curl_easy_setopt(curl, CURLOPT_URL, g_cfg.endpoint);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req->payload);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)ai_breaker_timeout_ms());
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)req);
+    req->t0 = now_ms();
+
+    if (curl_multi_add_handle(g_async.multi, curl) != CURLM_OK) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, NULL);
+        async_fail(req, AI_ERR_CURL, "curl_multi_add_failed");
+    }
+}
+
+// JSON 문자열 값 이스케이프 (배치는 항목 하나가 깨지면 전체가 실패하므로 항상 이스케이프)
+static size_t json_escape(char* out, size_t cap, const char* s) {
+    size_t n = 0;
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        char tmp[8];
+        size_t k;
+        if (*p == '"' || *p == '\\') {
+            tmp[0] = '\\';
+            tmp[1] = (char)*p;
+            k = 2;
+        } else if (*p < 0x20) {
+            k = (size_t)snprintf(tmp, sizeof(tmp), "\\u%04x", *p);
+        } else {
+            tmp[0] = (char)*p;
+            k = 1;
+        }
+        if (n + k + 1 > cap) break;
+        memcpy(out + n, tmp, k);
+        n += k;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+static void batch_free(ai_async_batch_t* b) {
+    if (!b) return;
+    free(b->items);
+    free(b->payload);
+    free(b);
+}
+
+// 모인 배치 -> /v1/score_batch 요청 1건
+static void async_flush_batch(void) {
+    if (g_async.batch_count == 0) return;
+
+    int count = g_async.batch_count;
+    ai_async_req_t* head = g_async.batch_head;
+    g_async.batch_head = g_async.batch_tail = NULL;
+    g_async.batch_count = 0;
+
+    ai_async_batch_t* b = (ai_async_batch_t*)calloc(1, sizeof(ai_async_batch_t));
+    size_t cap = (size_t)count * 2048 + 32;
+    if (b) {
+        b->kind = AI_XFER_BATCH;
+        b->items = (ai_async_req_t**)malloc((size_t)count * sizeof(ai_async_req_t*));
+        b->payload = (char*)malloc(cap);
+        b->conn = conn_acquire();
+    }
+
+    if (!b || !b->items || !b->payload || !b->conn) {
+        if (b && b->conn) conn_release(b->conn);
+        batch_free(b);
+        while (head) {
+            ai_async_req_t* next = head->next;
+            async_fail(head, AI_ERR_CURL, "batch_alloc_failed");
+            head = next;
+        }
+        return;
+    }
+
+    // {"items":[{"request_id":"..","host":"..","path":".."},...]}
+    size_t n = (size_t)snprintf(b->payload, cap, "{\"items\":[");
+    for (ai_async_req_t* r = head; r; r = r->next) {
+        char host[600];
+        char path[1200];
+        json_escape(host, sizeof(host), r->host);
+        json_escape(path, sizeof(path), r->path);
+
+        n += (size_t)snprintf(b->payload + n, cap - n,
+                              "%s{\"request_id\":\"%s\",\"host\":\"%s\",\"path\":\"%s\"}",
+                              b->count ? "," : "", r->request_id, host, path);
+        b->items[b->count++] = r;
+    }
+    snprintf(b->payload + n, cap - n, "]}");
+
+    for (int i = 0; i < b->count; i++) b->items[i]->next = NULL;
+
+    CURL* curl = b->conn->curl;
+    curl_easy_setopt(curl, CURLOPT_URL, g_cfg.batch_endpoint);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, b->payload);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)ai_breaker_timeout_ms());
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)b);
+    b->t0 = now_ms();
+
+    if (curl_multi_add_handle(g_async.multi, curl) != CURLM_OK) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, NULL);
+        conn_release(b->conn);
+        for (int i = 0; i < b->count; i++) async_fail(b->items[i], AI_ERR_CURL, "curl_multi_add_failed");
+        batch_free(b);
+    }
+}
+
+static void batch_append(ai_async_req_t* req) {
+    if (g_async.batch_count == 0) g_async.batch_deadline = now_ms() + g_async.cfg.batch_wait_ms;
+
+    req->next = NULL;
+    if (g_async.batch_tail) g_async.batch_tail->next = req;
+    else g_async.batch_head = req;
+    g_async.batch_tail = req;
+
+    if (++g_async.batch_count >= g_async.cfg.batch_max) async_flush_batch();
+}
+
+// "key": true
+static int json_get_true(const char* json, const char* key) {
+    char pat[64];
+    snprintf(pat, sizeof(pat), "\"%s\"", key);
+    const char* p = strstr(json, pat);
+    if (!p) return 0;
+    p = strchr(p + strlen(pat), ':');
+    if (!p) return 0;
+    p++;
+    while (*p == ' ' || *p == '\t') p++;
+    return strncmp(p, "true", 4) == 0;
+}
+
+// p가 가리키는 '{'에 대응하는 '}' 다음 위치 (문자열 안의 괄호는 무시, 없으면 NULL)
+static const char* json_object_end(const char* p) {
+    int depth = 0;
+    int in_str = 0;
+    for (; *p; p++) {
+        if (in_str) {
+            if (*p == '\\' && p[1]) p++;
+            else if (*p == '"') in_str = 0;
+        } else if (*p == '"') {
+            in_str = 1;
+        } else if (*p == '{') {
+            depth++;
+        } else if (*p == '}') {
+            if (--depth == 0) return p + 1;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * 배치 응답 -> 항목별 결과로 분배
+ * - 전송/HTTP 실패는 모든 항목에 같은 에러
+ * - results[i]가 없거나 ok=false인 항목만 개별 실패
+ */
+static void finish_batch(ai_async_batch_t* b, CURLcode res) {
+    CURL* curl = b->conn->curl;
+    mem_t* mem = &b->conn->mem;
+
+    int64_t latency = now_ms() - b->t0;
+    long http_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, NULL);
+
+    ai_error_t batch_err = AI_OK;
+    char why[128] = {0};
+    if (res != CURLE_OK) {
+        batch_err = (res == CURLE_OPERATION_TIMEDOUT) ? AI_ERR_TIMEOUT : AI_ERR_CURL;
+        snprintf(why, sizeof(why), "curl_error:%s", curl_easy_strerror(res));
+    } else if (http_code < 200 || http_code >= 300) {
+        batch_err = AI_ERR_HTTP;
+        snprintf(why, sizeof(why), "%.*s", (int)sizeof(why) - 1, mem->buf);
+    }
+
+    // 배치 엔드포인트가 없는 API: 배치를 끄고 단건으로 재전송
+    if (http_code == 404) {
+        fprintf(stderr, "[AI_ASYNC] %s returned 404, micro-batching disabled\n", g_cfg.batch_endpoint);
+        g_async.batch_on = 0;
+        conn_release(b->conn);
+        for (int i = 0; i < b->count; i++) async_send_single(b->items[i]);
+        batch_free(b);
+        return;
+    }
+
+    // 배치 1건 = breaker 결과 1건 (가장 늦게 허용된 항목의 epoch: 배치에 probe가 있으면 그 결과)
+    uint32_t epoch = b->items[0]->epoch;
+    for (int i = 1; i < b->count; i++) {
+        if ((int32_t)(b->items[i]->epoch - epoch) > 0) epoch = b->items[i]->epoch;
+    }
+    ai_breaker_record(epoch, breaker_failure(batch_err, (int)http_code), batch_err == AI_ERR_TIMEOUT, latency);
+
+    char mv[64] = {0};
+    const char* cur = NULL;
+    if (batch_err == AI_OK) {
+        json_get_string(mem->buf, "model_version", mv, sizeof(mv));
+        cur = strstr(mem->buf, "\"results\"");
+        if (cur) cur = strchr(cur, '[');
+    }
+
+    for (int i = 0; i < b->count; i++) {
+        ai_async_req_t* req = b->items[i];
+        ai_result_t* out = &req->result;
+        out->latency_ms = latency;
+        out->http_status = (int)http_code;
+
+        if (batch_err != AI_OK) {
+            out->error_code = batch_err;
+            snprintf(out->raw, sizeof(out->raw), "%s", why);
+            async_complete(req, 0);
+            continue;
+        }
+
+        const char* obj = cur ? strchr(cur, '{') : NULL;
+        const char* end = obj ? json_object_end(obj) : NULL;
+        if (!end) {
+            cur = NULL;
+            out->error_code = AI_ERR_PARSE;
+            snprintf(out->raw, sizeof(out->raw), "batch_result_missing");
+            async_complete(req, 0);
+            continue;
+        }
+        cur = end;
+
+        char item[1024];
+        size_t len = (size_t)(end - obj);
+        if (len >= sizeof(item)) len = sizeof(item) - 1;
+        memcpy(item, obj, len);
+        item[len] = '\0';
+
+        double score = 0.0;
+        char label[32] = {0};
+        if (!json_get_true(item, "ok") ||
+            !json_get_double(item, "score", &score) ||
+            !json_get_string(item, "label", label, sizeof(label))) {
+            out->error_code = AI_ERR_PARSE;
+            snprintf(out->raw, sizeof(out->raw), "%.*s", (int)sizeof(out->raw) - 1, item);
+            async_complete(req, 0);
+            continue;
+        }
+
+        out->ok = 1;
+        out->error_code = AI_OK;
+        out->score = score;
+        snprintf(out->label, sizeof(out->label), "%s", label);
+        snprintf(out->model_version, sizeof(out->model_version), "%s", mv);
+        async_complete(req, 1);
+    }
+
+    conn_release(b->conn);
+    batch_free(b);
+}
+
+/* ---------- 비동기 Unix socket (pipelining, 루프 스레드 전용) ---------- */
+
+static struct {
+    int             fd;
+    uint32_t        seq;
+    uint8_t*        wbuf;           // 아직 못 보낸 요청 frame [woff, wlen)
+    size_t          wlen;
+    size_t          woff;
+    size_t          wcap;
+    uint8_t         rbuf[16 * 1024];
+    size_t          rlen;
+    int             hello_wait;     // hello 응답 대기 중 (요청은 hello 뒤에 이어서 보냄)
+    int64_t         hello_deadline;
+    ai_async_req_t* head;           // 응답 대기 (보낸 순서 = 응답 순서)
+    ai_async_req_t* tail;
+} g_uds = { .fd = -1 };
+
+// 연결을 버리고 응답 대기 중인 요청을 모두 같은 에러로 완료
+static void uds_async_reset(ai_error_t code, const char* why) {
+    if (g_uds.fd >= 0) close(g_uds.fd);
+    g_uds.fd = -1;
+    g_uds.wlen = g_uds.woff = 0;
+    g_uds.rlen = 0;
+    g_uds.hello_wait = 0;
+
+    ai_async_req_t* req = g_uds.head;
+    g_uds.head = g_uds.tail = NULL;
+
+    int64_t now = now_ms();
+    while (req) {
+        ai_async_req_t* next = req->next;
+        req->next = NULL;
+        req->result.latency_ms = now - req->t0;
+        req->result.error_code = code;
+        snprintf(req->result.raw, sizeof(req->result.raw), "%s", why);
+        breaker_record_result(&req->result, req->epoch);
+        async_complete(req, 0);
+        req = next;
+    }
+}
+
+static void uds_async_flush(void) {
+    while (g_uds.fd >= 0 && g_uds.woff < g_uds.wlen) {
+        ssize_t n = send(g_uds.fd, g_uds.wbuf + g_uds.woff, g_uds.wlen - g_uds.woff, MSG_NOSIGNAL);
+        if (n > 0) {
+            g_uds.woff += (size_t)n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+        uds_async_reset(AI_ERR_CURL, "uds_send_failed");
+        return;
+    }
+    g_uds.wlen = g_uds.woff = 0;
+}
+
+// 쓰기 버퍼에 need 바이트 확보 (보낸 부분은 앞으로 당김)
+static int uds_wbuf_reserve(size_t need) {
+    if (g_uds.woff > 0) {
+        memmove(g_uds.wbuf, g_uds.wbuf + g_uds.woff, g_uds.wlen - g_uds.woff);
+        g_uds.wlen -= g_uds.woff;
+        g_uds.woff = 0;
+    }
+    if (g_uds.wcap - g_uds.wlen < need) {
+        size_t cap = g_uds.wcap ? g_uds.wcap * 2 : 64 * 1024;
+        uint8_t* nb = (uint8_t*)realloc(g_uds.wbuf, cap);
+        if (!nb) return -1;
+        g_uds.wbuf = nb;
+        g_uds.wcap = cap;
+    }
+    return 0;
+}
+
+/*
+ * 루프 스레드에서 블로킹 없이 연결
+ * - connect는 non-blocking (Unix socket은 즉시 성공/실패)
+ * - hello는 쓰기 버퍼 맨 앞에 넣고 응답은 uds_async_read가 첫 frame 전에 확인
+ * - hello 응답이 connect_timeout_ms 안에 오지 않으면 uds_async_check_timeout이 연결을 버림
+ */
+static int uds_async_open(char* err, size_t errsz) {
+    g_uds.fd = ai_proto_open(g_cfg.uds_path, 1, err, errsz);
+    if (g_uds.fd < 0) return -1;
+
+    if (uds_wbuf_reserve(AI_PROTO_HELLO_MAX) != 0) {
+        snprintf(err, errsz, "uds_alloc_failed");
+        close(g_uds.fd);
+        g_uds.fd = -1;
+        return -1;
+    }
+    g_uds.wlen += ai_proto_encode_hello(g_uds.wbuf + g_uds.wlen, g_uds.wcap - g_uds.wlen, g_cfg.token);
+    g_uds.hello_wait = 1;
+    g_uds.hello_deadline = now_ms() + g_cfg.connect_timeout_ms;
+    return 0;
+}
+
+// 요청 frame을 쓰기 버퍼에 추가 (전송은 uds_async_flush)
+static void uds_async_send(ai_async_req_t* req) {
+    if (g_uds.fd < 0) {
+        char err[128];
+        if (uds_async_open(err, sizeof(err)) != 0) {
+            req->result.error_code = AI_ERR_CURL;
+            snprintf(req->result.raw, sizeof(req->result.raw), "%s", err);
+            breaker_record_result(&req->result, req->epoch);
+            async_complete(req, 0);
+            return;
+        }
+    }
+
+    if (uds_wbuf_reserve(AI_PROTO_REQ_MAX) != 0) {
+        async_fail(req, AI_ERR_CURL, "uds_alloc_failed");
+        return;
+    }
+
+    size_t n = ai_proto_encode_request(g_uds.wbuf + g_uds.wlen, g_uds.wcap - g_uds.wlen,
+                                       g_uds.seq + 1, req->host, req->path, req->request_id);
+    if (n == 0) {
+        async_fail(req, AI_ERR_EMPTY, "request_too_large");
+        return;
+    }
+    g_uds.wlen += n;
+
+    req->seq = ++g_uds.seq;
+    req->t0 = now_ms();
+    req->deadline = req->t0 + ai_breaker_timeout_ms();
+    req->next = NULL;
+    if (g_uds.tail) g_uds.tail->next = req;
+    else g_uds.head = req;
+    g_uds.tail = req;
+}
+
+// 도착한 응답을 보낸 순서대로 완료
+static void uds_async_read(void) {
+    while (g_uds.fd >= 0) {
+        ssize_t n = recv(g_uds.fd, g_uds.rbuf + g_uds.rlen, sizeof(g_uds.rbuf) - g_uds.rlen, 0);
+        if (n == 0) {
+            uds_async_reset(AI_ERR_CURL, "uds_closed");
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN) uds_async_reset(AI_ERR_CURL, "uds_recv_failed");
+            return;
+        }
+        g_uds.rlen += (size_t)n;
+
+        size_t off = 0;
+        if (g_uds.hello_wait) {
+            if (g_uds.rlen < AI_PROTO_HELLO_REPLY) continue;
+            uint16_t status = ai_proto_hello_status(g_uds.rbuf);
+            if (status != 200) {
+                char why[64];
+                snprintf(why, sizeof(why), "uds_hello_status:%u", (unsigned)status);
+                uds_async_reset(AI_ERR_CURL, why);
+                return;
+            }
+            g_uds.hello_wait = 0;
+            off = AI_PROTO_HELLO_REPLY;
+        }
+
+        for (;;) {
+            ai_async_req_t* req = g_uds.head;
+            uint32_t seq = 0;
+            size_t used = 0;
+            ai_result_t r = req ? req->result : (ai_result_t){0};
+            int rc = ai_proto_decode_response(g_uds.rbuf + off, g_uds.rlen - off, &seq, &r, &used);
+            if (rc == 0) break;
+            if (rc < 0 || !req || seq != req->seq) {
+                uds_async_reset(AI_ERR_PARSE, "uds_bad_frame");
+                return;
+            }
+
+            off += used;
+            g_uds.head = req->next;
+            if (!g_uds.head) g_uds.tail = NULL;
+            req->next = NULL;
+
+            req->result = r;
+            req->result.latency_ms = now_ms() - req->t0;
+            breaker_record_result(&req->result, req->epoch);
+            async_complete(req, req->result.ok);
+        }
+
+        if (off > 0) {
+            memmove(g_uds.rbuf, g_uds.rbuf + off, g_uds.rlen - off);
+            g_uds.rlen -= off;
+        }
+    }
+}
+
+// 가장 오래된 요청이 기한을 넘기면 연결째 버림 (뒤 요청의 응답도 그 뒤에 오므로)
+static void uds_async_check_timeout(void) {
+    int64_t now = now_ms();
+    if (g_uds.fd >= 0 && g_uds.hello_wait && now >= g_uds.hello_deadline) uds_async_reset(AI_ERR_CURL, "uds_hello:timeout");
+    else if (g_uds.head && now >= g_uds.head->deadline) uds_async_reset(AI_ERR_TIMEOUT, "uds_timeout");
+}
+
+// 제출 큐 -> multi 등록 (배치 사용 시 배치에 모음)
+static void async_take_queue(int* stopping) {
+    pthread_mutex_lock(&g_async.lock);
+    ai_async_req_t* req = g_async.queue_head;
+    g_async.queue_head = g_async.queue_tail = NULL;
+    *stopping = g_async.stopping;
+    pthread_mutex_unlock(&g_async.lock);
+
+    while (req) {
+        ai_async_req_t* next = req->next;
+        req->next = NULL;
+
+        if (g_async.uds_on) uds_async_send(req);
+        else if (g_async.batch_on) batch_append(req);
+        else async_send_single(req);
+        req = next;
+    }
+
+    if (g_async.batch_count > 0 && (*stopping || now_ms() >= g_async.batch_deadline)) async_flush_batch();
+}
+
+static void async_collect_done(void) {
+    CURLMsg* msg;
+    int left = 0;
+    while ((msg = curl_multi_info_read(g_async.multi, &left)) != NULL) {
+        if (msg->msg != CURLMSG_DONE) continue;
+
+        CURL* curl = msg->easy_handle;
+        CURLcode res = msg->data.result;
+        int* kind = NULL;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&kind);
+        curl_multi_remove_handle(g_async.multi, curl);
+        if (!kind) continue;
+
+        if (*kind == AI_XFER_BATCH) {
+            finish_batch((ai_async_batch_t*)kind, res);
+        } else {
+            ai_async_req_t* req = (ai_async_req_t*)kind;
+            int ok = finish_result(req->conn, res, req->t0, &req->result);
+            breaker_record_result(&req->result, req->epoch);
+            async_complete(req, ok);
+        }
+    }
+}
+
+/*
+ * 완료 콜백 스레드
+ * - thread_begin 결과를 ai_async_start에 알리고, 실패하면 콜백을 받지 않고 종료
+ * - cb_stop 이후에도 done 큐가 빌 때까지 처리
+ */
+static void* async_cb_main(void* arg) {
+    int index = (int)(intptr_t)arg;
+    int rc = g_async.cfg.thread_begin ? g_async.cfg.thread_begin(index) : 0;
+
+    pthread_mutex_lock(&g_async.cb_lock);
+    if (rc != 0) g_async.cb_failed++;
+    else g_async.cb_ready++;
+    pthread_cond_broadcast(&g_async.ctl_cond);
+    pthread_mutex_unlock(&g_async.cb_lock);
+
+    if (rc != 0) {
+        fprintf(stderr, "[AI_ASYNC] callback thread %d init failed\n", index);
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&g_async.cb_lock);
+        while (!g_async.done_head && !g_async.cb_stop) pthread_cond_wait(&g_async.cb_cond, &g_async.cb_lock);
+        ai_async_req_t* req = g_async.done_head;
+        if (req) {
+            g_async.done_head = req->next;
+            if (!g_async.done_head) g_async.done_tail = NULL;
+        }
+        pthread_mutex_unlock(&g_async.cb_lock);
+
+        if (!req) break;
+
+        req->done(req->ok, &req->result, req->ctx);
+        free(req);
+        inflight_release();
+    }
+
+    if (g_async.cfg.thread_end) g_async.cfg.thread_end();
+    return NULL;
+}
+
+// 콜백 스레드 종료 (done 큐는 비운 뒤 종료)
+static void async_cb_stop(void) {
+    pthread_mutex_lock(&g_async.cb_lock);
+    g_async.cb_stop = 1;
+    pthread_cond_broadcast(&g_async.cb_cond);
+    pthread_mutex_unlock(&g_async.cb_lock);
+
+    for (int i = 0; i < g_async.cb_count; i++) pthread_join(g_async.cb_threads[i], NULL);
+    free(g_async.cb_threads);
+    g_async.cb_threads = NULL;
+    g_async.cb_count = 0;
+}
+
+/*
+ * 이벤트 루프 스레드
+ * - 네트워크(curl multi / Unix socket)만 처리, 완료 콜백은 콜백 스레드로 넘김
+ * - 배치는 batch_max개가 모이거나 첫 항목 후 batch_wait_ms가 지나면 전송
+ * - 종료 요청 후에도 진행 중 요청은 끝까지 처리 (각 요청은 timeout_ms로 제한)
+ */
+static void* async_main(void* arg) {
+    (void)arg;
+
+    // 모든 in-flight 요청의 handle을 idle로 유지 (keep-alive 연결은 multi가 보관)
+    t_idle_keep = g_async.cfg.max_inflight;
+
+    for (;;) {
+        int stopping = 0;
+        async_take_queue(&stopping);
+
+        int still_running = 0;
+        curl_multi_perform(g_async.multi, &still_running);
+        async_collect_done();
+
+        if (g_async.uds_on) {
+            uds_async_flush();
+            uds_async_read();
+            uds_async_check_timeout();
+        }
+
+        if (stopping && __atomic_load_n(&g_async.inflight, __ATOMIC_ACQUIRE) == 0) break;
+
+        int wait_ms = 100;
+        if (g_async.batch_count > 0) {
+            int64_t left = g_async.batch_deadline - now_ms();
+            wait_ms = left <= 0 ? 0 : (left < wait_ms ? (int)left : wait_ms);
+        }
+
+        struct curl_waitfd wfd;
+        unsigned int nfds = 0;
+        if (g_async.uds_on && g_uds.fd >= 0) {
+            wfd.fd = g_uds.fd;
+            wfd.events = CURL_WAIT_POLLIN | (g_uds.woff < g_uds.wlen ? CURL_WAIT_POLLOUT : 0);
+            wfd.revents = 0;
+            nfds = 1;
+            if (g_uds.head || g_uds.hello_wait) {
+                int64_t dl = g_uds.head ? g_uds.head->deadline : g_uds.hello_deadline;
+                if (g_uds.hello_wait && g_uds.hello_deadline < dl) dl = g_uds.hello_deadline;
+                int64_t left = dl - now_ms();
+                wait_ms = left <= 0 ? 0 : (left < wait_ms ? (int)left : wait_ms);
+            }
+        }
+        curl_multi_poll(g_async.multi, nfds ? &wfd : NULL, nfds, wait_ms, NULL);
+    }
+
+    if (g_uds.fd >= 0) close(g_uds.fd);
+    g_uds.fd = -1;
+    g_uds.hello_wait = 0;
+    free(g_uds.wbuf);
+    g_uds.wbuf = NULL;
+    g_uds.wlen = g_uds.woff = g_uds.wcap = 0;
+
+    ai_client_thread_cleanup();
+    return NULL;
+}
+
+int ai_async_start(const ai_async_config_t* cfg) {
+    if (!cfg || cfg->max_inflight <= 0 || !g_inited || g_async.running) return -1;
+
+    g_async.cfg = *cfg;
+    g_async.multi = curl_multi_init();
+    if (!g_async.multi) return -1;
+
+    // 동시 요청 수만큼 연결 유지 (HTTP/1.1 keep-alive, 요청 완료 후 다음 요청이 재사용)
+    curl_multi_setopt(g_async.multi, CURLMOPT_MAXCONNECTS, (long)cfg->max_inflight);
+
+    g_async.uds_on = (g_cfg.uds_path[0] != '\0');
+    g_async.batch_on = (!g_async.uds_on && cfg->batch_max > 1 && g_cfg.batch_endpoint[0] != '\0');
+    if (g_async.cfg.batch_wait_ms < 0) g_async.cfg.batch_wait_ms = 0;
+
+    g_async.stopping = 0;
+    g_async.inflight = 0;
+
+    // 콜백 스레드 먼저: 모두 thread_begin에 성공해야 시작
+    int nthreads = cfg->callback_threads > 0 ? cfg->callback_threads : 1;
+    g_async.cb_threads = (pthread_t*)calloc((size_t)nthreads, sizeof(pthread_t));
+    g_async.cb_count = 0;
+    g_async.cb_ready = 0;
+    g_async.cb_failed = 0;
+    g_async.cb_stop = 0;
+
+    for (int i = 0; g_async.cb_threads && i < nthreads; i++) {
+        if (pthread_create(&g_async.cb_threads[i], NULL, async_cb_main, (void*)(intptr_t)i) != 0) break;
+        g_async.cb_count++;
+    }
+
+    pthread_mutex_lock(&g_async.cb_lock);
+    while (g_async.cb_ready + g_async.cb_failed < g_async.cb_count) {
+        pthread_cond_wait(&g_async.ctl_cond, &g_async.cb_lock);
+    }
+    int cb_ok = (g_async.cb_count == nthreads && g_async.cb_failed == 0);
+    pthread_mutex_unlock(&g_async.cb_lock);
+
+    if (!cb_ok || pthread_create(&g_async.thread, NULL, async_main, NULL) != 0) {
+        async_cb_stop();
+        curl_multi_cleanup(g_async.multi);
+        g_async.multi = NULL;
+        return -1;
+    }
+    g_async.running = 1;
+
+    if (g_async.uds_on) {
+        fprintf(stderr, "[AI_ASYNC] started max_inflight=%d callback_threads=%d transport=uds path=%s (pipelined)\n",
+                cfg->max_inflight, nthreads, g_cfg.uds_path);
+    } else if (g_async.batch_on) {
+        fprintf(stderr, "[AI_ASYNC] started max_inflight=%d callback_threads=%d batch_max=%d batch_wait=%dms endpoint=%s\n",
+                cfg->max_inflight, nthreads, cfg->batch_max, g_async.cfg.batch_wait_ms, g_cfg.batch_endpoint);
+    } else {
+        fprintf(stderr, "[AI_ASYNC] started max_inflight=%d callback_threads=%d (no batching)\n",
+                cfg->max_inflight, nthreads);
+    }
+    return 0;
+}
+
+void ai_async_stop(void) {
+    if (!g_async.running) return;
+
+    pthread_mutex_lock(&g_async.lock);
+    g_async.stopping = 1;
+    pthread_mutex_unlock(&g_async.lock);
+    curl_multi_wakeup(g_async.multi);
+
+    pthread_join(g_async.thread, NULL);
+    async_cb_stop();
+    g_async.running = 0;
+
+    curl_multi_cleanup(g_async.multi);
+    g_async.multi = NULL;
+}
+
+int ai_async_enabled(void) {
+    return g_async.running;
+}
+
+int ai_async_inflight(void) {
+    return __atomic_load_n(&g_async.inflight, __ATOMIC_ACQUIRE);
+}
+
+void ai_async_drain(void) {
+    if (!g_async.running) return;
+
+    pthread_mutex_lock(&g_async.cb_lock);
+    while (__atomic_load_n(&g_async.inflight, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_wait(&g_async.ctl_cond, &g_async.cb_lock);
+    }
+    pthread_mutex_unlock(&g_async.cb_lock);
+}
+
+int ai_classify_url_async(const HttpEvent* ev, const char* request_id, ai_classify_done_fn done, void* ctx) {
+    if (!g_async.running || !done) return AI_ASYNC_REJECTED;
+
+    ai_async_req_t* req = (ai_async_req_t*)calloc(1, sizeof(ai_async_req_t));
+    if (!req) return AI_ASYNC_REJECTED;
+
+    req->kind = AI_XFER_SINGLE;
+    out_reset(&req->result);
+    req->done = done;
+    req->ctx = ctx;
+
+    // 요청 자체가 잘못된 경우도 콜백으로 완료 (호출자 경로를 하나로 유지)
+    int valid = g_cfg.uds_path[0] ? validate_event(ev, &req->result)
+                                  : build_payload(ev, request_id, req->payload, sizeof(req->payload), &req->result);
+    if (valid) {
+        snprintf(req->request_id, sizeof(req->request_id), "%s", request_id ? request_id : "");
+        snprintf(req->host, sizeof(req->host), "%s", ev->host);
+        snprintf(req->path, sizeof(req->path), "%s", ev->path[0] ? ev->path : "/");
+    }
+
+    // 같은 URL이 진행 중이면 follower로 붙음 (요청 없음, in-flight 한도와 무관)
+    char url[URL_FEATURES_URL_MAX];
+    uint64_t hash = 0;
+    if (valid && flight_key(ev, url, sizeof(url), &hash)) {
+        pthread_mutex_lock(&g_flight_lock);
+        ai_flight_t* f = flight_find_locked(hash, url);
+        if (f) {
+            req->next = f->followers;
+            f->followers = req;
+            __atomic_add_fetch(&g_async.inflight, 1, __ATOMIC_ACQ_REL);
+            pthread_mutex_unlock(&g_flight_lock);
+            engine_metrics_count(EM_COUNT_AI_COALESCED, 1);
+            return AI_ASYNC_QUEUED;
+        }
+        req->flight = flight_open_locked(hash, url);
+        pthread_mutex_unlock(&g_flight_lock);
+    }
+
+    // 한도 확인과 예약을 한 번에 (초과 시 즉시 거절 -> 호출자가 backpressure 처리)
+    // 배치 대기 중인 항목도 in-flight로 셈. breaker보다 먼저 확인해 BUSY가 HALF_OPEN probe를 쓰지 않게 함
+    int cur = __atomic_load_n(&g_async.inflight, __ATOMIC_RELAXED);
+    int busy = 0;
+    do {
+        if (cur >= g_async.cfg.max_inflight) {
+            busy = 1;
+            break;
+        }
+    } while (!__atomic_compare_exchange_n(&g_async.inflight, &cur, cur + 1, 1,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    // breaker OPEN: 보내지 않고 잘못된 요청과 같은 경로로 즉시 콜백
+    if (valid && !busy) {
+        int allow = ai_breaker_allow(&req->epoch);
+        if (!allow) {
+            set_circuit_open(&req->result);
+            valid = 0;
+        }
+        req->probe = (allow == AI_BREAKER_PROBE);
+    }
+
+    pthread_mutex_lock(&g_async.lock);
+    int rc = busy ? AI_ASYNC_BUSY : (g_async.stopping ? AI_ASYNC_REJECTED : AI_ASYNC_QUEUED);
+    if (rc == AI_ASYNC_QUEUED && valid) {
+        if (g_async.queue_tail) g_async.queue_tail->next = req;
+        else g_async.queue_head = req;
+        g_async.queue_tail = req;
+    }
+    pthread_mutex_unlock(&g_async.lock);
+
+    if (rc != AI_ASYNC_QUEUED) {
+        // 요청하지 못함: 그 사이 붙은 follower도 같은 이유로 실패 처리
+        if (req->probe) ai_breaker_release_probe();
+        if (!busy) inflight_release();
+        req->result.error_code = (rc == AI_ASYNC_BUSY) ? AI_ERR_BUSY : AI_ERR_CURL;
+        snprintf(req->result.raw, sizeof(req->result.raw), "%s", busy ? "ai_inflight_limit" : "ai_async_stopping");
+        flight_finish(req->flight, 0, &req->result);
+        free(req);
+        return rc;
+    }
+
+    if (!valid) {
+        async_complete(req, 0);
+        return AI_ASYNC_QUEUED;
+    }
+
+    curl_multi_wakeup(g_async.multi);
+    return AI_ASYNC_QUEUED;
+}
+
 int ai_classify_url(const HttpEvent* ev, ai_result_t* out) {
     // 기존 호출부 호환: request_id 없이 호출
     return ai_classify_url_ex(ev, NULL, out);
@@ -0,0 +1,373 @@
+// src/url_features.c
+#include "url_features.h"
+
+#include <string.h>
+#include <strings.h>
+
+static const char* const g_feature_names[UF_COUNT] = {
+    "url_length", "host_length", "path_length", "query_length",
+    "slash_count", "dot_count", "hyphen_count", "underscore_count",
+    "question_mark_count", "ampersand_count", "equal_count", "digit_count",
+    "special_char_count", "suspicious_keyword_hits", "host_suspicious_keyword_hits",
+    "path_suspicious_keyword_hits", "query_suspicious_keyword_hits", "brand_keyword_hits",
+    "has_brand_keyword", "brand_suspicious_combo", "has_suspicious_extension", "has_query",
+    "is_ipv4_host", "subdomain_count", "host_dot_count", "host_hyphen_count",
+    "path_hyphen_count", "query_param_count", "tld_length", "is_suspicious_tld",
+    "has_long_host", "has_many_subdomains", "has_at_symbol", "double_slash_in_path",
+    "contains_hex_like_token"
+};
+
+static const char* const SUSPICIOUS_KEYWORDS[] = {
+    "login", "admin", "signin", "verify", "update", "payment", "secure", "account", "token",
+    "reset", "confirm", "bank", "wallet", "free", "bonus", "download", "exe", "apk", NULL
+};
+
+static const char* const BRAND_KEYWORDS[] = {
+    "paypal", "google", "apple", "microsoft", "naver", "kakao", "facebook", "instagram",
+    "amazon", "netflix", "telegram", "whatsapp", "bank", "woori", "kb", "shinhan", "hana", "nh", NULL
+};
+
+static const char* const QUERY_SUSPICIOUS_KEYWORDS[] = {
+    "redirect", "return", "continue", "next", "target", "session", "token", "auth", "key",
+    "login", "verify", NULL
+};
+
+static const char* const SUSPICIOUS_EXTENSIONS[] = {
+    ".exe", ".apk", ".zip", ".rar", ".scr", ".bat", ".js", NULL
+};
+
+static const char* const SUSPICIOUS_TLDS[] = {
+    "xyz", "top", "click", "work", "shop", "info", "support", "live", "buzz", NULL
+};
+
+int url_features_isspace(unsigned char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r') || (c >= 0x1c && c <= 0x1f);
+}
+
+const char* url_feature_name(url_feature_t f)
+{
+    return (f >= 0 && f < UF_COUNT) ? g_feature_names[f] : "";
+}
+
+int url_feature_find(const char* name, size_t maxlen)
+{
+    for (int f = 0; f < UF_COUNT; f++) {
+        if (strncmp(name, g_feature_names[f], maxlen) == 0) return f;
+    }
+    return -1;
+}
+
+typedef struct {
+    const char* p;
+    size_t      n;
+} span_t;
+
+static int span_contains(span_t s, const char* kw)
+{
+    size_t k = strlen(kw);
+    if (k > s.n) return 0;
+    for (size_t i = 0; i + k <= s.n; i++) {
+        if (memcmp(s.p + i, kw, k) == 0) return 1;
+    }
+    return 0;
+}
+
+static int keyword_hits(span_t s, const char* const* kws)
+{
+    int hits = 0;
+    for (; *kws; kws++) hits += span_contains(s, *kws);
+    return hits;
+}
+
+static int count_byte(span_t s, char c)
+{
+    int n = 0;
+    for (size_t i = 0; i < s.n; i++) n += (s.p[i] == c);
+    return n;
+}
+
+// ^(?:\d{1,3}\.){3}\d{1,3}$
+static int is_ipv4(span_t s)
+{
+    size_t i = 0;
+    for (int part = 0; part < 4; part++) {
+        size_t d = 0;
+        while (i < s.n && s.p[i] >= '0' && s.p[i] <= '9' && d < 3) {
+            i++;
+            d++;
+        }
+        if (d == 0) return 0;
+        if (part < 3) {
+            if (i >= s.n || s.p[i] != '.') return 0;
+            i++;
+        }
+    }
+    return i == s.n;
+}
+
+// '.'으로 나눈 비어 있지 않은 조각 수, 마지막 조각
+static int host_parts(span_t host, span_t* last)
+{
+    int parts = 0;
+    size_t i = 0;
+    while (i < host.n) {
+        while (i < host.n && host.p[i] == '.') i++;
+        if (i >= host.n) break;
+        size_t b = i;
+        while (i < host.n && host.p[i] != '.') i++;
+        parts++;
+        last->p = host.p + b;
+        last->n = i - b;
+    }
+    return parts;
+}
+
+static int hexval(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// unquote(name.replace('+', ' '))
+static size_t qs_unquote(span_t s, char* out, size_t cap)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < s.n && n < cap; i++) {
+        char c = s.p[i];
+        if (c == '+') {
+            c = ' ';
+        } else if (c == '%' && i + 2 < s.n && hexval(s.p[i + 1]) >= 0 && hexval(s.p[i + 2]) >= 0) {
+            c = (char)(hexval(s.p[i + 1]) * 16 + hexval(s.p[i + 2]));
+            i += 2;
+        }
+        out[n++] = c;
+    }
+    return n;
+}
+
+// len(parse_qs(query, keep_blank_values=True)): '&'로 나눈 비어 있지 않은 항목의 서로 다른 이름 수
+static int query_param_count(span_t q)
+{
+    char names[64][64];
+    size_t lens[64];
+    int count = 0;
+
+    size_t i = 0;
+    while (i <= q.n && count < 64) {
+        size_t b = i;
+        while (i < q.n && q.p[i] != '&') i++;
+        span_t item = { q.p + b, i - b };
+        i++;
+        if (item.n == 0) continue;
+
+        size_t eq = 0;
+        while (eq < item.n && item.p[eq] != '=') eq++;
+
+        char name[64];
+        size_t len = qs_unquote((span_t){ item.p, eq }, name, sizeof(name));
+
+        int dup = 0;
+        for (int k = 0; k < count && !dup; k++) dup = (lens[k] == len && memcmp(names[k], name, len) == 0);
+        if (dup) continue;
+
+        memcpy(names[count], name, len);
+        lens[count++] = len;
+    }
+    return count;
+}
+
+static int contains_hex_run(span_t s)
+{
+    int run = 0;
+    for (size_t i = 0; i < s.n; i++) {
+        char c = s.p[i];
+        run = ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')) ? run + 1 : 0;
+        if (run >= 12) return 1;
+    }
+    return 0;
+}
+
+static int ends_with_any(span_t s, const char* const* list)
+{
+    for (; *list; list++) {
+        size_t k = strlen(*list);
+        if (k <= s.n && memcmp(s.p + s.n - k, *list, k) == 0) return 1;
+    }
+    return 0;
+}
+
+/*
+ * build_url(host, path): strip/lower, path 기본값 "/", 선행 '/' 보장, scheme 없으면 "http://"
+ * 반환: url 길이 (0이면 버퍼 부족)
+ */
+size_t url_features_build_url(const char* host, const char* path, char* url, size_t cap)
+{
+    const char* hb = host;
+    const char* he = host + strlen(host);
+    while (hb < he && url_features_isspace((unsigned char)*hb)) hb++;
+    while (he > hb && url_features_isspace((unsigned char)he[-1])) he--;
+
+    const char* pb = path;
+    const char* pe = path + strlen(path);
+    while (pb < pe && url_features_isspace((unsigned char)*pb)) pb++;
+    while (pe > pb && url_features_isspace((unsigned char)pe[-1])) pe--;
+
+    char tmp[URL_FEATURES_URL_MAX];
+    size_t n = 0;
+    size_t hl = (size_t)(he - hb);
+    size_t pl = (size_t)(pe - pb);
+    if (hl + pl + 2 > sizeof(tmp)) return 0;
+
+    memcpy(tmp, hb, hl);
+    n = hl;
+    if (pl == 0 || *pb != '/') tmp[n++] = '/';
+    memcpy(tmp + n, pb, pl);
+    n += pl;
+
+    // normalize_url: 전체 strip + lower
+    size_t b = 0;
+    while (b < n && url_features_isspace((unsigned char)tmp[b])) b++;
+    while (n > b && url_features_isspace((unsigned char)tmp[n - 1])) n--;
+
+    size_t len = n - b;
+    int has_scheme = (len >= 7 && strncasecmp(tmp + b, "http://", 7) == 0) ||
+                     (len >= 8 && strncasecmp(tmp + b, "https://", 8) == 0);
+    size_t prefix = has_scheme ? 0 : 7;
+    if (prefix + len + 1 > cap) return 0;
+
+    memcpy(url, "http://", prefix);
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)tmp[b + i];
+        url[prefix + i] = (char)((c >= 'A' && c <= 'Z') ? c + 32 : c);
+    }
+    url[prefix + len] = '\0';
+    return prefix + len;
+}
+
+/*
+ * urlparse 결과 (host=netloc, path, query), 파싱 실패 시 모두 빈 값
+ * - urlsplit처럼 \t \r \n 제거 후 분리 (clean은 호출자 버퍼)
+ */
+static void split_url(const char* url, size_t len, char* clean, span_t* host, span_t* path, span_t* query)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (url[i] != '\t' && url[i] != '\r' && url[i] != '\n') clean[n++] = url[i];
+    }
+    clean[n] = '\0';
+
+    host->p = path->p = query->p = clean;
+    host->n = path->n = query->n = 0;
+
+    const char* p = strstr(clean, "://");
+    if (!p) return;
+    p += 3;
+    const char* end = clean + n;
+
+    const char* hb = p;
+    while (p < end && *p != '/' && *p != '?' && *p != '#') p++;
+    span_t h = { hb, (size_t)(p - hb) };
+
+    // 대괄호 짝이 맞지 않는 netloc은 ValueError
+    int open = span_contains(h, "[");
+    int close = span_contains(h, "]");
+    if (open != close) return;
+
+    const char* frag = memchr(p, '#', (size_t)(end - p));
+    if (frag) end = frag;
+
+    const char* q = memchr(p, '?', (size_t)(end - p));
+    *host = h;
+    path->p = p;
+    path->n = (size_t)((q ? q : end) - p);
+    if (q) {
+        query->p = q + 1;
+        query->n = (size_t)(end - q - 1);
+    }
+}
+
+void url_features_compute(const char* url, size_t url_len, double* f)
+{
+    char clean[URL_FEATURES_URL_MAX];
+    span_t host, path, query;
+    split_url(url, url_len, clean, &host, &path, &query);
+
+    // full_text = f"{host}{path}?{query}"
+    char full[URL_FEATURES_URL_MAX + 1];
+    size_t fl = 0;
+    memcpy(full + fl, host.p, host.n);
+    fl += host.n;
+    memcpy(full + fl, path.p, path.n);
+    fl += path.n;
+    full[fl++] = '?';
+    memcpy(full + fl, query.p, query.n);
+    fl += query.n;
+    span_t full_text = { full, fl };
+    span_t u = { url, url_len };
+
+    int digits = 0;
+    int special = 0;
+    for (size_t i = 0; i < url_len; i++) {
+        unsigned char c = (unsigned char)url[i];
+        int alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        int digit = (c >= '0' && c <= '9');
+        digits += digit;
+        special += !(alpha || digit);
+    }
+
+    span_t tld = { "", 0 };
+    int parts = host_parts(host, &tld);
+    if (parts < 2) tld.n = 0;
+    int subdomains = parts > 2 ? parts - 2 : 0;
+
+    int host_hits = keyword_hits(host, SUSPICIOUS_KEYWORDS);
+    int path_hits = keyword_hits(path, SUSPICIOUS_KEYWORDS);
+    int query_hits = keyword_hits(query, QUERY_SUSPICIOUS_KEYWORDS);
+    int brand_hits = keyword_hits(host, BRAND_KEYWORDS) + keyword_hits(path, BRAND_KEYWORDS);
+    int has_brand = brand_hits > 0;
+    int has_suspicious = host_hits + path_hits + query_hits > 0;
+
+    int suspicious_tld = 0;
+    for (const char* const* t = SUSPICIOUS_TLDS; *t && !suspicious_tld; t++) {
+        suspicious_tld = (strlen(*t) == tld.n && memcmp(*t, tld.p, tld.n) == 0);
+    }
+
+    f[UF_URL_LENGTH] = (double)url_len;
+    f[UF_HOST_LENGTH] = (double)host.n;
+    f[UF_PATH_LENGTH] = (double)path.n;
+    f[UF_QUERY_LENGTH] = (double)query.n;
+    f[UF_SLASH_COUNT] = count_byte(u, '/');
+    f[UF_DOT_COUNT] = count_byte(u, '.');
+    f[UF_HYPHEN_COUNT] = count_byte(u, '-');
+    f[UF_UNDERSCORE_COUNT] = count_byte(u, '_');
+    f[UF_QUESTION_MARK_COUNT] = count_byte(u, '?');
+    f[UF_AMPERSAND_COUNT] = count_byte(u, '&');
+    f[UF_EQUAL_COUNT] = count_byte(u, '=');
+    f[UF_DIGIT_COUNT] = digits;
+    f[UF_SPECIAL_CHAR_COUNT] = special;
+    f[UF_SUSPICIOUS_KEYWORD_HITS] = keyword_hits(full_text, SUSPICIOUS_KEYWORDS);
+    f[UF_HOST_SUSPICIOUS_KEYWORD_HITS] = host_hits;
+    f[UF_PATH_SUSPICIOUS_KEYWORD_HITS] = path_hits;
+    f[UF_QUERY_SUSPICIOUS_KEYWORD_HITS] = query_hits;
+    f[UF_BRAND_KEYWORD_HITS] = brand_hits;
+    f[UF_HAS_BRAND_KEYWORD] = has_brand;
+    f[UF_BRAND_SUSPICIOUS_COMBO] = has_brand && has_suspicious;
+    f[UF_HAS_SUSPICIOUS_EXTENSION] = ends_with_any(path, SUSPICIOUS_EXTENSIONS);
+    f[UF_HAS_QUERY] = query.n > 0;
+    f[UF_IS_IPV4_HOST] = is_ipv4(host);
+    f[UF_SUBDOMAIN_COUNT] = subdomains;
+    f[UF_HOST_DOT_COUNT] = count_byte(host, '.');
+    f[UF_HOST_HYPHEN_COUNT] = count_byte(host, '-');
+    f[UF_PATH_HYPHEN_COUNT] = count_byte(path, '-');
+    f[UF_QUERY_PARAM_COUNT] = query_param_count(query);
+    f[UF_TLD_LENGTH] = (double)tld.n;
+    f[UF_IS_SUSPICIOUS_TLD] = suspicious_tld;
+    f[UF_HAS_LONG_HOST] = host.n >= 25;
+    f[UF_HAS_MANY_SUBDOMAINS] = subdomains >= 2;
+    f[UF_HAS_AT_SYMBOL] = memchr(url, '@', url_len) != NULL;
+    f[UF_DOUBLE_SLASH_IN_PATH] = span_contains(path, "//");
+    f[UF_CONTAINS_HEX_LIKE_TOKEN] = contains_hex_run(full_text);
+}
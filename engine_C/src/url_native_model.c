@@ -0,0 +1,405 @@
+// src/url_native_model.c
+#include "url_native_model.h"
+#include "url_features.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NM_MAGIC        "GGNMODL"
+#define NM_ENDIAN_TAG   0x01020304u
+#define NM_LABEL_SIZE   32
+#define NM_NAME_SIZE    48
+#define NM_MAX_CLASSES  16
+#define NM_MAX_NGRAM    16
+
+#define NM_PROB_BINARY  0   // sigmoid(d), proba = [1-p, p]
+#define NM_PROB_SOFTMAX 1   // softmax (coef 1행이면 [-d, d])
+#define NM_PROB_OVR     2   // 클래스별 sigmoid 후 합으로 정규화
+
+// extract_to_file.py build_native_model_bytes와 같은 배치 (little-endian, 120 byte)
+typedef struct {
+    char     magic[8];
+    uint32_t format_version;
+    uint32_t endian_tag;
+    uint32_t class_count;
+    uint32_t benign_index;
+    uint32_t ngram_min;
+    uint32_t ngram_max;
+    uint32_t vocab_count;
+    uint32_t numeric_count;
+    uint32_t coef_rows;
+    uint32_t prob_mode;
+    uint32_t crc32;         // header 뒤 본문 전체
+    uint32_t reserved;
+    char     model_version[64];
+} nm_header_t;
+
+/* ---------- 모델 ---------- */
+
+typedef struct {
+    uint8_t*        buf;            // 파일 전체 (아래 배열은 모두 buf 내부를 가리킴)
+    const nm_header_t* h;
+    const char*     labels;         // class_count * NM_LABEL_SIZE
+    int             numeric_ids[UF_COUNT];
+    const uint32_t* term_off;       // vocab_count + 1
+    const char*     term_blob;
+    const double*   idf;
+    const double*   coef;           // coef_rows * feature_count (행 우선)
+    const double*   intercept;
+    uint32_t        feature_count;
+
+    uint32_t*       slots;          // vocabulary 해시 (term index + 1, 0이면 빈 칸)
+    uint32_t        slot_mask;
+} nm_model_t;
+
+static nm_model_t* g_model = NULL;
+static uint32_t term_hash(const char* s, size_t n)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t crc32_ieee(const uint8_t* p, size_t len)
+{
+    static uint32_t table[256];
+    if (table[1] == 0) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            table[i] = c;
+        }
+    }
+
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--) crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void model_free(nm_model_t* m)
+{
+    if (!m) return;
+    free(m->slots);
+    free(m->buf);
+    free(m);
+}
+
+static int build_vocab_slots(nm_model_t* m)
+{
+    uint32_t n = m->h->vocab_count;
+    uint32_t cap = 16;
+    while (cap < n * 2) cap <<= 1;
+
+    m->slots = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    if (!m->slots) return -1;
+    m->slot_mask = cap - 1;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const char* t = m->term_blob + m->term_off[i];
+        size_t len = m->term_off[i + 1] - m->term_off[i];
+        uint32_t s = term_hash(t, len) & m->slot_mask;
+        while (m->slots[s]) s = (s + 1) & m->slot_mask;
+        m->slots[s] = i + 1;
+    }
+    return 0;
+}
+
+static int64_t vocab_find(const nm_model_t* m, const char* s, size_t n)
+{
+    uint32_t k = term_hash(s, n) & m->slot_mask;
+    for (uint32_t v; (v = m->slots[k]) != 0; k = (k + 1) & m->slot_mask) {
+        uint32_t i = v - 1;
+        if (m->term_off[i + 1] - m->term_off[i] == n && memcmp(m->term_blob + m->term_off[i], s, n) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 본문 구획 (header 뒤 순서대로, 길이 검증 포함)
+static const char* parse_body(nm_model_t* m, size_t file_size)
+{
+    const nm_header_t* h = m->h;
+    size_t off = sizeof(nm_header_t);
+
+    m->labels = (const char*)(m->buf + off);
+    off += (size_t)h->class_count * NM_LABEL_SIZE;
+
+    const char* names = (const char*)(m->buf + off);
+    off += (size_t)h->numeric_count * NM_NAME_SIZE;
+
+    if (off + ((size_t)h->vocab_count + 1) * sizeof(uint32_t) > file_size) return "truncated vocab";
+    m->term_off = (const uint32_t*)(m->buf + off);
+    off += ((size_t)h->vocab_count + 1) * sizeof(uint32_t);
+    m->term_blob = (const char*)(m->buf + off);
+    off += m->term_off[h->vocab_count];
+    off = (off + 7) & ~(size_t)7;
+
+    for (uint32_t i = 0; i < h->vocab_count; i++) {
+        if (m->term_off[i] > m->term_off[i + 1]) return "bad vocab offsets";
+    }
+
+    m->feature_count = h->vocab_count + h->numeric_count;
+    m->idf = (const double*)(m->buf + off);
+    off += (size_t)h->vocab_count * sizeof(double);
+    m->coef = (const double*)(m->buf + off);
+    off += (size_t)h->coef_rows * m->feature_count * sizeof(double);
+    m->intercept = (const double*)(m->buf + off);
+    off += (size_t)h->coef_rows * sizeof(double);
+
+    if (off != file_size) return "size mismatch";
+
+    for (uint32_t k = 0; k < h->numeric_count; k++) {
+        const char* name = names + (size_t)k * NM_NAME_SIZE;
+        int id = url_feature_find(name, NM_NAME_SIZE);
+        if (id < 0) {
+            fprintf(stderr, "[AI_NATIVE] unknown numeric feature: %.*s\n", NM_NAME_SIZE, name);
+            return "unknown numeric feature";
+        }
+        m->numeric_ids[k] = id;
+    }
+    return NULL;
+}
+
+int url_native_model_load(const char* path)
+{
+    if (!path || !path[0]) return -1;
+
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "[AI_NATIVE] open failed: %s\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    nm_model_t* m = (nm_model_t*)calloc(1, sizeof(nm_model_t));
+    if (m && size > 0) m->buf = (uint8_t*)malloc((size_t)size);
+
+    const char* why = NULL;
+    if (!m || !m->buf) why = "out of memory";
+    else if ((size_t)size < sizeof(nm_header_t)) why = "file too small";
+    else if (fread(m->buf, 1, (size_t)size, fp) != (size_t)size) why = "read failed";
+    fclose(fp);
+
+    if (!why) {
+        const nm_header_t* h = (const nm_header_t*)m->buf;
+        m->h = h;
+
+        if (memcmp(h->magic, NM_MAGIC, sizeof(NM_MAGIC)) != 0) why = "bad magic";
+        else if (h->format_version != URL_NATIVE_MODEL_VERSION) why = "format version mismatch";
+        else if (h->endian_tag != NM_ENDIAN_TAG) why = "endian mismatch";
+        else if (h->class_count < 2 || h->class_count > NM_MAX_CLASSES || h->benign_index >= h->class_count) why = "bad classes";
+        // 단일 행(coef_rows==1)은 이진 분류에서만 허용 (to_proba가 p[0..1]만 채움)
+        else if (h->coef_rows != h->class_count && !(h->coef_rows == 1 && h->class_count == 2)) why = "bad coef rows";
+        else if (h->prob_mode > NM_PROB_OVR) why = "bad prob mode";
+        else if (h->ngram_min < 1 || h->ngram_min > h->ngram_max || h->ngram_max > NM_MAX_NGRAM) why = "bad ngram range";
+        else if (h->numeric_count > UF_COUNT) why = "too many numeric features";
+        else if (crc32_ieee(m->buf + sizeof(nm_header_t), (size_t)size - sizeof(nm_header_t)) != h->crc32) why = "checksum mismatch";
+        else why = parse_body(m, (size_t)size);
+    }
+
+    if (!why && build_vocab_slots(m) != 0) why = "out of memory";
+
+    if (why) {
+        fprintf(stderr, "[AI_NATIVE] load rejected (%s): %s\n", why, path);
+        model_free(m);
+        return -1;
+    }
+
+    model_free(g_model);
+    g_model = m;
+
+    fprintf(stderr, "[AI_NATIVE] loaded %s model_version=%.*s vocab=%u numeric=%u classes=%u ngram=%u-%u\n",
+            path, (int)sizeof(m->h->model_version), m->h->model_version,
+            m->h->vocab_count, m->h->numeric_count, m->h->class_count,
+            m->h->ngram_min, m->h->ngram_max);
+    return 0;
+}
+
+void url_native_model_unload(void)
+{
+    model_free(g_model);
+    g_model = NULL;
+}
+
+int url_native_model_loaded(void)
+{
+    return g_model != NULL;
+}
+/* ---------- 점수 ---------- */
+
+static int cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static double sigmoid(double d)
+{
+    if (d >= 0) return 1.0 / (1.0 + exp(-d));
+    double e = exp(d);
+    return e / (1.0 + e);
+}
+
+/*
+ * TF-IDF(char n-gram, l2) + numeric -> 클래스별 decision 값
+ * - analyzer: 공백 2개 이상을 공백 1개로 줄인 뒤 n-gram
+ * - vocabulary에 없는 n-gram은 무시, 같은 n-gram은 count로 합산
+ */
+static int decision_values(const nm_model_t* m, const char* url, size_t url_len, double* acc)
+{
+    const nm_header_t* h = m->h;
+
+    char text[URL_FEATURES_URL_MAX];
+    size_t tl = 0;
+    for (size_t i = 0; i < url_len; i++) {
+        if (url_features_isspace((unsigned char)url[i]) && i + 1 < url_len && url_features_isspace((unsigned char)url[i + 1])) {
+            while (i + 1 < url_len && url_features_isspace((unsigned char)url[i + 1])) i++;
+            text[tl++] = ' ';
+        } else {
+            text[tl++] = url[i];
+        }
+    }
+
+    uint32_t local[2048];
+    size_t cap = (size_t)(h->ngram_max - h->ngram_min + 1) * tl;
+    uint32_t* hits = cap <= sizeof(local) / sizeof(local[0]) ? local : (uint32_t*)malloc(cap * sizeof(uint32_t));
+    if (!hits) return 0;
+
+    size_t nh = 0;
+    for (uint32_t n = h->ngram_min; n <= h->ngram_max && n <= tl; n++) {
+        for (size_t i = 0; i + n <= tl; i++) {
+            int64_t idx = vocab_find(m, text + i, n);
+            if (idx >= 0) hits[nh++] = (uint32_t)idx;
+        }
+    }
+    qsort(hits, nh, sizeof(uint32_t), cmp_u32);
+
+    uint32_t rows = h->coef_rows;
+    for (uint32_t r = 0; r < rows; r++) acc[r] = 0.0;
+
+    double norm2 = 0.0;
+    for (size_t i = 0; i < nh;) {
+        uint32_t idx = hits[i];
+        size_t j = i;
+        while (j < nh && hits[j] == idx) j++;
+
+        double v = (double)(j - i) * m->idf[idx];
+        norm2 += v * v;
+        for (uint32_t r = 0; r < rows; r++) acc[r] += v * m->coef[(size_t)r * m->feature_count + idx];
+        i = j;
+    }
+    if (hits != local) free(hits);
+
+    double inv = norm2 > 0.0 ? 1.0 / sqrt(norm2) : 0.0;
+    for (uint32_t r = 0; r < rows; r++) acc[r] *= inv;
+
+    double f[UF_COUNT];
+    url_features_compute(url, url_len, f);
+
+    for (uint32_t k = 0; k < h->numeric_count; k++) {
+        double x = f[m->numeric_ids[k]];
+        if (x == 0.0) continue;
+        for (uint32_t r = 0; r < rows; r++) {
+            acc[r] += x * m->coef[(size_t)r * m->feature_count + h->vocab_count + k];
+        }
+    }
+
+    for (uint32_t r = 0; r < rows; r++) acc[r] += m->intercept[r];
+    return 1;
+}
+
+// LogisticRegression.predict_proba와 같은 변환
+static void to_proba(const nm_header_t* h, const double* d, double* p)
+{
+    uint32_t k = h->class_count;
+
+    if (h->coef_rows == 1) {
+        double p1 = (h->prob_mode == NM_PROB_SOFTMAX) ? sigmoid(2.0 * d[0]) : sigmoid(d[0]);
+        p[0] = 1.0 - p1;
+        p[1] = p1;
+        return;
+    }
+
+    if (h->prob_mode == NM_PROB_SOFTMAX) {
+        double mx = d[0];
+        for (uint32_t i = 1; i < k; i++) if (d[i] > mx) mx = d[i];
+        double sum = 0.0;
+        for (uint32_t i = 0; i < k; i++) {
+            p[i] = exp(d[i] - mx);
+            sum += p[i];
+        }
+        for (uint32_t i = 0; i < k; i++) p[i] /= sum;
+        return;
+    }
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < k; i++) {
+        p[i] = sigmoid(d[i]);
+        sum += p[i];
+    }
+    for (uint32_t i = 0; i < k; i++) p[i] /= sum;
+}
+
+int url_native_classify_host_path(const char* host, const char* path, ai_result_t* out)
+{
+    if (!out) return 0;
+    memset(out, 0, sizeof(*out));
+
+    const nm_model_t* m = g_model;
+    if (!m) {
+        out->error_code = AI_ERR_EMPTY;
+        snprintf(out->raw, sizeof(out->raw), "native_model_not_loaded");
+        return 0;
+    }
+
+    if (!host || !host[0]) {
+        out->error_code = AI_ERR_EMPTY;
+        snprintf(out->raw, sizeof(out->raw), "host_empty");
+        return 0;
+    }
+
+    char url[URL_FEATURES_URL_MAX];
+    size_t url_len = url_features_build_url(host, path ? path : "", url, sizeof(url));
+    if (url_len == 0) {
+        out->error_code = AI_ERR_PARSE;
+        snprintf(out->raw, sizeof(out->raw), "url_too_long");
+        return 0;
+    }
+
+    double d[NM_MAX_CLASSES];
+    double p[NM_MAX_CLASSES];
+    if (!decision_values(m, url, url_len, d)) {
+        out->error_code = AI_ERR_PARSE;
+        snprintf(out->raw, sizeof(out->raw), "native_alloc_failed");
+        return 0;
+    }
+    to_proba(m->h, d, p);
+
+    uint32_t best = 0;
+    for (uint32_t i = 1; i < m->h->class_count; i++) if (p[i] > p[best]) best = i;
+
+    out->ok = 1;
+    out->error_code = AI_OK;
+    out->score = 1.0 - p[m->h->benign_index];
+    snprintf(out->label, sizeof(out->label), "%.*s", NM_LABEL_SIZE - 1, m->labels + (size_t)best * NM_LABEL_SIZE);
+    snprintf(out->model_version, sizeof(out->model_version), "%.*s",
+             (int)sizeof(m->h->model_version), m->h->model_version);
+    return 1;
+}
+
+int url_native_classify(const HttpEvent* ev, ai_result_t* out)
+{
+    if (!ev) return 0;
+    return url_native_classify_host_path(ev->host, ev->path, out);
+}
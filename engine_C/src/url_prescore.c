@@ -0,0 +1,94 @@
+// src/url_prescore.c
+#include "url_prescore.h"
+#include "url_features.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+static url_prescore_config_t g_cfg = { 0.0, 2.0 };
+
+// 정적 리소스: 의심 신호가 없으면 정상 쪽으로 보정
+static const char* const STATIC_EXTENSIONS[] = {
+    ".css", ".png", ".jpg", ".jpeg", ".gif", ".svg", ".ico", ".webp",
+    ".woff", ".woff2", ".ttf", ".map", NULL
+};
+
+static int path_is_static_asset(const char* path)
+{
+    size_t n = strcspn(path, "?#");
+    for (const char* const* e = STATIC_EXTENSIONS; *e; e++) {
+        size_t k = strlen(*e);
+        if (k <= n && strncasecmp(path + n - k, *e, k) == 0) return 1;
+    }
+    return 0;
+}
+
+static double excess(double v, double free_count)
+{
+    return v > free_count ? v - free_count : 0.0;
+}
+
+static double clamp_max(double v, double max)
+{
+    return v > max ? max : v;
+}
+
+void url_prescore_init(const url_prescore_config_t* cfg)
+{
+    if (cfg) g_cfg = *cfg;
+
+    if (url_prescore_enabled()) {
+        fprintf(stderr, "[PRESCORE] benign<%.3f malicious>=%.3f%s\n",
+                g_cfg.low, g_cfg.high, g_cfg.high > 1.0 ? " (malicious tier off)" : "");
+    }
+}
+
+int url_prescore_enabled(void)
+{
+    return g_cfg.low > 0.0 || g_cfg.high <= 1.0;
+}
+
+double url_prescore(const char* host, const char* path)
+{
+    if (!host || !host[0]) return 0.5;
+    if (!path) path = "";
+
+    char url[URL_FEATURES_URL_MAX];
+    size_t len = url_features_build_url(host, path, url, sizeof(url));
+    if (len == 0) return 0.5;
+
+    double f[UF_COUNT];
+    url_features_compute(url, len, f);
+
+    // 가중치: 일반 사이트 URL은 ~0.05, 신호 1개 ~0.2, 2개 이상이면 불확실 구간 위쪽
+    double z = -3.0;
+    z += 0.05 * excess(f[UF_DIGIT_COUNT], 6);
+    z += 0.04 * excess(f[UF_SPECIAL_CHAR_COUNT], 10);
+    z += 2.5 * f[UF_HAS_SUSPICIOUS_EXTENSION];
+    z += 2.5 * f[UF_IS_IPV4_HOST];
+    z += 0.6 * excess(f[UF_SUBDOMAIN_COUNT], 1);
+    z += 1.5 * f[UF_CONTAINS_HEX_LIKE_TOKEN];
+    z += 1.0 * clamp_max(f[UF_SUSPICIOUS_KEYWORD_HITS], 3);
+    z += 0.5 * clamp_max(f[UF_QUERY_SUSPICIOUS_KEYWORD_HITS], 2);
+    z += 1.0 * f[UF_IS_SUSPICIOUS_TLD];
+    z += 2.0 * f[UF_BRAND_SUSPICIOUS_COMBO];
+    z += 1.5 * f[UF_HAS_AT_SYMBOL];
+    z += 1.0 * f[UF_DOUBLE_SLASH_IN_PATH];
+    z += 0.5 * f[UF_HAS_LONG_HOST];
+
+    if (path_is_static_asset(path)) z -= 1.5;
+
+    return 1.0 / (1.0 + exp(-z));
+}
+
+url_prescore_tier_t url_prescore_classify(const HttpEvent* ev, double* score)
+{
+    double s = ev ? url_prescore(ev->host, ev->path) : 0.5;
+    if (score) *score = s;
+
+    if (g_cfg.low > 0.0 && s < g_cfg.low) return PRESCORE_BENIGN;
+    if (g_cfg.high <= 1.0 && s >= g_cfg.high) return PRESCORE_MALICIOUS;
+    return PRESCORE_ESCALATE;
+}
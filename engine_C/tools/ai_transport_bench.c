@@ -0,0 +1,138 @@
+// tools/ai_transport_bench.c
+// 채점 API 전송 방식 비교 (HTTP/JSON vs Unix socket 바이너리)
+// - sync: 요청 1건씩 왕복 (워커 스레드 동기 호출과 같음) -> 지연 p50/p99
+// - async: 비동기 루프로 inflight개까지 동시 진행 -> 처리량
+// - pool_size -1: 요청마다 새 연결 (handle 재사용 전 방식), keep-alive 재사용 전후 p50/p99 비교
+//   예) ai_transport_bench http://127.0.0.1:18091/v1/score 2000 64 1 -1  vs  ... 2000 64 1 2
+// 사용: ai_transport_bench http://127.0.0.1:8000/v1/score|unix:/run/gateguard/score.sock [count] [inflight] [batch_max] [pool_size]
+#include "url_classification_client.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int cmp_i64(const void* a, const void* b)
+{
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void make_event(HttpEvent* ev, int i)
+{
+    memset(ev, 0, sizeof(*ev));
+    snprintf(ev->host, sizeof(ev->host), "bench%d.example.com", i % 97);
+    snprintf(ev->path, sizeof(ev->path), "/item/%d/view?id=%d", i, i * 7);
+}
+
+static int g_done_ok = 0;
+static int g_done_fail = 0;
+
+static void on_done(int ok, const ai_result_t* ar, void* ctx)
+{
+    (void)ar;
+    (void)ctx;
+    if (ok) __atomic_add_fetch(&g_done_ok, 1, __ATOMIC_RELAXED);
+    else __atomic_add_fetch(&g_done_fail, 1, __ATOMIC_RELAXED);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <http endpoint | unix:/path> [count] [inflight] [batch_max] [pool_size]\n", argv[0]);
+        return 2;
+    }
+
+    int count = argc > 2 ? atoi(argv[2]) : 2000;
+    int inflight = argc > 3 ? atoi(argv[3]) : 64;
+    int batch_max = argc > 4 ? atoi(argv[4]) : 1;
+    int pool_size = argc > 5 ? atoi(argv[5]) : 2;
+    if (count <= 0) count = 2000;
+    if (inflight <= 0) inflight = 64;
+
+    ai_client_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    if (strncmp(argv[1], "unix:", 5) == 0) {
+        snprintf(cfg.uds_path, sizeof(cfg.uds_path), "%s", argv[1] + 5);
+    } else {
+        snprintf(cfg.endpoint, sizeof(cfg.endpoint), "%s", argv[1]);
+        const char* slash = strrchr(argv[1], '/');
+        if (slash) {
+            snprintf(cfg.batch_endpoint, sizeof(cfg.batch_endpoint), "%.*s/score_batch",
+                     (int)(slash - argv[1]), argv[1]);
+        }
+    }
+    const char* token = getenv("API_TOKEN");
+    snprintf(cfg.token, sizeof(cfg.token), "%s", token ? token : "changeme-token");
+    cfg.timeout_ms = 3000;
+    cfg.connect_timeout_ms = 1500;
+    cfg.pool_size = pool_size;
+    cfg.keepalive_idle_sec = 30;
+
+    if (!ai_client_init(&cfg)) {
+        fprintf(stderr, "ai_client_init failed\n");
+        return 1;
+    }
+
+    // sync
+    int64_t* lat = (int64_t*)malloc((size_t)count * sizeof(int64_t));
+    if (!lat) return 1;
+
+    int ok = 0;
+    int64_t t0 = now_us();
+    for (int i = 0; i < count; i++) {
+        HttpEvent ev;
+        make_event(&ev, i);
+        ai_result_t ar;
+        int64_t s = now_us();
+        ok += ai_classify_url_ex(&ev, "bench", &ar);
+        lat[i] = now_us() - s;
+    }
+    double sync_sec = (double)(now_us() - t0) / 1e6;
+    qsort(lat, (size_t)count, sizeof(int64_t), cmp_i64);
+
+    printf("%-6s sync  n=%d ok=%d pool=%d p50=%lldus p90=%lldus p99=%lldus max=%lldus %.0f req/s\n",
+           cfg.uds_path[0] ? "uds" : "http", count, ok, pool_size,
+           (long long)lat[count / 2], (long long)lat[(count * 90) / 100],
+           (long long)lat[(count * 99) / 100], (long long)lat[count - 1],
+           (double)count / sync_sec);
+    free(lat);
+
+    // async
+    ai_async_config_t acfg;
+    memset(&acfg, 0, sizeof(acfg));
+    acfg.max_inflight = inflight;
+    acfg.batch_max = batch_max;
+    acfg.batch_wait_ms = 2;
+    if (ai_async_start(&acfg) != 0) {
+        fprintf(stderr, "ai_async_start failed\n");
+        ai_client_cleanup();
+        return 1;
+    }
+
+    t0 = now_us();
+    for (int i = 0; i < count; i++) {
+        HttpEvent ev;
+        make_event(&ev, count + i);
+        while (ai_classify_url_async(&ev, "bench", on_done, NULL) == AI_ASYNC_BUSY) usleep(50);
+    }
+    ai_async_drain();
+    double async_sec = (double)(now_us() - t0) / 1e6;
+
+    printf("%-6s async n=%d ok=%d fail=%d inflight=%d batch_max=%d %.0f req/s\n",
+           cfg.uds_path[0] ? "uds" : "http", count, g_done_ok, g_done_fail, inflight,
+           cfg.uds_path[0] ? 0 : batch_max, (double)count / async_sec);
+
+    ai_async_stop();
+    ai_client_cleanup();
+    return 0;
+}
@@ -0,0 +1,138 @@
+// tools/policy_prefix_bench.c
+// PREFIX 룰 매칭 비교 (radix 인덱스 vs 선형 평가)
+// - 룰 n개 합성 (PATH PREFIX, policy 1개당 룰 1개), 조회의 약 1/3이 매칭
+// - 인덱스 빌드 시간, match_policy 1회당 평균 시간 (인덱스 / 선형)
+// - 선형 평가는 룰 수에 비례해 느리므로 조회 수를 줄여서 측정 (linear_lookups)
+// 사용: policy_prefix_bench [lookups] [linear_lookups] [rules...]   (기본 200000 200 1000 100000 1000000)
+#include "policy.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint32_t xorshift(uint32_t* s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+// policy i: "/svc<i>/api/"  (우선순위 = 배열 순서)
+static int make_cache(policy_cache_t* cache, size_t n)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->policies = (policy_t*)calloc(n, sizeof(policy_t));
+    if (!cache->policies) return -1;
+
+    for (size_t i = 0; i < n; i++) {
+        policy_t* p = &cache->policies[i];
+        p->policy_id = (long long)i + 1;
+        p->action = ACT_BLOCK;
+        p->priority = (int)i;
+        p->is_enabled = 1;
+
+        p->rules = (policy_rule_t*)calloc(1, sizeof(policy_rule_t));
+        if (!p->rules) return -1;
+        p->rule_count = 1;
+        cache->policy_count = i + 1;
+
+        policy_rule_t* r = &p->rules[0];
+        r->rule_id = (long long)i + 1;
+        r->policy_id = p->policy_id;
+        r->rule_type = RT_PATH;
+        r->match_type = MT_PREFIX;
+        r->is_enabled = 1;
+        snprintf(r->pattern, sizeof(r->pattern), "/svc%zu/api/", i);
+
+        char err[128];
+        if (policy_rule_compile(r, err, sizeof(err)) != 0) return -1;
+    }
+    return 0;
+}
+
+// 1/3: 룰 prefix로 시작하는 path, 나머지: 어떤 룰에도 없는 path
+static void make_path(char* out, size_t outsz, size_t n, uint32_t* seed)
+{
+    uint32_t v = xorshift(seed);
+    size_t i = (size_t)(xorshift(seed) % (uint32_t)n);
+    if (v % 3 == 0) snprintf(out, outsz, "/svc%zu/api/items/%u", i, v & 0xffff);
+    else snprintf(out, outsz, "/static/svc%zu/img/%u.png", i, v & 0xffff);
+}
+
+// match_policy 1회당 평균 ns (hits: 매칭 수)
+static double run_lookups(const policy_cache_t* cache, size_t n, int lookups, int* hits)
+{
+    char path[128];
+    uint32_t seed = 0x9e3779b9u;
+    int h = 0;
+
+    int64_t t0 = now_ns();
+    for (int i = 0; i < lookups; i++) {
+        make_path(path, sizeof(path), n, &seed);
+        policy_decision_t d = match_policy(cache, "bench.example.com", path, path);
+        h += d.matched;
+    }
+    int64_t dt = now_ns() - t0;
+
+    *hits = h;
+    return (double)dt / (double)lookups;
+}
+
+int main(int argc, char** argv)
+{
+    int lookups = argc > 1 ? atoi(argv[1]) : 200000;
+    int linear_lookups = argc > 2 ? atoi(argv[2]) : 200;
+    if (lookups <= 0) lookups = 200000;
+    if (linear_lookups <= 0) linear_lookups = 200;
+
+    static const size_t defaults[] = { 1000, 100000, 1000000 };
+    size_t nsizes = argc > 3 ? (size_t)(argc - 3) : sizeof(defaults) / sizeof(defaults[0]);
+
+    printf("%-10s %12s %13s %15s  %s\n", "rules", "build", "indexed", "linear", "hit(idx/lin)");
+
+    for (size_t s = 0; s < nsizes; s++) {
+        size_t n = argc > 3 ? (size_t)strtoull(argv[3 + s], NULL, 10) : defaults[s];
+        if (n == 0) continue;
+
+        policy_cache_t cache;
+        if (make_cache(&cache, n) != 0) {
+            fprintf(stderr, "make_cache failed (rules=%zu)\n", n);
+            free_policy_cache(&cache);
+            return 1;
+        }
+
+        // 선형: 인덱스 없는 상태
+        int lin_hits = 0;
+        double lin_ns = run_lookups(&cache, n, linear_lookups, &lin_hits);
+
+        int64_t b0 = now_ns();
+        if (policy_cache_build_index(&cache) != 0) {
+            fprintf(stderr, "index build failed (rules=%zu)\n", n);
+            free_policy_cache(&cache);
+            return 1;
+        }
+        double build_ms = (double)(now_ns() - b0) / 1e6;
+
+        int idx_hits = 0;
+        double idx_ns = run_lookups(&cache, n, lookups, &idx_hits);
+
+        printf("%-10zu %9.1f ms %10.2f us %12.2f us  %.3f/%.3f\n",
+               n, build_ms, idx_ns / 1000.0, lin_ns / 1000.0,
+               (double)idx_hits / lookups, (double)lin_hits / linear_lookups);
+
+        free_policy_cache(&cache);
+    }
+    return 0;
+}
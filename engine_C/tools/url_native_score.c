@@ -0,0 +1,35 @@
+// tools/url_native_score.c
+// 내장 분류기 단독 실행 (ai_trainer/scripts/check_native_parity.py가 사용)
+// 입력: 한 줄에 "host\tpath", 출력: "ok\tscore\tlabel" (score는 %.17g)
+#include "url_native_model.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s model_native.bin < host_path.tsv\n", argv[0]);
+        return 2;
+    }
+
+    if (url_native_model_load(argv[1]) != 0) return 1;
+
+    char line[2048];
+    while (fgets(line, sizeof(line), stdin)) {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        char* path = strchr(line, '\t');
+        if (path) *path++ = '\0';
+
+        ai_result_t ar;
+        if (url_native_classify_host_path(line, path ? path : "", &ar)) {
+            printf("1\t%.17g\t%s\n", ar.score, ar.label);
+        } else {
+            printf("0\t0\t%s\n", ar.raw);
+        }
+    }
+
+    url_native_model_unload();
+    return 0;
+}
@@ -1044,7 +1044,7 @@ class PolicyPatchRequest(BaseModel):
 
 class PolicyRuleCreateRequest(BaseModel):
     rule_type: str  # HOST/PATH/URL
-    match_type: str # EXACT/PREFIX/CONTAINS/REGEX
+    match_type: str # EXACT/PREFIX/CONTAINS/REGEX/DOMAIN
     pattern: str
 
     is_case_sensitive: int = 0
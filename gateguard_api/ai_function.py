@@ -1,7 +1,7 @@
 from __future__ import annotations
 
 import re
-from typing import Any, Dict, List
+from typing import Any, Dict, List, Sequence, Tuple
 from urllib.parse import parse_qs, urlparse
 
 import numpy as np
@@ -266,8 +266,12 @@ def build_feature_row(host: str, path: str) -> Dict[str, Any]:
 
 
 def build_feature_dataframe(host: str, path: str) -> pd.DataFrame:
-    row = build_feature_row(host, path)
-    df = pd.DataFrame([row])
+    return build_feature_dataframe_batch([(host, path)])
+
+
+def build_feature_dataframe_batch(items: Sequence[Tuple[str, str]]) -> pd.DataFrame:
+    rows = [build_feature_row(host, path) for host, path in items]
+    df = pd.DataFrame(rows)
 
     meta = get_loaded_meta()
     feature_columns = meta.get("feature_columns", [])
@@ -283,6 +287,18 @@ def build_feature_dataframe(host: str, path: str) -> pd.DataFrame:
 
 
 def predict_score(host: str, path: str) -> Dict[str, Any]:
+    return predict_scores([(host, path)])[0]
+
+
+def predict_scores(items: Sequence[Tuple[str, str]]) -> List[Dict[str, Any]]:
+    """
+    (host, path) 여러 건을 한 번에 추론
+    - vectorizer.transform / predict_proba 를 배치 전체에 대해 1회 호출
+    - 결과 순서는 items 순서와 동일
+    """
+    if not items:
+        return []
+
     model = get_loaded_model()
     vectorizer = get_loaded_vectorizer()
     label_encoder = get_loaded_label_encoder()
@@ -305,7 +321,7 @@ def predict_score(host: str, path: str) -> Dict[str, Any]:
     if not numeric_feature_columns:
         raise RuntimeError("numeric_feature_columns missing in meta.json")
 
-    df = build_feature_dataframe(host, path)
+    df = build_feature_dataframe_batch(items)
 
     text_series = df["url"].astype(str)
     numeric_df = df[numeric_feature_columns].astype(float)
@@ -314,21 +330,22 @@ def predict_score(host: str, path: str) -> Dict[str, Any]:
     x_numeric = csr_matrix(numeric_df.values)
     x_combined = hstack([x_text, x_numeric])
 
-    probabilities = model.predict_proba(x_combined)[0]
-    pred_index = int(np.argmax(probabilities))
-    label = str(label_encoder.inverse_transform([pred_index])[0])
+    probabilities = model.predict_proba(x_combined)
+    pred_indexes = np.argmax(probabilities, axis=1)
+    labels = [str(label) for label in label_encoder.inverse_transform(pred_indexes)]
 
     classes = [str(c) for c in label_encoder.classes_]
     if "benign" not in classes:
         raise RuntimeError("label_encoder.classes_ does not contain 'benign'")
 
     benign_index = classes.index("benign")
-    benign_probability = float(probabilities[benign_index])
+    model_version = meta.get("model_version", "unknown")
 
-    score = 1.0 - benign_probability
-
-    return {
-        "score": score,
-        "label": label,
-        "model_version": meta.get("model_version", "unknown"),
-    }
+    return [
+        {
+            "score": 1.0 - float(probabilities[i][benign_index]),
+            "label": labels[i],
+            "model_version": model_version,
+        }
+        for i in range(len(items))
+    ]
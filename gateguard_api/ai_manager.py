@@ -2,9 +2,9 @@
 from __future__ import annotations
 
 import time
-from typing import Any, Dict, Optional
+from typing import Any, Dict, List, Optional, Sequence, Tuple
 
-from gateguard_api.ai_function import predict_score
+from gateguard_api.ai_function import predict_score, predict_scores
 from gateguard_api.ai_loader import get_model_version
 from gateguard_api.db import insert_ai_analysis
 
@@ -63,3 +63,41 @@ def score_url(
                 analysis_seq=0,
             )
         raise
+
+
+def score_url_batch(items: Sequence[Tuple[str, str]]) -> List[Dict[str, Any]]:
+    """
+    엔진 마이크로 배치 채점 (/v1/score_batch)
+    - 유효한 항목만 모아 predict_scores 1회 호출, 결과는 입력 순서대로
+    - host가 비어 있는 항목은 그 항목만 error로 응답
+    - ai_analysis는 엔진이 기록하므로 여기서는 DB에 쓰지 않음
+    """
+    model_version = get_model_version()
+    results: List[Dict[str, Any]] = [
+        {"ok": False, "error": "host is required", "model_version": model_version}
+        for _ in items
+    ]
+
+    valid_index: List[int] = []
+    valid_items: List[Tuple[str, str]] = []
+    for i, (host, path) in enumerate(items):
+        if not host or not str(host).strip():
+            continue
+        if path is None or str(path).strip() == "":
+            path = "/"
+        valid_index.append(i)
+        valid_items.append((host, path))
+
+    if not valid_items:
+        return results
+
+    predictions = predict_scores(valid_items)
+    for i, prediction in zip(valid_index, predictions):
+        results[i] = {
+            "ok": True,
+            "score": prediction["score"],
+            "label": prediction["label"],
+            "model_version": model_version,
+        }
+
+    return results
@@ -13,7 +13,8 @@ from fastapi.responses import JSONResponse
 from pydantic import BaseModel, Field
 
 from gateguard_api.ai_loader import load_artifacts_on_startup, get_model_version
-from gateguard_api.ai_manager import score_url
+from gateguard_api.ai_manager import score_url, score_url_batch
+from gateguard_api.score_socket import start_score_socket, stop_score_socket
 from gateguard_api.alert_state import dedup_allow_send, update_component_status
 from gateguard_api.slack_alerts import (
     send_ai_block_alert,
@@ -67,6 +68,21 @@ async def unhandled_exception_handler(request: Request, exc: Exception):
 def startup_event() -> None:
     load_artifacts_on_startup()
 
+# 엔진 전용 Unix socket 바이너리 채점 (SCORE_UDS_PATH 지정 시, 엔진은 AI_UDS_PATH로 연결)
+SCORE_UDS_PATH = os.getenv("SCORE_UDS_PATH", "")
+SCORE_UDS_MODE = int(os.getenv("SCORE_UDS_MODE", "660"), 8)
+
+
+@app.on_event("startup")
+async def start_score_socket_event() -> None:
+    if SCORE_UDS_PATH:
+        await start_score_socket(SCORE_UDS_PATH, API_TOKEN, SCORE_UDS_MODE, on_error=_safe_send_platform_error)
+
+
+@app.on_event("shutdown")
+async def stop_score_socket_event() -> None:
+    await stop_score_socket()
+
 # --- CORS (Admin UI에서 FastAPI 호출 허용) ---
 def _parse_csv(v: Optional[str]) -> List[str]:
     if not v:
@@ -1503,7 +1519,7 @@ class PolicyPatchRequest(BaseModel):
 
 class PolicyRuleCreateRequest(BaseModel):
     rule_type: str  # HOST/PATH/URL
-    match_type: str # EXACT/PREFIX/CONTAINS/REGEX
+    match_type: str # EXACT/PREFIX/CONTAINS/REGEX/DOMAIN
     pattern: str
 
     is_case_sensitive: int = 0
@@ -2020,6 +2036,89 @@ def score(req: ScoreRequest, authorization: Optional[str] = Header(default=None)
         latency_ms=int(latency_ms),
     )
 
+SCORE_BATCH_MAX_ITEMS = int(os.getenv("SCORE_BATCH_MAX_ITEMS", "256"))
+
+
+class ScoreBatchItem(BaseModel):
+    request_id: Optional[str] = None
+    host: str = ""
+    path: Optional[str] = None
+
+
+class ScoreBatchRequest(BaseModel):
+    items: List[ScoreBatchItem]
+
+
+class ScoreBatchResult(BaseModel):
+    request_id: Optional[str] = None
+    ok: bool
+    score: Optional[float] = None
+    label: Optional[str] = None
+    error: Optional[str] = None
+
+
+class ScoreBatchResponse(BaseModel):
+    model_version: str
+    threshold: float
+    latency_ms: int
+    results: List[ScoreBatchResult]
+
+
+@app.post("/v1/score_batch", response_model=ScoreBatchResponse)
+def score_batch(req: ScoreBatchRequest, authorization: Optional[str] = Header(default=None)):
+    """
+    엔진 마이크로 배치 채점:
+    - items 전체를 vectorizer.transform + predict_proba 1회로 추론
+    - results는 items와 같은 순서/개수 (항목별 실패는 ok=false + error)
+    - ai_analysis는 /v1/score 와 같이 엔진이 기록
+    - 엔진 테스트 훅 (/v1/score 와 같은 조건):
+      timeout_test는 배치 전체 지연 (응답 1개라 항목만 늦출 수 없음),
+      error_test는 해당 항목 ok=false, invalid_test는 해당 항목만 label 없는 결과
+    """
+    require_token(authorization)
+
+    if len(req.items) > SCORE_BATCH_MAX_ITEMS:
+        raise HTTPException(status_code=413, detail=f"too many items (max {SCORE_BATCH_MAX_ITEMS})")
+
+    start = time.time()
+
+    def has_hook(item: ScoreBatchItem, name: str) -> bool:
+        return name in (item.host or "").lower() or name in (item.path or "").lower()
+
+    if any(has_hook(item, "timeout_test") for item in req.items):
+        time.sleep(10)
+
+    try:
+        scored = score_url_batch([(item.host, item.path or "/") for item in req.items])
+    except Exception as exc:
+        _safe_send_platform_error("/v1/score_batch [POST]", str(exc))
+        raise HTTPException(status_code=500, detail=f"AI scoring failed: {exc}") from exc
+
+    results = []
+    for item, r in zip(req.items, scored):
+        if has_hook(item, "error_test"):
+            results.append(ScoreBatchResult(request_id=item.request_id, ok=False, error="forced error for engine test"))
+        elif has_hook(item, "invalid_test"):
+            results.append(ScoreBatchResult(request_id=item.request_id, ok=True, score=0.1))
+        elif r["ok"]:
+            results.append(ScoreBatchResult(
+                request_id=item.request_id,
+                ok=True,
+                score=round(float(r["score"]), 4),
+                label=r["label"],
+            ))
+        else:
+            results.append(ScoreBatchResult(request_id=item.request_id, ok=False, error=r["error"]))
+
+    latency_ms = int((time.time() - start) * 1000)
+
+    return ScoreBatchResponse(
+        model_version=get_model_version(),
+        threshold=float(THRESHOLD),
+        latency_ms=latency_ms,
+        results=results,
+    )
+
 def label_from_score(score: float, threshold: float) -> str:
     return "malicious" if score >= threshold else "benign"
 
@@ -0,0 +1,185 @@
+# ~/GateGuard/gateguard_api/score_socket.py
+from __future__ import annotations
+
+import asyncio
+import os
+import struct
+import time
+from typing import Callable, List, Optional, Tuple
+
+from gateguard_api.ai_loader import get_model_version
+from gateguard_api.ai_manager import score_url_batch
+
+# 엔진용 Unix domain socket 바이너리 채점 프로토콜 (engine_C/include/ai_score_proto.h 와 동일)
+# - 모든 정수는 little-endian
+# - hello: "GGS1" + u16 token_len + token  ->  u16 status(200/401/403) + u16 0
+# - 요청: u32 len + u32 seq + u16 host_len + u16 path_len + u16 rid_len + u16 0 + host + path + rid
+# - 응답: u32 len + u32 seq + u16 status + u8 label_len + u8 mv_len + f64 score + label + mv (+ 에러 메시지)
+# - pipelining: 한 번에 읽힌 요청들을 predict_scores 1회로 채점, 응답은 요청 순서대로
+# - ai_analysis는 /v1/score 와 같이 엔진이 기록
+
+MAGIC = b"GGS1"
+HELLO_REPLY = struct.Struct("<HH")
+REQ_HEAD = struct.Struct("<IIHHHH")   # len, seq, host_len, path_len, rid_len, reserved
+RESP_HEAD = struct.Struct("<IIHBBd")  # len, seq, status, label_len, mv_len, score
+REQ_FIXED = REQ_HEAD.size - 4
+RESP_FIXED = RESP_HEAD.size - 4
+
+MAX_REQUEST_FRAME = 2048   # AI_PROTO_REQ_MAX
+MAX_ERROR_BYTES = 400      # 응답 frame이 AI_PROTO_RESP_MAX(1024)를 넘지 않도록
+SCORE_SOCKET_MAX_ITEMS = int(os.getenv("SCORE_BATCH_MAX_ITEMS", "256"))
+
+Frame = Tuple[int, str, str, str]  # seq, host, path, request_id
+
+_server: Optional[asyncio.AbstractServer] = None
+
+
+def encode_response(seq: int, status: int, score: float = 0.0, label: str = "",
+                    model_version: str = "", error: str = "") -> bytes:
+    label_b = label.encode("utf-8")[:255]
+    mv_b = model_version.encode("utf-8")[:255]
+    err_b = error.encode("utf-8")[:MAX_ERROR_BYTES] if status != 200 else b""
+    body_len = RESP_FIXED + len(label_b) + len(mv_b) + len(err_b)
+    return RESP_HEAD.pack(body_len, seq, status, len(label_b), len(mv_b), float(score)) + label_b + mv_b + err_b
+
+
+def split_frames(buf: bytearray) -> List[Frame]:
+    """
+    buf에서 완성된 요청 frame을 꺼냄 (꺼낸 만큼 buf에서 삭제)
+    - 잘못된 frame이면 ValueError (연결 종료)
+    """
+    frames: List[Frame] = []
+    off = 0
+    while len(buf) - off >= REQ_HEAD.size:
+        body_len, seq, host_len, path_len, rid_len, _ = REQ_HEAD.unpack_from(buf, off)
+        if body_len > MAX_REQUEST_FRAME or body_len != REQ_FIXED + host_len + path_len + rid_len:
+            raise ValueError("bad request frame")
+        if len(buf) - off < 4 + body_len:
+            break
+
+        p = off + REQ_HEAD.size
+        host = bytes(buf[p:p + host_len]).decode("utf-8", "replace")
+        p += host_len
+        path = bytes(buf[p:p + path_len]).decode("utf-8", "replace")
+        p += path_len
+        request_id = bytes(buf[p:p + rid_len]).decode("utf-8", "replace")
+
+        frames.append((seq, host, path, request_id))
+        off += 4 + body_len
+
+    del buf[:off]
+    return frames
+
+
+def score_frames(frames: List[Frame]) -> bytes:
+    """
+    /v1/score 와 같은 규칙으로 채점 (엔진 테스트 훅 포함)
+    - 정상 항목은 score_url_batch 1회로 묶어서 추론
+    """
+    model_version = get_model_version()
+    responses: List[Optional[bytes]] = [None] * len(frames)
+
+    batch_index: List[int] = []
+    batch_items: List[Tuple[str, str]] = []
+    for i, (seq, host, path, _) in enumerate(frames):
+        h = host.lower()
+        p = path.lower()
+
+        # 기존 엔진 테스트 훅 유지
+        if "timeout_test" in h or "timeout_test" in p:
+            time.sleep(10)
+        if "error_test" in h or "error_test" in p:
+            responses[i] = encode_response(seq, 500, error="forced 500 for engine test")
+            continue
+        if "invalid_test" in h or "invalid_test" in p:
+            responses[i] = encode_response(seq, 200, model_version=model_version)
+            continue
+
+        batch_index.append(i)
+        batch_items.append((host, path or "/"))
+
+    if batch_items:
+        try:
+            scored = score_url_batch(batch_items)
+        except Exception as exc:
+            scored = [{"ok": False, "error": f"AI scoring failed: {exc}", "status": 500}] * len(batch_items)
+
+        for i, r in zip(batch_index, scored):
+            seq = frames[i][0]
+            if r["ok"]:
+                responses[i] = encode_response(seq, 200, round(float(r["score"]), 4), r["label"], r["model_version"])
+            else:
+                responses[i] = encode_response(seq, r.get("status", 400), error=r["error"])
+
+    return b"".join(responses)
+
+
+async def _handle_connection(reader: asyncio.StreamReader, writer: asyncio.StreamWriter, token: str) -> None:
+    try:
+        hello = await reader.readexactly(6)
+        if hello[:4] != MAGIC:
+            return
+
+        (token_len,) = struct.unpack_from("<H", hello, 4)
+        received = (await reader.readexactly(token_len)).decode("utf-8", "replace") if token_len else ""
+        status = 200 if received == token else (401 if not received else 403)
+
+        writer.write(HELLO_REPLY.pack(status, 0))
+        await writer.drain()
+        if status != 200:
+            return
+
+        loop = asyncio.get_running_loop()
+        buf = bytearray()
+        while True:
+            data = await reader.read(64 * 1024)
+            if not data:
+                return
+            buf += data
+
+            frames = split_frames(buf)
+            for start in range(0, len(frames), SCORE_SOCKET_MAX_ITEMS):
+                chunk = frames[start:start + SCORE_SOCKET_MAX_ITEMS]
+                writer.write(await loop.run_in_executor(None, score_frames, chunk))
+            await writer.drain()
+
+    except (asyncio.IncompleteReadError, ConnectionError, ValueError):
+        return
+    finally:
+        writer.close()
+
+
+async def start_score_socket(path: str, token: str, mode: int = 0o660,
+                             on_error: Optional[Callable[[str, str], None]] = None) -> None:
+    """
+    채점 소켓 시작 (FastAPI startup)
+    - 이전 실행이 남긴 소켓 파일은 지우고 다시 생성
+    - uvicorn 워커 1개 기준 (여러 워커면 마지막 워커만 소켓을 가짐)
+    """
+    global _server
+    if _server is not None:
+        return
+
+    try:
+        if os.path.exists(path):
+            os.unlink(path)
+        _server = await asyncio.start_unix_server(
+            lambda r, w: _handle_connection(r, w, token),
+            path=path,
+        )
+        os.chmod(path, mode)
+    except OSError as exc:
+        if on_error is not None:
+            on_error(f"score socket {path}", str(exc))
+        _server = None
+
+
+async def stop_score_socket() -> None:
+    global _server
+    if _server is None:
+        return
+
+    server = _server
+    _server = None
+    server.close()
+    await server.wait_closed()